@@ -26,6 +26,10 @@
  * @version     00.00.01
  *              - 2018/10/29 : zhaozhenge@outlook.com
  *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Add pool module
+ *                  -# Add lz module
  */
 
 #ifndef _CLIB_API_H_
@@ -61,10 +65,18 @@ extern "C" {
 #include "CLIB_list.h"
 #endif
 
+#ifdef CLIB_LZ_MODULE_ENABLED
+#include "CLIB_lz.h"
+#endif
+
 #ifdef CLIB_NET_MODULE_ENABLED
 #include "CLIB_net.h"
 #endif
 
+#ifdef CLIB_POOL_MODULE_ENABLED
+#include "CLIB_pool.h"
+#endif
+
 #ifdef CLIB_RANDOM_MODULE_ENABLED
 #include "CLIB_random.h"
 #endif
@@ -29,6 +29,15 @@
  * @version     00.00.02
  *              - 2018/10/29 : zhaozhenge@outlook.com
  *                  -# Add configuration of sub module
+ * @version     00.00.03
+ *              - 2026/10/17 : agent@local
+ *                  -# Add configuration of pool module
+ * @version     00.00.04
+ *              - 2026/10/17 : agent@local
+ *                  -# Add configuration of heap statistics
+ * @version     00.00.05
+ *              - 2026/10/17 : agent@local
+ *                  -# Add configuration of lz module
  */
 
 #ifndef _CLIB_DEF_H_
@@ -54,7 +63,9 @@ extern "C" {
 //#define CLIB_BUFFER_MODULE_ENABLED
 #define CLIB_HEAP_MODULE_ENABLED
 #define CLIB_LIST_MODULE_ENABLED
+#define CLIB_LZ_MODULE_ENABLED
 #define CLIB_NET_MODULE_ENABLED
+#define CLIB_POOL_MODULE_ENABLED
 //#define CLIB_RANDOM_MODULE_ENABLED
 //#define CLIB_RINGBUFFER_MODULE_ENABLED
 //#define CLIB_SHA_MODULE_ENABLED
@@ -63,6 +74,8 @@ extern "C" {
 //#define CLIB_TIMER_MODULE_ENABLED
 //#define CLIB_PRINT_MODULE_ENABLED
 
+//#define CLIB_HEAP_STATISTICS      /* Count the allocations of CLIB_heap (costs some time in each malloc and free) */
+
 #define CLIB_ALIGNBYTES             (sizeof(void *))
 #define CLIB_ALIGN(p,alignbytes)    ((((size_t)p+alignbytes-1)&~(alignbytes-1)))
 
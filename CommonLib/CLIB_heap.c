@@ -33,6 +33,12 @@
  * @version     00.00.01 
  *              - 2018/05/04 : zhaozhenge@outlook.com 
  *                  -# New
+ * @version     00.00.02 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add the two-level segregated fit engine selected by CLIB_heap_create_ex
+ * @version     00.00.03 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add the statistics enabled by CLIB_HEAP_STATISTICS
  */
 
 /**************************************************************
@@ -53,10 +59,159 @@
 #define MINIMUM_BLOCK_SIZE      ( ( size_t ) ( Heap->m_prvHeapStructSize << 1 ) )
 /*!< Block sizes must not get too small. */
 
+#define TLSF_SL_INDEX_COUNT_LOG2    ( 3 )
+/*!< log2 of the second level lists number of each first level */
+
+#define TLSF_SL_INDEX_COUNT         ( 1 << TLSF_SL_INDEX_COUNT_LOG2 )
+/*!< Number of the second level lists of each first level */
+
+#define TLSF_FL_INDEX_MAX           ( 30 )
+/*!< The block size is less than ( 2 << TLSF_FL_INDEX_MAX ) */
+
+#define TLSF_FL_INDEX_COUNT_MAX     ( TLSF_FL_INDEX_MAX - ( TLSF_SL_INDEX_COUNT_LOG2 + 3 ) + 2 )
+/*!< Number of the first levels with the minimum alignment (8 bytes) */
+
+#define TLSF_BLOCK_FREE_BIT         ( ( size_t ) 1 )
+/*!< Set in the Size member of a free block (the block size is always aligned) */
+
+#define TLSF_BLOCK_SIZE( Block )    ( ( Block )->Size & ~TLSF_BLOCK_FREE_BIT )
+/*!< Size of a block */
+
+#define TLSF_BLOCK_NEXT( Block )    ( ( S_TLSF_BLOCK * ) ( ( ( uint8_t * ) ( Block ) ) + TLSF_BLOCK_SIZE( Block ) ) )
+/*!< The physically next block */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/** 
+ *  @brief      The block header of the TLSF engine
+ *  @details    The free list links are only valid in a free block, they are the beginning of the user data in an allocated block
+ *  @author     agent@local
+ *  @date       2026/10/17
+ */
+typedef struct _S_TLSF_BLOCK
+{
+    struct _S_TLSF_BLOCK*   PrevPhysBlock;              /*!< The physically previous block (NULL for the first block) */
+    size_t                  Size;                       /*!< The size of the block (with the header) and TLSF_BLOCK_FREE_BIT */
+    struct _S_TLSF_BLOCK*   NextFreeBlock;              /*!< The next free block in the same list */
+    struct _S_TLSF_BLOCK*   PrevFreeBlock;              /*!< The previous free block in the same list */
+} S_TLSF_BLOCK;
+
+/** 
+ *  @brief      The control structure of the TLSF engine
+ *  @details    The free blocks are kept in the list of [first level][second level] by their size. The first level is 
+ *              the power of 2 of the size and the second level divides it linearly. The bitmaps show which lists are 
+ *              not empty, so a fit list is found by two bit scans.
+ *  @author     agent@local
+ *  @date       2026/10/17
+ */
+typedef struct _S_TLSF_CONTROL
+{
+    size_t                  AlignLog2;                  /*!< log2 of the alignment */
+    size_t                  FlShift;                    /*!< Blocks smaller than ( 1 << FlShift ) are in the first level 0 */
+    size_t                  FlCount;                    /*!< Number of the first levels */
+    size_t                  HeaderSize;                 /*!< Offset of the user data in an allocated block */
+    size_t                  MinBlockSize;               /*!< Minimum size of a block */
+    size_t                  MaxBlockSize;               /*!< Maximum size of a block */
+    uint32_t                FlBitmap;                   /*!< Bit of the first level is set if any list of it is not empty */
+    uint32_t                SlBitmap[TLSF_FL_INDEX_COUNT_MAX];                          /*!< Bit of the list is set if it is not empty */
+    S_TLSF_BLOCK*           Blocks[TLSF_FL_INDEX_COUNT_MAX][TLSF_SL_INDEX_COUNT];       /*!< Heads of the free lists */
+} S_TLSF_CONTROL;
+
 /**************************************************************
 **  Function
 **************************************************************/
 
+/** 
+ * @brief               Lock the heap
+ * @param[in,out]       Heap                Heap information
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvHeapLock( S_HEAP_HANDLE* Heap )
+{
+    if(Heap->LockFunc)
+    {
+        Heap->LockFunc(Heap->UsrData);
+    }
+#if defined(CLIB_HEAP_STATISTICS)
+    Heap->m_Statistics.LockCount++;
+    if(Heap->m_ClockFunc)
+    {
+        Heap->m_LockStart = Heap->m_ClockFunc(Heap->UsrData);
+    }
+#endif
+    return;
+}
+
+/** 
+ * @brief               Unlock the heap
+ * @param[in,out]       Heap                Heap information
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvHeapUnlock( S_HEAP_HANDLE* Heap )
+{
+#if defined(CLIB_HEAP_STATISTICS)
+    if(Heap->m_ClockFunc)
+    {
+        Heap->m_Statistics.LockTime += Heap->m_ClockFunc(Heap->UsrData) - Heap->m_LockStart;
+    }
+#endif
+    if(Heap->UnlockFunc)
+    {
+        Heap->UnlockFunc(Heap->UsrData);
+    }
+    return;
+}
+
+#if defined(CLIB_HEAP_STATISTICS)
+
+/** 
+ * @brief               Count an allocation in the statistics
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           WantedSize          Memory size that wanted to allocate
+ * @param[in]           Pv                  Memory address allocated (NULL if failed)
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvHeapStatisticsAlloc( S_HEAP_HANDLE* Heap, size_t WantedSize, void* Pv )
+{
+    uint32_t    i   =   0;
+    
+    if( !WantedSize )
+    {
+        return;
+    }
+    while( ( i < ( CLIB_HEAP_HISTOGRAM_NUM - 1 ) ) && ( WantedSize > ( ( size_t ) 8 << i ) ) )
+    {
+        i++;
+    }
+    Heap->m_Statistics.SizeHistogram[i]++;
+    if( Pv )
+    {
+        Heap->m_Statistics.AllocCount++;
+    }
+    else
+    {
+        Heap->m_Statistics.FailedCount++;
+        Heap->m_Statistics.LastFailedSize = WantedSize;
+    }
+    return;
+}
+
+#endif /* CLIB_HEAP_STATISTICS */
+
 /** 
  * @brief               Called automatically to set up the required heap structures the first time
  * @param[in,out]       Heap                Heap information
@@ -167,23 +322,541 @@ static void prvInsertBlockIntoFreeList( S_HEAP_HANDLE* Heap, S_BLOCK_LINK *Block
             BlockToInsert->NextFreeBlock = Heap->m_EndBlockPtr;
         }
     }
-    else
+    else
+    {
+        BlockToInsert->NextFreeBlock = Iterator->NextFreeBlock;
+    }
+
+    /* If the block being inserted plugged a gab, so was merged with the block
+     * before and the block after, then it's NextFreeBlock pointer will have
+     * already been set, and should not be set here as that would make it point
+     * to itself. 
+     */
+    if( Iterator != BlockToInsert )
+    {
+        Iterator->NextFreeBlock = BlockToInsert;
+    }
+    return;
+}
+
+/** 
+ * @brief               Find the last (most significant) set bit
+ * @param[in]           Word                Word (not 0)
+ * @return              Index of the bit
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvTlsfFls( uint32_t Word )
+{
+    uint32_t    Bit     =   0;
+    
+    if( Word & 0xFFFF0000 ) { Word >>= 16; Bit += 16; }
+    if( Word & 0x0000FF00 ) { Word >>= 8;  Bit += 8;  }
+    if( Word & 0x000000F0 ) { Word >>= 4;  Bit += 4;  }
+    if( Word & 0x0000000C ) { Word >>= 2;  Bit += 2;  }
+    if( Word & 0x00000002 ) { Bit += 1; }
+    return Bit;
+}
+
+/** 
+ * @brief               Find the first (least significant) set bit
+ * @param[in]           Word                Word (not 0)
+ * @return              Index of the bit
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvTlsfFfs( uint32_t Word )
+{
+    return prvTlsfFls( Word & ( ~Word + 1 ) );
+}
+
+/** 
+ * @brief               Get the free list of a block size
+ * @param[in]           Control             TLSF control structure
+ * @param[in]           Size                Block size
+ * @param[out]          Fl                  First level index
+ * @param[out]          Sl                  Second level index
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvTlsfMappingInsert( S_TLSF_CONTROL* Control, size_t Size, uint32_t* Fl, uint32_t* Sl )
+{
+    uint32_t    Bit     =   0;
+    
+    if( Size < ( ( size_t ) 1 << Control->FlShift ) )
+    {
+        /* Small blocks are divided linearly by the alignment */
+        *Fl = 0;
+        *Sl = ( uint32_t ) ( Size >> Control->AlignLog2 );
+    }
+    else
+    {
+        Bit = prvTlsfFls( ( uint32_t ) Size );
+        *Sl = ( uint32_t ) ( Size >> ( Bit - TLSF_SL_INDEX_COUNT_LOG2 ) ) ^ TLSF_SL_INDEX_COUNT;
+        *Fl = Bit - ( uint32_t ) Control->FlShift + 1;
+    }
+    return;
+}
+
+/** 
+ * @brief               Insert a free block into its free list
+ * @param[in,out]       Control             TLSF control structure
+ * @param[in]           Block               Free block
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvTlsfInsertFreeBlock( S_TLSF_CONTROL* Control, S_TLSF_BLOCK* Block )
+{
+    uint32_t    Fl  =   0;
+    uint32_t    Sl  =   0;
+    
+    prvTlsfMappingInsert( Control, TLSF_BLOCK_SIZE( Block ), &Fl, &Sl );
+    Block->PrevFreeBlock = NULL;
+    Block->NextFreeBlock = Control->Blocks[Fl][Sl];
+    if( Block->NextFreeBlock )
+    {
+        Block->NextFreeBlock->PrevFreeBlock = Block;
+    }
+    Control->Blocks[Fl][Sl] = Block;
+    Control->FlBitmap |= ( 1u << Fl );
+    Control->SlBitmap[Fl] |= ( 1u << Sl );
+    return;
+}
+
+/** 
+ * @brief               Remove a free block from its free list
+ * @param[in,out]       Control             TLSF control structure
+ * @param[in]           Block               Free block
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvTlsfRemoveFreeBlock( S_TLSF_CONTROL* Control, S_TLSF_BLOCK* Block )
+{
+    uint32_t    Fl  =   0;
+    uint32_t    Sl  =   0;
+    
+    if( Block->NextFreeBlock )
+    {
+        Block->NextFreeBlock->PrevFreeBlock = Block->PrevFreeBlock;
+    }
+    if( Block->PrevFreeBlock )
+    {
+        Block->PrevFreeBlock->NextFreeBlock = Block->NextFreeBlock;
+    }
+    else
+    {
+        /* The head of the list is removed */
+        prvTlsfMappingInsert( Control, TLSF_BLOCK_SIZE( Block ), &Fl, &Sl );
+        Control->Blocks[Fl][Sl] = Block->NextFreeBlock;
+        if( !Block->NextFreeBlock )
+        {
+            Control->SlBitmap[Fl] &= ~( 1u << Sl );
+            if( !Control->SlBitmap[Fl] )
+            {
+                Control->FlBitmap &= ~( 1u << Fl );
+            }
+        }
+    }
+    return;
+}
+
+/** 
+ * @brief               Take a free block which is not smaller than the size out of the free lists
+ * @param[in,out]       Control             TLSF control structure
+ * @param[in]           Size                Block size (aligned)
+ * @return              Free block (NULL if not found)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static S_TLSF_BLOCK* prvTlsfFindFreeBlock( S_TLSF_CONTROL* Control, size_t Size )
+{
+    S_TLSF_BLOCK*   Block   =   NULL;
+    uint32_t        Fl      =   0;
+    uint32_t        Sl      =   0;
+    uint32_t        Map     =   0;
+    
+    /* Round up to the next list, so any block of the list found is large enough */
+    if( Size >= ( ( size_t ) 1 << Control->FlShift ) )
+    {
+        Size += ( ( size_t ) 1 << ( prvTlsfFls( ( uint32_t ) Size ) - TLSF_SL_INDEX_COUNT_LOG2 ) ) - 1;
+    }
+    prvTlsfMappingInsert( Control, Size, &Fl, &Sl );
+    if( Fl >= Control->FlCount )
+    {
+        return NULL;
+    }
+    
+    /* Search the lists of the same first level, then the larger first levels */
+    Map = Control->SlBitmap[Fl] & ( ~0u << Sl );
+    if( !Map )
+    {
+        Map = Control->FlBitmap & ( ~0u << ( Fl + 1 ) );
+        if( !Map )
+        {
+            return NULL;
+        }
+        Fl = prvTlsfFfs( Map );
+        Map = Control->SlBitmap[Fl];
+    }
+    Sl = prvTlsfFfs( Map );
+    
+    Block = Control->Blocks[Fl][Sl];
+    prvTlsfRemoveFreeBlock( Control, Block );
+    return Block;
+}
+
+/** 
+ * @brief               Set up the TLSF control structure and the first free block
+ * @param[in,out]       Heap                Heap information
+ * @retval              0                   success
+ * @retval              -1                  the Heap buffer is too small
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvTlsfInit( S_HEAP_HANDLE* Heap )
+{
+    S_TLSF_CONTROL* Control;
+    S_TLSF_BLOCK*   FirstFreeBlock;
+    S_TLSF_BLOCK*   EndBlock;
+    size_t          MemAddress;
+    size_t          MemEnd;
+    size_t          BlockSize;
+    
+    /* The control structure is placed at the beginning of the heap */
+    MemAddress = ( ( size_t ) Heap->m_prvHeap + Heap->m_PortByteAlignmentMask ) & ~Heap->m_PortByteAlignmentMask;
+    MemEnd = ( ( size_t ) Heap->m_prvHeap + Heap->m_prvTotalHeapSize ) & ~Heap->m_PortByteAlignmentMask;
+    Control = ( void * ) MemAddress;
+    
+    MemAddress += ( sizeof( S_TLSF_CONTROL ) + Heap->m_PortByteAlignmentMask ) & ~Heap->m_PortByteAlignmentMask;
+    if( MemEnd < MemAddress + sizeof( S_TLSF_BLOCK ) * 2 )
+    {
+        return (-1);
+    }
+    
+    memset( Control, 0, sizeof( S_TLSF_CONTROL ) );
+    Control->AlignLog2 = prvTlsfFls( ( uint32_t ) Heap->m_PortByteAlignment );
+    Control->FlShift = Control->AlignLog2 + TLSF_SL_INDEX_COUNT_LOG2;
+    Control->FlCount = TLSF_FL_INDEX_MAX - Control->FlShift + 2;
+    Control->HeaderSize = ( offsetof( S_TLSF_BLOCK, NextFreeBlock ) + Heap->m_PortByteAlignmentMask ) & ~Heap->m_PortByteAlignmentMask;
+    Control->MinBlockSize = ( sizeof( S_TLSF_BLOCK ) + Heap->m_PortByteAlignmentMask ) & ~Heap->m_PortByteAlignmentMask;
+    Control->MaxBlockSize = ( ( ( size_t ) 2 << TLSF_FL_INDEX_MAX ) - 1 ) & ~Heap->m_PortByteAlignmentMask;
+    
+    /* One free block takes up the heap space, and an allocated block with size 0 marks the end */
+    BlockSize = MemEnd - MemAddress - Control->HeaderSize;
+    if( BlockSize > Control->MaxBlockSize )
+    {
+        BlockSize = Control->MaxBlockSize;
+    }
+    if( BlockSize < Control->MinBlockSize )
+    {
+        return (-1);
+    }
+    FirstFreeBlock = ( void * ) MemAddress;
+    FirstFreeBlock->PrevPhysBlock = NULL;
+    FirstFreeBlock->Size = BlockSize | TLSF_BLOCK_FREE_BIT;
+    EndBlock = TLSF_BLOCK_NEXT( FirstFreeBlock );
+    EndBlock->PrevPhysBlock = FirstFreeBlock;
+    EndBlock->Size = 0;
+    prvTlsfInsertFreeBlock( Control, FirstFreeBlock );
+    
+    Heap->m_TlsfControl = Control;
+    Heap->m_FreeBytesRemaining = BlockSize;
+    Heap->m_MinimumEverFreeBytesRemaining = BlockSize;
+    return (0);
+}
+
+/** 
+ * @brief               Memory allocate function of the TLSF engine
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           WantedSize          Memory size that want to allocate
+ * @return              Memory address allocated successfully (NULL when no memory enough)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void* prvTlsfMalloc( S_HEAP_HANDLE* Heap, size_t WantedSize )
+{
+    S_TLSF_CONTROL* Control = ( S_TLSF_CONTROL * ) Heap->m_TlsfControl;
+    S_TLSF_BLOCK*   Block;
+    S_TLSF_BLOCK*   RemainBlock;
+    size_t          BlockSize;
+    
+    if( ( WantedSize == 0 ) || ( WantedSize > Control->MaxBlockSize - Control->HeaderSize ) )
+    {
+        return NULL;
+    }
+    
+    /* The block contains the header and the user data, and is large enough to be a free block again */
+    WantedSize = ( WantedSize + Control->HeaderSize + Heap->m_PortByteAlignmentMask ) & ~Heap->m_PortByteAlignmentMask;
+    if( WantedSize < Control->MinBlockSize )
+    {
+        WantedSize = Control->MinBlockSize;
+    }
+    
+    Block = prvTlsfFindFreeBlock( Control, WantedSize );
+    if( !Block )
+    {
+        return NULL;
+    }
+    
+    /* Split the block and give the remaining part back to the free lists */
+    BlockSize = TLSF_BLOCK_SIZE( Block );
+    if( ( BlockSize - WantedSize ) >= Control->MinBlockSize )
+    {
+        RemainBlock = ( S_TLSF_BLOCK * ) ( ( ( uint8_t * ) Block ) + WantedSize );
+        RemainBlock->PrevPhysBlock = Block;
+        RemainBlock->Size = ( BlockSize - WantedSize ) | TLSF_BLOCK_FREE_BIT;
+        TLSF_BLOCK_NEXT( RemainBlock )->PrevPhysBlock = RemainBlock;
+        prvTlsfInsertFreeBlock( Control, RemainBlock );
+        BlockSize = WantedSize;
+    }
+    Block->Size = BlockSize;
+    
+    Heap->m_FreeBytesRemaining -= BlockSize;
+    if( Heap->m_FreeBytesRemaining < Heap->m_MinimumEverFreeBytesRemaining )
+    {
+        Heap->m_MinimumEverFreeBytesRemaining = Heap->m_FreeBytesRemaining;
+    }
+    
+    return ( void * ) ( ( ( uint8_t * ) Block ) + Control->HeaderSize );
+}
+
+/** 
+ * @brief               Memory free function of the TLSF engine
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           Pv                  Memory address that allocated from the heap handle
+ * @return              None
+ * @note                The block is merged with the free blocks next to it at once
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvTlsfFree( S_HEAP_HANDLE* Heap, void* Pv )
+{
+    S_TLSF_CONTROL* Control = ( S_TLSF_CONTROL * ) Heap->m_TlsfControl;
+    S_TLSF_BLOCK*   Block;
+    S_TLSF_BLOCK*   NeighborBlock;
+    size_t          BlockSize;
+    
+    if( ( ( uint8_t * ) Pv < Heap->m_prvHeap ) || ( ( uint8_t * ) Pv >= Heap->m_prvHeap + Heap->m_prvTotalHeapSize ) )
+    {
+        return;
+    }
+    Block = ( S_TLSF_BLOCK * ) ( ( ( uint8_t * ) Pv ) - Control->HeaderSize );
+    if( ( Block->Size & TLSF_BLOCK_FREE_BIT ) || ( TLSF_BLOCK_SIZE( Block ) == 0 ) )
+    {
+        /* Not an allocated block */
+        return;
+    }
+    BlockSize = Block->Size;
+    Heap->m_FreeBytesRemaining += BlockSize;
+#if defined(CLIB_HEAP_STATISTICS)
+    Heap->m_Statistics.FreeCount++;
+#endif
+    
+    /* Merge with the previous block */
+    NeighborBlock = Block->PrevPhysBlock;
+    if( NeighborBlock && ( NeighborBlock->Size & TLSF_BLOCK_FREE_BIT ) )
+    {
+        prvTlsfRemoveFreeBlock( Control, NeighborBlock );
+        BlockSize += TLSF_BLOCK_SIZE( NeighborBlock );
+        Block = NeighborBlock;
+    }
+    
+    /* Merge with the next block */
+    NeighborBlock = ( S_TLSF_BLOCK * ) ( ( ( uint8_t * ) Block ) + BlockSize );
+    if( NeighborBlock->Size & TLSF_BLOCK_FREE_BIT )
+    {
+        prvTlsfRemoveFreeBlock( Control, NeighborBlock );
+        BlockSize += TLSF_BLOCK_SIZE( NeighborBlock );
+    }
+    
+    Block->Size = BlockSize | TLSF_BLOCK_FREE_BIT;
+    TLSF_BLOCK_NEXT( Block )->PrevPhysBlock = Block;
+    prvTlsfInsertFreeBlock( Control, Block );
+    return;
+}
+
+/** 
+ * @brief               Memory allocate function of the first fit engine
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           WantedSize          Memory size that want to allocate
+ * @return              Memory address allocated successfully (NULL when no memory enough)
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/04/12
+ * @callgraph
+ * @callergraph
+ */
+static void* prvHeapMalloc( S_HEAP_HANDLE* Heap, size_t WantedSize )
+{
+    S_BLOCK_LINK *CurrentBlock, *PreviousBlock, *NewBlockLink;
+    void *prvReturn = NULL;
+    
+    /* If this is the first call to malloc then the heap will require
+     * initialisation to setup the list of free blocks. 
+     */
+    if( Heap->m_EndBlockPtr == NULL )
+    {
+        prvHeapInit(Heap);
+    }
+    /* Check the requested block size is not so large that the top bit is
+     * set.  The top bit of the block size member of the S_BLOCK_LINK structure
+     * is used to determine who owns the block - the application or the
+     * kernel, so it must be free. 
+     */
+    if( ( WantedSize & Heap->m_BlockAllocatedBit ) == 0 )
+    {
+        /* The wanted size is increased so it can contain a S_BLOCK_LINK
+         * structure in addition to the requested amount of bytes. 
+         */
+        if( WantedSize > 0 )
+        {
+            WantedSize += Heap->m_prvHeapStructSize;
+            /* Ensure that blocks are always aligned to the required number of bytes. */
+            if( ( WantedSize & Heap->m_PortByteAlignmentMask ) != 0x00 )
+            {
+                /* Byte alignment required. */
+                WantedSize += ( Heap->m_PortByteAlignment - ( WantedSize & Heap->m_PortByteAlignmentMask ) );
+            }
+        }
+        
+        if( ( WantedSize > 0 ) && ( WantedSize <= Heap->m_FreeBytesRemaining ) )
+        {
+            /* Traverse the list from the start	(lowest address) block until
+             * one of adequate size is found. 
+             */
+            PreviousBlock = &(Heap->m_StartBlock);
+            CurrentBlock = Heap->m_StartBlock.NextFreeBlock;
+            while( ( CurrentBlock->BlockSize < WantedSize ) && ( CurrentBlock->NextFreeBlock != NULL ) )
+            {
+                PreviousBlock = CurrentBlock;
+                CurrentBlock = CurrentBlock->NextFreeBlock;
+            }
+            
+            /* If the end marker was reached then a block of adequate size was not found. */
+            if( CurrentBlock != Heap->m_EndBlockPtr )
+            {
+                /* Return the memory space pointed to - jumping over the
+                 * S_BLOCK_LINK structure at its start.
+                 */
+                prvReturn = ( void * ) ( ( ( uint8_t * ) PreviousBlock->NextFreeBlock ) + Heap->m_prvHeapStructSize );
+                
+                /* This block is being returned for use so must be taken out of the list of free blocks. */
+                PreviousBlock->NextFreeBlock = CurrentBlock->NextFreeBlock;
+                
+                /* If the block is larger than required it can be split into two. */
+                if( ( CurrentBlock->BlockSize - WantedSize ) > MINIMUM_BLOCK_SIZE )
+                {
+                    /* This block is to be split into two.  Create a new
+                     * block following the number of bytes requested. The void
+                     * cast is used to prevent byte alignment warnings from the
+                     * compiler. 
+                     */
+                    NewBlockLink = ( void * ) ( ( ( uint8_t * ) CurrentBlock ) + WantedSize );
+                    
+                    /* Calculate the sizes of two blocks split from the single block. */
+                    NewBlockLink->BlockSize = CurrentBlock->BlockSize - WantedSize;
+                    CurrentBlock->BlockSize = WantedSize;
+                    
+                    /* Insert the new block into the list of free blocks. */
+                    prvInsertBlockIntoFreeList( Heap, NewBlockLink );
+                }
+                
+                Heap->m_FreeBytesRemaining -= CurrentBlock->BlockSize;
+                
+                if( Heap->m_FreeBytesRemaining < Heap->m_MinimumEverFreeBytesRemaining )
+                {
+                    Heap->m_MinimumEverFreeBytesRemaining = Heap->m_FreeBytesRemaining;
+                }
+                
+                /* The block is being returned - it is allocated and owned
+                 * by the application and has no "next" block. 
+                 */
+                CurrentBlock->BlockSize |= Heap->m_BlockAllocatedBit;
+                CurrentBlock->NextFreeBlock = NULL;
+            }
+        }
+    }
+    
+    return prvReturn;
+}
+
+#if defined(CLIB_HEAP_STATISTICS)
+
+/** 
+ * @brief               Walk all free blocks to find the number and the largest one
+ * @param[in]           Heap                Heap information
+ * @param[out]          Statistics          The statistics to fill the free block information
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvHeapStatisticsFreeBlock( S_HEAP_HANDLE* Heap, S_HEAP_STATISTICS* Statistics )
+{
+    S_TLSF_CONTROL* Control;
+    S_TLSF_BLOCK*   TlsfBlock;
+    S_BLOCK_LINK*   Block;
+    uint32_t        Fl;
+    uint32_t        Sl;
+    
+    Statistics->FreeBlockNum = 0;
+    Statistics->LargestFreeBlock = 0;
+    
+    if( E_HEAP_ENGINE_TLSF == Heap->m_Engine )
     {
-        BlockToInsert->NextFreeBlock = Iterator->NextFreeBlock;
+        Control = ( S_TLSF_CONTROL * ) Heap->m_TlsfControl;
+        for( Fl = 0; Fl < Control->FlCount; Fl++ )
+        {
+            for( Sl = 0; Sl < TLSF_SL_INDEX_COUNT; Sl++ )
+            {
+                for( TlsfBlock = Control->Blocks[Fl][Sl]; TlsfBlock; TlsfBlock = TlsfBlock->NextFreeBlock )
+                {
+                    Statistics->FreeBlockNum++;
+                    if( TLSF_BLOCK_SIZE( TlsfBlock ) > Statistics->LargestFreeBlock )
+                    {
+                        Statistics->LargestFreeBlock = TLSF_BLOCK_SIZE( TlsfBlock );
+                    }
+                }
+            }
+        }
     }
-
-    /* If the block being inserted plugged a gab, so was merged with the block
-     * before and the block after, then it's NextFreeBlock pointer will have
-     * already been set, and should not be set here as that would make it point
-     * to itself. 
-     */
-    if( Iterator != BlockToInsert )
+    else if( Heap->m_EndBlockPtr )
     {
-        Iterator->NextFreeBlock = BlockToInsert;
+        for( Block = Heap->m_StartBlock.NextFreeBlock; Block != Heap->m_EndBlockPtr; Block = Block->NextFreeBlock )
+        {
+            Statistics->FreeBlockNum++;
+            if( Block->BlockSize > Statistics->LargestFreeBlock )
+            {
+                Statistics->LargestFreeBlock = Block->BlockSize;
+            }
+        }
     }
     return;
 }
 
+#endif /* CLIB_HEAP_STATISTICS */
+
 /**************************************************************
 **  Interface
 **************************************************************/
@@ -207,12 +880,40 @@ static void prvInsertBlockIntoFreeList( S_HEAP_HANDLE* Heap, S_BLOCK_LINK *Block
 extern int32_t CLIB_heap_create(S_HEAP_HANDLE* Heap, uint8_t* Memory, size_t HeapSize, 
                                 size_t PortByteAlignment, void* UserData, 
                                 F_CLIB_LOCKFUNC Lock, F_CLIB_UNLOCKFUNC Unlock)
+{
+    return CLIB_heap_create_ex(Heap, Memory, HeapSize, PortByteAlignment, E_HEAP_ENGINE_FIRST_FIT, UserData, Lock, Unlock);
+}
+
+/** 
+ * @brief               create a memory heap with the allocation engine
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           Memory              Buffer used to create the Heap
+ * @param[in]           HeapSize            The size of the Heap buffer
+ * @param[in]           PortByteAlignment   Byte Alignment, only can be 32 or 16 or 8
+ * @param[in]           Engine              The allocation engine
+ * @param[in]           UserData            User Data used for callback function 
+ * @param[in]           Lock                Resource Lock callback function
+ * @param[in]           Unlock              Resource Unlock callback function
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_create_ex(S_HEAP_HANDLE* Heap, uint8_t* Memory, size_t HeapSize, 
+                                   size_t PortByteAlignment, E_HEAP_ENGINE Engine, void* UserData, 
+                                   F_CLIB_LOCKFUNC Lock, F_CLIB_UNLOCKFUNC Unlock)
 {
     /* check input Data */
     if( !Heap || !Memory || !HeapSize )
     {
         return (-1);
     }
+    if( (E_HEAP_ENGINE_FIRST_FIT != Engine) && (E_HEAP_ENGINE_TLSF != Engine) )
+    {
+        return (-1);
+    }
     if( (32 != PortByteAlignment) && (16 != PortByteAlignment) && (8 != PortByteAlignment) )
     {
         return (-1);
@@ -250,10 +951,18 @@ extern int32_t CLIB_heap_create(S_HEAP_HANDLE* Heap, uint8_t* Memory, size_t Hea
     Heap->m_MinimumEverFreeBytesRemaining = 0;
     Heap->m_BlockAllocatedBit = 0;
     
+    Heap->m_Engine = Engine;
+    
     Heap->LockFunc = Lock;
     Heap->UnlockFunc = Unlock;
     Heap->UsrData = UserData;
     
+    if( E_HEAP_ENGINE_TLSF == Heap->m_Engine )
+    {
+        /* Setup the control structure and the free lists */
+        return prvTlsfInit(Heap);
+    }
+    
     /* Require initialisation to setup the list of free blocks */
     prvHeapInit(Heap);
     
@@ -273,7 +982,6 @@ extern int32_t CLIB_heap_create(S_HEAP_HANDLE* Heap, uint8_t* Memory, size_t Hea
  */
 extern void *CLIB_heap_malloc( S_HEAP_HANDLE* Heap, size_t WantedSize )
 {
-    S_BLOCK_LINK *CurrentBlock, *PreviousBlock, *NewBlockLink;
     void *prvReturn = NULL;
     
     /* check input Data */
@@ -282,101 +990,22 @@ extern void *CLIB_heap_malloc( S_HEAP_HANDLE* Heap, size_t WantedSize )
         return prvReturn;
     }
     
-    if(Heap->LockFunc)
-    {
-        Heap->LockFunc(Heap->UsrData);
-    }
+    prvHeapLock(Heap);
     
-    /* If this is the first call to malloc then the heap will require
-     * initialisation to setup the list of free blocks. 
-     */
-    if( Heap->m_EndBlockPtr == NULL )
+    if( E_HEAP_ENGINE_TLSF == Heap->m_Engine )
     {
-        prvHeapInit(Heap);
+        prvReturn = prvTlsfMalloc(Heap, WantedSize);
     }
-    /* Check the requested block size is not so large that the top bit is
-     * set.  The top bit of the block size member of the S_BLOCK_LINK structure
-     * is used to determine who owns the block - the application or the
-     * kernel, so it must be free. 
-     */
-    if( ( WantedSize & Heap->m_BlockAllocatedBit ) == 0 )
+    else
     {
-        /* The wanted size is increased so it can contain a S_BLOCK_LINK
-         * structure in addition to the requested amount of bytes. 
-         */
-        if( WantedSize > 0 )
-        {
-            WantedSize += Heap->m_prvHeapStructSize;
-            /* Ensure that blocks are always aligned to the required number of bytes. */
-            if( ( WantedSize & Heap->m_PortByteAlignmentMask ) != 0x00 )
-            {
-                /* Byte alignment required. */
-                WantedSize += ( Heap->m_PortByteAlignment - ( WantedSize & Heap->m_PortByteAlignmentMask ) );
-            }
-        }
-        
-        if( ( WantedSize > 0 ) && ( WantedSize <= Heap->m_FreeBytesRemaining ) )
-        {
-            /* Traverse the list from the start	(lowest address) block until
-             * one of adequate size is found. 
-             */
-            PreviousBlock = &(Heap->m_StartBlock);
-            CurrentBlock = Heap->m_StartBlock.NextFreeBlock;
-            while( ( CurrentBlock->BlockSize < WantedSize ) && ( CurrentBlock->NextFreeBlock != NULL ) )
-            {
-                PreviousBlock = CurrentBlock;
-                CurrentBlock = CurrentBlock->NextFreeBlock;
-            }
-            
-            /* If the end marker was reached then a block of adequate size was not found. */
-            if( CurrentBlock != Heap->m_EndBlockPtr )
-            {
-                /* Return the memory space pointed to - jumping over the
-                 * S_BLOCK_LINK structure at its start.
-                 */
-                prvReturn = ( void * ) ( ( ( uint8_t * ) PreviousBlock->NextFreeBlock ) + Heap->m_prvHeapStructSize );
-                
-                /* This block is being returned for use so must be taken out of the list of free blocks. */
-                PreviousBlock->NextFreeBlock = CurrentBlock->NextFreeBlock;
-                
-                /* If the block is larger than required it can be split into two. */
-                if( ( CurrentBlock->BlockSize - WantedSize ) > MINIMUM_BLOCK_SIZE )
-                {
-                    /* This block is to be split into two.  Create a new
-                     * block following the number of bytes requested. The void
-                     * cast is used to prevent byte alignment warnings from the
-                     * compiler. 
-                     */
-                    NewBlockLink = ( void * ) ( ( ( uint8_t * ) CurrentBlock ) + WantedSize );
-                    
-                    /* Calculate the sizes of two blocks split from the single block. */
-                    NewBlockLink->BlockSize = CurrentBlock->BlockSize - WantedSize;
-                    CurrentBlock->BlockSize = WantedSize;
-                    
-                    /* Insert the new block into the list of free blocks. */
-                    prvInsertBlockIntoFreeList( Heap, NewBlockLink );
-                }
-                
-                Heap->m_FreeBytesRemaining -= CurrentBlock->BlockSize;
-                
-                if( Heap->m_FreeBytesRemaining < Heap->m_MinimumEverFreeBytesRemaining )
-                {
-                    Heap->m_MinimumEverFreeBytesRemaining = Heap->m_FreeBytesRemaining;
-                }
-                
-                /* The block is being returned - it is allocated and owned
-                 * by the application and has no "next" block. 
-                 */
-                CurrentBlock->BlockSize |= Heap->m_BlockAllocatedBit;
-                CurrentBlock->NextFreeBlock = NULL;
-            }
-        }
+        prvReturn = prvHeapMalloc(Heap, WantedSize);
     }
     
-    if(Heap->UnlockFunc)
-    {
-        Heap->UnlockFunc(Heap->UsrData);
-    }
+#if defined(CLIB_HEAP_STATISTICS)
+    prvHeapStatisticsAlloc(Heap, WantedSize, prvReturn);
+#endif
+    
+    prvHeapUnlock(Heap);
     
     return prvReturn;
 }
@@ -396,7 +1025,13 @@ extern void CLIB_heap_free(S_HEAP_HANDLE* Heap, void* Pv)
     uint8_t*        MemAddress = ( uint8_t * ) Pv;
     S_BLOCK_LINK*   Link;
 
-    if( (Pv != NULL) && (Heap != NULL) )
+    if( (Pv != NULL) && (Heap != NULL) && (E_HEAP_ENGINE_TLSF == Heap->m_Engine) )
+    {
+        prvHeapLock(Heap);
+        prvTlsfFree(Heap, Pv);
+        prvHeapUnlock(Heap);
+    }
+    else if( (Pv != NULL) && (Heap != NULL) )
     {
         /* The memory being freed will have an S_BLOCK_LINK structure immediately before it. */
         MemAddress -= Heap->m_prvHeapStructSize;
@@ -411,19 +1046,16 @@ extern void CLIB_heap_free(S_HEAP_HANDLE* Heap, void* Pv)
                 /* The block is being returned to the heap - it is no longer allocated. */
                 Link->BlockSize &= ~(Heap->m_BlockAllocatedBit);
                 
-                if(Heap->LockFunc)
-                {
-                    Heap->LockFunc(Heap->UsrData);
-                }
+                prvHeapLock(Heap);
 
                 /* Add this block to the list of free blocks. */
                 Heap->m_FreeBytesRemaining += Link->BlockSize;
                 prvInsertBlockIntoFreeList( Heap, ( ( S_BLOCK_LINK * ) Link ) );
+#if defined(CLIB_HEAP_STATISTICS)
+                Heap->m_Statistics.FreeCount++;
+#endif
                 
-                if(Heap->UnlockFunc)
-                {
-                    Heap->UnlockFunc(Heap->UsrData);
-                }
+                prvHeapUnlock(Heap);
     
             }
         }
@@ -473,6 +1105,150 @@ extern size_t CLIB_heap_GetMinimumEverFreeHeapSize( S_HEAP_HANDLE* Heap )
     }
 }
 
+#if defined(CLIB_HEAP_STATISTICS)
+
+/** 
+ * @brief               Set the clock used to measure the time under the heap lock
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           Clock               Clock callback function (NULL to stop the measurement)
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_SetStatisticsClock( S_HEAP_HANDLE* Heap, F_CLIB_HEAP_CLOCKFUNC Clock )
+{
+    if( !Heap )
+    {
+        return (-1);
+    }
+    
+    if(Heap->LockFunc)
+    {
+        Heap->LockFunc(Heap->UsrData);
+    }
+    Heap->m_ClockFunc = Clock;
+    if(Heap->UnlockFunc)
+    {
+        Heap->UnlockFunc(Heap->UsrData);
+    }
+    return (0);
+}
+
+/** 
+ * @brief               Get the statistics of the heap
+ * @param[in,out]       Heap                Heap information
+ * @param[out]          Statistics          The statistics
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_GetStatistics( S_HEAP_HANDLE* Heap, S_HEAP_STATISTICS* Statistics )
+{
+    if( !Heap || !Statistics )
+    {
+        return (-1);
+    }
+    
+    /* The query itself is not counted in the lock statistics */
+    if(Heap->LockFunc)
+    {
+        Heap->LockFunc(Heap->UsrData);
+    }
+    *Statistics = Heap->m_Statistics;
+    Statistics->FreeBytes = Heap->m_FreeBytesRemaining;
+    Statistics->MinimumEverFreeBytes = Heap->m_MinimumEverFreeBytesRemaining;
+    prvHeapStatisticsFreeBlock( Heap, Statistics );
+    if(Heap->UnlockFunc)
+    {
+        Heap->UnlockFunc(Heap->UsrData);
+    }
+    return (0);
+}
+
+/** 
+ * @brief               Clear the counters of the statistics
+ * @param[in,out]       Heap                Heap information
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_ResetStatistics( S_HEAP_HANDLE* Heap )
+{
+    if( !Heap )
+    {
+        return (-1);
+    }
+    
+    if(Heap->LockFunc)
+    {
+        Heap->LockFunc(Heap->UsrData);
+    }
+    memset(&(Heap->m_Statistics), 0, sizeof(S_HEAP_STATISTICS));
+    if(Heap->UnlockFunc)
+    {
+        Heap->UnlockFunc(Heap->UsrData);
+    }
+    return (0);
+}
+
+/** 
+ * @brief               Print the statistics of the heap
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           Print               Print callback function
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_DumpStatistics( S_HEAP_HANDLE* Heap, F_CLIB_HEAP_PRINTFUNC Print )
+{
+    S_HEAP_STATISTICS   Statistics;
+    uint32_t            i   =   0;
+    
+    if( !Print || CLIB_heap_GetStatistics( Heap, &Statistics ) )
+    {
+        return (-1);
+    }
+    
+    Print("heap (%s): free %lu bytes, minimum ever %lu bytes\n", 
+          ( E_HEAP_ENGINE_TLSF == Heap->m_Engine )?("tlsf"):("first fit"),
+          ( unsigned long ) Statistics.FreeBytes, ( unsigned long ) Statistics.MinimumEverFreeBytes);
+    /* Fragmentation is the part of the free bytes which can not be allocated at once */
+    Print("  free blocks %lu, largest %lu bytes, fragmentation %lu%%\n", 
+          ( unsigned long ) Statistics.FreeBlockNum, ( unsigned long ) Statistics.LargestFreeBlock,
+          ( unsigned long ) ( ( Statistics.FreeBytes )?( 100 - ( uint64_t ) Statistics.LargestFreeBlock * 100 / Statistics.FreeBytes ):( 0 ) ));
+    Print("  alloc %lu, free %lu, failed %lu (last failed size %lu)\n", 
+          ( unsigned long ) Statistics.AllocCount, ( unsigned long ) Statistics.FreeCount, 
+          ( unsigned long ) Statistics.FailedCount, ( unsigned long ) Statistics.LastFailedSize);
+    Print("  lock %lu times, %llu clock under the lock\n", 
+          ( unsigned long ) Statistics.LockCount, ( unsigned long long ) Statistics.LockTime);
+    for( i = 0; i < CLIB_HEAP_HISTOGRAM_NUM; i++ )
+    {
+        if( ( CLIB_HEAP_HISTOGRAM_NUM - 1 ) == i )
+        {
+            Print("  size > %lu: %lu\n", ( unsigned long ) ( ( size_t ) 8 << ( i - 1 ) ), ( unsigned long ) Statistics.SizeHistogram[i]);
+        }
+        else
+        {
+            Print("  size <= %lu: %lu\n", ( unsigned long ) ( ( size_t ) 8 << i ), ( unsigned long ) Statistics.SizeHistogram[i]);
+        }
+    }
+    return (0);
+}
+
+#endif /* CLIB_HEAP_STATISTICS */
+
 /** 
  * @brief               delete a memory heap
  * @param[in,out]       Heap                Heap information
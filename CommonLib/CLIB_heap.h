@@ -33,6 +33,12 @@
  * @version     00.00.01 
  *              - 2018/05/04 : zhaozhenge@outlook.com 
  *                  -# New
+ * @version     00.00.02 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add the two-level segregated fit engine selected by CLIB_heap_create_ex
+ * @version     00.00.03 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add the statistics enabled by CLIB_HEAP_STATISTICS
  */
 
 #ifndef _CLIB_HEAP_H_
@@ -49,10 +55,51 @@ extern "C" {
 #include <string.h>
 #include "CLIB_def.h"
 
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#if defined(CLIB_HEAP_STATISTICS)
+
+#if !defined(CLIB_HEAP_HISTOGRAM_NUM)
+#define CLIB_HEAP_HISTOGRAM_NUM     (12)
+/*!< Number of the allocation size classes of the statistics. 
+ *   Class 0 counts the sizes up to 8 bytes, class i counts the sizes in ( 8 << (i-1), 8 << i ], 
+ *   and the last class counts all larger sizes 
+ */
+#endif
+
+/**
+ *  @brief          Clock callback function used to measure the time under the heap lock
+ *  @param[in]      CustomData      Custom Data defined by user
+ *  @return         Current time in any unit (CPU cycles, micro seconds, ...)
+ */
+typedef uint64_t (*F_CLIB_HEAP_CLOCKFUNC) (void* CustomData);
+
+/**
+ *  @brief          Print callback function used to dump the statistics (printf can be used)
+ *  @param[in]      Format          Format string like printf
+ *  @return         Ignored
+ */
+typedef int (*F_CLIB_HEAP_PRINTFUNC) (const char* Format, ...);
+
+#endif /* CLIB_HEAP_STATISTICS */
+
 /**************************************************************
 **  Structure
 **************************************************************/
 
+/** 
+ *  @brief      The allocation engine of the heap
+ *  @author     agent@local
+ *  @date       2026/10/17
+ */
+typedef enum _E_HEAP_ENGINE
+{
+    E_HEAP_ENGINE_FIRST_FIT = 0,                        /*!< First fit free list in address order (heap_4 of FreeRTOS) */
+    E_HEAP_ENGINE_TLSF,                                 /*!< Two-level segregated fit, malloc and free take constant time */
+} E_HEAP_ENGINE;
+
 /** 
  *  @brief      The linked list structure 
  *  @details    This is used to link free blocks in order of their memory address
@@ -65,6 +112,33 @@ typedef struct _S_BLOCK_LINK
     size_t                  BlockSize;                  /*!< The size of the free block. */
 } S_BLOCK_LINK;
 
+#if defined(CLIB_HEAP_STATISTICS)
+
+/** 
+ *  @brief      The statistics of the heap
+ *  @details    The free block information is collected when CLIB_heap_GetStatistics is called, 
+ *              others are counted by each allocation and free. 
+ *              When the largest free block is much smaller than the free bytes, the heap is fragmented.
+ *  @author     agent@local
+ *  @date       2026/10/17
+ */
+typedef struct _S_HEAP_STATISTICS
+{
+    size_t                  FreeBytes;                  /*!< The free bytes of the heap */
+    size_t                  MinimumEverFreeBytes;       /*!< The minimum free bytes ever */
+    size_t                  LargestFreeBlock;           /*!< The size of the largest free block (with the block header) */
+    size_t                  FreeBlockNum;               /*!< The number of the free blocks */
+    uint32_t                AllocCount;                 /*!< The number of the successful allocations */
+    uint32_t                FreeCount;                  /*!< The number of the frees */
+    uint32_t                FailedCount;                /*!< The number of the failed allocations */
+    size_t                  LastFailedSize;             /*!< The wanted size of the last failed allocation */
+    uint32_t                SizeHistogram[CLIB_HEAP_HISTOGRAM_NUM];     /*!< The number of the allocations of each size class */
+    uint32_t                LockCount;                  /*!< The number of the times the heap is locked */
+    uint64_t                LockTime;                   /*!< Total time under the heap lock (measured by the clock callback) */
+} S_HEAP_STATISTICS;
+
+#endif /* CLIB_HEAP_STATISTICS */
+
 /** 
  *  @brief      The Heap Handle structure
  *  @author     zhaozhenge@outlook.com
@@ -91,6 +165,15 @@ typedef struct _S_HEAP_HANDLE
                                                          *   space. 
                                                          */
     
+    E_HEAP_ENGINE           m_Engine;                   /*!< The allocation engine of the heap */
+    void*                   m_TlsfControl;              /*!< Control structure of the TLSF engine (placed at the beginning of the Heap buffer) */
+    
+#if defined(CLIB_HEAP_STATISTICS)
+    S_HEAP_STATISTICS       m_Statistics;               /*!< The statistics counted by each allocation and free */
+    F_CLIB_HEAP_CLOCKFUNC   m_ClockFunc;                /*!< Clock callback function used to measure the time under the lock */
+    uint64_t                m_LockStart;                /*!< The time when the heap is locked */
+#endif
+    
     F_CLIB_LOCKFUNC         LockFunc;                   /*!< Lock callback function */
     F_CLIB_UNLOCKFUNC       UnlockFunc;                 /*!< Unlock callback function */
     void*                   UsrData;                    /*!< UserData used for callback function */
@@ -132,6 +215,29 @@ extern int32_t CLIB_heap_create(S_HEAP_HANDLE* Heap, uint8_t* Memory, size_t Hea
                                 size_t PortByteAlignment, void* UserData, 
                                 F_CLIB_LOCKFUNC Lock, F_CLIB_UNLOCKFUNC Unlock);
 
+/** 
+ * @brief               create a memory heap with the allocation engine
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           Memory              Buffer used to create the Heap
+ * @param[in]           HeapSize            The size of the Heap buffer
+ * @param[in]           PortByteAlignment   Byte Alignment, only can be 32 or 16 or 8
+ * @param[in]           Engine              The allocation engine
+ * @param[in]           UserData            User Data used for callback function 
+ * @param[in]           Lock                Resource Lock callback function
+ * @param[in]           Unlock              Resource Unlock callback function
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @note                E_HEAP_ENGINE_TLSF keeps its control structure (about 1KB on 32bit CPU) in the Heap buffer, 
+ *                      and uses at most 2GB of the buffer
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_create_ex(S_HEAP_HANDLE* Heap, uint8_t* Memory, size_t HeapSize, 
+                                   size_t PortByteAlignment, E_HEAP_ENGINE Engine, void* UserData, 
+                                   F_CLIB_LOCKFUNC Lock, F_CLIB_UNLOCKFUNC Unlock);
+
 /** 
  * @brief               Memory allocate function
  * @param[in,out]       Heap                Heap information
@@ -191,6 +297,63 @@ extern size_t CLIB_heap_GetMinimumEverFreeHeapSize( S_HEAP_HANDLE* Heap );
  */
 extern int32_t CLIB_heap_delete( S_HEAP_HANDLE* Heap );
 
+#if defined(CLIB_HEAP_STATISTICS)
+
+/** 
+ * @brief               Set the clock used to measure the time under the heap lock
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           Clock               Clock callback function (NULL to stop the measurement)
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @note                The clock is called with the UserData of the heap twice in each allocation and free
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_SetStatisticsClock( S_HEAP_HANDLE* Heap, F_CLIB_HEAP_CLOCKFUNC Clock );
+
+/** 
+ * @brief               Get the statistics of the heap
+ * @param[in,out]       Heap                Heap information
+ * @param[out]          Statistics          The statistics
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @note                All free blocks are walked under the heap lock to find the largest one
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_GetStatistics( S_HEAP_HANDLE* Heap, S_HEAP_STATISTICS* Statistics );
+
+/** 
+ * @brief               Clear the counters of the statistics
+ * @param[in,out]       Heap                Heap information
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_ResetStatistics( S_HEAP_HANDLE* Heap );
+
+/** 
+ * @brief               Print the statistics of the heap
+ * @param[in,out]       Heap                Heap information
+ * @param[in]           Print               Print callback function
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_heap_DumpStatistics( S_HEAP_HANDLE* Heap, F_CLIB_HEAP_PRINTFUNC Print );
+
+#endif /* CLIB_HEAP_STATISTICS */
+
 /**
  * @}
  */
@@ -0,0 +1,497 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  LZ77 Compression Library with C
+**************************************************************/
+/**
+ * @file        CLIB_lz.c
+ * @brief       LZ77 Compression API with C
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "CLIB_lz.h"
+
+#ifdef CLIB_LZ_MODULE_ENABLED
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_CLIB_LZ_LENGTH_MASK           (15)            /*!< Length in the token which means more bytes follow */
+#define D_CLIB_LZ_SIZE_MAX              (0xFFFEFFFFU)   /*!< Maximum size of the data (the positions of the dictionary and the data are kept in 32 bits) */
+#define D_CLIB_LZ_HEADER_SIZE_MAX       (5)             /*!< Maximum size of the original length */
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Hash the 4 bytes at the position
+ * @param[in]           Data                The position of the data
+ * @return              Index of the hash table
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvLzHash(const uint8_t* Data)
+{
+    uint32_t    Value   =   0;
+
+    /* No alignment is needed */
+    memcpy(&Value, Data, sizeof(Value));
+    return (uint32_t)(Value * 2654435761U) >> (32 - CLIB_LZ_HASH_BITS);
+}
+
+/**
+ * @brief               Count the bytes of a match
+ * @param[in]           Dict                Preset dictionary
+ * @param[in]           DictLen             The size of the dictionary
+ * @param[in]           Src                 The data to compress
+ * @param[in]           Srclen              The size of the data
+ * @param[in]           Ref                 Position of the earlier bytes (the dictionary is followed by the data)
+ * @param[in]           Pos                 Position of the current bytes in the data
+ * @return              The number of the same bytes
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static size_t prvLzMatchLength(const uint8_t* Dict, size_t DictLen, const uint8_t* Src, size_t Srclen, size_t Ref, size_t Pos)
+{
+    const uint8_t*  Start   =   Src + Pos;
+    const uint8_t*  Cur     =   Start;
+    const uint8_t*  End     =   Src + Srclen;
+    const uint8_t*  Prev    =   NULL;
+
+    if(Ref < DictLen)
+    {
+        /* The match starts in the dictionary and may go on with the data */
+        for(Prev = Dict + Ref; (Prev < Dict + DictLen) && (Cur < End) && (*Prev == *Cur); Prev++, Cur++);
+        if( (Prev < Dict + DictLen) || (Cur == End) )
+        {
+            return (size_t)(Cur - Start);
+        }
+        Ref = DictLen;
+    }
+    /* The earlier bytes may overlap the current ones */
+    for(Prev = Src + (Ref - DictLen); (Cur < End) && (*Prev == *Cur); Prev++, Cur++);
+    return (size_t)(Cur - Start);
+}
+
+/**
+ * @brief               Write the bytes of a length which does not fit in the token
+ * @param[in,out]       Out                 Position of the output
+ * @param[in]           End                 End of the output buffer
+ * @param[in]           Length              The length (not less than D_CLIB_LZ_LENGTH_MASK)
+ * @return              Position of the output after the bytes (NULL if the buffer is too small)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint8_t* prvLzLengthWrite(uint8_t* Out, const uint8_t* End, size_t Length)
+{
+    for(Length = Length - D_CLIB_LZ_LENGTH_MASK; Length >= 255; Length = Length - 255)
+    {
+        if(Out == End)
+        {
+            return NULL;
+        }
+        *Out++ = 255;
+    }
+    if(Out == End)
+    {
+        return NULL;
+    }
+    *Out++ = (uint8_t)Length;
+    return Out;
+}
+
+/**
+ * @brief               Read the bytes of a length which does not fit in the token
+ * @param[in]           Src                 The compressed data
+ * @param[in,out]       In                  Position of the input
+ * @param[in]           Srclen              The size of the compressed data
+ * @param[in,out]       Length              The length
+ * @retval              0                   success
+ * @retval              -1                  the data ends
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvLzLengthRead(const uint8_t* Src, size_t* In, size_t Srclen, size_t* Length)
+{
+    uint8_t     Byte    =   0;
+
+    do
+    {
+        if(*In == Srclen)
+        {
+            return -1;
+        }
+        Byte = Src[(*In)++];
+        *Length = *Length + Byte;
+    }while(255 == Byte);
+    return 0;
+}
+
+/**
+ * @brief               Write a sequence of the literals and a match
+ * @param[in,out]       Out                 Position of the output
+ * @param[in]           End                 End of the output buffer
+ * @param[in]           Literal             The literals
+ * @param[in]           LiteralLen          The number of the literals
+ * @param[in]           Offset              Distance of the match
+ * @param[in]           MatchLen            Length of the match (0 means the last sequence without a match)
+ * @return              Position of the output after the sequence (NULL if the buffer is too small)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint8_t* prvLzSequenceWrite(uint8_t* Out, const uint8_t* End, const uint8_t* Literal, size_t LiteralLen, size_t Offset, size_t MatchLen)
+{
+    size_t      Match   =   (MatchLen)?(MatchLen - CLIB_LZ_MIN_MATCH):(0);
+
+    if(Out == End)
+    {
+        return NULL;
+    }
+    *Out++ = (uint8_t)( ( ((LiteralLen < D_CLIB_LZ_LENGTH_MASK)?(LiteralLen):(D_CLIB_LZ_LENGTH_MASK)) << 4 ) |
+                        ( (Match < D_CLIB_LZ_LENGTH_MASK)?(Match):(D_CLIB_LZ_LENGTH_MASK) ) );
+    if( (LiteralLen >= D_CLIB_LZ_LENGTH_MASK) && (!(Out = prvLzLengthWrite(Out, End, LiteralLen))) )
+    {
+        return NULL;
+    }
+    if((size_t)(End - Out) < LiteralLen)
+    {
+        return NULL;
+    }
+    memcpy(Out, Literal, LiteralLen);
+    Out = Out + LiteralLen;
+    if(!MatchLen)
+    {
+        return Out;
+    }
+    if((End - Out) < 2)
+    {
+        return NULL;
+    }
+    *Out++ = (uint8_t)(Offset);
+    *Out++ = (uint8_t)(Offset >> 8);
+    if(Match >= D_CLIB_LZ_LENGTH_MASK)
+    {
+        Out = prvLzLengthWrite(Out, End, Match);
+    }
+    return Out;
+}
+
+/**
+ * @brief               Read the original length at the head of the compressed data
+ * @param[in]           Src                 The compressed data
+ * @param[in]           Srclen              The size of the compressed data
+ * @param[out]          Size                The original length
+ * @return              The size of the original length (0 means bad format)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static size_t prvLzHeaderRead(const uint8_t* Src, size_t Srclen, size_t* Size)
+{
+    uint32_t    Value   =   0;
+    size_t      i       =   0;
+
+    for(i = 0; (i < Srclen) && (i < D_CLIB_LZ_HEADER_SIZE_MAX); i++)
+    {
+        Value = Value | ((uint32_t)(Src[i] & 0x7F) << (7 * i));
+        if(!(Src[i] & 0x80))
+        {
+            *Size = Value;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Compress the data
+ * @param[in]           Dict                Preset dictionary (can be NULL)
+ * @param[in]           DictLen             The size of the dictionary
+ * @param[in]           Src                 The data to compress
+ * @param[in]           Srclen              The size of the data
+ * @param[out]          Dst                 The buffer of the compressed data
+ * @param[in,out]       Dstlen              [in] The size of the buffer [out] The size of the compressed data
+ * @retval              0                   success
+ * @retval              -1                  fail (the buffer is too small)
+ * @note                The buffer of CLIB_LZ_BOUND(Srclen) bytes is always enough
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_lz_compress(const uint8_t* Dict, size_t DictLen, const uint8_t* Src, size_t Srclen, uint8_t* Dst, size_t* Dstlen)
+{
+    uint32_t        Table[1 << CLIB_LZ_HASH_BITS];
+    uint8_t*        Out         =   Dst;
+    const uint8_t*  End         =   Dst + *Dstlen;
+    size_t          Anchor      =   0;
+    size_t          Pos         =   0;
+    size_t          Ref         =   0;
+    size_t          Length      =   0;
+    uint32_t        Hash        =   0;
+
+    if( (!Src && Srclen) || (Srclen > D_CLIB_LZ_SIZE_MAX) )
+    {
+        return -1;
+    }
+    if( (!Dict) || (!DictLen) )
+    {
+        Dict = NULL;
+        DictLen = 0;
+    }
+    else if(DictLen > CLIB_LZ_MAX_OFFSET)
+    {
+        /* Only the end of the dictionary can be reached by a match */
+        Dict = Dict + (DictLen - CLIB_LZ_MAX_OFFSET);
+        DictLen = CLIB_LZ_MAX_OFFSET;
+    }
+
+    /* Original length */
+    for(Length = Srclen; ; Length = Length >> 7)
+    {
+        if(Out == End)
+        {
+            return -1;
+        }
+        *Out++ = (uint8_t)( (Length & 0x7F) | ((Length > 0x7F)?(0x80):(0)) );
+        if(Length <= 0x7F)
+        {
+            break;
+        }
+    }
+
+    /* Table keeps the last position + 1 of each hash value (0 means none) */
+    memset(Table, 0, sizeof(Table));
+    for(Pos = 0; Pos + CLIB_LZ_MIN_MATCH <= DictLen; Pos++)
+    {
+        Table[prvLzHash(Dict + Pos)] = (uint32_t)(Pos + 1);
+    }
+
+    Pos = 0;
+    while(Pos + CLIB_LZ_MIN_MATCH <= Srclen)
+    {
+        Hash = prvLzHash(Src + Pos);
+        Ref = Table[Hash];
+        Table[Hash] = (uint32_t)(DictLen + Pos + 1);
+        if( Ref && (DictLen + Pos + 1 - Ref <= CLIB_LZ_MAX_OFFSET) )
+        {
+            Ref = Ref - 1;
+            Length = prvLzMatchLength(Dict, DictLen, Src, Srclen, Ref, Pos);
+            if(Length >= CLIB_LZ_MIN_MATCH)
+            {
+                Out = prvLzSequenceWrite(Out, End, Src + Anchor, Pos - Anchor, DictLen + Pos - Ref, Length);
+                if(!Out)
+                {
+                    return -1;
+                }
+                Pos = Pos + Length;
+                Anchor = Pos;
+                /* Remember a position in the match for the next one */
+                if(Pos + CLIB_LZ_MIN_MATCH - 2 <= Srclen)
+                {
+                    Table[prvLzHash(Src + Pos - 2)] = (uint32_t)(DictLen + Pos - 1);
+                }
+                continue;
+            }
+        }
+        /* Skip faster in the data which does not match */
+        Pos = Pos + 1 + ((Pos - Anchor) >> 6);
+    }
+
+    /* The last literals */
+    if(Anchor < Srclen)
+    {
+        Out = prvLzSequenceWrite(Out, End, Src + Anchor, Srclen - Anchor, 0, 0);
+        if(!Out)
+        {
+            return -1;
+        }
+    }
+    *Dstlen = (size_t)(Out - Dst);
+    return 0;
+}
+
+/**
+ * @brief               Get the original size of the compressed data
+ * @param[in]           Src                 The compressed data
+ * @param[in]           Srclen              The size of the compressed data
+ * @param[out]          Size                The size of the data after decompression
+ * @retval              0                   success
+ * @retval              -1                  fail (bad format)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_lz_size(const uint8_t* Src, size_t Srclen, size_t* Size)
+{
+    if( (!Src) || (!Size) )
+    {
+        return -1;
+    }
+    return (prvLzHeaderRead(Src, Srclen, Size))?(0):(-1);
+}
+
+/**
+ * @brief               Decompress the data
+ * @param[in]           Dict                Preset dictionary used to compress the data (can be NULL)
+ * @param[in]           DictLen             The size of the dictionary
+ * @param[in]           Src                 The compressed data
+ * @param[in]           Srclen              The size of the compressed data
+ * @param[out]          Dst                 The buffer of the data
+ * @param[in,out]       Dstlen              [in] The size of the buffer [out] The size of the data
+ * @retval              0                   success
+ * @retval              -1                  fail (bad format, or the buffer is smaller than CLIB_lz_size tells)
+ * @note                The bytes of Src are checked, so the data from the network can be given as it is
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_lz_decompress(const uint8_t* Dict, size_t DictLen, const uint8_t* Src, size_t Srclen, uint8_t* Dst, size_t* Dstlen)
+{
+    size_t          Size        =   0;
+    size_t          In          =   0;
+    size_t          Out         =   0;
+    size_t          Literal     =   0;
+    size_t          Match       =   0;
+    size_t          Offset      =   0;
+    size_t          Copy        =   0;
+    const uint8_t*  Prev        =   NULL;
+    uint8_t         Token       =   0;
+
+    if( (!Src) || (!Dstlen) )
+    {
+        return -1;
+    }
+    if(!Dict)
+    {
+        DictLen = 0;
+    }
+    In = prvLzHeaderRead(Src, Srclen, &Size);
+    if( (!In) || (Size > *Dstlen) || (Size && !Dst) )
+    {
+        return -1;
+    }
+
+    while(Out < Size)
+    {
+        if(In == Srclen)
+        {
+            return -1;
+        }
+        Token = Src[In++];
+
+        /* Literals */
+        Literal = Token >> 4;
+        if( (D_CLIB_LZ_LENGTH_MASK == Literal) && prvLzLengthRead(Src, &In, Srclen, &Literal) )
+        {
+            return -1;
+        }
+        if( (Literal > Size - Out) || (Literal > Srclen - In) )
+        {
+            return -1;
+        }
+        memcpy(Dst + Out, Src + In, Literal);
+        Out = Out + Literal;
+        In = In + Literal;
+        if(Out == Size)
+        {
+            break;
+        }
+
+        /* Match */
+        if(Srclen - In < 2)
+        {
+            return -1;
+        }
+        Offset = (size_t)Src[In] | ((size_t)Src[In + 1] << 8);
+        In = In + 2;
+        Match = Token & D_CLIB_LZ_LENGTH_MASK;
+        if( (D_CLIB_LZ_LENGTH_MASK == Match) && prvLzLengthRead(Src, &In, Srclen, &Match) )
+        {
+            return -1;
+        }
+        Match = Match + CLIB_LZ_MIN_MATCH;
+        if( (!Offset) || (Offset > Out + DictLen) || (Match > Size - Out) )
+        {
+            return -1;
+        }
+        if(Offset > Out)
+        {
+            /* The match starts in the dictionary */
+            Prev = Dict + DictLen - (Offset - Out);
+            Copy = (size_t)(Dict + DictLen - Prev);
+            Copy = (Copy < Match)?(Copy):(Match);
+            memcpy(Dst + Out, Prev, Copy);
+            Out = Out + Copy;
+            Match = Match - Copy;
+        }
+        if(!Match)
+        {
+            continue;
+        }
+        if(Offset >= Match)
+        {
+            memcpy(Dst + Out, Dst + Out - Offset, Match);
+            Out = Out + Match;
+        }
+        else
+        {
+            /* The match overlaps itself */
+            for(Prev = Dst + Out - Offset; Match; Match--)
+            {
+                Dst[Out++] = *Prev++;
+            }
+        }
+    }
+
+    if(In != Srclen)
+    {
+        return -1;
+    }
+    *Dstlen = Size;
+    return 0;
+}
+
+#endif /* CLIB_LZ_MODULE_ENABLED */
@@ -0,0 +1,145 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  LZ77 Compression Library with C
+**************************************************************/
+/**
+ * @file        CLIB_lz.h
+ * @brief       LZ77 Compression API with C Header
+ * @details     A small byte oriented LZ77 codec for the short messages. \n
+ *              The compressed data starts with the original length (7 bits in each byte, the lowest first),
+ *              and is followed by the sequences. Each sequence has a token (literal length in the high 4 bits and
+ *              match length - 4 in the low 4 bits, 15 means more bytes of the length follow until one less than 255),
+ *              the literals, and the offset of the match (2 bytes, little endian) unless the data ends after
+ *              the literals. \n
+ *              A preset dictionary shared by both sides lets the short messages refer to the bytes common to them,
+ *              it is placed just before the data and the matches can start in it.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+#ifndef _CLIB_LZ_H_
+#define _CLIB_LZ_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <string.h>
+#include "CLIB_def.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#if !defined(CLIB_LZ_HASH_BITS)
+#define CLIB_LZ_HASH_BITS               (10)
+/*!< Bits of the hash table of the compressor, which takes (4 << CLIB_LZ_HASH_BITS) bytes of the stack */
+#endif
+
+#define CLIB_LZ_MIN_MATCH               (4)
+/*!< Minimum length of a match */
+
+#define CLIB_LZ_MAX_OFFSET              (65535)
+/*!< Maximum distance of a match (the bytes of the dictionary farther than it are not used) */
+
+#define CLIB_LZ_BOUND(Size)             ( (Size) + ((Size) / 255) + 16 )
+/*!< Maximum size of the compressed data of Size bytes */
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @addtogroup  lz_module
+ * @ingroup     mbed_c_library
+ * @brief       LZ77 Compression API
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @{
+ */
+
+/**
+ * @brief               Compress the data
+ * @param[in]           Dict                Preset dictionary (can be NULL)
+ * @param[in]           DictLen             The size of the dictionary
+ * @param[in]           Src                 The data to compress
+ * @param[in]           Srclen              The size of the data
+ * @param[out]          Dst                 The buffer of the compressed data
+ * @param[in,out]       Dstlen              [in] The size of the buffer [out] The size of the compressed data
+ * @retval              0                   success
+ * @retval              -1                  fail (the buffer is too small)
+ * @note                The buffer of CLIB_LZ_BOUND(Srclen) bytes is always enough
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_lz_compress(const uint8_t* Dict, size_t DictLen, const uint8_t* Src, size_t Srclen, uint8_t* Dst, size_t* Dstlen);
+
+/**
+ * @brief               Get the original size of the compressed data
+ * @param[in]           Src                 The compressed data
+ * @param[in]           Srclen              The size of the compressed data
+ * @param[out]          Size                The size of the data after decompression
+ * @retval              0                   success
+ * @retval              -1                  fail (bad format)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_lz_size(const uint8_t* Src, size_t Srclen, size_t* Size);
+
+/**
+ * @brief               Decompress the data
+ * @param[in]           Dict                Preset dictionary used to compress the data (can be NULL)
+ * @param[in]           DictLen             The size of the dictionary
+ * @param[in]           Src                 The compressed data
+ * @param[in]           Srclen              The size of the compressed data
+ * @param[out]          Dst                 The buffer of the data
+ * @param[in,out]       Dstlen              [in] The size of the buffer [out] The size of the data
+ * @retval              0                   success
+ * @retval              -1                  fail (bad format, or the buffer is smaller than CLIB_lz_size tells)
+ * @note                The bytes of Src are checked, so the data from the network can be given as it is
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_lz_decompress(const uint8_t* Dict, size_t DictLen, const uint8_t* Src, size_t Srclen, uint8_t* Dst, size_t* Dstlen);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLIB_LZ_H_ */
@@ -0,0 +1,321 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Fixed Size Memory Pool Library with C
+**************************************************************/
+/**
+ * @file        CLIB_pool.c
+ * @brief       Fixed Size Memory Pool API with C
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "CLIB_pool.h"
+
+#ifdef CLIB_POOL_MODULE_ENABLED
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Find the size class which the memory belongs to
+ * @param[in]           Pool                Pool information
+ * @param[in]           Pv                  Memory address
+ * @return              The size class (NULL if the memory does not belong to the pool)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static S_POOL_CLASS* prvPoolClassFind( S_POOL_HANDLE* Pool, uint8_t* Pv )
+{
+    S_POOL_CLASS*   Class   =   NULL;
+    uint32_t        i       =   0;
+
+    for( i = 0; i < Pool->ClassNum; i++ )
+    {
+        Class = &(Pool->Class[i]);
+        if( (Pv >= Class->Start) && (Pv < Class->End) )
+        {
+            /* Must be the head of a block */
+            return ( 0 == ((size_t)(Pv - Class->Start) % Class->BlockSize) )?(Class):(NULL);
+        }
+    }
+    return NULL;
+}
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               create a memory pool
+ * @param[in,out]       Pool                Pool information
+ * @param[in]           Memory              Buffer used to create the Pool
+ * @param[in]           PoolSize            The size of the Pool buffer
+ * @param[in]           BlockSizeList       Block size of each class, in ascending order
+ * @param[in]           BlockNumList        Block number of each class
+ * @param[in]           ClassNum            The number of the classes (1 ~ CLIB_POOL_CLASS_MAX)
+ * @param[in]           UserData            User Data used for callback function
+ * @param[in]           Lock                Resource Lock callback function
+ * @param[in]           Unlock              Resource Unlock callback function
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_pool_create(S_POOL_HANDLE* Pool, uint8_t* Memory, size_t PoolSize,
+                                const size_t* BlockSizeList, const size_t* BlockNumList, uint32_t ClassNum,
+                                void* UserData, F_CLIB_LOCKFUNC Lock, F_CLIB_UNLOCKFUNC Unlock)
+{
+    S_POOL_CLASS*   Class       =   NULL;
+    uint8_t*        MemAddress  =   NULL;
+    uint8_t*        MemEnd      =   NULL;
+    size_t          BlockSize   =   0;
+    size_t          i           =   0;
+    uint32_t        j           =   0;
+
+    /* check input Data */
+    if( !Pool || !Memory || !PoolSize || !BlockSizeList || !BlockNumList )
+    {
+        return (-1);
+    }
+    if( (0 == ClassNum) || (CLIB_POOL_CLASS_MAX < ClassNum) )
+    {
+        return (-1);
+    }
+    if( ( !Lock && Unlock ) || (Lock && !Unlock) )
+    {
+        return (-1);
+    }
+
+    /* Init Pool */
+    memset(Pool, 0, sizeof(S_POOL_HANDLE));
+
+    MemAddress = (uint8_t*)CLIB_ALIGN(Memory, CLIB_ALIGNBYTES);
+    MemEnd = Memory + PoolSize;
+
+    for( j = 0; j < ClassNum; j++ )
+    {
+        BlockSize = CLIB_POOL_BLOCK_SIZE(BlockSizeList[j]);
+        if( (j > 0) && (BlockSizeList[j] <= BlockSizeList[j - 1]) )
+        {
+            return (-1);
+        }
+        if( (size_t)(MemEnd - MemAddress) / BlockSize < BlockNumList[j] )
+        {
+            /* No enough memory */
+            return (-1);
+        }
+
+        /* Link all blocks of the class into the free list, the lowest address first */
+        Class = &(Pool->Class[j]);
+        Class->Start = MemAddress;
+        Class->End = MemAddress + BlockSize * BlockNumList[j];
+        Class->BlockSize = BlockSize;
+        Class->FreeList = (BlockNumList[j])?(Class->Start):(NULL);
+        Class->FreeCount = BlockNumList[j];
+        Class->MinimumEverFreeCount = BlockNumList[j];
+        for( i = 0; i < BlockNumList[j]; i++ )
+        {
+            *((void**)(Class->Start + BlockSize * i)) = ( (i + 1) < BlockNumList[j] )?(Class->Start + BlockSize * (i + 1)):(NULL);
+        }
+        MemAddress = Class->End;
+    }
+    Pool->ClassNum = ClassNum;
+
+    Pool->LockFunc = Lock;
+    Pool->UnlockFunc = Unlock;
+    Pool->UsrData = UserData;
+
+    return (0);
+}
+
+/**
+ * @brief               Memory allocate function
+ * @param[in,out]       Pool                Pool information
+ * @param[in]           WantedSize          Memory size that want to allocate
+ * @return              Memory address allocated successfully
+ * @note                NULL maybe returned when no block enough
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern void* CLIB_pool_malloc(S_POOL_HANDLE* Pool, size_t WantedSize)
+{
+    S_POOL_CLASS*   Class       =   NULL;
+    void*           prvReturn   =   NULL;
+    uint32_t        i           =   0;
+
+    /* check input Data */
+    if( !Pool || !WantedSize )
+    {
+        return prvReturn;
+    }
+
+    if(Pool->LockFunc)
+    {
+        Pool->LockFunc(Pool->UsrData);
+    }
+
+    for( i = 0; i < Pool->ClassNum; i++ )
+    {
+        Class = &(Pool->Class[i]);
+        if( (Class->BlockSize >= WantedSize) && (Class->FreeList) )
+        {
+            /* Take the first block of the free list */
+            prvReturn = Class->FreeList;
+            Class->FreeList = *((void**)prvReturn);
+            Class->FreeCount--;
+            if(Class->FreeCount < Class->MinimumEverFreeCount)
+            {
+                Class->MinimumEverFreeCount = Class->FreeCount;
+            }
+            break;
+        }
+    }
+
+    if(Pool->UnlockFunc)
+    {
+        Pool->UnlockFunc(Pool->UsrData);
+    }
+
+    return prvReturn;
+}
+
+/**
+ * @brief               Memory free function
+ * @param[in,out]       Pool                Pool information
+ * @param[in]           Pv                  Memory address that allocated from the pool handle
+ * @retval              0                   success
+ * @retval              -1                  Pv does not belong to the pool (nothing is done)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_pool_free(S_POOL_HANDLE* Pool, void* Pv)
+{
+    S_POOL_CLASS*   Class   =   NULL;
+
+    if( (Pv == NULL) || (Pool == NULL) )
+    {
+        return (-1);
+    }
+
+    /* The classes are not changed after created, so no lock is needed to find the class */
+    Class = prvPoolClassFind(Pool, (uint8_t*)Pv);
+    if(!Class)
+    {
+        return (-1);
+    }
+
+    if(Pool->LockFunc)
+    {
+        Pool->LockFunc(Pool->UsrData);
+    }
+
+    /* Put the block back to the head of the free list */
+    *((void**)Pv) = Class->FreeList;
+    Class->FreeList = Pv;
+    Class->FreeCount++;
+
+    if(Pool->UnlockFunc)
+    {
+        Pool->UnlockFunc(Pool->UsrData);
+    }
+
+    return (0);
+}
+
+/**
+ * @brief               Get the free block number of a size class
+ * @param[in]           Pool                Pool information
+ * @param[in]           ClassIndex          Index of the size class
+ * @return              Free block number of the size class (0 for an invalid index)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern size_t CLIB_pool_GetFreeBlockNum(S_POOL_HANDLE* Pool, uint32_t ClassIndex)
+{
+    if( Pool && (ClassIndex < Pool->ClassNum) )
+    {
+        return Pool->Class[ClassIndex].FreeCount;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+/**
+ * @brief               Get the minimum free block number ever of a size class
+ * @param[in]           Pool                Pool information
+ * @param[in]           ClassIndex          Index of the size class
+ * @return              The minimum free block number ever of the size class (0 for an invalid index)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern size_t CLIB_pool_GetMinimumEverFreeBlockNum(S_POOL_HANDLE* Pool, uint32_t ClassIndex)
+{
+    if( Pool && (ClassIndex < Pool->ClassNum) )
+    {
+        return Pool->Class[ClassIndex].MinimumEverFreeCount;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+/**
+ * @brief               delete a memory pool
+ * @param[in,out]       Pool                Pool information
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_pool_delete(S_POOL_HANDLE* Pool)
+{
+    if(!Pool)
+    {
+        return (-1);
+    }
+    memset(Pool, 0, sizeof(S_POOL_HANDLE));
+    return (0);
+}
+
+#endif /* CLIB_POOL_MODULE_ENABLED */
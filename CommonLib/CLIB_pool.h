@@ -0,0 +1,206 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Fixed Size Memory Pool Library with C
+**************************************************************/
+/**
+ * @file        CLIB_pool.h
+ * @brief       Fixed Size Memory Pool API with C Header
+ * @details     The memory is divided into some size classes, each class has a number of blocks with the same size
+ *              and a free list of them, so the allocation and the free take constant time without fragmentation.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+#ifndef _CLIB_POOL_H_
+#define _CLIB_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <string.h>
+#include "CLIB_def.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#if !defined(CLIB_POOL_CLASS_MAX)
+#define CLIB_POOL_CLASS_MAX             (4)
+/*!< Maximum number of the size classes of one pool */
+#endif
+
+#define CLIB_POOL_BLOCK_SIZE(Size)      CLIB_ALIGN( ( ((Size) > sizeof(void*))?(Size):(sizeof(void*)) ), CLIB_ALIGNBYTES )
+/*!< Size of one block used for the wanted size (a free block keeps the pointer to the next one) */
+
+#define CLIB_POOL_CLASS_MEMORY(Size, Num)   ( CLIB_POOL_BLOCK_SIZE(Size) * (Num) )
+/*!< Memory used by a size class, the pool memory is the sum of all classes and CLIB_ALIGNBYTES for the alignment */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ *  @brief      Size class of the memory pool
+ *  @author     agent@local
+ *  @date       2026/10/17
+ */
+typedef struct _S_POOL_CLASS
+{
+    uint8_t*                Start;                      /*!< The first block of the class */
+    uint8_t*                End;                        /*!< The end of the last block of the class */
+    size_t                  BlockSize;                  /*!< The size of each block */
+    void*                   FreeList;                   /*!< The first free block (each free block keeps the next one in its head) */
+    size_t                  FreeCount;                  /*!< The number of the free blocks */
+    size_t                  MinimumEverFreeCount;       /*!< The minimum number of the free blocks ever */
+} S_POOL_CLASS;
+
+/**
+ *  @brief      The Pool Handle structure
+ *  @author     agent@local
+ *  @date       2026/10/17
+ */
+typedef struct _S_POOL_HANDLE
+{
+    S_POOL_CLASS            Class[CLIB_POOL_CLASS_MAX]; /*!< Size classes in ascending order of the block size */
+    uint32_t                ClassNum;                   /*!< The number of the size classes */
+
+    F_CLIB_LOCKFUNC         LockFunc;                   /*!< Lock callback function */
+    F_CLIB_UNLOCKFUNC       UnlockFunc;                 /*!< Unlock callback function */
+    void*                   UsrData;                    /*!< UserData used for callback function */
+} S_POOL_HANDLE;
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @addtogroup  pool_memory_module
+ * @ingroup     mbed_c_library
+ * @brief       Fixed Size Memory Pool API
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @{
+ */
+
+/**
+ * @brief               create a memory pool
+ * @param[in,out]       Pool                Pool information
+ * @param[in]           Memory              Buffer used to create the Pool
+ * @param[in]           PoolSize            The size of the Pool buffer
+ * @param[in]           BlockSizeList       Block size of each class, in ascending order
+ * @param[in]           BlockNumList        Block number of each class
+ * @param[in]           ClassNum            The number of the classes (1 ~ CLIB_POOL_CLASS_MAX)
+ * @param[in]           UserData            User Data used for callback function
+ * @param[in]           Lock                Resource Lock callback function
+ * @param[in]           Unlock              Resource Unlock callback function
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @note                PoolSize should not be less than the sum of CLIB_POOL_CLASS_MEMORY of each class and CLIB_ALIGNBYTES
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_pool_create(S_POOL_HANDLE* Pool, uint8_t* Memory, size_t PoolSize,
+                                const size_t* BlockSizeList, const size_t* BlockNumList, uint32_t ClassNum,
+                                void* UserData, F_CLIB_LOCKFUNC Lock, F_CLIB_UNLOCKFUNC Unlock);
+
+/**
+ * @brief               Memory allocate function
+ * @param[in,out]       Pool                Pool information
+ * @param[in]           WantedSize          Memory size that want to allocate
+ * @return              Memory address allocated successfully
+ * @note                The block is taken from the smallest class which fits and has free block. \n
+ *                      NULL is returned when no such block, the caller can fall back to another allocator
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern void* CLIB_pool_malloc(S_POOL_HANDLE* Pool, size_t WantedSize);
+
+/**
+ * @brief               Memory free function
+ * @param[in,out]       Pool                Pool information
+ * @param[in]           Pv                  Memory address that allocated from the pool handle
+ * @retval              0                   success
+ * @retval              -1                  Pv does not belong to the pool (nothing is done)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_pool_free(S_POOL_HANDLE* Pool, void* Pv);
+
+/**
+ * @brief               Get the free block number of a size class
+ * @param[in]           Pool                Pool information
+ * @param[in]           ClassIndex          Index of the size class
+ * @return              Free block number of the size class (0 for an invalid index)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern size_t CLIB_pool_GetFreeBlockNum(S_POOL_HANDLE* Pool, uint32_t ClassIndex);
+
+/**
+ * @brief               Get the minimum free block number ever of a size class
+ * @param[in]           Pool                Pool information
+ * @param[in]           ClassIndex          Index of the size class
+ * @return              The minimum free block number ever of the size class (0 for an invalid index)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern size_t CLIB_pool_GetMinimumEverFreeBlockNum(S_POOL_HANDLE* Pool, uint32_t ClassIndex);
+
+/**
+ * @brief               delete a memory pool
+ * @param[in,out]       Pool                Pool information
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+extern int32_t CLIB_pool_delete(S_POOL_HANDLE* Pool);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLIB_POOL_H_ */
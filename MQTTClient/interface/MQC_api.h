@@ -26,6 +26,23 @@
  * @version     00.00.01 
  *              - 2018/06/13 : zhaozhenge@outlook.com 
  *                  -# New
+ * @version     00.00.02 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add the chunked delivery for the received PUBLISH message
+ *                  -# Add the scattered write callback for the QoS0 PUBLISH message
+ *                  -# Add D_MQC_RET_BUSY
+ *                  -# Add the in-flight window of the PUBLISH message and MQC_Statistics
+ *                  -# Add the output batch and MQC_Flush
+ *                  -# Add the topic filter handler and MQC_SubscribeHandler
+ *                  -# Add MQC_NextDeadline
+ *                  -# Add the store of the Messages in flight kept across the restart
+ *                  -# Add the offline buffer of the PUBLISH Messages
+ *                  -# Add the MQTT 5.0 protocol version and the Topic Alias
+ *                  -# Add the Receive Maximum and the Maximum Packet Size of MQTT 5.0
+ *                  -# Add the payload codec of the Topic Filter and MQC_CodecSet
+ * @version     00.00.03 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add DecodeMaxSize to limit the decoded payload of the received PUBLISH message
  */
 
 #ifndef _MQC_API_H_
@@ -65,9 +82,12 @@ extern "C" {
 #define D_MQC_RET_BAD_SEQUEUE           (-4)        /*!< Bad sequeue for MQTT protocol */
 #define D_MQC_RET_BAD_FORMAT            (-5)        /*!< Bad Message format for MQTT protocol */
 #define D_MQC_RET_CALLBACK_ERROR        (-6)        /*!< Callback function error */
+#define D_MQC_RET_BUSY                  (-7)        /*!< No Packet Identifier (or no room of the offline buffer) is free, try again after some Messages complete */
 
 #define D_MQC_OPEN_SUCCESS_CODE         (0)         /*!< Connect Return Code for open success */
 
+#define D_MQC_DEADLINE_INFINITE         (0xFFFFFFFF)    /*!< MQC_Continue has no work until the next API call or received data */
+
 /** 
  * @brief       Message Type define of MQTT
  * @author      zhaozhenge@outlook.com
@@ -133,6 +153,46 @@ typedef enum _E_MQC_BEHAVIOR_RESULT
 #endif
 }E_MQC_BEHAVIOR_RESULT;
 
+/** 
+ * @brief       Event of the PUBLISH message delivered in chunks
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef enum _E_MQC_CHUNK_EVENT
+{
+    E_MQC_CHUNK_BEGIN = 0x00,                       /*!< Message begin (Topic, Packet Identifier and total length are available) */
+    E_MQC_CHUNK_DATA,                               /*!< A fragment of the message payload */
+    E_MQC_CHUNK_END,                                /*!< Message complete (response will be sent to server after this event) */
+    E_MQC_CHUNK_ABORT                               /*!< Message abandoned before complete (session closed, reset or bad format) */
+}E_MQC_CHUNK_EVENT;
+
+#if defined (MQC_OFFLINE_BUFFER)
+/** 
+ * @brief       Policy of the PUBLISH message published when the offline buffer is full
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef enum _E_MQC_OFFLINE_POLICY
+{
+    E_MQC_OFFLINE_DROP_OLDEST = 0x00,               /*!< The oldest message in the buffer is discarded (notified with E_MQC_BEHAVIOR_CANCEL) */
+    E_MQC_OFFLINE_DROP_NEWEST,                      /*!< The new message is discarded, MQC_Publish returns D_MQC_RET_NO_NOTIFY */
+    E_MQC_OFFLINE_BLOCK                             /*!< The new message is refused, MQC_Publish returns D_MQC_RET_BUSY until the buffer has room */
+}E_MQC_OFFLINE_POLICY;
+#endif /* MQC_OFFLINE_BUFFER */
+
+#if defined (MQC_MQTT5)
+/** 
+ * @brief       Version of the MQTT protocol used by the session
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef enum _E_MQC_PROTOCOL_VERSION
+{
+    E_MQC_PROTOCOL_V311 = 0x00,                     /*!< MQTT 3.1.1 */
+    E_MQC_PROTOCOL_V5                               /*!< MQTT 5.0 (no properties other than the ones used by the library are sent) */
+}E_MQC_PROTOCOL_VERSION;
+#endif /* MQC_MQTT5 */
+
 /**
  * @} 
  */
@@ -169,6 +229,150 @@ typedef struct _S_MQC_MESSAGE_INFO
     uint32_t                Length;                 /*!< Message Length */
 }S_MQC_MESSAGE_INFO;
 
+/**
+ * @brief       Fragment of the PUBLISH Message delivered in chunks
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_CHUNK_INFO
+{
+    S_MQC_UTF8_DATA         Topic;                  /*!< Message Topic */
+    uint16_t                PacketIdentifier;       /*!< Packet Identifier (0 when QoS0) */
+    E_MQC_QOS_LEVEL         QoS;                    /*!< Message QoS Level */
+    uint32_t                TotalLength;            /*!< Total length of the Message payload */
+    uint32_t                Offset;                 /*!< Offset of the fragment in the Message payload */
+    uint8_t*                Content;                /*!< Fragment Content (only for E_MQC_CHUNK_DATA, otherwise NULL) */
+    uint32_t                Length;                 /*!< Fragment Length */
+}S_MQC_CHUNK_INFO;
+
+/**
+ * @brief       Segment of the Message data written by WriteVecFuncCB
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_IOVEC
+{
+    const uint8_t*          Data;                   /*!< Segment Data */
+    size_t                  Size;                   /*!< Segment Size */
+}S_MQC_IOVEC;
+
+/**
+ * @brief       Statistics of the MQTT Session
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_STATISTICS
+{
+    uint32_t                InflightCount;          /*!< QoS1/QoS2 PUBLISH messages waiting for the response (occupancy of the in-flight window) */
+    uint32_t                InflightPeak;           /*!< Peak of InflightCount since the session started */
+    uint32_t                PendingCount;           /*!< PUBLISH messages waiting for a free slot of the in-flight window */
+    uint32_t                PendingPeak;            /*!< Peak of PendingCount since the session started */
+    uint32_t                QueueCount;             /*!< All messages waiting for the response (PUBLISH, PUBREC, PUBREL, SUBSCRIBE and UNSUBSCRIBE) */
+#if defined (MQC_OFFLINE_BUFFER)
+    uint32_t                OfflineCount;           /*!< PUBLISH messages in the offline buffer */
+    size_t                  OfflineSize;            /*!< Size of the encoded messages in the offline buffer */
+    uint32_t                OfflineDropCount;       /*!< PUBLISH messages discarded because the offline buffer was full since the session started */
+#endif /* MQC_OFFLINE_BUFFER */
+#if defined (MQC_MQTT5)
+    uint32_t                TopicAliasCount;        /*!< Topic Aliases of the client mapped to a Topic Name on the current connection */
+    uint32_t                TopicAliasMapCount;     /*!< PUBLISH messages sent with the Topic Name to map a Topic Alias since the session started */
+    uint32_t                TopicAliasHitCount;     /*!< PUBLISH messages sent with a Topic Alias only since the session started */
+    uint64_t                TopicAliasSavedBytes;   /*!< Bytes not sent by the PUBLISH messages with a Topic Alias only since the session started */
+    uint32_t                InflightMaximum;        /*!< Size of the in-flight window on the current connection (0 means no limit) */
+    uint32_t                ServerMaximumPacketSize;/*!< Maximum Packet Size of the server on the current connection (0 means no limit) */
+#endif /* MQC_MQTT5 */
+#if defined (MQC_PAYLOAD_CODEC)
+    uint32_t                CodecEncodeCount;       /*!< PUBLISH messages sent or kept through a codec since the session started */
+    uint64_t                CodecRawBytes;          /*!< Payload bytes of these messages given by user since the session started */
+    uint64_t                CodecEncodedBytes;      /*!< Payload bytes of these messages after the codec (with the format byte) since the session started */
+    uint32_t                CodecDecodeCount;       /*!< Received PUBLISH messages decoded by a codec since the session started */
+    uint32_t                CodecDecodeErrorCount;  /*!< Received PUBLISH messages discarded because the codec failed to decode since the session started */
+#endif /* MQC_PAYLOAD_CODEC */
+}S_MQC_STATISTICS;
+
+/**
+ * @brief       Handler of the PUBLISH Messages matched by a Topic Filter
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_TOPIC_HANDLER
+{
+    int32_t                 (*HandlerFuncCB)(void* Ctx, S_MQC_MESSAGE_INFO* Message);
+    /*!< Callback function to notify user the received PUBLISH Message */
+    
+    void*                   Ctx;
+    /*!< User Data used for HandlerFuncCB */
+}S_MQC_TOPIC_HANDLER;
+
+#if defined (MQC_PAYLOAD_CODEC)
+/**
+ * @brief       Codec of the payload of the PUBLISH Messages (e.g. compression)
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_CODEC
+{
+    size_t                  (*BoundFuncCB)(void* Ctx, size_t Length);
+    /*!< Maximum size of the encoded payload of Length bytes */
+    
+    int32_t                 (*EncodeFuncCB)(void* Ctx, const uint8_t* Src, size_t Srclen, uint8_t* Dst, size_t* Dstlen);
+    /*!< Encode the payload into Dst (*Dstlen is the size of Dst given by BoundFuncCB, and set to the encoded size), 
+         0 means success */
+    
+    int32_t                 (*DecodeFuncCB)(void* Ctx, const uint8_t* Src, size_t Srclen, uint8_t* Dst, size_t* Dstlen);
+    /*!< Decode the payload. With Dst NULL, only set *Dstlen to the decoded size. Otherwise decode into Dst 
+         (*Dstlen is the size of Dst, and set to the decoded size), 0 means success */
+    
+    void*                   Ctx;
+    /*!< User Data used for the callback functions (kept by user while the codec is set) */
+}S_MQC_CODEC;
+
+/**
+ * @brief       Preset dictionary of the built-in LZ codec
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_CODEC_DICT
+{
+    const uint8_t*          Data;                   /*!< Bytes common to the payloads (e.g. a sample message, the last 64KB are used) */
+    size_t                  Size;                   /*!< Size of the dictionary */
+}S_MQC_CODEC_DICT;
+#endif /* MQC_PAYLOAD_CODEC */
+
+#if defined (MQC_PERSISTENCE)
+/**
+ * @brief       Store of the QoS1/QoS2 Messages in flight, so they are resumed after the restart
+ * @details     The PUBLISH (QoS1/QoS2) and PUBREL Messages sent by the client and the PUBREC Messages
+ *              for the QoS2 PUBLISH Messages received are saved while they wait for the response.
+ *              A Message is identified by its type and Packet Identifier.
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_PERSIST_FUNC
+{
+    void*                   Ctx;
+    /*!< Context of the store */
+    
+    int32_t                 (*SaveFuncCB)(void* Ctx, E_MQC_MSG_TYPE Type, uint16_t PacketIdentifier, const uint8_t* Data, size_t Size);
+    /*!< Save the encoded Message (the Message saved before with the same type and Packet Identifier is replaced) */
+    
+    int32_t                 (*DeleteFuncCB)(void* Ctx, E_MQC_MSG_TYPE Type, uint16_t PacketIdentifier);
+    /*!< Delete the Message when its flow completes or it is discarded */
+    
+    int32_t                 (*ClearFuncCB)(void* Ctx);
+    /*!< Delete all Messages when the session is cleaned */
+    
+    int32_t                 (*LoadFuncCB)(void* Ctx, int32_t (*RecordFuncCB)(void* UsrData, E_MQC_MSG_TYPE Type, uint16_t PacketIdentifier, const uint8_t* Data, size_t Size), void* UsrData);
+    /*!< Give all Messages to RecordFuncCB in the order they were saved */
+    
+    int32_t                 (*SyncFuncCB)(void* Ctx);
+    /*!< Make the saved data durable, called once before the session is unlocked if anything was saved or deleted (can be NULL) */
+    
+    int32_t                 (*ResultFuncCB)(E_MQC_BEHAVIOR_RESULT Result, S_MQC_MESSAGE_INFO* Message);
+    /*!< Result callback function of the PUBLISH Messages resumed from the store (NULL means not notified) */
+}S_MQC_PERSIST_FUNC;
+#endif /* MQC_PERSISTENCE */
+
 /**
  * @brief       Will Message Setting for MQTT Session
  * @author      zhaozhenge@outlook.com
@@ -250,6 +454,84 @@ typedef struct _S_MQC_SESSION_HANDLE
     int32_t                 (*OpenResetFuncCB)(void* Ctx, E_MQC_BEHAVIOR_RESULT Result, uint8_t SrvResCode, bool SessionPresent);
     /*!< CONNECT result callback function */
     
+    uint32_t                ReadChunkThreshold;
+    /*!< PUBLISH message with the Remaining Length not less than this value is delivered in chunks by ReadChunkFuncCB */
+    
+    int32_t                 (*ReadChunkFuncCB)(void* Ctx, E_MQC_CHUNK_EVENT Event, S_MQC_CHUNK_INFO* Info);
+    /*!< PUBLISH message chunk read callback function (NULL means always deliver the whole message by ReadFuncCB) */
+    
+    int32_t                 (*WriteVecFuncCB)(void* Ctx, const S_MQC_IOVEC* Vec, uint32_t VecNum);
+    /*!< Message data write callback function with segments, all segments should be written in order as one message. \n
+         Used for QoS0 PUBLISH message (and PUBLISH message with a Topic Alias of MQTT 5.0), so the Topic and the payload 
+         are not copied by the library (NULL means always use WriteFuncCB) */
+    
+    uint32_t                MaxInflight;
+    /*!< Maximum number of QoS1/QoS2 PUBLISH messages waiting for the response, the others wait in the pending list 
+         and are sent when the former ones complete (0 means no limit) */
+    
+    uint32_t                WriteBatchSize;
+    /*!< Size of the buffer to coalesce the Messages smaller than it into one WriteFuncCB call (0 means write each Message at once). \n
+         The buffer is written when it is full, at the end of MQC_Read and MQC_Continue, or by MQC_Flush. Set it before MQC_Start */
+    
+#if defined (MQC_PERSISTENCE)
+    S_MQC_PERSIST_FUNC*     PersistFunc;
+    /*!< Store of the Messages in flight (NULL means they are kept in memory only). \n
+         MQC_Start resumes the Messages in the store when CleanSession is false, and clears the store when it is true. 
+         MQC_Stop keeps them in the store when CleanSession is false. Set it before MQC_Start */
+#endif /* MQC_PERSISTENCE */
+    
+#if defined (MQC_OFFLINE_BUFFER)
+    uint32_t                OfflineMaxNum;
+    /*!< Maximum number of PUBLISH messages kept while the session is not connected (0 means MQC_Publish returns 
+         D_MQC_RET_BAD_SEQUEUE before MQC_Open). The messages are sent in order after CONNACK is received, 
+         the QoS0 ones have no result callback. The buffer is kept by MQC_Close and discarded by MQC_Stop */
+    
+    size_t                  OfflineMaxSize;
+    /*!< Maximum total size of the encoded messages in the offline buffer (0 means no limit) */
+    
+    E_MQC_OFFLINE_POLICY    OfflinePolicy;
+    /*!< Policy of the new message when the offline buffer is full */
+    
+    uint32_t                OfflineFlushNum;
+    /*!< Maximum number of messages sent from the offline buffer each time (0 means all at once). The buffer is sent 
+         after CONNACK is received, by MQC_Continue and when a QoS1/QoS2 message completes. The QoS1/QoS2 ones 
+         also wait for a free slot of MaxInflight */
+#endif /* MQC_OFFLINE_BUFFER */
+    
+#if defined (MQC_MQTT5)
+    E_MQC_PROTOCOL_VERSION  ProtocolVersion;
+    /*!< Version of the MQTT protocol. With MQTT 5.0 the Reason Codes 0x80 or more of SUBACK are notified as 
+         E_MQC_CODE_FAIL, and PUBACK/PUBREC with the Reason Code 0x80 or more completes the PUBLISH message with 
+         E_MQC_BEHAVIOR_CANCEL. Set it before MQC_Start */
+    
+    uint16_t                TopicAliasMaximum;
+    /*!< Maximum Topic Alias accepted from the server, sent by CONNECT (0 means the server does not use the Topic Alias). 
+         The Topic Names are kept by the library, about 24 bytes and the Topic Name each */
+    
+    uint16_t                TopicAliasSendMaximum;
+    /*!< Maximum Topic Alias used for the PUBLISH messages sent, limited by the Topic Alias Maximum of CONNACK (0 means 
+         no Topic Alias is used). The least recently used Topic Alias is mapped to the new Topic Name when all are used. 
+         The retransmitted messages are sent with the Topic Name */
+    
+    uint16_t                ReceiveMaximum;
+    /*!< Maximum number of QoS1/QoS2 PUBLISH messages from the server processed at once, sent by CONNECT (0 means 
+         not sent, the server assumes 65535) */
+    
+    uint32_t                MaximumPacketSize;
+    /*!< Maximum size of the message accepted from the server, sent by CONNECT (0 means no limit). A larger message 
+         is refused with D_MQC_RET_BAD_FORMAT before the receive buffer grows for it. \n
+         The Receive Maximum and the Maximum Packet Size of the server got by CONNACK are also applied: the in-flight 
+         window is the smaller of MaxInflight and the Receive Maximum, and MQC_Publish refuses a message larger than 
+         the Maximum Packet Size with D_MQC_RET_BAD_INPUT_DATA (the buffered ones are canceled) */
+#endif /* MQC_MQTT5 */
+#if defined (MQC_PAYLOAD_CODEC)
+    
+    uint32_t                DecodeMaxSize;
+    /*!< Maximum size of the decoded payload of a received PUBLISH message. A message which the codec tells larger 
+         is discarded as the codec failed, before the decode buffer grows for it (0 means the MaximumPacketSize of 
+         MQTT 5.0 if it is set, otherwise MQC_DECODE_MAX_SIZE) */
+#endif /* MQC_PAYLOAD_CODEC */
+    
 }S_MQC_SESSION_HANDLE;
 
 /**
@@ -316,6 +598,7 @@ MQC_EXTERN int32_t MQC_Start(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
  * @retval              D_MQC_RET_CALLBACK_ERROR
  * @retval              D_MQC_RET_BAD_INPUT_DATA
  * @note                This API can only be called after a MQTT client handler is started
+ * @note                The discarded Messages are notified after the session is stopped, so their callbacks may start it again
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/14
  * @callgraph
@@ -384,6 +667,7 @@ MQC_EXTERN int32_t MQC_Reset(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Timeout)
  * @retval              D_MQC_RET_BAD_SEQUEUE
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_BAD_INPUT_DATA
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/19
@@ -392,6 +676,34 @@ MQC_EXTERN int32_t MQC_Reset(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Timeout)
  */
 MQC_EXTERN int32_t MQC_Subscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, uint32_t ListNum, F_SUBSCRIBE_RES_CBFUNC ResultFuncCB);
 
+#if defined (MQC_TOPIC_DISPATCH)
+/** 
+ * @brief               Subscribe topic via MQTT Session with a handler for each Topic Filter.
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilterList         Topic Filter List
+ * @param[in]           QoSList                 Topic Filter's QoS List
+ * @param[in]           HandlerList             Topic Filter's Handler List
+ * @param[in]           ListNum                 Count of the topic filter list
+ * @param[in]           ResultFuncCB            Callback function will be called to notify if received Server Response
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_SEQUEUE
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @note                The received PUBLISH Message is delivered to the handlers of all matched Topic Filters,
+ *                      and to ReadFuncCB only when no Topic Filter matches. \n
+ *                      The handler is removed by MQC_Unsubscribe. When the server refuses the Topic Filter, the 
+ *                      handler registered before for the same Topic Filter is restored (or it is removed if none).
+ *                      It is kept while the connection is closed and reset.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_SubscribeHandler(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, S_MQC_TOPIC_HANDLER* HandlerList, uint32_t ListNum, F_SUBSCRIBE_RES_CBFUNC ResultFuncCB);
+#endif /* MQC_TOPIC_DISPATCH */
+
 /** 
  * @brief               Cancel a subscribed topic via MQTT Session.
  * @param[in,out]       MQCHandler              MQTT client handler
@@ -402,6 +714,7 @@ MQC_EXTERN int32_t MQC_Subscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DA
  * @retval              D_MQC_RET_BAD_SEQUEUE
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_BAD_INPUT_DATA
  * @author              zhaozhenge@outlook.com
  * @date                2018/12/04
@@ -420,8 +733,11 @@ MQC_EXTERN int32_t MQC_Unsubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_CALLBACK_ERROR
  * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @retval              D_MQC_RET_NO_NOTIFY     The message is discarded by the full offline buffer (E_MQC_OFFLINE_DROP_NEWEST)
+ * @note                With OfflineMaxNum, the message published before MQC_Open or after MQC_Close is kept in the offline buffer
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/19
  * @callgraph
@@ -478,6 +794,95 @@ MQC_EXTERN int32_t MQC_Read(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, siz
  */
 MQC_EXTERN void MQC_Continue(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeCount);
 
+/** 
+ * @brief               Get the time until MQC_Continue has work to do next
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           SystimeCount            System timer count with millisecond
+ * @return              Milliseconds until the next retry, keep alive or CONNACK timeout (0 means call MQC_Continue now) \n
+ *                      D_MQC_DEADLINE_INFINITE when no timer is running \n
+ *                      0 also when the offline buffer or the output batch has messages which can be sent
+ * @note                The caller can sleep this long instead of calling MQC_Continue periodically. \n
+ *                      The deadline may come earlier after MQC_Read or the other API is called, so get it again after them.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN uint32_t MQC_NextDeadline(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeCount);
+
+/** 
+ * @brief               Get the statistics of the MQTT Session
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[out]          Statistics              Statistics of the MQTT Session
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_Statistics(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_STATISTICS* Statistics);
+
+/** 
+ * @brief               Write the Messages waiting in the output batch at once
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @note                Only needed when WriteBatchSize is set and the Messages should not wait for the next MQC_Read or MQC_Continue
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_Flush(S_MQC_SESSION_HANDLE* MQCHandler);
+
+#if defined (MQC_PAYLOAD_CODEC)
+/** 
+ * @brief               Set the codec of the payload of the PUBLISH Messages with the Topics matched by a Topic Filter
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Codec                   Codec of the Topic Filter (copied, NULL means remove the codec)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @note                The payload of MQC_Publish is encoded before it is sent or kept in the offline buffer, and 
+ *                      the result callback gets the encoded one. The received payload is decoded before it is 
+ *                      notified, the Message is discarded (after the response is sent) if the codec fails or the 
+ *                      decoded payload is larger than DecodeMaxSize. \n
+ *                      One format byte goes before the encoded payload, and the payload which the codec does not 
+ *                      make smaller is sent as it is after the format byte, so both sides must set the codec. \n
+ *                      The empty payloads, the Will Message and the Messages delivered in chunks are not encoded 
+ *                      nor decoded. When more than one Topic Filter matches, the codec set first is used. \n
+ *                      The codecs are kept until MQC_Stop, set them after MQC_Start.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_CodecSet(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilter, const S_MQC_CODEC* Codec);
+
+#if defined (CLIB_LZ_MODULE_ENABLED)
+/** 
+ * @brief               Fill the callback functions of the built-in LZ codec
+ * @param[out]          Codec                   Codec
+ * @param[in]           Dict                    Preset dictionary shared with the other side (NULL means none)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @note                The dictionary is kept by user while the codec is set. \n
+ *                      The compressor takes (4 << CLIB_LZ_HASH_BITS) bytes of the stack.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_CodecLz(S_MQC_CODEC* Codec, S_MQC_CODEC_DICT* Dict);
+#endif /* CLIB_LZ_MODULE_ENABLED */
+#endif /* MQC_PAYLOAD_CODEC */
+
 /**
  * @} 
  */
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @file        MQC_alias.h
+ * @brief       MQTT Client Libary Topic Alias Table Header
+ * @details     The table keeps the Topic Name of each Topic Alias of one direction of the connection (MQTT 5.0).
+ *              The Topic Aliases of the client are found by the Topic Name with a hash table, and the least
+ *              recently used one is mapped to the new Topic Name when all are in use. The Topic Aliases of the
+ *              server are set and got by the number.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+#ifndef _MQC_ALIAS_H_
+#define _MQC_ALIAS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "MQC_api.h"
+
+#if defined (MQC_MQTT5)
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Topic Name mapped to a Topic Alias
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_ALIAS_ENTRY
+{
+    uint8_t*                    Topic;              /*!< Topic Name (NULL means the Topic Alias is not mapped) */
+    uint16_t                    Length;             /*!< Length of the Topic Name */
+    uint16_t                    HashNext;           /*!< Next Topic Alias in the same bucket of the hash table (0 means none) */
+    uint16_t                    Prev;               /*!< Topic Alias used more recently (0 means none) */
+    uint16_t                    Next;               /*!< Topic Alias used less recently (0 means none) */
+    uint32_t                    HashValue;          /*!< Hash value of the Topic Name */
+}S_MQC_ALIAS_ENTRY;
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Create a Topic Alias table
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Num                     Number of the Topic Aliases (Topic Alias Maximum)
+ * @param[in]           MallocFunc              malloc callback function
+ * @param[in]           FreeFunc                free callback function
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                No memory is allocated if \a Num is 0, and the table has no Topic Alias
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicAlias_create(S_MQC_TOPIC_ALIAS* Table, uint16_t Num, void* (*MallocFunc)(size_t), void (*FreeFunc)(void*));
+
+/**
+ * @brief               Delete a Topic Alias table and all Topic Names in it
+ * @param[in,out]       Table                   Topic Alias table
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicAlias_delete(S_MQC_TOPIC_ALIAS* Table);
+
+/**
+ * @brief               Search the Topic Alias mapped to a Topic Name
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Topic                   Topic Name
+ * @return              Topic Alias (0 means the Topic Name is not mapped)
+ * @note                The Topic Alias found becomes the most recently used one
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint16_t MQC_TopicAlias_search(S_MQC_TOPIC_ALIAS* Table, const S_MQC_UTF8_DATA* Topic);
+
+/**
+ * @brief               Map a Topic Alias to a Topic Name which is not mapped yet
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Topic                   Topic Name
+ * @return              Topic Alias (0 means no Topic Alias or no enough memory)
+ * @note                A free Topic Alias is used first, then the least recently used one is mapped again
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint16_t MQC_TopicAlias_insert(S_MQC_TOPIC_ALIAS* Table, const S_MQC_UTF8_DATA* Topic);
+
+/**
+ * @brief               Map a given Topic Alias to a Topic Name
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias
+ * @param[in]           Topic                   Topic Name
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA    The Topic Alias is out of the range
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                The Topic Name mapped to the Topic Alias before is replaced
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicAlias_set(S_MQC_TOPIC_ALIAS* Table, uint16_t Alias, const S_MQC_UTF8_DATA* Topic);
+
+/**
+ * @brief               Get the Topic Name mapped to a Topic Alias
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias
+ * @param[out]          Topic                   Topic Name (kept in the table until the Topic Alias is mapped again)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA    The Topic Alias is out of the range or not mapped
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicAlias_get(S_MQC_TOPIC_ALIAS* Table, uint16_t Alias, S_MQC_UTF8_DATA* Topic);
+
+#endif /* MQC_MQTT5 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MQC_ALIAS_H_ */
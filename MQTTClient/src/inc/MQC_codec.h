@@ -0,0 +1,151 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @file        MQC_codec.h
+ * @brief       MQTT Client Libary Payload Codec Table Header
+ * @details     The table keeps the codec of each Topic Filter in the order they were set, and finds the first
+ *              one which matches the Topic of a PUBLISH Message. Only a few Topic Filters are expected, so they
+ *              are kept in a list. The built-in LZ codec wraps CLIB_lz.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Add the format byte of the payload
+ */
+
+#ifndef _MQC_CODEC_H_
+#define _MQC_CODEC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "MQC_api.h"
+
+#if defined (MQC_PAYLOAD_CODEC)
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_MQC_CODEC_FORMAT_RAW      (0x00)      /*!< First byte of the payload sent as it is (the codec did not make it smaller) */
+#define D_MQC_CODEC_FORMAT_ENCODED  (0x01)      /*!< First byte of the payload encoded by the codec */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Codec of a Topic Filter
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_CODEC_ENTRY
+{
+    struct _S_MQC_CODEC_ENTRY*  Next;           /*!< Codec set later */
+    S_MQC_CODEC                 Codec;          /*!< Codec */
+    S_MQC_UTF8_DATA             TopicFilter;    /*!< Topic Filter (the data follows the entry) */
+}S_MQC_CODEC_ENTRY;
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Create a codec table
+ * @param[in,out]       Table                   Codec table
+ * @param[in]           MallocFunc              malloc callback function
+ * @param[in]           FreeFunc                free callback function
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_Codec_create(S_MQC_CODEC_TABLE* Table, void* (*MallocFunc)(size_t), void (*FreeFunc)(void*));
+
+/**
+ * @brief               Delete a codec table and all codecs in it
+ * @param[in,out]       Table                   Codec table
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_Codec_delete(S_MQC_CODEC_TABLE* Table);
+
+/**
+ * @brief               Set or remove the codec of a Topic Filter
+ * @param[in,out]       Table                   Codec table
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Codec                   Codec (NULL means remove the codec of the Topic Filter)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA    Bad Topic Filter
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                The codec of the same Topic Filter is replaced and keeps its order
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_Codec_set(S_MQC_CODEC_TABLE* Table, const S_MQC_UTF8_DATA* TopicFilter, const S_MQC_CODEC* Codec);
+
+/**
+ * @brief               Find the codec of a Topic
+ * @param[in]           Table                   Codec table
+ * @param[in]           Topic                   Topic Name
+ * @return              Codec of the first Topic Filter which matches the Topic (NULL means none)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern const S_MQC_CODEC* MQC_Codec_search(const S_MQC_CODEC_TABLE* Table, const S_MQC_UTF8_DATA* Topic);
+
+#if defined (CLIB_LZ_MODULE_ENABLED)
+/**
+ * @brief               Fill the callback functions of the built-in LZ codec
+ * @param[out]          Codec                   Codec
+ * @param[in]           Dict                    Preset dictionary (NULL means none)
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_Codec_lz(S_MQC_CODEC* Codec, S_MQC_CODEC_DICT* Dict);
+#endif /* CLIB_LZ_MODULE_ENABLED */
+
+#endif /* MQC_PAYLOAD_CODEC */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MQC_CODEC_H_ */
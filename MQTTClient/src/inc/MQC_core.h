@@ -26,6 +26,13 @@
  * @version     00.00.01 
  *              - 2018/06/14 : zhaozhenge@outlook.com 
  *                  -# New
+ * @version     00.00.02 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add MQC_CoreStatistics
+ *                  -# Add MQC_CoreFlush
+ *                  -# Add MQC_CoreSubscribeHandler
+ *                  -# Add MQC_CoreNextDeadline
+ *                  -# Add MQC_CoreCodecSet
  */
 
 #ifndef _MQC_CORE_H_
@@ -129,6 +136,7 @@ extern int32_t MQC_CoreReset(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Timeout)
  * @retval              D_MQC_RET_BAD_SEQUEUE
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/19
  * @callgraph
@@ -136,6 +144,29 @@ extern int32_t MQC_CoreReset(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Timeout)
  */
 extern int32_t MQC_CoreSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, uint32_t ListNum, F_SUBSCRIBE_RES_CBFUNC ResultFuncCB);
 
+#if defined (MQC_TOPIC_DISPATCH)
+/** 
+ * @brief               Subscribe topic via MQTT Session with a handler for each Topic Filter.
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilterList         Topic Filter List
+ * @param[in]           QoSList                 Topic Filter's QoS List
+ * @param[in]           HandlerList             Topic Filter's Handler List
+ * @param[in]           ListNum                 Count of the topic filter list
+ * @param[in]           ResultFuncCB            Callback function will be called to notify if received Server Response
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_SEQUEUE
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_CoreSubscribeHandler(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, S_MQC_TOPIC_HANDLER* HandlerList, uint32_t ListNum, F_SUBSCRIBE_RES_CBFUNC ResultFuncCB);
+#endif /* MQC_TOPIC_DISPATCH */
+
 /** 
  * @brief               Cancel a subscribed topic via MQTT Session.
  * @param[in,out]       MQCHandler              MQTT client handler
@@ -146,6 +177,7 @@ extern int32_t MQC_CoreSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DA
  * @retval              D_MQC_RET_BAD_SEQUEUE
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @author              zhaozhenge@outlook.com
  * @date                2018/12/04
  * @callgraph
@@ -163,6 +195,7 @@ extern int32_t MQC_CoreUnsubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_CALLBACK_ERROR
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/19
@@ -217,6 +250,64 @@ extern int32_t MQC_CoreRead(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, siz
  */
 extern void MQC_CoreContinue(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeCount);
 
+/** 
+ * @brief               Get the time until MQC_CoreContinue has work to do next
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           SystimeCount            System timer count with millisecond
+ * @return              Milliseconds until the next retry, keep alive or CONNACK timeout \n
+ *                      0 when the output batch or the offline buffer has Messages to send \n
+ *                      D_MQC_DEADLINE_INFINITE when no timer is running
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint32_t MQC_CoreNextDeadline(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeCount);
+
+/** 
+ * @brief               Get the statistics of the MQTT Session
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[out]          Statistics              Statistics of the MQTT Session
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_CoreStatistics(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_STATISTICS* Statistics);
+
+/** 
+ * @brief               Write the Messages waiting in the output batch at once
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_CoreFlush(S_MQC_SESSION_HANDLE* MQCHandler);
+
+#if defined (MQC_PAYLOAD_CODEC)
+/** 
+ * @brief               Set the codec of the payload of the PUBLISH Messages with the Topics matched by a Topic Filter
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Codec                   Codec of the Topic Filter (NULL means remove the codec)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_CoreCodecSet(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilter, const S_MQC_CODEC* Codec);
+#endif /* MQC_PAYLOAD_CODEC */
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,6 +26,27 @@
  * @version     00.00.01 
  *              - 2018/06/13 : zhaozhenge@outlook.com 
  *                  -# New
+ * @version     00.00.02 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add the receive buffer size to the session context
+ *                  -# Add the chunked delivery context to the session context
+ *                  -# Add the send buffer to the session context
+ *                  -# Add the index of the Message Queue
+ *                  -# Order the Messages of the Queue by the Deadline
+ *                  -# Add the in-use map of the Packet Identifier
+ *                  -# Add the pending list and the in-flight window of the PUBLISH Message
+ *                  -# Add the output batch to the session context
+ *                  -# Add the fixed size pool to the session context
+ *                  -# Add the event list to the session context
+ *                  -# Add the topic filter trie to the session context
+ *                  -# Add the state of the Message store to the session context
+ *                  -# Add the offline list to the Message Queue
+ *                  -# Add the Topic Alias tables to the session context
+ *                  -# Add the limits of the server got by CONNACK to the session context
+ *                  -# Add the codec table and the decode buffer to the session context
+ * @version     00.00.03 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Count the references of the fixed size pool, the event lists taken keep it
  */
 
 #ifndef _MQC_DEFINE_H_
@@ -52,6 +73,43 @@ extern "C" {
 **  Symbol
 **************************************************************/
 
+#if !defined (MQC_MSG_QUEUE_HASH_SIZE)
+#define MQC_MSG_QUEUE_HASH_SIZE     (16)    /*!< Default maximum bucket number of the Message Queue index */
+#endif /* MQC_MSG_QUEUE_HASH_SIZE */
+
+#if (MQC_MSG_QUEUE_HASH_SIZE < 1) || (MQC_MSG_QUEUE_HASH_SIZE & (MQC_MSG_QUEUE_HASH_SIZE - 1))
+#error MQC_MSG_QUEUE_HASH_SIZE should be a power of 2
+#endif
+
+/** Bucket number of the Message Queue index kept in the session handle (a larger one is allocated at MQC_Open) */
+#define D_MQC_MSG_QUEUE_HASH_LOCAL  ((MQC_MSG_QUEUE_HASH_SIZE < 16)?(MQC_MSG_QUEUE_HASH_SIZE):(16))
+
+#if !defined (MQC_PACKET_ID_MAX)
+#define MQC_PACKET_ID_MAX           (65535) /*!< Default maximum Packet Identifier */
+#endif /* MQC_PACKET_ID_MAX */
+
+#if (MQC_PACKET_ID_MAX < 1) || (MQC_PACKET_ID_MAX > 65535)
+#error MQC_PACKET_ID_MAX should be in range 1~65535
+#endif
+
+#define D_MQC_PACKET_ID_MAP_SIZE    ((MQC_PACKET_ID_MAX / 32) + 1)  /*!< Word number of the Packet Identifier in-use map */
+
+#if !defined (MQC_POOL_MSG_NUM)
+#define MQC_POOL_MSG_NUM            (0)     /*!< Default number of the Message contexts in the pool */
+#endif /* MQC_POOL_MSG_NUM */
+
+#if !defined (MQC_POOL_SMALL_SIZE)
+#define MQC_POOL_SMALL_SIZE         (32)    /*!< Default block size of the small buffers in the pool */
+#endif /* MQC_POOL_SMALL_SIZE */
+
+#if !defined (MQC_POOL_SMALL_NUM)
+#define MQC_POOL_SMALL_NUM          (0)     /*!< Default number of the small buffers in the pool */
+#endif /* MQC_POOL_SMALL_NUM */
+
+#if defined (CLIB_POOL_MODULE_ENABLED) && ( (MQC_POOL_MSG_NUM > 0) || (MQC_POOL_SMALL_NUM > 0) )
+#define D_MQC_POOL_ENABLED                  /*!< The session keeps a fixed size pool for its own objects */
+#endif
+
 /**
  * @brief      MQTT session status
  * @author     zhaozhenge@outlook.com
@@ -79,11 +137,131 @@ typedef struct _S_MQC_MSG_QUEUE
 {
     T_LIST_NODE             MsgList;            /*!< Message entry list */
     T_LIST_NODE             ExecMsgList;        /*!< Execute entry list */
+    T_LIST_NODE*            HashList;           /*!< Index of the Messages by Packet Identifier (HashLocal or the lists given by MQC_MsgQueue_rehash) */
+    uint32_t                HashMask;           /*!< Bucket number of the index - 1 */
+    T_LIST_NODE             HashLocal[D_MQC_MSG_QUEUE_HASH_LOCAL];  /*!< Index used until a larger one is given */
+    T_LIST_NODE             TimerList;          /*!< Messages ordered by the Deadline */
+    T_LIST_NODE             PendingList;        /*!< Messages waiting to be sent (no Packet Identifier yet) */
+    uint32_t                PendingCount;       /*!< Message number of the pending list */
+#if defined (MQC_OFFLINE_BUFFER)
+    T_LIST_NODE             OfflineList;        /*!< PUBLISH Messages kept while the session is not connected */
+    uint32_t                OfflineCount;       /*!< Message number of the offline list */
+    size_t                  OfflineSize;        /*!< Total size of the Messages of the offline list */
+#endif /* MQC_OFFLINE_BUFFER */
     uint32_t                ListCount;          /*!< Message number of the Queue */
     uint32_t                MnotonicTime;       /*!< System timer count */
-    uint16_t                PacketIdentifier;   /*!< Packet Identifier */
+    uint16_t                PacketIdentifier;   /*!< Last allocated Packet Identifier */
+    uint32_t                PacketIdentifierMap[D_MQC_PACKET_ID_MAP_SIZE];  /*!< In-use map of the Packet Identifier (1 bit for each) */
 }S_MQC_MSG_QUEUE;
 
+/**
+ * @brief      Context of the PUBLISH message delivered in chunks
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_CHUNK_CTX
+{
+    bool                    Enable;             /*!< Message is being delivered in chunks */
+    bool                    Notified;           /*!< Begin of the Message has been notified to user */
+    bool                    Discard;            /*!< Message is discarded (duplicated QoS2 Message) */
+    uint8_t                 FixedHeader;        /*!< Fixed header of the Message */
+    uint8_t*                Topic;              /*!< Topic of the Message */
+    uint16_t                TopicLength;        /*!< Topic length of the Message */
+    uint16_t                PacketIdentifier;   /*!< Packet Identifier of the Message */
+    uint32_t                VariableHeaderSize; /*!< Size of the variable header (0 means not received yet) */
+    uint32_t                TotalLength;        /*!< Total length of the payload */
+    uint32_t                Offset;             /*!< Length of the payload delivered */
+}S_MQC_CHUNK_CTX;
+
+#if defined (D_MQC_POOL_ENABLED)
+/**
+ * @brief      Fixed size pool of the session
+ * @note       A callback can stop the session while the events taken from it are notified, 
+ *             so the pool is deleted when the session and all these events have released it
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_POOL
+{
+    S_POOL_HANDLE           Handle;             /*!< Pool of the Message contexts and the small buffers (the blocks follow the structure) */
+    uint32_t                RefCount;           /*!< The session and each event list taken from it */
+}S_MQC_POOL;
+#endif /* D_MQC_POOL_ENABLED */
+
+/**
+ * @brief      Events to notify user after the session is unlocked
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_EVENT_LIST
+{
+    struct _S_MQC_EVENT*    Event;              /*!< Events in the order of occurrence */
+    uint32_t                Num;                /*!< Number of the events */
+    uint32_t                Size;               /*!< Number of the events the memory can keep */
+#if defined (D_MQC_POOL_ENABLED)
+    S_MQC_POOL*             Pool;               /*!< Pool of the objects of the events (only for the list taken from the session) */
+#endif /* D_MQC_POOL_ENABLED */
+}S_MQC_EVENT_LIST;
+
+#if defined (MQC_TOPIC_DISPATCH)
+/**
+ * @brief      Topic Filter Trie to dispatch the received PUBLISH Messages
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_TOPIC_TRIE
+{
+    struct _S_MQC_TOPIC_NODE*   Root;           /*!< Node above the first level (allocated with the first Topic Filter) */
+    struct _S_MQC_TOPIC_NODE**  Bucket;         /*!< Hash table of the nodes indexed by the parent and the level name */
+    uint32_t                    BucketNum;      /*!< Number of the buckets (power of 2) */
+    uint32_t                    NodeNum;        /*!< Number of the nodes in the hash table */
+    uint32_t                    FilterNum;      /*!< Number of the Topic Filters */
+    void*                       (*MallocFunc)(size_t);
+                                                /*!< malloc callback function */
+    void                        (*FreeFunc)(void*);
+                                                /*!< free callback function */
+}S_MQC_TOPIC_TRIE;
+#endif /* MQC_TOPIC_DISPATCH */
+
+#if defined (MQC_MQTT5)
+/**
+ * @brief      Topic Alias table of one direction of the connection
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_TOPIC_ALIAS
+{
+    struct _S_MQC_ALIAS_ENTRY*  Entry;          /*!< Topic Names indexed by the Topic Alias - 1 (NULL means no Topic Alias) */
+    uint16_t*                   Bucket;         /*!< Hash table of the entries indexed by the Topic Name (Topic Alias, 0 for the empty bucket) */
+    uint32_t                    BucketNum;      /*!< Number of the buckets (power of 2) */
+    uint16_t                    Num;            /*!< Number of the Topic Aliases (Topic Alias Maximum) */
+    uint16_t                    Used;           /*!< Number of the Topic Aliases mapped to a Topic Name */
+    uint16_t                    Head;           /*!< Topic Alias used most recently (0 means none) */
+    uint16_t                    Tail;           /*!< Topic Alias used least recently (0 means none) */
+    void*                       (*MallocFunc)(size_t);
+                                                /*!< malloc callback function */
+    void                        (*FreeFunc)(void*);
+                                                /*!< free callback function */
+}S_MQC_TOPIC_ALIAS;
+#endif /* MQC_MQTT5 */
+
+#if defined (MQC_PAYLOAD_CODEC)
+/**
+ * @brief      Codecs of the payload registered for the Topic Filters
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_CODEC_TABLE
+{
+    struct _S_MQC_CODEC_ENTRY*  Head;           /*!< Codecs in the order they were set (the first matched one is used) */
+    uint32_t                    Num;            /*!< Number of the codecs */
+    void*                       (*MallocFunc)(size_t);
+                                                /*!< malloc callback function */
+    void                        (*FreeFunc)(void*);
+                                                /*!< free callback function */
+}S_MQC_CODEC_TABLE;
+#endif /* MQC_PAYLOAD_CODEC */
+
 /**
  * @brief      MQTT session manage context
  * @author     zhaozhenge@outlook.com
@@ -96,9 +274,53 @@ typedef struct _S_MQC_SESSION_CTX
     uint32_t                TimeoutCount;       /*!< Count the timeout */
     uint32_t                SystimeCount;       /*!< System timer count with millisecond */
     uint8_t*                RecvData;           /*!< The Data recieved already */
+    uint32_t                RecvBufferSize;     /*!< The size of the buffer to store the Data recieved */
     uint32_t                RecvDataSize;       /*!< The size of Data recieved already */
     uint32_t                TotalRecvDataSize;  /*!< The total size of Data want to recieve */
     uint32_t                HeaderDataSize;     /*!< The data size of Message header (Fixed header + Remaining length)  */
+    S_MQC_CHUNK_CTX         ChunkCtx;           /*!< Context of the Message delivered in chunks */
+    uint8_t*                SendData;           /*!< The buffer to encode the Message which is not kept after sending */
+    size_t                  SendBufferSize;     /*!< The size of the buffer to encode the Message */
+    uint32_t                InflightCount;      /*!< QoS1/QoS2 PUBLISH Messages waiting for the response */
+    uint32_t                InflightPeak;       /*!< Peak of InflightCount */
+    uint32_t                PendingPeak;        /*!< Peak of the Message number of the pending list */
+#if defined (MQC_OFFLINE_BUFFER)
+    uint32_t                OfflineDropCount;   /*!< Messages discarded because the offline list was full */
+#endif /* MQC_OFFLINE_BUFFER */
+    uint8_t*                BatchData;          /*!< The buffer to coalesce the small Messages into one write */
+    size_t                  BatchBufferSize;    /*!< The size of the buffer to coalesce the Messages */
+    size_t                  BatchLength;        /*!< The size of Data waiting in the buffer to be written */
+    S_MQC_EVENT_LIST        EventList;          /*!< Events to notify user after the session is unlocked */
+#if defined (MQC_TOPIC_DISPATCH)
+    S_MQC_TOPIC_TRIE        TopicTrie;          /*!< Handlers of the Topic Filters */
+#endif /* MQC_TOPIC_DISPATCH */
+#if defined (MQC_MQTT5)
+    S_MQC_TOPIC_ALIAS       SendAlias;          /*!< Topic Aliases of the PUBLISH Messages sent by the client (for the current connection) */
+    S_MQC_TOPIC_ALIAS       RecvAlias;          /*!< Topic Aliases of the PUBLISH Messages sent by the server (for the current connection) */
+    uint8_t*                RecvAliasTopic;     /*!< Topic Name of the Topic Alias of the PUBLISH Message received last */
+    uint32_t                AliasMapCount;      /*!< PUBLISH Messages sent to map a Topic Alias to the Topic Name */
+    uint32_t                AliasHitCount;      /*!< PUBLISH Messages sent with the Topic Alias instead of the Topic Name */
+    uint64_t                AliasSavedBytes;    /*!< Bytes not sent because of the Topic Alias */
+    uint16_t                ServerReceiveMaximum;   /*!< Receive Maximum of the server (0 means no limit given by the current connection) */
+    uint32_t                ServerMaximumPacketSize;/*!< Maximum Packet Size of the server (0 means no limit given by the current connection) */
+#endif /* MQC_MQTT5 */
+#if defined (MQC_PAYLOAD_CODEC)
+    S_MQC_CODEC_TABLE       CodecTable;         /*!< Codecs of the Topic Filters */
+    uint8_t*                DecodeData;         /*!< The buffer of the decoded payload of the received Message */
+    size_t                  DecodeBufferSize;   /*!< The size of the buffer of the decoded payload */
+    uint32_t                EncodeCount;        /*!< PUBLISH Messages encoded by a codec */
+    uint64_t                EncodeRawBytes;     /*!< Payload bytes given to the codecs to encode */
+    uint64_t                EncodeBytes;        /*!< Payload bytes made by the codecs */
+    uint32_t                DecodeCount;        /*!< Received PUBLISH Messages decoded by a codec */
+    uint32_t                DecodeErrorCount;   /*!< Received PUBLISH Messages which the codec failed to decode */
+#endif /* MQC_PAYLOAD_CODEC */
+#if defined (MQC_PERSISTENCE)
+    bool                    PersistEnable;      /*!< The Messages in flight are saved into the store of PersistFunc */
+    bool                    PersistDirty;       /*!< The store is changed since the last sync */
+#endif /* MQC_PERSISTENCE */
+#if defined (D_MQC_POOL_ENABLED)
+    S_MQC_POOL*             Pool;               /*!< Fixed size pool of the Message contexts and the small buffers (NULL if no enough memory) */
+#endif /* D_MQC_POOL_ENABLED */
 }S_MQC_SESSION_CTX;
 
 #ifdef __cplusplus
@@ -29,6 +29,19 @@
  * @version     00.00.02 
  *              - 2018/12/12 : zhaozhenge@outlook.com 
  *                  -# Modify some comment
+ * @version     00.00.03 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Index the Messages by Packet Identifier
+ *                  -# Schedule the Messages by the absolute Deadline
+ *                  -# Allocate the Packet Identifier which is not in use
+ *                  -# Hold the Messages which can not be sent yet in the pending list
+ *                  -# Add MQC_MsgQueue_remaining
+ *                  -# Add MQC_MsgQueue_reserve
+ *                  -# Add the offline list
+ *                  -# Add MQC_MsgQueue_rehash
+ * @version     00.00.04 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Keep the handlers replaced by the SUBSCRIBE Message with the Topic Filter handlers
  */
 
 #ifndef _MQC_QUEUE_H_
@@ -48,6 +61,17 @@ extern "C" {
 **  Structure
 **************************************************************/
 
+/**
+ * @brief      Handler of a Topic Filter before the SUBSCRIBE Message registered its own
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_MSG_SUB_HANDLER
+{
+    bool                        Replaced;               /*!< A handler of the same Topic Filter was registered before */
+    S_MQC_TOPIC_HANDLER         Previous;               /*!< Handler registered before (restored if the Topic Filter is refused) */
+}S_MQC_MSG_SUB_HANDLER;
+
 /**
  * @brief      MQTT SUBSCRIBE Message Extra information  
  * @author     zhaozhenge@outlook.com
@@ -56,6 +80,7 @@ extern "C" {
 typedef struct _S_MQC_MSG_SUB_DATA
 {
     F_SUBSCRIBE_RES_CBFUNC      ResultFuncCB;           /*!< Result callback function */
+    S_MQC_MSG_SUB_HANDLER*      HandlerList;            /*!< Handlers replaced by the Topic Filters, kept after TopicFilterList (NULL if no handler is registered) */
     uint32_t                    ListNum;                /*!< List Count of the Topic Filter want to subscribe */
     S_MQC_UTF8_DATA             TopicFilterList[];      /*!< List of the Topic Filter want to subscribe */
 }S_MQC_MSG_SUB_DATA;
@@ -104,8 +129,10 @@ typedef union _U_MQC_MSG_EXT_DATA
 typedef struct _S_MQC_MSG_CTX
 {
     T_LIST_NODE                 Node;                   /*!< List Node information */
+    T_LIST_NODE                 HashNode;               /*!< Index Node information */
+    T_LIST_NODE                 TimerNode;              /*!< Timer Node information */
     uint32_t                    SendCount;              /*!< Send Count */
-    uint32_t                    ExpireTime;             /*!< Timeout Expire time Count */
+    uint32_t                    Deadline;               /*!< System timer count when the response times out */
     uint32_t                    Timeout;                /*!< Timeout */ 
     uint32_t                    MsgLength;              /*!< Message Length */
     uint8_t*                    MsgData;                /*!< Message Data */
@@ -140,6 +167,21 @@ extern int32_t MQC_MsgQueue_create(S_MQC_MSG_QUEUE* MsgQueue, uint32_t SysTimeCo
  */
 extern int32_t MQC_MsgQueue_delete(S_MQC_MSG_QUEUE* MsgQueue);
 
+/** 
+ * @brief               Move the index of the Messages to other lists
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           HashList                Lists of the new index (NULL means the lists kept in the handler)
+ * @param[in]           BucketNum               Number of the lists (power of 2, ignored if HashList is NULL)
+ * @return              Lists of the former index given by the caller (NULL if it was the one kept in the handler)
+ * @note                The caller frees the lists returned. The index should be moved back to the handler 
+ *                      with HashList NULL before MQC_MsgQueue_delete
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern T_LIST_NODE* MQC_MsgQueue_rehash(S_MQC_MSG_QUEUE* MsgQueue, T_LIST_NODE* HashList, uint32_t BucketNum);
+
 /** 
  * @brief               Search a Message by Packet Identifier and Message Type from the Message Queue
  * @param[in,out]       MsgQueue                Message Queue Management handler
@@ -194,6 +236,119 @@ extern S_MQC_MSG_CTX* MQC_MsgQueue_push( S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CT
  */
 extern void MQC_MsgQueue_slice(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message);
 
+/** 
+ * @brief               Let all of the Messages in the Queue time out at the next process
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              None
+ * @note                The Messages will be processed in the order they were pushed
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_MsgQueue_expire(S_MQC_MSG_QUEUE* MsgQueue);
+
+/** 
+ * @brief               Allocate a Packet Identifier which is not in use
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              The allocated Packet Identifier
+ * @note                0 will be returned if all of the Packet Identifiers are in use
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint16_t MQC_MsgQueue_allocate(S_MQC_MSG_QUEUE* MsgQueue);
+
+/** 
+ * @brief               Release a Packet Identifier when its flow completes
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           PacketIdentifier        Packet Identifier allocated by MQC_MsgQueue_allocate
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_MsgQueue_release(S_MQC_MSG_QUEUE* MsgQueue, uint16_t PacketIdentifier);
+
+/** 
+ * @brief               Mark a known Packet Identifier in use
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           PacketIdentifier        Packet Identifier of the Message resumed from the store
+ * @retval              true                    Marked
+ * @retval              false                   Out of range or already in use
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern bool MQC_MsgQueue_reserve(S_MQC_MSG_QUEUE* MsgQueue, uint16_t PacketIdentifier);
+
+/** 
+ * @brief               Hold the Message in the pending list until it can be sent
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           Message                 Message that want to be held
+ * @return              None
+ * @note                The held Message is not searched, processed nor popped until it is taken out by MQC_MsgQueue_unhold
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_MsgQueue_hold(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message);
+
+/** 
+ * @brief               Take the oldest Message out of the pending list
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              The pointer of the Message taken out
+ * @note                NULL maybe returned if the pending list is empty
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern S_MQC_MSG_CTX* MQC_MsgQueue_unhold(S_MQC_MSG_QUEUE* MsgQueue);
+
+#if defined (MQC_OFFLINE_BUFFER)
+/** 
+ * @brief               Keep a PUBLISH Message in the offline list until the session is connected
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           Message                 Message that want to be kept
+ * @return              None
+ * @note                The kept Message is not searched, processed nor popped until it is taken out by MQC_MsgQueue_unpark
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_MsgQueue_park(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message);
+
+/** 
+ * @brief               Take the oldest Message out of the offline list
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              The pointer of the Message taken out
+ * @note                NULL maybe returned if the offline list is empty
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern S_MQC_MSG_CTX* MQC_MsgQueue_unpark(S_MQC_MSG_QUEUE* MsgQueue);
+
+/** 
+ * @brief               Get the oldest Message of the offline list without taking it out
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              The pointer of the oldest Message
+ * @note                NULL maybe returned if the offline list is empty
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern S_MQC_MSG_CTX* MQC_MsgQueue_parked(S_MQC_MSG_QUEUE* MsgQueue);
+#endif /* MQC_OFFLINE_BUFFER */
+
 /** 
  * @brief               Judge if the Message Queue is empty
  * @param[in,out]       MsgQueue        Message Queue Management handler
@@ -206,6 +361,19 @@ extern void MQC_MsgQueue_slice(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message
  */
 extern bool MQC_MsgQueue_empty( S_MQC_MSG_QUEUE* MsgQueue );
 
+/** 
+ * @brief               Get the time until the earliest Deadline of the Messages
+ * @param[in,out]       MsgQueue        Message Queue Management handler
+ * @param[in]           SysTimeCount    Now System timer count
+ * @return              Milliseconds until the earliest Deadline (0 when it has passed) \n
+ *                      D_MQC_DEADLINE_INFINITE when no Message waits for the response
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint32_t MQC_MsgQueue_remaining( S_MQC_MSG_QUEUE* MsgQueue, uint32_t SysTimeCount );
+
 /** 
  * @brief               Message Queue process iterator
  * @param[in,out]       MsgQueue                Message Queue Management handler
@@ -0,0 +1,172 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @file        MQC_trie.h
+ * @brief       MQTT Client Libary Topic Filter Trie Header
+ * @details     Each node of the trie is one level of the Topic Filters. The children of all nodes are indexed
+ *              by one hash table with the parent node and the level name, so a topic is matched level by level
+ *              without visiting the other subscriptions.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Add MQC_TopicTrie_search
+ */
+
+#ifndef _MQC_TRIE_H_
+#define _MQC_TRIE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "MQC_api.h"
+
+#if defined (MQC_TOPIC_DISPATCH)
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      One level of the Topic Filters
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_TOPIC_NODE
+{
+    struct _S_MQC_TOPIC_NODE*   Parent;             /*!< Node of the upper level (NULL for the root) */
+    struct _S_MQC_TOPIC_NODE*   HashNext;           /*!< Next node in the same bucket of the hash table */
+    struct _S_MQC_TOPIC_NODE*   PlusChild;          /*!< Child of the single-level wildcard '+' */
+    struct _S_MQC_TOPIC_NODE*   HashChild;          /*!< Child of the multi-level wildcard '#' */
+    uint32_t                    ChildNum;           /*!< Number of the children */
+    uint32_t                    HashValue;          /*!< Hash value of the parent and the level name */
+    bool                        Subscribed;         /*!< A Topic Filter ends at this level */
+    S_MQC_TOPIC_HANDLER         Handler;            /*!< Handler of the Topic Filter */
+    uint16_t                    Length;             /*!< Length of the level name */
+    uint8_t                     Level[];            /*!< Level name */
+}S_MQC_TOPIC_NODE;
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Create a Topic Filter Trie
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           MallocFunc              malloc callback function
+ * @param[in]           FreeFunc                free callback function
+ * @retval              D_MQC_RET_OK
+ * @note                No memory is allocated until the first Topic Filter is inserted
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_create(S_MQC_TOPIC_TRIE* Trie, void* (*MallocFunc)(size_t), void (*FreeFunc)(void*));
+
+/**
+ * @brief               Delete a Topic Filter Trie and all Topic Filters in it
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_delete(S_MQC_TOPIC_TRIE* Trie);
+
+/**
+ * @brief               Insert a Topic Filter with its handler
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Handler                 Handler of the Topic Filter
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                The handler of the same Topic Filter inserted before is replaced
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_insert(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* TopicFilter, const S_MQC_TOPIC_HANDLER* Handler);
+
+/**
+ * @brief               Remove a Topic Filter
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           TopicFilter             Topic Filter
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_NOTIFY     The Topic Filter is not in the trie
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_remove(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* TopicFilter);
+
+/**
+ * @brief               Get the handler of a Topic Filter
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[out]          Handler                 Handler of the Topic Filter
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_NOTIFY     The Topic Filter is not in the trie
+ * @note                The Topic Filter is compared as it is, the wildcards are not matched
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_search(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* TopicFilter, S_MQC_TOPIC_HANDLER* Handler);
+
+/**
+ * @brief               Find the handlers of all Topic Filters which match a topic
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           Topic                   Topic Name of the PUBLISH Message
+ * @param[in]           MatchFuncCB             Callback function called for each matched Topic Filter
+ * @param[in]           UsrData                 User Data used for callback function
+ * @return              Number of the matched Topic Filters
+ * @note                The cost is proportional to the levels of the topic (and the wildcard branches),
+ *                      not to the number of the Topic Filters. \n
+ *                      The topic beginning with '$' does not match the Topic Filters beginning with a wildcard.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint32_t MQC_TopicTrie_match(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* Topic,
+                                    void (*MatchFuncCB)(const S_MQC_TOPIC_HANDLER* Handler, void* UsrData), void* UsrData);
+
+#endif /* MQC_TOPIC_DISPATCH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MQC_TRIE_H_ */
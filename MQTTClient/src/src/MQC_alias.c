@@ -0,0 +1,459 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @file        MQC_alias.c
+ * @brief       MQTT Client Library Topic Alias Table
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <string.h>
+#include "../inc/MQC_alias.h"
+
+#if defined (MQC_MQTT5)
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Calculate the hash value of a Topic Name
+ * @param[in]           Topic                   Topic Name
+ * @return              Hash value
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvHash(const S_MQC_UTF8_DATA* Topic)
+{
+    /* FNV-1a of the Topic Name */
+    uint32_t    Hash    =   2166136261u;
+    uint16_t    i       =   0;
+
+    for(i = 0; i < Topic->Length; i++)
+    {
+        Hash = (Hash ^ Topic->Data[i]) * 16777619u;
+    }
+    return Hash;
+}
+
+/**
+ * @brief               Get the entry of a Topic Alias
+ * @param[in]           Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias (1 to the number of the Topic Aliases)
+ * @return              The entry
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static S_MQC_ALIAS_ENTRY* prvEntry(const S_MQC_TOPIC_ALIAS* Table, uint16_t Alias)
+{
+    return &Table->Entry[Alias - 1];
+}
+
+/**
+ * @brief               Link a Topic Alias at the head of the recently used list
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvPushHead(S_MQC_TOPIC_ALIAS* Table, uint16_t Alias)
+{
+    S_MQC_ALIAS_ENTRY*  Entry   =   prvEntry(Table, Alias);
+
+    Entry->Prev = 0;
+    Entry->Next = Table->Head;
+    if(Table->Head)
+    {
+        prvEntry(Table, Table->Head)->Prev = Alias;
+    }
+    else
+    {
+        Table->Tail = Alias;
+    }
+    Table->Head = Alias;
+}
+
+/**
+ * @brief               Unlink a Topic Alias from the recently used list
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvUnlinkList(S_MQC_TOPIC_ALIAS* Table, uint16_t Alias)
+{
+    S_MQC_ALIAS_ENTRY*  Entry   =   prvEntry(Table, Alias);
+
+    if(Entry->Prev)
+    {
+        prvEntry(Table, Entry->Prev)->Next = Entry->Next;
+    }
+    else
+    {
+        Table->Head = Entry->Next;
+    }
+    if(Entry->Next)
+    {
+        prvEntry(Table, Entry->Next)->Prev = Entry->Prev;
+    }
+    else
+    {
+        Table->Tail = Entry->Prev;
+    }
+    Entry->Prev = 0;
+    Entry->Next = 0;
+}
+
+/**
+ * @brief               Map a Topic Alias to a Topic Name copied already
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias (not mapped)
+ * @param[in]           Copy                    Copy of the Topic Name (owned by the table after the call)
+ * @param[in]           Length                  Length of the Topic Name
+ * @param[in]           HashValue               Hash value of the Topic Name
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMap(S_MQC_TOPIC_ALIAS* Table, uint16_t Alias, uint8_t* Copy, uint16_t Length, uint32_t HashValue)
+{
+    S_MQC_ALIAS_ENTRY*  Entry   =   prvEntry(Table, Alias);
+    uint16_t*           Bucket  =   &Table->Bucket[HashValue & (Table->BucketNum - 1)];
+
+    Entry->Topic        = Copy;
+    Entry->Length       = Length;
+    Entry->HashValue    = HashValue;
+    Entry->HashNext     = *Bucket;
+    *Bucket             = Alias;
+    prvPushHead(Table, Alias);
+    Table->Used++;
+    return;
+}
+
+/**
+ * @brief               Remove the Topic Name mapped to a Topic Alias
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias (mapped)
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvUnmap(S_MQC_TOPIC_ALIAS* Table, uint16_t Alias)
+{
+    S_MQC_ALIAS_ENTRY*  Entry   =   prvEntry(Table, Alias);
+    uint16_t*           Link    =   &Table->Bucket[Entry->HashValue & (Table->BucketNum - 1)];
+
+    while(Alias != *Link)
+    {
+        Link = &prvEntry(Table, *Link)->HashNext;
+    }
+    *Link = Entry->HashNext;
+    prvUnlinkList(Table, Alias);
+    Table->FreeFunc(Entry->Topic);
+    memset(Entry, 0, sizeof(S_MQC_ALIAS_ENTRY));
+    Table->Used--;
+    return;
+}
+
+/**
+ * @brief               Copy a Topic Name
+ * @param[in]           Table                   Topic Alias table
+ * @param[in]           Topic                   Topic Name
+ * @return              The copy (NULL for no enough memory)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint8_t* prvCopy(const S_MQC_TOPIC_ALIAS* Table, const S_MQC_UTF8_DATA* Topic)
+{
+    /* one byte at least, so the mapped entry never has a NULL Topic */
+    uint8_t*    Copy    =   (uint8_t*)Table->MallocFunc((Topic->Length)?(Topic->Length):(1));
+
+    if( (Copy) && (Topic->Length) )
+    {
+        memcpy(Copy, Topic->Data, Topic->Length);
+    }
+    return Copy;
+}
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Create a Topic Alias table
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Num                     Number of the Topic Aliases (Topic Alias Maximum)
+ * @param[in]           MallocFunc              malloc callback function
+ * @param[in]           FreeFunc                free callback function
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                No memory is allocated if \a Num is 0, and the table has no Topic Alias
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicAlias_create(S_MQC_TOPIC_ALIAS* Table, uint16_t Num, void* (*MallocFunc)(size_t), void (*FreeFunc)(void*))
+{
+    memset(Table, 0, sizeof(S_MQC_TOPIC_ALIAS));
+    Table->MallocFunc   = MallocFunc;
+    Table->FreeFunc     = FreeFunc;
+    if(!Num)
+    {
+        return D_MQC_RET_OK;
+    }
+
+    Table->BucketNum = 1;
+    while(Table->BucketNum < Num)
+    {
+        Table->BucketNum <<= 1;
+    }
+    Table->Entry    = (S_MQC_ALIAS_ENTRY*)MallocFunc(sizeof(S_MQC_ALIAS_ENTRY) * Num);
+    Table->Bucket   = (uint16_t*)MallocFunc(sizeof(uint16_t) * Table->BucketNum);
+    if( (!Table->Entry) || (!Table->Bucket) )
+    {
+        (void)MQC_TopicAlias_delete(Table);
+        Table->MallocFunc   = MallocFunc;
+        Table->FreeFunc     = FreeFunc;
+        return D_MQC_RET_NO_MEMORY;
+    }
+    memset(Table->Entry, 0, sizeof(S_MQC_ALIAS_ENTRY) * Num);
+    memset(Table->Bucket, 0, sizeof(uint16_t) * Table->BucketNum);
+    Table->Num = Num;
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Delete a Topic Alias table and all Topic Names in it
+ * @param[in,out]       Table                   Topic Alias table
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicAlias_delete(S_MQC_TOPIC_ALIAS* Table)
+{
+    uint16_t    i   =   0;
+
+    if(Table->Entry)
+    {
+        for(i = 0; i < Table->Num; i++)
+        {
+            if(Table->Entry[i].Topic)
+            {
+                Table->FreeFunc(Table->Entry[i].Topic);
+            }
+        }
+        Table->FreeFunc(Table->Entry);
+    }
+    if(Table->Bucket)
+    {
+        Table->FreeFunc(Table->Bucket);
+    }
+    memset(Table, 0, sizeof(S_MQC_TOPIC_ALIAS));
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Search the Topic Alias mapped to a Topic Name
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Topic                   Topic Name
+ * @return              Topic Alias (0 means the Topic Name is not mapped)
+ * @note                The Topic Alias found becomes the most recently used one
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint16_t MQC_TopicAlias_search(S_MQC_TOPIC_ALIAS* Table, const S_MQC_UTF8_DATA* Topic)
+{
+    uint32_t            HashValue   =   0;
+    uint16_t            Alias       =   0;
+    S_MQC_ALIAS_ENTRY*  Entry       =   NULL;
+
+    if(!Table->Used)
+    {
+        return 0;
+    }
+
+    HashValue   = prvHash(Topic);
+    Alias       = Table->Bucket[HashValue & (Table->BucketNum - 1)];
+    while(Alias)
+    {
+        Entry = prvEntry(Table, Alias);
+        if( (HashValue == Entry->HashValue) && (Topic->Length == Entry->Length)
+         && (!memcmp(Topic->Data, Entry->Topic, Topic->Length)) )
+        {
+            if(Alias != Table->Head)
+            {
+                prvUnlinkList(Table, Alias);
+                prvPushHead(Table, Alias);
+            }
+            return Alias;
+        }
+        Alias = Entry->HashNext;
+    }
+    return 0;
+}
+
+/**
+ * @brief               Map a Topic Alias to a Topic Name which is not mapped yet
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Topic                   Topic Name
+ * @return              Topic Alias (0 means no Topic Alias or no enough memory)
+ * @note                A free Topic Alias is used first, then the least recently used one is mapped again
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint16_t MQC_TopicAlias_insert(S_MQC_TOPIC_ALIAS* Table, const S_MQC_UTF8_DATA* Topic)
+{
+    uint8_t*    Copy    =   NULL;
+    uint16_t    Alias   =   0;
+
+    if(!Table->Num)
+    {
+        return 0;
+    }
+
+    /* copy first, so the table is not changed if no enough memory */
+    Copy = prvCopy(Table, Topic);
+    if(!Copy)
+    {
+        return 0;
+    }
+
+    if(Table->Used < Table->Num)
+    {
+        /* the Topic Aliases are mapped in order and only mapped again after all are used */
+        Alias = Table->Used + 1;
+    }
+    else
+    {
+        Alias = Table->Tail;
+        prvUnmap(Table, Alias);
+    }
+    prvMap(Table, Alias, Copy, Topic->Length, prvHash(Topic));
+    return Alias;
+}
+
+/**
+ * @brief               Map a given Topic Alias to a Topic Name
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias
+ * @param[in]           Topic                   Topic Name
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA    The Topic Alias is out of the range
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                The Topic Name mapped to the Topic Alias before is replaced
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicAlias_set(S_MQC_TOPIC_ALIAS* Table, uint16_t Alias, const S_MQC_UTF8_DATA* Topic)
+{
+    S_MQC_ALIAS_ENTRY*  Entry   =   NULL;
+    uint8_t*            Copy    =   NULL;
+
+    if( (!Alias) || (Alias > Table->Num) )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+
+    Entry = prvEntry(Table, Alias);
+    if( (Entry->Topic) && (Topic->Length == Entry->Length)
+     && (!memcmp(Topic->Data, Entry->Topic, Topic->Length)) )
+    {
+        /* the server sends the Topic Name again with the same Topic Alias */
+        return D_MQC_RET_OK;
+    }
+
+    Copy = prvCopy(Table, Topic);
+    if(!Copy)
+    {
+        return D_MQC_RET_NO_MEMORY;
+    }
+    if(Entry->Topic)
+    {
+        prvUnmap(Table, Alias);
+    }
+    prvMap(Table, Alias, Copy, Topic->Length, prvHash(Topic));
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Get the Topic Name mapped to a Topic Alias
+ * @param[in,out]       Table                   Topic Alias table
+ * @param[in]           Alias                   Topic Alias
+ * @param[out]          Topic                   Topic Name (kept in the table until the Topic Alias is mapped again)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA    The Topic Alias is out of the range or not mapped
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicAlias_get(S_MQC_TOPIC_ALIAS* Table, uint16_t Alias, S_MQC_UTF8_DATA* Topic)
+{
+    S_MQC_ALIAS_ENTRY*  Entry   =   NULL;
+
+    if( (!Alias) || (Alias > Table->Num) )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+
+    Entry = prvEntry(Table, Alias);
+    if(!Entry->Topic)
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    Topic->Data     = Entry->Topic;
+    Topic->Length   = Entry->Length;
+    return D_MQC_RET_OK;
+}
+
+#endif /* MQC_MQTT5 */
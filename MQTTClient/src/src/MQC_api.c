@@ -29,6 +29,16 @@
  * @version     00.00.02 
  *              - 2018/12/17 : zhaozhenge@outlook.com 
  *                  -# Improvement for param check
+ * @version     00.00.03 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add MQC_Statistics
+ *                  -# Add MQC_Flush
+ *                  -# Add MQC_SubscribeHandler
+ *                  -# Add MQC_NextDeadline
+ *                  -# Check the callback functions of PersistFunc
+ *                  -# Check the policy of the offline buffer
+ *                  -# Check the protocol version
+ *                  -# Add MQC_CodecSet and MQC_CodecLz
  */
 
 /**************************************************************
@@ -36,6 +46,7 @@
 **************************************************************/
 
 #include "../inc/MQC_core.h"
+#include "../inc/MQC_codec.h"
 
 /**************************************************************
 **  Interface
@@ -106,6 +117,28 @@ MQC_EXTERN int32_t MQC_Start(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
     {
         MQCHandler->Authorition.PasswordEnable = false;
     }
+#if defined (MQC_PERSISTENCE)
+    if(MQCHandler->PersistFunc)
+    {
+        if( !MQCHandler->PersistFunc->SaveFuncCB || !MQCHandler->PersistFunc->DeleteFuncCB
+           || !MQCHandler->PersistFunc->ClearFuncCB || !MQCHandler->PersistFunc->LoadFuncCB )
+        {
+            return D_MQC_RET_BAD_INPUT_DATA;
+        }
+    }
+#endif /* MQC_PERSISTENCE */
+#if defined (MQC_OFFLINE_BUFFER)
+    if( MQCHandler->OfflineMaxNum && (E_MQC_OFFLINE_BLOCK < MQCHandler->OfflinePolicy) )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+#endif /* MQC_OFFLINE_BUFFER */
+#if defined (MQC_MQTT5)
+    if(E_MQC_PROTOCOL_V5 < MQCHandler->ProtocolVersion)
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+#endif /* MQC_MQTT5 */
     /* Core Start */
     return MQC_CoreStart(MQCHandler, SystimeCount);
 }
@@ -223,6 +256,7 @@ MQC_EXTERN int32_t MQC_Reset(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Timeout)
  * @retval              D_MQC_RET_BAD_SEQUEUE
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_BAD_INPUT_DATA
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/19
@@ -244,6 +278,51 @@ MQC_EXTERN int32_t MQC_Subscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DA
     return MQC_CoreSubscribe( MQCHandler, TopicFilterList, QoSList, ListNum, ResultFuncCB);
 }
 
+#if defined (MQC_TOPIC_DISPATCH)
+/** 
+ * @brief               Subscribe topic via MQTT Session with a handler for each Topic Filter.
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilterList         Topic Filter List
+ * @param[in]           QoSList                 Topic Filter's QoS List
+ * @param[in]           HandlerList             Topic Filter's Handler List
+ * @param[in]           ListNum                 Count of the topic filter list
+ * @param[in]           ResultFuncCB            Callback function will be called to notify if received Server Response
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_SEQUEUE
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_SubscribeHandler(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, S_MQC_TOPIC_HANDLER* HandlerList, uint32_t ListNum, F_SUBSCRIBE_RES_CBFUNC ResultFuncCB)
+{
+    uint32_t    i   =   0;
+    
+    /* Check the input parameter */
+    if(!MQCHandler)
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    if( !TopicFilterList || !QoSList || !HandlerList || !ListNum )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    for(i = 0; i < ListNum; i++)
+    {
+        if(!HandlerList[i].HandlerFuncCB)
+        {
+            return D_MQC_RET_BAD_INPUT_DATA;
+        }
+    }
+    /* Core Subscribe */
+    return MQC_CoreSubscribeHandler( MQCHandler, TopicFilterList, QoSList, HandlerList, ListNum, ResultFuncCB);
+}
+#endif /* MQC_TOPIC_DISPATCH */
+
 /** 
  * @brief               Cancel a subscribed topic via MQTT Session.
  * @param[in,out]       MQCHandler              MQTT client handler
@@ -254,6 +333,7 @@ MQC_EXTERN int32_t MQC_Subscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DA
  * @retval              D_MQC_RET_BAD_SEQUEUE
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_BAD_INPUT_DATA
  * @author              zhaozhenge@outlook.com
  * @date                2018/12/04
@@ -285,8 +365,11 @@ MQC_EXTERN int32_t MQC_Unsubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_CALLBACK_ERROR
  * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @retval              D_MQC_RET_NO_NOTIFY     The message is discarded by the full offline buffer (E_MQC_OFFLINE_DROP_NEWEST)
+ * @note                With OfflineMaxNum, the message published before MQC_Open or after MQC_Close is kept in the offline buffer
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/19
  * @callgraph
@@ -389,3 +472,126 @@ MQC_EXTERN void MQC_Continue(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
     }
     return;
 }
+
+/** 
+ * @brief               Get the time until MQC_Continue has work to do next
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           SystimeCount            System timer count with millisecond
+ * @return              Milliseconds until the next retry, keep alive or CONNACK timeout (0 means call MQC_Continue now) \n
+ *                      D_MQC_DEADLINE_INFINITE when no timer is running
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN uint32_t MQC_NextDeadline(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeCount)
+{
+    /* Check the input parameter */
+    if(!MQCHandler)
+    {
+        return D_MQC_DEADLINE_INFINITE;
+    }
+    /* Core NextDeadline */
+    return MQC_CoreNextDeadline(MQCHandler, SystimeCount);
+}
+
+/** 
+ * @brief               Get the statistics of the MQTT Session
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[out]          Statistics              Statistics of the MQTT Session
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_Statistics(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_STATISTICS* Statistics)
+{
+    /* Check the input parameter */
+    if( (!MQCHandler) || (!Statistics) )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    /* Core Statistics */
+    return MQC_CoreStatistics(MQCHandler, Statistics);
+}
+
+/** 
+ * @brief               Write the Messages waiting in the output batch at once
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_Flush(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    /* Check the input parameter */
+    if(!MQCHandler)
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    /* Core Flush */
+    return MQC_CoreFlush(MQCHandler);
+}
+
+#if defined (MQC_PAYLOAD_CODEC)
+/** 
+ * @brief               Set the codec of the payload of the PUBLISH Messages with the Topics matched by a Topic Filter
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Codec                   Codec of the Topic Filter (copied, NULL means remove the codec)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_CodecSet(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilter, const S_MQC_CODEC* Codec)
+{
+    /* Check the input parameter */
+    if( (!MQCHandler) || (!TopicFilter) )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    if( Codec && ( (!Codec->BoundFuncCB) || (!Codec->EncodeFuncCB) || (!Codec->DecodeFuncCB) ) )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    /* Core CodecSet */
+    return MQC_CoreCodecSet(MQCHandler, TopicFilter, Codec);
+}
+
+#if defined (CLIB_LZ_MODULE_ENABLED)
+/** 
+ * @brief               Fill the callback functions of the built-in LZ codec
+ * @param[out]          Codec                   Codec
+ * @param[in]           Dict                    Preset dictionary shared with the other side (NULL means none)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @hidecallergraph
+ */
+MQC_EXTERN int32_t MQC_CodecLz(S_MQC_CODEC* Codec, S_MQC_CODEC_DICT* Dict)
+{
+    /* Check the input parameter */
+    if( (!Codec) || ( Dict && (!Dict->Data) && Dict->Size ) )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    MQC_Codec_lz(Codec, Dict);
+    return D_MQC_RET_OK;
+}
+#endif /* CLIB_LZ_MODULE_ENABLED */
+#endif /* MQC_PAYLOAD_CODEC */
@@ -0,0 +1,379 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @file        MQC_codec.c
+ * @brief       MQTT Client Library Payload Codec Table
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <string.h>
+#include "../inc/MQC_codec.h"
+
+#if defined (MQC_PAYLOAD_CODEC)
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_MQC_CODEC_LEVEL_SEPARATOR     ('/')   /*!< Topic level separator */
+#define D_MQC_CODEC_SINGLE_WILDCARD     ('+')   /*!< Single-level wildcard */
+#define D_MQC_CODEC_MULTI_WILDCARD      ('#')   /*!< Multi-level wildcard */
+#define D_MQC_CODEC_SYSTEM_PREFIX       ('$')   /*!< Prefix of the topics used by the server */
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Check the format of a Topic Filter
+ * @param[in]           TopicFilter             Topic Filter
+ * @retval              true                    The wildcards are used correctly
+ * @retval              false                   Bad Topic Filter
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvFilterCheck(const S_MQC_UTF8_DATA* TopicFilter)
+{
+    uint16_t    i       =   0;
+
+    if( (!TopicFilter->Data) || (!TopicFilter->Length) )
+    {
+        return false;
+    }
+    for(i = 0; i < TopicFilter->Length; i++)
+    {
+        if( (D_MQC_CODEC_SINGLE_WILDCARD != TopicFilter->Data[i]) && (D_MQC_CODEC_MULTI_WILDCARD != TopicFilter->Data[i]) )
+        {
+            continue;
+        }
+        /* The wildcard must occupy an entire level */
+        if( (i && (D_MQC_CODEC_LEVEL_SEPARATOR != TopicFilter->Data[i - 1])) ||
+            ((i + 1 < TopicFilter->Length) && (D_MQC_CODEC_LEVEL_SEPARATOR != TopicFilter->Data[i + 1])) )
+        {
+            return false;
+        }
+        /* '#' must be the last level */
+        if( (D_MQC_CODEC_MULTI_WILDCARD == TopicFilter->Data[i]) && (i + 1 != TopicFilter->Length) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief               Check if a Topic Filter matches a Topic
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Topic                   Topic Name
+ * @retval              true                    Matched
+ * @retval              false                   Not matched
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvTopicMatch(const S_MQC_UTF8_DATA* TopicFilter, const S_MQC_UTF8_DATA* Topic)
+{
+    const uint8_t*  Filter      =   TopicFilter->Data;
+    const uint8_t*  FilterEnd   =   TopicFilter->Data + TopicFilter->Length;
+    const uint8_t*  Name        =   Topic->Data;
+    const uint8_t*  NameEnd     =   Topic->Data + Topic->Length;
+
+    /* The topics used by the server are not matched by a wildcard of the first level */
+    if( (Name < NameEnd) && (D_MQC_CODEC_SYSTEM_PREFIX == Name[0]) &&
+        ( (D_MQC_CODEC_SINGLE_WILDCARD == Filter[0]) || (D_MQC_CODEC_MULTI_WILDCARD == Filter[0]) ) )
+    {
+        return false;
+    }
+    while(Filter < FilterEnd)
+    {
+        if(D_MQC_CODEC_MULTI_WILDCARD == *Filter)
+        {
+            return true;
+        }
+        if(D_MQC_CODEC_SINGLE_WILDCARD == *Filter)
+        {
+            /* Skip one level of the Topic */
+            for(Filter++; (Name < NameEnd) && (D_MQC_CODEC_LEVEL_SEPARATOR != *Name); Name++);
+        }
+        else
+        {
+            for(; (Filter < FilterEnd) && (D_MQC_CODEC_LEVEL_SEPARATOR != *Filter); Filter++, Name++)
+            {
+                if( (Name == NameEnd) || (*Name != *Filter) )
+                {
+                    return false;
+                }
+            }
+            if( (Name < NameEnd) && (D_MQC_CODEC_LEVEL_SEPARATOR != *Name) )
+            {
+                return false;
+            }
+        }
+        /* Both are at the end of the level */
+        if(Filter == FilterEnd)
+        {
+            break;
+        }
+        Filter++;
+        if(Name == NameEnd)
+        {
+            /* "a/#" also matches "a" */
+            return ( (Filter + 1 == FilterEnd) && (D_MQC_CODEC_MULTI_WILDCARD == *Filter) );
+        }
+        Name++;
+    }
+    return (Name == NameEnd);
+}
+
+#if defined (CLIB_LZ_MODULE_ENABLED)
+/**
+ * @brief               Maximum size of the payload encoded by the built-in LZ codec
+ * @param[in]           Ctx                     Preset dictionary
+ * @param[in]           Length                  Size of the payload
+ * @return              Maximum size of the encoded payload
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static size_t prvLzBound(void* Ctx, size_t Length)
+{
+    return CLIB_LZ_BOUND(Length);
+}
+
+/**
+ * @brief               Encode the payload by the built-in LZ codec
+ * @param[in]           Ctx                     Preset dictionary
+ * @param[in]           Src                     Payload
+ * @param[in]           Srclen                  Size of the payload
+ * @param[out]          Dst                     Encoded payload
+ * @param[in,out]       Dstlen                  [in] Size of Dst [out] Size of the encoded payload
+ * @retval              0                       success
+ * @retval              -1                      fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvLzEncode(void* Ctx, const uint8_t* Src, size_t Srclen, uint8_t* Dst, size_t* Dstlen)
+{
+    S_MQC_CODEC_DICT*   Dict    =   (S_MQC_CODEC_DICT*)Ctx;
+
+    return CLIB_lz_compress( (Dict)?(Dict->Data):(NULL), (Dict)?(Dict->Size):(0), Src, Srclen, Dst, Dstlen );
+}
+
+/**
+ * @brief               Decode the payload by the built-in LZ codec
+ * @param[in]           Ctx                     Preset dictionary
+ * @param[in]           Src                     Encoded payload
+ * @param[in]           Srclen                  Size of the encoded payload
+ * @param[out]          Dst                     Payload (NULL means only get the size)
+ * @param[in,out]       Dstlen                  [in] Size of Dst [out] Size of the payload
+ * @retval              0                       success
+ * @retval              -1                      fail
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvLzDecode(void* Ctx, const uint8_t* Src, size_t Srclen, uint8_t* Dst, size_t* Dstlen)
+{
+    S_MQC_CODEC_DICT*   Dict    =   (S_MQC_CODEC_DICT*)Ctx;
+
+    if(!Dst)
+    {
+        return CLIB_lz_size(Src, Srclen, Dstlen);
+    }
+    return CLIB_lz_decompress( (Dict)?(Dict->Data):(NULL), (Dict)?(Dict->Size):(0), Src, Srclen, Dst, Dstlen );
+}
+#endif /* CLIB_LZ_MODULE_ENABLED */
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Create a codec table
+ * @param[in,out]       Table                   Codec table
+ * @param[in]           MallocFunc              malloc callback function
+ * @param[in]           FreeFunc                free callback function
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_Codec_create(S_MQC_CODEC_TABLE* Table, void* (*MallocFunc)(size_t), void (*FreeFunc)(void*))
+{
+    /* Internal module , do not need to check the input data */
+    memset(Table, 0, sizeof(S_MQC_CODEC_TABLE));
+    Table->MallocFunc = MallocFunc;
+    Table->FreeFunc = FreeFunc;
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Delete a codec table and all codecs in it
+ * @param[in,out]       Table                   Codec table
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_Codec_delete(S_MQC_CODEC_TABLE* Table)
+{
+    S_MQC_CODEC_ENTRY*  Entry   =   NULL;
+    S_MQC_CODEC_ENTRY*  Next    =   NULL;
+
+    for(Entry = Table->Head; Entry; Entry = Next)
+    {
+        Next = Entry->Next;
+        Table->FreeFunc(Entry);
+    }
+    memset(Table, 0, sizeof(S_MQC_CODEC_TABLE));
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Set or remove the codec of a Topic Filter
+ * @param[in,out]       Table                   Codec table
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Codec                   Codec (NULL means remove the codec of the Topic Filter)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA    Bad Topic Filter
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                The codec of the same Topic Filter is replaced and keeps its order
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_Codec_set(S_MQC_CODEC_TABLE* Table, const S_MQC_UTF8_DATA* TopicFilter, const S_MQC_CODEC* Codec)
+{
+    S_MQC_CODEC_ENTRY**     Link    =   &(Table->Head);
+    S_MQC_CODEC_ENTRY*      Entry   =   NULL;
+
+    if(!prvFilterCheck(TopicFilter))
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+    for(; *Link; Link = &((*Link)->Next))
+    {
+        if( ((*Link)->TopicFilter.Length == TopicFilter->Length) &&
+            (!memcmp((*Link)->TopicFilter.Data, TopicFilter->Data, TopicFilter->Length)) )
+        {
+            break;
+        }
+    }
+    if(*Link)
+    {
+        Entry = *Link;
+        if(Codec)
+        {
+            Entry->Codec = *Codec;
+        }
+        else
+        {
+            *Link = Entry->Next;
+            Table->FreeFunc(Entry);
+            Table->Num--;
+        }
+        return D_MQC_RET_OK;
+    }
+    if(!Codec)
+    {
+        /* Nothing to remove */
+        return D_MQC_RET_OK;
+    }
+    /* Add to the tail */
+    Entry = (S_MQC_CODEC_ENTRY*)Table->MallocFunc(sizeof(S_MQC_CODEC_ENTRY) + TopicFilter->Length);
+    if(!Entry)
+    {
+        return D_MQC_RET_NO_MEMORY;
+    }
+    Entry->Next = NULL;
+    Entry->Codec = *Codec;
+    Entry->TopicFilter.Data = (uint8_t*)(Entry + 1);
+    Entry->TopicFilter.Length = TopicFilter->Length;
+    memcpy(Entry->TopicFilter.Data, TopicFilter->Data, TopicFilter->Length);
+    *Link = Entry;
+    Table->Num++;
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Find the codec of a Topic
+ * @param[in]           Table                   Codec table
+ * @param[in]           Topic                   Topic Name
+ * @return              Codec of the first Topic Filter which matches the Topic (NULL means none)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern const S_MQC_CODEC* MQC_Codec_search(const S_MQC_CODEC_TABLE* Table, const S_MQC_UTF8_DATA* Topic)
+{
+    const S_MQC_CODEC_ENTRY*    Entry   =   NULL;
+
+    for(Entry = Table->Head; Entry; Entry = Entry->Next)
+    {
+        if(prvTopicMatch(&(Entry->TopicFilter), Topic))
+        {
+            return &(Entry->Codec);
+        }
+    }
+    return NULL;
+}
+
+#if defined (CLIB_LZ_MODULE_ENABLED)
+/**
+ * @brief               Fill the callback functions of the built-in LZ codec
+ * @param[out]          Codec                   Codec
+ * @param[in]           Dict                    Preset dictionary (NULL means none)
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_Codec_lz(S_MQC_CODEC* Codec, S_MQC_CODEC_DICT* Dict)
+{
+    Codec->BoundFuncCB  = prvLzBound;
+    Codec->EncodeFuncCB = prvLzEncode;
+    Codec->DecodeFuncCB = prvLzDecode;
+    Codec->Ctx          = Dict;
+    return;
+}
+#endif /* CLIB_LZ_MODULE_ENABLED */
+
+#endif /* MQC_PAYLOAD_CODEC */
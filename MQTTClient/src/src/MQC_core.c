@@ -35,6 +35,34 @@
  * @version     00.00.04 
  *              - 2018/12/18 : zhaozhenge@outlook.com 
  *                  -# Set message content to NULL, when message length is 0
+ * @version     00.00.05 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Parse the received data by message frame instead of byte by byte
+ *                  -# Reuse the receive buffer of the session for the received messages
+ *                  -# Deliver the big PUBLISH message in chunks
+ *                  -# Encode the sent messages in one pass into the caller or session buffer
+ *                  -# Send the QoS0 PUBLISH message in segments by WriteVecFuncCB without copy
+ *                  -# Let the Message Queue schedule the retry by the Deadline of the Messages
+ *                  -# Allocate the Packet Identifier which is not in use and release it when the flow completes
+ *                  -# Limit the QoS1/QoS2 PUBLISH Messages in flight by MaxInflight and hold the others in the pending list
+ *                  -# Coalesce the small Messages into one write by the output batch
+ *                  -# Take the Message contexts and the small buffers from the fixed size pool of the session
+ *                  -# Notify user the events after the session is unlocked instead of unlocking for each callback
+ *                  -# Dispatch the received PUBLISH Messages to the handlers of the matched Topic Filters
+ *                  -# Tell the time until MQC_CoreContinue has work to do
+ *                  -# Save the Messages in flight into the store of PersistFunc and resume them at start
+ *                  -# Keep the PUBLISH Messages in the offline buffer while the session is not connected
+ *                  -# Support MQTT 5.0 and send the repeated Topic Names of the PUBLISH Messages by the Topic Alias
+ *                  -# Apply the Receive Maximum and the Maximum Packet Size of MQTT 5.0
+ *                  -# Encode and decode the payload of the PUBLISH Messages by the codec of the Topic Filter
+ * @version     00.00.06 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Size the index of the Message Queue by MaxInflight at MQC_Open instead of keeping MQC_MSG_QUEUE_HASH_SIZE lists in the session
+ *                  -# Encode the payload after the PUBLISH Message is accepted, and send it as it is when the codec does not make it smaller
+ *                  -# Keep the fixed size pool until the events taken from the session are freed, a callback may stop the session
+ *                  -# Notify the Messages discarded by MQC_CoreStop after the teardown instead of unlocking in the middle of it
+ *                  -# Discard the received payload which the codec tells larger than DecodeMaxSize before allocating for it
+ *                  -# Restore the handlers replaced by MQC_CoreSubscribeHandler when the Topic Filters are not subscribed
  */
 
 /**************************************************************
@@ -46,6 +74,9 @@
 #include <stdarg.h>
 #include "../inc/MQC_core.h"
 #include "../inc/MQC_queue.h"
+#include "../inc/MQC_trie.h"
+#include "../inc/MQC_alias.h"
+#include "../inc/MQC_codec.h"
 #include "../../../CommonLib/CLIB_api.h"
 #include "MQC_wrap.h"
 
@@ -54,6 +85,7 @@
 **************************************************************/
 
 #define D_MQC_PROTOCOL_LEVEL                        (4)     /*!< Ver 3.1.1 */
+#define D_MQC_PROTOCOL_LEVEL_V5                     (5)     /*!< Ver 5.0 */
 
 #define D_MQC_MAX_MESSAGE_HEADER_SIZE               (5)     /*!< The maximum message header size of MQTT */
 
@@ -67,26 +99,35 @@
 #define D_MQC_PINGREQ_MSG_VARIABLE_HEADER_SIZE      (0)     /*!< No Data */
 #define D_MQC_DISCONNECT_MSG_VARIABLE_HEADER_SIZE   (0)     /*!< No Data */
 
-#define D_MQC_CALLBACK_SAFECALL(Ret, function, ...) {\
-                                                        if(function)\
-                                                        {\
-                                                            if(MQCHandler->UnlockFunc)\
-                                                            {\
-                                                                MQCHandler->UnlockFunc(MQCHandler->UsrCtx);\
-                                                            }\
-                                                            Ret = function(__VA_ARGS__);\
-                                                            if(MQCHandler->LockFunc)\
-                                                            {\
-                                                                MQCHandler->LockFunc(MQCHandler->UsrCtx);\
-                                                            }\
-                                                            Ret = (Ret)?D_MQC_RET_CALLBACK_ERROR:D_MQC_RET_OK;\
-                                                        }\
-                                                        else\
-                                                        {\
-                                                            Ret = D_MQC_RET_OK;\
-                                                        }\
-                                                        (void)Ret;\
-                                                    }
+#define D_MQC_ACK_MSG_SIZE                          (4)     /*!< FixedHeader(1) + RemainingLength(1) + PacketIdentifier(2) */
+#define D_MQC_PUBLISH_VEC_HEADER_SIZE               (13)    /*!< FixedHeader(1) + RemainingLength(4) + TopicLength(2) + PacketIdentifier(2) + PropertyLength(1) + TopicAlias(3) */
+#define D_MQC_PUBLISH_VEC_NUM                       (4)     /*!< Header + Topic Name + Packet Identifier and Properties + Payload */
+
+#define D_MQC_PROPERTY_RECEIVE_MAXIMUM              (0x21)  /*!< Receive Maximum (Two Byte Integer) */
+#define D_MQC_PROPERTY_TOPIC_ALIAS_MAXIMUM          (0x22)  /*!< Topic Alias Maximum (Two Byte Integer) */
+#define D_MQC_PROPERTY_MAXIMUM_PACKET_SIZE          (0x27)  /*!< Maximum Packet Size (Four Byte Integer) */
+#define D_MQC_PROPERTY_TOPIC_ALIAS                  (0x23)  /*!< Topic Alias (Two Byte Integer) */
+#define D_MQC_TOPIC_ALIAS_PROPERTY_SIZE             (3)     /*!< Property Identifier(1) + Topic Alias(2) */
+#define D_MQC_RECEIVE_MAXIMUM_PROPERTY_SIZE         (3)     /*!< Property Identifier(1) + Receive Maximum(2) */
+#define D_MQC_PACKET_SIZE_PROPERTY_SIZE             (5)     /*!< Property Identifier(1) + Maximum Packet Size(4) */
+
+#if !defined (MQC_RECV_BUFFER_KEEP_SIZE)
+#define MQC_RECV_BUFFER_KEEP_SIZE                   (1024)  /*!< Default size of the receive buffer kept by the session */
+#endif /* MQC_RECV_BUFFER_KEEP_SIZE */
+
+#if !defined (MQC_SEND_BUFFER_KEEP_SIZE)
+#define MQC_SEND_BUFFER_KEEP_SIZE                   (1024)  /*!< Default size of the send buffer kept by the session */
+#endif /* MQC_SEND_BUFFER_KEEP_SIZE */
+
+#if !defined (MQC_DECODE_MAX_SIZE)
+#define MQC_DECODE_MAX_SIZE                         (65536) /*!< Default maximum size of the decoded payload of a received Message */
+#endif /* MQC_DECODE_MAX_SIZE */
+
+#if !defined (MQC_EVENT_KEEP_NUM)
+#define MQC_EVENT_KEEP_NUM                          (64)    /*!< Default size of the event list kept by the session */
+#endif /* MQC_EVENT_KEEP_NUM */
+
+#define D_MQC_EVENT_LIST_INIT_NUM                   (8)     /*!< Size of the event list allocated first */
 
 /**************************************************************
 **  Structure
@@ -106,6 +147,102 @@ typedef struct _S_MQC_PROTOCOL_DATA
     /*!< Message Process Function */
 }S_MQC_PROTOCOL_DATA;
 
+/**
+ * @brief       Output buffer of the Message encoder
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_ENCODE_BUFFER
+{
+    uint8_t*                Data;
+    /*!< \b in : Buffer provided by the caller (can be NULL) \n \b out : Buffer the Message is written to */
+    
+    size_t                  Size;
+    /*!< \b in : Size of the buffer provided by the caller \n \b out : Total Message Size */
+    
+    bool                    Persist;
+    /*!< The Message is kept after sending (true: allocated by prvMQC_ObjectMalloc and freed by the caller / false: caller or session buffer) */
+}S_MQC_ENCODE_BUFFER;
+
+/**
+ * @brief       Type of the event notified to user
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef enum _E_MQC_EVENT_TYPE
+{
+    E_MQC_EVENT_READ        =   0,      /*!< Message received from server (ReadFuncCB) */
+    E_MQC_EVENT_OPENRESET,              /*!< Result of the CONNECT Message (OpenResetFuncCB) */
+    E_MQC_EVENT_RESULT,                 /*!< Result of the Message sent by the client (ResultFuncCB of the Message) */
+    E_MQC_EVENT_CHUNK,                  /*!< Event of the Message delivered in chunks (ReadChunkFuncCB), never deferred */
+    E_MQC_EVENT_TOPIC,                  /*!< PUBLISH Message matched by a Topic Filter (HandlerFuncCB of the Topic Filter) */
+}E_MQC_EVENT_TYPE;
+
+/**
+ * @brief       Event kept in the event list of the session until the session is unlocked
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_EVENT
+{
+    E_MQC_EVENT_TYPE        Type;
+    /*!< Event type */
+    
+    E_MQC_MSG_TYPE          MsgType;
+    /*!< Type of the Message received (E_MQC_EVENT_READ) */
+    
+    S_MQC_MESSAGE_INFO      Info;
+    /*!< PUBLISH Message received (E_MQC_EVENT_READ / E_MQC_EVENT_TOPIC) */
+    
+    uint8_t*                CopyData;
+    /*!< Copy of the topic and the payload of the PUBLISH Message in the receive buffer (E_MQC_EVENT_READ / E_MQC_EVENT_TOPIC) */
+    
+    E_MQC_BEHAVIOR_RESULT   Result;
+    /*!< Result (E_MQC_EVENT_OPENRESET / E_MQC_EVENT_RESULT) */
+    
+    uint8_t                 SrvResCode;
+    /*!< Return code of the CONNACK Message (E_MQC_EVENT_OPENRESET) */
+    
+    bool                    SessionPresent;
+    /*!< Session Present flag of the CONNACK Message (E_MQC_EVENT_OPENRESET) */
+    
+    S_MQC_MSG_CTX*          Message;
+    /*!< Message context which is freed after the notification (E_MQC_EVENT_RESULT) */
+    
+    E_MQC_RETURN_CODE*      CodeList;
+    /*!< Return codes of the SUBACK Message which are freed after the notification (E_MQC_EVENT_RESULT) */
+    
+    E_MQC_CHUNK_EVENT       ChunkEvent;
+    /*!< Event of the chunked delivery (E_MQC_EVENT_CHUNK) */
+    
+    S_MQC_CHUNK_INFO*       ChunkInfo;
+    /*!< Information of the chunk (E_MQC_EVENT_CHUNK) */
+#if defined (MQC_TOPIC_DISPATCH)
+    
+    S_MQC_TOPIC_HANDLER     Handler;
+    /*!< Handler of the matched Topic Filter (E_MQC_EVENT_TOPIC) */
+#endif /* MQC_TOPIC_DISPATCH */
+}S_MQC_EVENT;
+
+#if defined (MQC_TOPIC_DISPATCH)
+/**
+ * @brief       Context to queue the events of the Topic Filters matched by a PUBLISH Message
+ * @author      agent@local
+ * @date        2026/10/17
+ */
+typedef struct _S_MQC_TOPIC_MATCH_CTX
+{
+    S_MQC_SESSION_HANDLE*   MQCHandler;
+    /*!< MQTT client handler */
+    
+    S_MQC_MESSAGE_INFO      Origin;
+    /*!< PUBLISH Message in the receive buffer */
+    
+    S_MQC_MESSAGE_INFO      Info;
+    /*!< PUBLISH Message notified (the copy made for the first event is shared by the later ones) */
+}S_MQC_TOPIC_MATCH_CTX;
+#endif /* MQC_TOPIC_DISPATCH */
+
 /**************************************************************
 **  Global Param
 **************************************************************/
@@ -162,59 +299,51 @@ static uint32_t prvMQC_CheckPassTime(uint32_t SystimeCountOrig, uint32_t Systime
 }
  
 /** 
- * @brief               Encode an Integer Remaining Length into MQTT format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written                                            
+ * @brief               Get the number of bytes an Integer Remaining Length is encoded into
  * @param[in]           RemainingLength         Amount of the Remaining Data encoded
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
- * @author              zhaozhenge@outlook.com
- * @date                2018/06/18
+ * @return              Number of bytes (0 means the Remaining Length is too large to encode)
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_RemainingLengthEncode( uint8_t* Dst, uint32_t* Dstlen, uint32_t RemainingLength )
+static uint32_t prvMQC_RemainingLengthSize( uint32_t RemainingLength )
 {
-    uint32_t    MsgLength       =   0;
-    uint8_t*    EndPtr          =   NULL;
-    uint32_t    CalData_32bit   =   0;
-    
-    /* check the RemainingLength */
-    if( 128 > RemainingLength )
-    {
-        MsgLength = MsgLength + 1;
-    }
-    else if( 16383 > RemainingLength )
-    {
-        MsgLength = MsgLength + 2;
-    }
-    else if( 2097151 > RemainingLength )
-    {
-        MsgLength = MsgLength + 3;
-    }
-    else if( 268435455 > RemainingLength )
+    if( 127 >= RemainingLength )
     {
-        MsgLength = MsgLength + 4;
+        return 1;
     }
-    else
+    else if( 16383 >= RemainingLength )
     {
-        return (-1);
+        return 2;
     }
-    if( (NULL == Dst) || (0 == *Dstlen) )
+    else if( 2097151 >= RemainingLength )
     {
-        *Dstlen = MsgLength;
-        return (0);
+        return 3;
     }
-    if( *Dstlen < MsgLength )
+    else if( 268435455 >= RemainingLength )
     {
-        /* Buffer not enough */
-        return (-1);
+        return 4;
     }
-    /* encode the Message */
-    EndPtr = Dst;
-    CalData_32bit = RemainingLength;
+    return 0;
+}
+
+/** 
+ * @brief               Encode an Integer Remaining Length into MQTT format
+ * @param[in]           Dst                     Destination buffer
+ * @param[in]           RemainingLength         Amount of the Remaining Data encoded
+ * @return              Number of bytes written
+ * @note                \a Dst should have the space of prvMQC_RemainingLengthSize() bytes
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/06/18
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvMQC_RemainingLengthEncode( uint8_t* Dst, uint32_t RemainingLength )
+{
+    uint8_t*    EndPtr          =   Dst;
+    uint32_t    CalData_32bit   =   RemainingLength;
+    
     do
     {
         *EndPtr = CalData_32bit % 128;
@@ -225,8 +354,8 @@ static int32_t prvMQC_RemainingLengthEncode( uint8_t* Dst, uint32_t* Dstlen, uin
         }
         EndPtr++;
     }while(CalData_32bit);
-    *Dstlen = MsgLength;
-    return (0);
+    
+    return (uint32_t)(EndPtr - Dst);
 }
 
 /** 
@@ -281,845 +410,2408 @@ static int32_t prvMQC_RemainingLengthDecode( uint8_t* Src, uint32_t Srclen, uint
 }
 
 /** 
- * @brief               Encode a buffer into MQTT CONNECT Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
- * @param[in]           CleanSessionSetting     The Setting information of CleanSession Flag
- * @param[in]           WillMessageSetting      The Setting information of Will Message
- * @param[in]           AuthoritionSetting      The Setting information of Authorition
- * @param[in]           KeepAliveInterval       Keep Alive Message sent interval (in Second)
- * @param[in]           ClientId                Unique Client Id
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
- * @author              zhaozhenge@outlook.com
- * @date                2018/06/18
+ * @brief               Judge if the session uses MQTT 5.0
+ * @param[in]           MQCHandler              MQTT client handler
+ * @retval              true                    MQTT 5.0
+ * @retval              false                   MQTT 3.1.1
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_ConnectMessageEncode( uint8_t* Dst, size_t* Dstlen, bool CleanSessionSetting, S_MQC_WILL_INFO* WillMessageSetting, 
-                                            S_MQC_AUTH_INFO* AuthoritionSetting, uint16_t KeepAliveInterval, S_MQC_UTF8_DATA* ClientId )
+static bool prvMQC_Version5( S_MQC_SESSION_HANDLE* MQCHandler )
 {
-    uint32_t    RemainingLength        =   0;
-    uint32_t    EncodeRemainingLength  =   0;
-    size_t      WriteDataSize          =   0;
-    int32_t     Ret                    =   0;
-    uint8_t*    EndPtr                 =   NULL;
-    uint16_t    OrigDataLength         =   0;
+#if defined (MQC_MQTT5)
+    return (E_MQC_PROTOCOL_V5 == MQCHandler->ProtocolVersion);
+#else
+    (void)MQCHandler;
+    return false;
+#endif /* MQC_MQTT5 */
+}
 
-    /* calculate the RemainingLength of CONNECT Message */
-    RemainingLength = RemainingLength + D_MQC_CONNECT_MSG_VARIABLE_HEADER_SIZE;
-    /* Client Id */
-    RemainingLength = RemainingLength + sizeof(ClientId->Length) + ClientId->Length;
-    /* Will Message */
-    if(WillMessageSetting->Enable)
-    {
-        RemainingLength = RemainingLength + sizeof(uint16_t) + WillMessageSetting->Message.Topic.Length;
-        RemainingLength = RemainingLength + sizeof(uint16_t) + WillMessageSetting->Message.Length;
-    }
-    /* authorization */
-    if(AuthoritionSetting->UsernameEnable)
-    {
-        RemainingLength = RemainingLength + sizeof(AuthoritionSetting->Username.Length) + AuthoritionSetting->Username.Length;
-    }
-    if(AuthoritionSetting->PasswordEnable)
-    {
-        RemainingLength = RemainingLength + sizeof(AuthoritionSetting->Password.Length) + AuthoritionSetting->Password.Length;
-    }
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
-    {
-        return (-1);
-    }
-    /* calculate the Total Message Size of CONNECT Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
+#if defined (MQC_MQTT5)
+/** 
+ * @brief               Decode a Variable Byte Integer from MQTT format
+ * @param[in]           Src                     Source buffer
+ * @param[in]           Srclen                  Size of the Source buffer
+ * @param[out]          Value                   Decode result
+ * @return              Number of bytes decoded (0 means data not enough or decode error)
+ * @note                Unlike prvMQC_RemainingLengthDecode, \a Src may have more data after the integer
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvMQC_VariableIntegerDecode( const uint8_t* Src, uint32_t Srclen, uint32_t* Value )
+{
+    uint32_t    Multiplier  =   1;
+    uint32_t    i           =   0;
+    
+    *Value = 0;
+    for(i = 0; (i < Srclen) && (i < 4); i++)
     {
-        *Dstlen = WriteDataSize;
-        return (0);
+        *Value += (Src[i] & 127) * Multiplier;
+        if(!(Src[i] & 128))
+        {
+            return (i + 1);
+        }
+        Multiplier *= 128;
     }
-    if(*Dstlen < WriteDataSize)
+    return 0;
+}
+
+/** 
+ * @brief               Get the Properties at the head of the data
+ * @param[in]           Data                    Property Length and the Properties
+ * @param[in]           DataSize                Size of the data
+ * @param[out]          Property                Properties
+ * @param[out]          PropertyLength          Length of the Properties
+ * @return              Size of the Property Length and the Properties (0 means bad format)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvMQC_PropertyGet( uint8_t* Data, uint32_t DataSize, uint8_t** Property, uint32_t* PropertyLength )
+{
+    uint32_t    Size    =   prvMQC_VariableIntegerDecode(Data, DataSize, PropertyLength);
+    
+    if( (!Size) || (*PropertyLength > (DataSize - Size)) )
     {
-        /* No enough Buffer */
-        return (-1);
+        return 0;
     }
+    *Property = Data + Size;
+    return (Size + *PropertyLength);
+}
 
-    /* Make the Message Data */
-    EndPtr = Dst;
+/** 
+ * @brief               Read a Property and move to the next one
+ * @param[in,out]       Property                Properties (the next Property after the call)
+ * @param[in,out]       PropertyLength          Length of the Properties (the rest after the call)
+ * @param[out]          Identifier              Property Identifier
+ * @param[out]          Value                   Value of the integer Property (0 for the string or binary Property)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_FORMAT
+ * @note                The Properties not used by the library are skipped by the type of the Property Identifier
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PropertyNext( uint8_t** Property, uint32_t* PropertyLength, uint8_t* Identifier, uint32_t* Value )
+{
+    uint8_t*    Data    =   *Property;
+    uint32_t    Size    =   *PropertyLength;
+    uint32_t    Length  =   0;
     
-    /* Fixed Header */
-    *EndPtr = (E_MQC_MSG_CONNECT << 4);
-    EndPtr++;
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    *Value = 0;
+    if(!Size)
     {
-        return (-1);
+        return D_MQC_RET_BAD_FORMAT;
     }
-    EndPtr = EndPtr + EncodeRemainingLength;
-    /* Protocol Name */
-    OrigDataLength = strlen((char*)D_MQC_STR_PROTOCOL);
-    *((uint16_t*)EndPtr) = MQC_htons(OrigDataLength);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    memcpy(EndPtr, D_MQC_STR_PROTOCOL, OrigDataLength);
-    EndPtr = EndPtr + OrigDataLength;
-    /* Protocol Level */
-    *EndPtr = D_MQC_PROTOCOL_LEVEL;
-    EndPtr++;
-    /* Connect Flags */
-    *EndPtr = ( CleanSessionSetting?(1<<1):(0) ) + 
-              ( WillMessageSetting->Enable?(1<<2):(0) ) + 
-              ( WillMessageSetting->QoS<<3 ) + 
-              ( WillMessageSetting->Retain?(1<<5):(0) ) + 
-              ( AuthoritionSetting->PasswordEnable?(1<<6):(0) ) +
-              ( AuthoritionSetting->UsernameEnable?(1<<7):(0) );
-    EndPtr++;
-    /* Keep Alive */
-    *((uint16_t*)EndPtr) = MQC_htons(KeepAliveInterval);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    /* Client Identifier */
-    *((uint16_t*)EndPtr) = MQC_htons(ClientId->Length);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    if(ClientId->Data && ClientId->Length)
+    *Identifier = *Data;
+    Data++;
+    Size--;
+    
+    switch(*Identifier)
     {
-        memcpy(EndPtr, ClientId->Data, ClientId->Length);
-        EndPtr = EndPtr + ClientId->Length;
+        /* Byte */
+        case 0x01: case 0x17: case 0x19: case 0x24: case 0x25: case 0x28: case 0x29: case 0x2A:
+            Length = 1;
+            if(Size >= Length)
+            {
+                *Value = Data[0];
+            }
+            break;
+        /* Two Byte Integer */
+        case 0x13: case 0x21: case 0x22: case 0x23:
+            Length = 2;
+            if(Size >= Length)
+            {
+                *Value = ((uint32_t)Data[0] << 8) | Data[1];
+            }
+            break;
+        /* Four Byte Integer */
+        case 0x02: case 0x11: case 0x18: case 0x27:
+            Length = 4;
+            if(Size >= Length)
+            {
+                *Value = ((uint32_t)Data[0] << 24) | ((uint32_t)Data[1] << 16) | ((uint32_t)Data[2] << 8) | Data[3];
+            }
+            break;
+        /* Variable Byte Integer */
+        case 0x0B:
+            Length = prvMQC_VariableIntegerDecode(Data, Size, Value);
+            if(!Length)
+            {
+                return D_MQC_RET_BAD_FORMAT;
+            }
+            break;
+        /* UTF-8 Encoded String / Binary Data */
+        case 0x03: case 0x08: case 0x09: case 0x12: case 0x15: case 0x16: case 0x1A: case 0x1C: case 0x1F:
+            if(Size < sizeof(uint16_t))
+            {
+                return D_MQC_RET_BAD_FORMAT;
+            }
+            Length = sizeof(uint16_t) + (((uint32_t)Data[0] << 8) | Data[1]);
+            break;
+        /* UTF-8 String Pair */
+        case 0x26:
+            if(Size < sizeof(uint16_t))
+            {
+                return D_MQC_RET_BAD_FORMAT;
+            }
+            Length = sizeof(uint16_t) + (((uint32_t)Data[0] << 8) | Data[1]);
+            if(Size < Length + sizeof(uint16_t))
+            {
+                return D_MQC_RET_BAD_FORMAT;
+            }
+            Length = Length + sizeof(uint16_t) + (((uint32_t)Data[Length] << 8) | Data[Length + 1]);
+            break;
+        default:
+            return D_MQC_RET_BAD_FORMAT;
     }
-    /* Will Topic */
-    if(WillMessageSetting->Enable)
+    if(Length > Size)
     {
-        *((uint16_t*)EndPtr) = MQC_htons(WillMessageSetting->Message.Topic.Length);
-        EndPtr = EndPtr + sizeof(uint16_t);
-        memcpy(EndPtr, WillMessageSetting->Message.Topic.Data, WillMessageSetting->Message.Topic.Length);
-        EndPtr = EndPtr + WillMessageSetting->Message.Topic.Length;
+        return D_MQC_RET_BAD_FORMAT;
     }
-    /* Will Message */
-    if( WillMessageSetting->Enable && WillMessageSetting->Message.Length && WillMessageSetting->Message.Content )
+    
+    *Property       = Data + Length;
+    *PropertyLength = Size - Length;
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Judge if a Message is larger than the Maximum Packet Size
+ * @param[in]           MaximumPacketSize       Maximum Packet Size (0 means no limit)
+ * @param[in]           RemainingLength         Remaining Length of the Message
+ * @retval              true                    The Message is too large
+ * @retval              false                   The Message can be sent or received
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvMQC_PacketOversize( uint32_t MaximumPacketSize, uint32_t RemainingLength )
+{
+    /* Fixed Header(1) + Remaining Length(1-4) + Remaining Length */
+    return ( MaximumPacketSize && ( (uint64_t)1 + prvMQC_RemainingLengthSize(RemainingLength) + RemainingLength > MaximumPacketSize ) );
+}
+#endif /* MQC_MQTT5 */
+
+/** 
+ * @brief               Allocate the memory of an object kept by the session (Message context, Message data, etc.)
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Size                    Memory size that want to allocate
+ * @return              Memory address (NULL means no enough memory)
+ * @note                The fixed size pool of the session is used first, and MallocFunc is used when no block fits
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void* prvMQC_ObjectMalloc( S_MQC_SESSION_HANDLE* MQCHandler, size_t Size )
+{
+#if defined (D_MQC_POOL_ENABLED)
+    void*       Ptr     =   NULL;
+    
+    if(MQCHandler->SessionCtx.Pool)
     {
-        *((uint16_t*)EndPtr) = MQC_htons(WillMessageSetting->Message.Length);
-        EndPtr = EndPtr + sizeof(uint16_t);
-        memcpy(EndPtr, WillMessageSetting->Message.Content, WillMessageSetting->Message.Length);
-        EndPtr = EndPtr + WillMessageSetting->Message.Length;
+        Ptr = CLIB_pool_malloc(&(MQCHandler->SessionCtx.Pool->Handle), Size);
     }
-    /* User Name */
-    if(AuthoritionSetting->UsernameEnable)
+    if(Ptr)
     {
-        *((uint16_t*)EndPtr) = MQC_htons(AuthoritionSetting->Username.Length);
-        EndPtr = EndPtr + sizeof(uint16_t);
-        memcpy(EndPtr, AuthoritionSetting->Username.Data, AuthoritionSetting->Username.Length);
-        EndPtr = EndPtr + AuthoritionSetting->Username.Length;
+        return Ptr;
     }
-    /* Password */
-    if(AuthoritionSetting->PasswordEnable)
+#endif /* D_MQC_POOL_ENABLED */
+    return MQCHandler->MallocFunc(Size);
+}
+
+/** 
+ * @brief               Free the memory allocated by prvMQC_ObjectMalloc
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Ptr                     Memory address
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_ObjectFree( S_MQC_SESSION_HANDLE* MQCHandler, void* Ptr )
+{
+#if defined (D_MQC_POOL_ENABLED)
+    if( MQCHandler->SessionCtx.Pool && (0 == CLIB_pool_free(&(MQCHandler->SessionCtx.Pool->Handle), Ptr)) )
     {
-        *((uint16_t*)EndPtr) = MQC_htons(AuthoritionSetting->Password.Length);
-        EndPtr = EndPtr + sizeof(uint16_t);
-        memcpy(EndPtr, AuthoritionSetting->Password.Data, AuthoritionSetting->Password.Length);
-        EndPtr = EndPtr + AuthoritionSetting->Password.Length;
+        return;
     }
-    *Dstlen = WriteDataSize;
-    return (0);
+#endif /* D_MQC_POOL_ENABLED */
+    MQCHandler->FreeFunc(Ptr);
+    return;
 }
 
+#if defined (D_MQC_POOL_ENABLED)
 /** 
- * @brief               Encode a buffer into MQTT DISCONNECT Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
- * @author              zhaozhenge@outlook.com
- * @date                2018/11/21
+ * @brief               Create the fixed size pool of the session
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                The session works without the pool if no enough memory. \n
+ *                      The session holds the first reference of the pool.
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_DisconnectMessageEncode(uint8_t* Dst, size_t* Dstlen)
+static void prvMQC_PoolCreate( S_MQC_SESSION_HANDLE* MQCHandler )
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    size_t      WriteDataSize           =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
+    S_MQC_SESSION_CTX*  SessionCtx      =   &(MQCHandler->SessionCtx);
+    size_t              BlockSize[2];
+    size_t              BlockNum[2];
+    size_t              PoolSize        =   0;
     
-    /* calculate the RemainingLength of DISCONNECT Message */
-    RemainingLength = RemainingLength + D_MQC_DISCONNECT_MSG_VARIABLE_HEADER_SIZE;
-    
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    /* The size classes are in ascending order */
+    if(MQC_POOL_SMALL_SIZE < sizeof(S_MQC_MSG_CTX))
     {
-        return (-1);
+        BlockSize[0] = MQC_POOL_SMALL_SIZE;         BlockNum[0] = MQC_POOL_SMALL_NUM;
+        BlockSize[1] = sizeof(S_MQC_MSG_CTX);       BlockNum[1] = MQC_POOL_MSG_NUM;
     }
-    /* calculate the Total Message Size of PINGREQ Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
+    else
     {
-        *Dstlen = WriteDataSize;
-        return (0);
+        BlockSize[0] = sizeof(S_MQC_MSG_CTX);       BlockNum[0] = MQC_POOL_MSG_NUM;
+        BlockSize[1] = MQC_POOL_SMALL_SIZE;         BlockNum[1] = MQC_POOL_SMALL_NUM;
     }
-    if(*Dstlen < WriteDataSize)
+    PoolSize = CLIB_POOL_CLASS_MEMORY(BlockSize[0], BlockNum[0]) + CLIB_POOL_CLASS_MEMORY(BlockSize[1], BlockNum[1]) + CLIB_ALIGNBYTES;
+    
+    /* The blocks follow the structure of the pool */
+    SessionCtx->Pool = (S_MQC_POOL*)MQCHandler->MallocFunc(sizeof(S_MQC_POOL) + PoolSize);
+    if( SessionCtx->Pool && 
+        CLIB_pool_create(&(SessionCtx->Pool->Handle), (uint8_t*)(SessionCtx->Pool + 1), PoolSize, BlockSize, BlockNum, 2, NULL, NULL, NULL) )
     {
-        /* No enough Buffer */
-        return (-1);
+        MQCHandler->FreeFunc(SessionCtx->Pool);
+        SessionCtx->Pool = NULL;
     }
-    
-    /* Make the Message Data */
-    EndPtr = Dst;
-    
-    /* Fixed Header */
-    *EndPtr = ( E_MQC_MSG_DISCONNECT << 4 );
-    EndPtr++; 
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    if(SessionCtx->Pool)
     {
-        return (-1);
+        SessionCtx->Pool->RefCount = 1;
     }
-    *Dstlen = WriteDataSize;
-    return (0);
+    return;
 }
- 
+
 /** 
- * @brief               Encode a buffer into MQTT SUBSCRIBE Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
+ * @brief               Release a reference of a fixed size pool
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Pool                    Pool (can be NULL)
+ * @return              None
+ * @note                The pool is deleted with the last reference, all objects allocated from it should be freed before
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PoolRelease( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_POOL* Pool )
+{
+    if( Pool && (0 == --(Pool->RefCount)) )
+    {
+        (void)CLIB_pool_delete(&(Pool->Handle));
+        MQCHandler->FreeFunc(Pool);
+    }
+    return;
+}
+
+/** 
+ * @brief               Delete the fixed size pool of the session
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                All objects of the session allocated from the pool should be freed before. \n
+ *                      The pool is kept until the events taken from the session are freed (prvMQC_EventFree).
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PoolDelete( S_MQC_SESSION_HANDLE* MQCHandler )
+{
+    prvMQC_PoolRelease(MQCHandler, MQCHandler->SessionCtx.Pool);
+    MQCHandler->SessionCtx.Pool = NULL;
+    return;
+}
+#endif /* D_MQC_POOL_ENABLED */
+
+/** 
+ * @brief               Grow the index of the Message Queue for the Messages in flight
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                The bucket number is MaxInflight rounded up to a power of 2 (MQC_MSG_QUEUE_HASH_SIZE if 
+ *                      MaxInflight is 0 or larger), the lists are allocated by MallocFunc and freed at MQC_Stop. \n
+ *                      The index kept in the session is used if it is large enough or no enough memory.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_QueueIndexResize( S_MQC_SESSION_HANDLE* MQCHandler )
+{
+    S_MQC_MSG_QUEUE*    MsgQueue    =   &(MQCHandler->SessionCtx.MessageQueue);
+    T_LIST_NODE*        HashList    =   NULL;
+    uint32_t            Wanted      =   MQC_MSG_QUEUE_HASH_SIZE;
+    uint32_t            BucketNum   =   D_MQC_MSG_QUEUE_HASH_LOCAL;
+    
+    if( MQCHandler->MaxInflight && (MQCHandler->MaxInflight < MQC_MSG_QUEUE_HASH_SIZE) )
+    {
+        Wanted = MQCHandler->MaxInflight;
+    }
+    while(BucketNum < Wanted)
+    {
+        BucketNum <<= 1;
+    }
+    if(BucketNum <= MsgQueue->HashMask + 1)
+    {
+        return;
+    }
+    HashList = (T_LIST_NODE*)MQCHandler->MallocFunc(sizeof(T_LIST_NODE) * BucketNum);
+    if(HashList)
+    {
+        HashList = MQC_MsgQueue_rehash(MsgQueue, HashList, BucketNum);
+        if(HashList)
+        {
+            MQCHandler->FreeFunc(HashList);
+        }
+    }
+    return;
+}
+
+/** 
+ * @brief               Get the buffer to write a Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           Size                    Total Message Size
+ * @return              Buffer to write the Message (NULL means no enough memory)
+ * @note                The buffer is selected in the order below : \n
+ *                      1. New buffer allocated by prvMQC_ObjectMalloc, if the Message is kept after sending \n
+ *                      2. Buffer provided by the caller, if it is large enough \n
+ *                      3. Send buffer of the session
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint8_t* prvMQC_EncodeBufferGet( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, size_t Size )
+{
+    size_t      BufferSize  =   0;
+    
+    if(Buffer->Persist)
+    {
+        Buffer->Data = prvMQC_ObjectMalloc(MQCHandler, Size);
+    }
+    else if( (!Buffer->Data) || (Buffer->Size < Size) )
+    {
+        if(MQCHandler->SessionCtx.SendBufferSize < Size)
+        {
+            if(MQCHandler->SessionCtx.SendData)
+            {
+                MQCHandler->FreeFunc(MQCHandler->SessionCtx.SendData);
+            }
+            BufferSize = (Size > MQC_SEND_BUFFER_KEEP_SIZE)?(Size):(MQC_SEND_BUFFER_KEEP_SIZE);
+            MQCHandler->SessionCtx.SendData = MQCHandler->MallocFunc(BufferSize);
+            MQCHandler->SessionCtx.SendBufferSize = (MQCHandler->SessionCtx.SendData)?(BufferSize):(0);
+        }
+        Buffer->Data = MQCHandler->SessionCtx.SendData;
+    }
+    Buffer->Size = (Buffer->Data)?(Size):(0);
+    return Buffer->Data;
+}
+
+/** 
+ * @brief               Release the output buffer of the encoder after the Message is sent
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Buffer                  Output buffer of the encoder
+ * @return              None
+ * @note                Only the send buffer of the session is handled here, it is kept for the next Message 
+ *                      unless it is larger than MQC_SEND_BUFFER_KEEP_SIZE.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_EncodeBufferRelease( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer )
+{
+    if( Buffer->Data && (Buffer->Data == MQCHandler->SessionCtx.SendData) && (MQCHandler->SessionCtx.SendBufferSize > MQC_SEND_BUFFER_KEEP_SIZE) )
+    {
+        /* Shrink the buffer allocated for a big message */
+        MQCHandler->FreeFunc(MQCHandler->SessionCtx.SendData);
+        MQCHandler->SessionCtx.SendData = NULL;
+        MQCHandler->SessionCtx.SendBufferSize = 0;
+    }
+    return;
+}
+
+/** 
+ * @brief               Get the output buffer and encode the Fixed Header of a Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           FixedHeader             The first byte of the Fixed Header
+ * @param[in]           RemainingLength         Remaining Length of the Message
+ * @param[out]          EndPtr                  Where the Variable Header should be written
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR  The Message is too large
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_FixedHeaderEncode( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint8_t FixedHeader, uint32_t RemainingLength, uint8_t** EndPtr )
+{
+    uint32_t    EncodeRemainingLength   =   0;
+    uint8_t*    StartPtr                =   NULL;
+    
+    EncodeRemainingLength = prvMQC_RemainingLengthSize(RemainingLength);
+    if(!EncodeRemainingLength)
+    {
+        return D_MQC_RET_UNEXPECTED_ERROR;
+    }
+    /* Get the buffer for the Total Message Size */
+    StartPtr = prvMQC_EncodeBufferGet(MQCHandler, Buffer, (size_t)RemainingLength + EncodeRemainingLength + 1);
+    if(!StartPtr)
+    {
+        return D_MQC_RET_NO_MEMORY;
+    }
+    /* Fixed Header */
+    *StartPtr = FixedHeader;
+    StartPtr++;
+    /* Remaining Length */
+    StartPtr = StartPtr + prvMQC_RemainingLengthEncode(StartPtr, RemainingLength);
+    *EndPtr = StartPtr;
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Encode MQTT CONNECT Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           CleanSessionSetting     The Setting information of CleanSession Flag
+ * @param[in]           WillMessageSetting      The Setting information of Will Message
+ * @param[in]           AuthoritionSetting      The Setting information of Authorition
+ * @param[in]           KeepAliveInterval       Keep Alive Message sent interval (in Second)
+ * @param[in]           ClientId                Unique Client Id
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/06/18
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_ConnectMessageEncode( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, bool CleanSessionSetting, S_MQC_WILL_INFO* WillMessageSetting, 
+                                            S_MQC_AUTH_INFO* AuthoritionSetting, uint16_t KeepAliveInterval, S_MQC_UTF8_DATA* ClientId )
+{
+    uint32_t    RemainingLength        =   0;
+    int32_t     Ret                    =   D_MQC_RET_OK;
+    uint8_t*    EndPtr                 =   NULL;
+    uint16_t    OrigDataLength         =   0;
+#if defined (MQC_MQTT5)
+    uint32_t    PropertyLength         =   0;
+#endif /* MQC_MQTT5 */
+
+    /* calculate the RemainingLength of CONNECT Message */
+    RemainingLength = RemainingLength + D_MQC_CONNECT_MSG_VARIABLE_HEADER_SIZE;
+#if defined (MQC_MQTT5)
+    if(prvMQC_Version5(MQCHandler))
+    {
+        /* Properties */
+        PropertyLength = (MQCHandler->TopicAliasMaximum)?(D_MQC_TOPIC_ALIAS_PROPERTY_SIZE):(0);
+        PropertyLength = PropertyLength + ((MQCHandler->ReceiveMaximum)?(D_MQC_RECEIVE_MAXIMUM_PROPERTY_SIZE):(0));
+        PropertyLength = PropertyLength + ((MQCHandler->MaximumPacketSize)?(D_MQC_PACKET_SIZE_PROPERTY_SIZE):(0));
+        RemainingLength = RemainingLength + 1 + PropertyLength;
+        /* Will Properties */
+        if(WillMessageSetting->Enable)
+        {
+            RemainingLength = RemainingLength + 1;
+        }
+    }
+#endif /* MQC_MQTT5 */
+    /* Client Id */
+    RemainingLength = RemainingLength + sizeof(ClientId->Length) + ClientId->Length;
+    /* Will Message */
+    if(WillMessageSetting->Enable)
+    {
+        RemainingLength = RemainingLength + sizeof(uint16_t) + WillMessageSetting->Message.Topic.Length;
+        RemainingLength = RemainingLength + sizeof(uint16_t) + WillMessageSetting->Message.Length;
+    }
+    /* authorization */
+    if(AuthoritionSetting->UsernameEnable)
+    {
+        RemainingLength = RemainingLength + sizeof(AuthoritionSetting->Username.Length) + AuthoritionSetting->Username.Length;
+    }
+    if(AuthoritionSetting->PasswordEnable)
+    {
+        RemainingLength = RemainingLength + sizeof(AuthoritionSetting->Password.Length) + AuthoritionSetting->Password.Length;
+    }
+    
+    /* Fixed Header */
+    Ret = prvMQC_FixedHeaderEncode( MQCHandler, Buffer, (E_MQC_MSG_CONNECT << 4), RemainingLength, &EndPtr );
+    if(Ret)
+    {
+        return Ret;
+    }
+    /* Protocol Name */
+    OrigDataLength = strlen((char*)D_MQC_STR_PROTOCOL);
+    *((uint16_t*)EndPtr) = MQC_htons(OrigDataLength);
+    EndPtr = EndPtr + sizeof(uint16_t);
+    memcpy(EndPtr, D_MQC_STR_PROTOCOL, OrigDataLength);
+    EndPtr = EndPtr + OrigDataLength;
+    /* Protocol Level */
+    *EndPtr = (prvMQC_Version5(MQCHandler))?(D_MQC_PROTOCOL_LEVEL_V5):(D_MQC_PROTOCOL_LEVEL);
+    EndPtr++;
+    /* Connect Flags */
+    *EndPtr = ( CleanSessionSetting?(1<<1):(0) ) + 
+              ( WillMessageSetting->Enable?(1<<2):(0) ) + 
+              ( WillMessageSetting->QoS<<3 ) + 
+              ( WillMessageSetting->Retain?(1<<5):(0) ) + 
+              ( AuthoritionSetting->PasswordEnable?(1<<6):(0) ) +
+              ( AuthoritionSetting->UsernameEnable?(1<<7):(0) );
+    EndPtr++;
+    /* Keep Alive */
+    *((uint16_t*)EndPtr) = MQC_htons(KeepAliveInterval);
+    EndPtr = EndPtr + sizeof(uint16_t);
+#if defined (MQC_MQTT5)
+    if(prvMQC_Version5(MQCHandler))
+    {
+        /* Properties */
+        *EndPtr = (uint8_t)PropertyLength;
+        EndPtr++;
+        if(MQCHandler->ReceiveMaximum)
+        {
+            *EndPtr = D_MQC_PROPERTY_RECEIVE_MAXIMUM;
+            *(EndPtr + 1) = (uint8_t)(MQCHandler->ReceiveMaximum >> 8);
+            *(EndPtr + 2) = (uint8_t)(MQCHandler->ReceiveMaximum);
+            EndPtr = EndPtr + D_MQC_RECEIVE_MAXIMUM_PROPERTY_SIZE;
+        }
+        if(MQCHandler->MaximumPacketSize)
+        {
+            *EndPtr = D_MQC_PROPERTY_MAXIMUM_PACKET_SIZE;
+            *(EndPtr + 1) = (uint8_t)(MQCHandler->MaximumPacketSize >> 24);
+            *(EndPtr + 2) = (uint8_t)(MQCHandler->MaximumPacketSize >> 16);
+            *(EndPtr + 3) = (uint8_t)(MQCHandler->MaximumPacketSize >> 8);
+            *(EndPtr + 4) = (uint8_t)(MQCHandler->MaximumPacketSize);
+            EndPtr = EndPtr + D_MQC_PACKET_SIZE_PROPERTY_SIZE;
+        }
+        if(MQCHandler->TopicAliasMaximum)
+        {
+            *EndPtr = D_MQC_PROPERTY_TOPIC_ALIAS_MAXIMUM;
+            *(EndPtr + 1) = (uint8_t)(MQCHandler->TopicAliasMaximum >> 8);
+            *(EndPtr + 2) = (uint8_t)(MQCHandler->TopicAliasMaximum);
+            EndPtr = EndPtr + D_MQC_TOPIC_ALIAS_PROPERTY_SIZE;
+        }
+    }
+#endif /* MQC_MQTT5 */
+    /* Client Identifier */
+    *((uint16_t*)EndPtr) = MQC_htons(ClientId->Length);
+    EndPtr = EndPtr + sizeof(uint16_t);
+    if(ClientId->Data && ClientId->Length)
+    {
+        memcpy(EndPtr, ClientId->Data, ClientId->Length);
+        EndPtr = EndPtr + ClientId->Length;
+    }
+    /* Will Properties */
+    if( WillMessageSetting->Enable && prvMQC_Version5(MQCHandler) )
+    {
+        *EndPtr = 0;
+        EndPtr++;
+    }
+    /* Will Topic */
+    if(WillMessageSetting->Enable)
+    {
+        *((uint16_t*)EndPtr) = MQC_htons(WillMessageSetting->Message.Topic.Length);
+        EndPtr = EndPtr + sizeof(uint16_t);
+        memcpy(EndPtr, WillMessageSetting->Message.Topic.Data, WillMessageSetting->Message.Topic.Length);
+        EndPtr = EndPtr + WillMessageSetting->Message.Topic.Length;
+    }
+    /* Will Message */
+    if(WillMessageSetting->Enable)
+    {
+        *((uint16_t*)EndPtr) = MQC_htons(WillMessageSetting->Message.Length);
+        EndPtr = EndPtr + sizeof(uint16_t);
+        if(WillMessageSetting->Message.Length && WillMessageSetting->Message.Content)
+        {
+            memcpy(EndPtr, WillMessageSetting->Message.Content, WillMessageSetting->Message.Length);
+            EndPtr = EndPtr + WillMessageSetting->Message.Length;
+        }
+    }
+    /* User Name */
+    if(AuthoritionSetting->UsernameEnable)
+    {
+        *((uint16_t*)EndPtr) = MQC_htons(AuthoritionSetting->Username.Length);
+        EndPtr = EndPtr + sizeof(uint16_t);
+        memcpy(EndPtr, AuthoritionSetting->Username.Data, AuthoritionSetting->Username.Length);
+        EndPtr = EndPtr + AuthoritionSetting->Username.Length;
+    }
+    /* Password */
+    if(AuthoritionSetting->PasswordEnable)
+    {
+        *((uint16_t*)EndPtr) = MQC_htons(AuthoritionSetting->Password.Length);
+        EndPtr = EndPtr + sizeof(uint16_t);
+        memcpy(EndPtr, AuthoritionSetting->Password.Data, AuthoritionSetting->Password.Length);
+        EndPtr = EndPtr + AuthoritionSetting->Password.Length;
+    }
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Encode MQTT DISCONNECT Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/11/21
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_DisconnectMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer)
+{
+    uint8_t*    EndPtr                  =   NULL;
+    
+    return prvMQC_FixedHeaderEncode( MQCHandler, Buffer, (E_MQC_MSG_DISCONNECT << 4), D_MQC_DISCONNECT_MSG_VARIABLE_HEADER_SIZE, &EndPtr );
+}
+ 
+/** 
+ * @brief               Encode MQTT SUBSCRIBE Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
  * @param[in]           PacketIdentifier        Packet Identifier
  * @param[in]           TopicFilterList         Topic Filter List
  * @param[in]           QoSList                 Topic Filter QoS List
  * @param[in]           ListNum                 The Count of the topic filter list
  * @param[out]          ExtData                 Extra Data used to store some customized information
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @author              zhaozhenge@outlook.com
  * @date                2018/11/19
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_SubscribeMessageEncode(uint8_t* Dst, size_t* Dstlen, uint16_t PacketIdentifier, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, uint32_t ListNum, S_MQC_MSG_SUB_DATA* ExtData)
+static int32_t prvMQC_SubscribeMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint16_t PacketIdentifier, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, uint32_t ListNum, S_MQC_MSG_SUB_DATA* ExtData)
+{
+    uint32_t    RemainingLength         =   0;
+    uint32_t    i                       =   0;
+    int32_t     Ret                     =   D_MQC_RET_OK;
+    uint8_t*    EndPtr                  =   NULL;
+    
+    /* calculate the RemainingLength of SUBSCRIBE Message */
+    RemainingLength = RemainingLength + D_MQC_SUBSCRIBE_MSG_VARIABLE_HEADER_SIZE;
+    /* Properties (none) */
+    RemainingLength = RemainingLength + ((prvMQC_Version5(MQCHandler))?(1):(0));
+    for(i = 0; i < ListNum; i++)
+    {
+        /* Topic Filter */
+        RemainingLength = RemainingLength + sizeof(uint16_t) + TopicFilterList[i].Length;
+        /* Requested QoS */
+        RemainingLength = RemainingLength + 1;
+    }
+    
+    /* Fixed Header */
+    Ret = prvMQC_FixedHeaderEncode( MQCHandler, Buffer, (E_MQC_MSG_SUBSCRIBE << 4) + (1<<1), RemainingLength, &EndPtr );
+    if(Ret)
+    {
+        return Ret;
+    }
+    /* PacketIdentifier */
+    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
+    EndPtr = EndPtr + sizeof(uint16_t);
+    /* Properties (none) */
+    if(prvMQC_Version5(MQCHandler))
+    {
+        *EndPtr = 0;
+        EndPtr++;
+    }
+    /* Topic Filter */
+    for(i = 0; i < ListNum; i++)
+    {
+        *((uint16_t*)EndPtr) = MQC_htons(TopicFilterList[i].Length);
+        EndPtr = EndPtr + sizeof(uint16_t);
+        if(TopicFilterList[i].Length)
+        {
+            memcpy(EndPtr, TopicFilterList[i].Data, TopicFilterList[i].Length);
+        }
+        if(ExtData)
+        {
+            ExtData->TopicFilterList[i].Data = (TopicFilterList[i].Length)?EndPtr:NULL;
+            ExtData->TopicFilterList[i].Length = TopicFilterList[i].Length;
+            ExtData->ListNum = ListNum;
+        }
+        EndPtr = EndPtr + TopicFilterList[i].Length;
+        *EndPtr = QoSList[i];
+        EndPtr++;
+    }
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Encode MQTT UNSUBSCRIBE Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           PacketIdentifier        Packet Identifier
+ * @param[in]           TopicFilterList         Topic Filter List
+ * @param[in]           ListNum                 The Count of the topic filter list
+ * @param[out]          ExtData                 Extra Data used to store some customized information
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/11/21
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_UnsubscribeMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint16_t PacketIdentifier, S_MQC_UTF8_DATA* TopicFilterList, uint32_t ListNum, S_MQC_MSG_UNSUB_DATA* ExtData)
+{
+    uint32_t    RemainingLength         =   0;
+    uint32_t    i                       =   0;
+    int32_t     Ret                     =   D_MQC_RET_OK;
+    uint8_t*    EndPtr                  =   NULL;
+    
+    /* calculate the RemainingLength of UNSUBSCRIBE Message */
+    RemainingLength = RemainingLength + D_MQC_UNSUBSCRIBE_MSG_VARIABLE_HEADER_SIZE;
+    /* Properties (none) */
+    RemainingLength = RemainingLength + ((prvMQC_Version5(MQCHandler))?(1):(0));
+    for(i = 0; i < ListNum; i++)
+    {
+        /* Topic Filter */
+        RemainingLength = RemainingLength + sizeof(uint16_t) + TopicFilterList[i].Length;
+    }
+    
+    /* Fixed Header */
+    Ret = prvMQC_FixedHeaderEncode( MQCHandler, Buffer, (E_MQC_MSG_UNSUBSCRIBE << 4) + (1<<1), RemainingLength, &EndPtr );
+    if(Ret)
+    {
+        return Ret;
+    }
+    /* PacketIdentifier */
+    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
+    EndPtr = EndPtr + sizeof(uint16_t);
+    /* Properties (none) */
+    if(prvMQC_Version5(MQCHandler))
+    {
+        *EndPtr = 0;
+        EndPtr++;
+    }
+    /* Topic Filter */
+    for(i = 0; i < ListNum; i++)
+    {
+        *((uint16_t*)EndPtr) = MQC_htons(TopicFilterList[i].Length);
+        EndPtr = EndPtr + sizeof(uint16_t);
+        memcpy(EndPtr, TopicFilterList[i].Data, TopicFilterList[i].Length);
+        if(ExtData)
+        {
+            ExtData->TopicFilterList[i].Data = EndPtr;
+            ExtData->TopicFilterList[i].Length = TopicFilterList[i].Length;
+            ExtData->ListNum = ListNum;
+        }
+        EndPtr = EndPtr + TopicFilterList[i].Length;
+    }
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Encode MQTT PUBLISH Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           PacketIdentifier        Packet Identifier
+ * @param[in]           Message                 Publish Message
+ * @param[in]           Retry                   Retry (DUP) flag of the Publish Message (false: first send / true: retry)
+ * @param[in]           QoS                     QoS level of the Publish Message
+ * @param[in]           Retain                  If a Retain Message
+ * @param[out]          ExtData                 Extra Data used to store some customized information
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/12/18
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PublishMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint16_t PacketIdentifier, S_MQC_MESSAGE_INFO* Message, bool Retry, E_MQC_QOS_LEVEL QoS, bool Retain, S_MQC_MSG_PUB_DATA* ExtData)
+{
+    uint32_t    RemainingLength         =   0;
+    int32_t     Ret                     =   D_MQC_RET_OK;
+    uint8_t*    EndPtr                  =   NULL;
+    
+    /* calculate the RemainingLength of PUBLISH Message */
+    RemainingLength = RemainingLength + sizeof(uint16_t) + Message->Topic.Length;
+    if( E_MQC_QOS_0 != QoS )
+    {
+        RemainingLength = RemainingLength + sizeof(uint16_t);
+    }
+    /* Properties (none, the Topic Alias is only used when the Message is sent first) */
+    RemainingLength = RemainingLength + ((prvMQC_Version5(MQCHandler))?(1):(0));
+    
+    RemainingLength = RemainingLength + Message->Length;
+    
+    /* Fixed Header */
+    Retry = Retry ? (1):(0);
+    Ret = prvMQC_FixedHeaderEncode( MQCHandler, Buffer, 
+                                    ( E_MQC_MSG_PUBLISH << 4 ) + 
+                                    ( (( E_MQC_QOS_0 != QoS )?Retry:0) << 3 ) +
+                                    ( QoS << 1 ) +
+                                    ( Retain?(1):(0) ), 
+                                    RemainingLength, &EndPtr );
+    if(Ret)
+    {
+        return Ret;
+    }
+    /* Topic Name */
+    *((uint16_t*)EndPtr) = MQC_htons(Message->Topic.Length);
+    EndPtr = EndPtr + sizeof(uint16_t);
+    memcpy(EndPtr, Message->Topic.Data, Message->Topic.Length);
+    if(ExtData)
+    {
+        ExtData->Message.Topic.Data = EndPtr;
+        ExtData->Message.Topic.Length = Message->Topic.Length;
+    }
+    EndPtr = EndPtr + Message->Topic.Length;
+    /* PacketIdentifier */
+    if( E_MQC_QOS_0 != QoS )
+    {
+        *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
+        EndPtr = EndPtr + sizeof(uint16_t);
+    }
+    /* Properties */
+    if(prvMQC_Version5(MQCHandler))
+    {
+        *EndPtr = 0;
+        EndPtr++;
+    }
+    /* Message Content */
+    if(Message->Length)
+    {
+        memcpy(EndPtr, Message->Content, Message->Length);
+    }
+    if(ExtData)
+    {
+        ExtData->Message.Length = Message->Length;
+        ExtData->Message.Content = (Message->Length) ? EndPtr : NULL;
+    }
+    return D_MQC_RET_OK;  
+}
+
+/** 
+ * @brief               Encode MQTT PUBLISH Message into segments
+ * @param[in]           MQCHandler              MQTT client handler
+ * @param[out]          Header                  Buffer for the data other than the Topic Name and the payload (D_MQC_PUBLISH_VEC_HEADER_SIZE bytes)
+ * @param[out]          Vec                     Segments of the Message (D_MQC_PUBLISH_VEC_NUM at most)
+ * @param[out]          VecNum                  Number of the segments
+ * @param[in]           FixedHeader             The first byte of the Fixed Header
+ * @param[in]           Message                 Publish Message
+ * @param[in]           PacketIdentifier        Packet Identifier (not used when QoS Level = 0)
+ * @param[in]           TopicAlias              Topic Alias (0 means no Topic Alias, only for MQTT 5.0)
+ * @param[in]           TopicOmit               The Topic Name is not sent (the server knows the Topic Alias already)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @note                The Topic Name and the payload segments refer to \a Message directly without copy
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PublishMessageEncodeVec(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Header, S_MQC_IOVEC* Vec, uint32_t* VecNum, uint8_t FixedHeader, 
+                                              S_MQC_MESSAGE_INFO* Message, uint16_t PacketIdentifier, uint16_t TopicAlias, bool TopicOmit)
+{
+    uint32_t    RemainingLength         =   0;
+    uint16_t    TopicLength             =   (TopicOmit)?(0):(Message->Topic.Length);
+    uint32_t    PropertyLength          =   (TopicAlias)?(D_MQC_TOPIC_ALIAS_PROPERTY_SIZE):(0);
+    uint8_t*    EndPtr                  =   Header;
+    uint8_t*    MiddlePtr               =   NULL;
+    
+    /* calculate the RemainingLength of PUBLISH Message */
+    RemainingLength = sizeof(uint16_t) + TopicLength + Message->Length;
+    if(FixedHeader & 0x06)
+    {
+        RemainingLength = RemainingLength + sizeof(uint16_t);
+    }
+    if(prvMQC_Version5(MQCHandler))
+    {
+        RemainingLength = RemainingLength + 1 + PropertyLength;
+    }
+    if(!prvMQC_RemainingLengthSize(RemainingLength))
+    {
+        return D_MQC_RET_UNEXPECTED_ERROR;
+    }
+    /* Fixed Header */
+    *EndPtr = FixedHeader;
+    EndPtr++;
+    /* Remaining Length */
+    EndPtr = EndPtr + prvMQC_RemainingLengthEncode(EndPtr, RemainingLength);
+    /* Topic Length */
+    *EndPtr = (uint8_t)(TopicLength >> 8);
+    EndPtr++;
+    *EndPtr = (uint8_t)(TopicLength);
+    EndPtr++;
+    
+    *VecNum = 0;
+    Vec[*VecNum].Data = Header;
+    Vec[*VecNum].Size = EndPtr - Header;
+    (*VecNum)++;
+    /* Topic Name */
+    if(TopicLength)
+    {
+        Vec[*VecNum].Data = Message->Topic.Data;
+        Vec[*VecNum].Size = TopicLength;
+        (*VecNum)++;
+    }
+    /* Packet Identifier and Properties follow the Topic Name */
+    MiddlePtr = EndPtr;
+    if(FixedHeader & 0x06)
+    {
+        *EndPtr = (uint8_t)(PacketIdentifier >> 8);
+        EndPtr++;
+        *EndPtr = (uint8_t)(PacketIdentifier);
+        EndPtr++;
+    }
+    if(prvMQC_Version5(MQCHandler))
+    {
+        *EndPtr = (uint8_t)PropertyLength;
+        EndPtr++;
+        if(TopicAlias)
+        {
+            *EndPtr = D_MQC_PROPERTY_TOPIC_ALIAS;
+            *(EndPtr + 1) = (uint8_t)(TopicAlias >> 8);
+            *(EndPtr + 2) = (uint8_t)(TopicAlias);
+            EndPtr = EndPtr + D_MQC_TOPIC_ALIAS_PROPERTY_SIZE;
+        }
+    }
+    if(EndPtr != MiddlePtr)
+    {
+        Vec[*VecNum].Data = MiddlePtr;
+        Vec[*VecNum].Size = EndPtr - MiddlePtr;
+        (*VecNum)++;
+    }
+    /* Message Content */
+    if(Message->Length)
+    {
+        Vec[*VecNum].Data = Message->Content;
+        Vec[*VecNum].Size = Message->Length;
+        (*VecNum)++;
+    }
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Encode MQTT Message which only has a Packet Identifier (PUBACK/PUBREC/PUBREL/PUBCOMP)
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           FixedHeader             The first byte of the Fixed Header
+ * @param[in]           PacketIdentifier        Packet Identifier
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_AckMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint8_t FixedHeader, uint16_t PacketIdentifier)
+{
+    int32_t     Ret                     =   D_MQC_RET_OK;
+    uint8_t*    EndPtr                  =   NULL;
+    
+    /* Fixed Header */
+    Ret = prvMQC_FixedHeaderEncode( MQCHandler, Buffer, FixedHeader, sizeof(uint16_t), &EndPtr );
+    if(Ret)
+    {
+        return Ret;
+    }
+    /* PacketIdentifier */
+    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Encode MQTT PUBACK Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           PacketIdentifier        Packet Identifier
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/11/21
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PubackMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint16_t PacketIdentifier)
+{
+    return prvMQC_AckMessageEncode( MQCHandler, Buffer, ( E_MQC_MSG_PUBACK << 4 ), PacketIdentifier );
+}
+
+/** 
+ * @brief               Encode MQTT PUBREC Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           PacketIdentifier        Packet Identifier
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/11/21
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PubrecMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint16_t PacketIdentifier)
+{
+    return prvMQC_AckMessageEncode( MQCHandler, Buffer, ( E_MQC_MSG_PUBREC << 4 ), PacketIdentifier );
+}
+
+/** 
+ * @brief               Encode MQTT PUBREL Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           PacketIdentifier        Packet Identifier
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/11/21
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PubrelMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint16_t PacketIdentifier)
+{
+    return prvMQC_AckMessageEncode( MQCHandler, Buffer, ( E_MQC_MSG_PUBREL << 4 ) + ( 1<<1 ), PacketIdentifier );
+}
+
+/** 
+ * @brief               Encode MQTT PUBCOMP Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @param[in]           PacketIdentifier        Packet Identifier
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/11/21
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PubcompMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer, uint16_t PacketIdentifier)
+{
+    return prvMQC_AckMessageEncode( MQCHandler, Buffer, ( E_MQC_MSG_PUBCOMP << 4 ), PacketIdentifier );
+}
+
+/** 
+ * @brief               Encode MQTT PINGREQ Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Buffer                  Output buffer of the encoder
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/11/21
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PingreqMessageEncode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_ENCODE_BUFFER* Buffer)
+{
+    uint8_t*    EndPtr                  =   NULL;
+    
+    return prvMQC_FixedHeaderEncode( MQCHandler, Buffer, ( E_MQC_MSG_PINGREQ << 4 ), D_MQC_PINGREQ_MSG_VARIABLE_HEADER_SIZE, &EndPtr );
+}
+
+/** 
+ * @brief               Make sure the receive buffer is large enough for the received data
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Size                    Size of the data need to be stored
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                The data already received is kept when the buffer is reallocated
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_RecvBufferReserve( S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Size )
+{
+    uint8_t*    StartPtr    =   NULL;
+    uint32_t    BufferSize  =   0;
+    
+    if(Size <= MQCHandler->SessionCtx.RecvBufferSize)
+    {
+        return D_MQC_RET_OK;
+    }
+    
+    /* Grow the buffer by twice (within the size kept by the session) to reduce the reallocation */
+    BufferSize = MQCHandler->SessionCtx.RecvBufferSize * 2;
+    if(BufferSize > MQC_RECV_BUFFER_KEEP_SIZE)
+    {
+        BufferSize = MQC_RECV_BUFFER_KEEP_SIZE;
+    }
+    if(BufferSize < Size)
+    {
+        BufferSize = Size;
+    }
+    
+    StartPtr = MQCHandler->MallocFunc(BufferSize);
+    if(!StartPtr)
+    {
+        return D_MQC_RET_NO_MEMORY;
+    }
+    if(MQCHandler->SessionCtx.RecvData)
+    {
+        memcpy(StartPtr, MQCHandler->SessionCtx.RecvData, MQCHandler->SessionCtx.RecvDataSize);
+        MQCHandler->FreeFunc(MQCHandler->SessionCtx.RecvData);
+    }
+    MQCHandler->SessionCtx.RecvData = StartPtr;
+    MQCHandler->SessionCtx.RecvBufferSize = BufferSize;
+    
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Check if the PUBLISH Message should be delivered in chunks
+ * @param[in]           MQCHandler              MQTT client handler
+ * @param[in]           FixedHeader             Fixed Header
+ * @param[in]           RemainingLength         Remaining Length of the Message
+ * @retval              true                    Deliver the Message in chunks
+ * @retval              false                   Deliver the whole Message
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvMQC_ChunkCheck( S_MQC_SESSION_HANDLE* MQCHandler, uint8_t FixedHeader, uint32_t RemainingLength )
+{
+    if( (E_MQC_MSG_PUBLISH != (FixedHeader >> 4)) || (!MQCHandler->ReadChunkFuncCB) )
+    {
+        return false;
+    }
+    return (RemainingLength >= MQCHandler->ReadChunkThreshold);
+}
+
+/** 
+ * @brief               Call the user callback function of an event
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Event                   Event notified to user
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @note                The session must not be locked
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_EventCall( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_EVENT* Event )
+{
+    S_MQC_MSG_CTX*  Message =   Event->Message;
+    int32_t         Ret     =   0;
+    
+    switch(Event->Type)
+    {
+        case E_MQC_EVENT_READ:
+            Ret = MQCHandler->ReadFuncCB(MQCHandler->UsrCtx, Event->MsgType, (E_MQC_MSG_PUBLISH == Event->MsgType)?(&(Event->Info)):(NULL));
+            break;
+        case E_MQC_EVENT_OPENRESET:
+            Ret = MQCHandler->OpenResetFuncCB(MQCHandler->UsrCtx, Event->Result, Event->SrvResCode, Event->SessionPresent);
+            break;
+        case E_MQC_EVENT_RESULT:
+            switch( Message->MsgData[0] >> 4 )
+            {
+                case E_MQC_MSG_SUBSCRIBE:
+                    Ret = Message->ExtData.Subscribe.ResultFuncCB(Event->Result, Message->ExtData.Subscribe.TopicFilterList, Event->CodeList, Message->ExtData.Subscribe.ListNum);
+                    break;
+                case E_MQC_MSG_UNSUBSCRIBE:
+                    Ret = Message->ExtData.UnSubscribe.ResultFuncCB(Event->Result, Message->ExtData.UnSubscribe.TopicFilterList, Message->ExtData.UnSubscribe.ListNum);
+                    break;
+                case E_MQC_MSG_PUBLISH:
+                    Ret = Message->ExtData.Publish.ResultFuncCB(Event->Result, &(Message->ExtData.Publish.Message));
+                    break;
+                default:
+                    /* Do nothing */
+                    break;
+            }
+            break;
+        case E_MQC_EVENT_CHUNK:
+            Ret = MQCHandler->ReadChunkFuncCB(MQCHandler->UsrCtx, Event->ChunkEvent, Event->ChunkInfo);
+            break;
+#if defined (MQC_TOPIC_DISPATCH)
+        case E_MQC_EVENT_TOPIC:
+            Ret = Event->Handler.HandlerFuncCB(Event->Handler.Ctx, &(Event->Info));
+            break;
+#endif /* MQC_TOPIC_DISPATCH */
+        default:
+            /* Do nothing */
+            break;
+    }
+    
+    return (Ret)?(D_MQC_RET_CALLBACK_ERROR):(D_MQC_RET_OK);
+}
+
+/** 
+ * @brief               Free the objects kept by an event for the notification
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Event                   Event notified to user
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_EventRelease( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_EVENT* Event )
+{
+    if(Event->Message)
+    {
+        prvMQC_ObjectFree(MQCHandler, Event->Message->MsgData);
+        prvMQC_ObjectFree(MQCHandler, Event->Message);
+        Event->Message = NULL;
+    }
+    if(Event->CodeList)
+    {
+        prvMQC_ObjectFree(MQCHandler, Event->CodeList);
+        Event->CodeList = NULL;
+    }
+    if(Event->CopyData)
+    {
+        MQCHandler->FreeFunc(Event->CopyData);
+        Event->CopyData = NULL;
+    }
+    return;
+}
+
+/** 
+ * @brief               Take all events from the event list of the session
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[out]          List                    Events taken
+ * @return              None
+ * @note                The session starts a new event list, so the events can be notified after the session is unlocked. \n
+ *                      The list keeps the pool of the session until prvMQC_EventFree, a callback may stop the session.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_EventTake( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_EVENT_LIST* List )
+{
+    *List = MQCHandler->SessionCtx.EventList;
+    MQCHandler->SessionCtx.EventList.Event = NULL;
+    MQCHandler->SessionCtx.EventList.Num = 0;
+    MQCHandler->SessionCtx.EventList.Size = 0;
+#if defined (D_MQC_POOL_ENABLED)
+    List->Pool = MQCHandler->SessionCtx.Pool;
+    if(List->Pool)
+    {
+        List->Pool->RefCount++;
+    }
+#endif /* D_MQC_POOL_ENABLED */
+    return;
+}
+
+/** 
+ * @brief               Notify user the events taken from the event list in order
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           List                    Events taken
+ * @return              None
+ * @note                The session must not be locked, the events are kept until prvMQC_EventFree
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_EventDispatch( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_EVENT_LIST* List )
+{
+    uint32_t    i   =   0;
+    
+    for( i = 0; i < List->Num; i++ )
+    {
+        (void)prvMQC_EventCall(MQCHandler, &(List->Event[i]));
+    }
+    return;
+}
+
+/** 
+ * @brief               Free the events taken from the event list
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       List                    Events taken
+ * @param[in,out]       Event                   Event notified with the list (can be NULL), its objects are freed too
+ * @return              None
+ * @note                The session must be locked, because the objects of the events may be in the fixed size pool
+ *                      of the session. The objects go back to the pool kept by the list, the session may have 
+ *                      been stopped (or started again with a new pool) by a callback. \n
+ *                      The memory of the list is given back to the session for the next events unless the session
+ *                      has got another one, it is larger than MQC_EVENT_KEEP_NUM or the session has been stopped.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_EventFree( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_EVENT_LIST* List, S_MQC_EVENT* Event )
+{
+    uint32_t        i       =   0;
+#if defined (D_MQC_POOL_ENABLED)
+    S_MQC_POOL*     Pool    =   MQCHandler->SessionCtx.Pool;
+    
+    MQCHandler->SessionCtx.Pool = List->Pool;
+#endif /* D_MQC_POOL_ENABLED */
+    
+    for( i = 0; i < List->Num; i++ )
+    {
+        prvMQC_EventRelease(MQCHandler, &(List->Event[i]));
+    }
+    List->Num = 0;
+    if(Event)
+    {
+        prvMQC_EventRelease(MQCHandler, Event);
+    }
+    
+#if defined (D_MQC_POOL_ENABLED)
+    MQCHandler->SessionCtx.Pool = Pool;
+    prvMQC_PoolRelease(MQCHandler, List->Pool);
+    List->Pool = NULL;
+#endif /* D_MQC_POOL_ENABLED */
+    
+    if( (E_MQC_STATUS_OPEN <= MQCHandler->SessionCtx.Status) && (E_MQC_STATUS_RESET >= MQCHandler->SessionCtx.Status) && 
+        !MQCHandler->SessionCtx.EventList.Event && (List->Size <= MQC_EVENT_KEEP_NUM) )
+    {
+        MQCHandler->SessionCtx.EventList = *List;
+    }
+    else if(List->Event)
+    {
+        MQCHandler->FreeFunc(List->Event);
+    }
+    List->Event = NULL;
+    List->Size = 0;
+    return;
+}
+
+/** 
+ * @brief               Notify user the events of the event list and an event at once
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in,out]       Event                   Event notified after the event list (can be NULL), its objects are freed
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @note                The session is unlocked during the notification and locked again before return
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_EventCallNow( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_EVENT* Event )
+{
+    S_MQC_EVENT_LIST    List;
+    int32_t             Ret     =   D_MQC_RET_OK;
+    
+    if( !MQCHandler->SessionCtx.EventList.Num && !Event )
+    {
+        return Ret;
+    }
+    
+    prvMQC_EventTake(MQCHandler, &List);
+    if(MQCHandler->UnlockFunc)
+    {
+        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
+    }
+    /* The events queued before go first to keep the order */
+    prvMQC_EventDispatch(MQCHandler, &List);
+    if(Event)
+    {
+        Ret = prvMQC_EventCall(MQCHandler, Event);
+    }
+    if(MQCHandler->LockFunc)
+    {
+        MQCHandler->LockFunc(MQCHandler->UsrCtx);
+    }
+    prvMQC_EventFree(MQCHandler, &List, Event);
+    
+    return Ret;
+}
+
+/** 
+ * @brief               Queue an event to notify user after the session is unlocked
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Local                   Event to notify (the objects kept by it are taken over)
+ * @return              None
+ * @note                The PUBLISH Message in the receive buffer of the session is copied, because the buffer
+ *                      may be reused by the next Message (so is the Topic Name got from the Topic Alias). \n
+ *                      The event is notified at once if no enough memory to queue it.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_EventQueue( S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_EVENT* Local )
+{
+    S_MQC_EVENT_LIST*   List        =   &(MQCHandler->SessionCtx.EventList);
+    S_MQC_EVENT*        Event       =   NULL;
+    uint8_t*            RecvData    =   MQCHandler->SessionCtx.RecvData;
+    uint32_t            Size        =   0;
+    
+    do
+    {
+        if(List->Num == List->Size)
+        {
+            /* Extend the list */
+            Size = (List->Size)?(List->Size * 2):(D_MQC_EVENT_LIST_INIT_NUM);
+            Event = (S_MQC_EVENT*)MQCHandler->MallocFunc(sizeof(S_MQC_EVENT) * Size);
+            if(!Event)
+            {
+                break;
+            }
+            if(List->Event)
+            {
+                memcpy(Event, List->Event, sizeof(S_MQC_EVENT) * List->Num);
+                MQCHandler->FreeFunc(List->Event);
+            }
+            List->Event = Event;
+            List->Size = Size;
+        }
+        
+        if( ( RecvData && (Local->Info.Topic.Data >= RecvData) && (Local->Info.Topic.Data < RecvData + MQCHandler->SessionCtx.RecvBufferSize) )
+#if defined (MQC_MQTT5)
+           /* The Topic Name of the Topic Alias may be replaced by the next Message */
+           || ( Local->Info.Topic.Data && (Local->Info.Topic.Data == MQCHandler->SessionCtx.RecvAliasTopic) )
+#endif /* MQC_MQTT5 */
+#if defined (MQC_PAYLOAD_CODEC)
+           /* The decoded payload is replaced by the next Message */
+           || ( Local->Info.Content && (Local->Info.Content == MQCHandler->SessionCtx.DecodeData) )
+#endif /* MQC_PAYLOAD_CODEC */
+          )
+        {
+            Local->CopyData = (uint8_t*)MQCHandler->MallocFunc(Local->Info.Topic.Length + Local->Info.Length);
+            if(!Local->CopyData)
+            {
+                break;
+            }
+            memcpy(Local->CopyData, Local->Info.Topic.Data, Local->Info.Topic.Length);
+            Local->Info.Topic.Data = Local->CopyData;
+            if(Local->Info.Length)
+            {
+                memcpy(Local->CopyData + Local->Info.Topic.Length, Local->Info.Content, Local->Info.Length);
+                Local->Info.Content = Local->CopyData + Local->Info.Topic.Length;
+            }
+        }
+        
+        List->Event[List->Num] = *Local;
+        List->Num++;
+        return;
+        
+    }while(0);
+    
+    /* No enough memory, notify user at once */
+    (void)prvMQC_EventCallNow(MQCHandler, Local);
+    return;
+}
+
+/** 
+ * @brief               Notify user a Message received from server after the session is unlocked
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           MsgType                 Message Type
+ * @param[in]           Info                    PUBLISH Message (NULL for the other Message)
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_ReadNotify( S_MQC_SESSION_HANDLE* MQCHandler, E_MQC_MSG_TYPE MsgType, S_MQC_MESSAGE_INFO* Info )
+{
+    S_MQC_EVENT     Event;
+    
+    if(!MQCHandler->ReadFuncCB)
+    {
+        return;
+    }
+    memset(&Event, 0, sizeof(S_MQC_EVENT));
+    Event.Type      =   E_MQC_EVENT_READ;
+    Event.MsgType   =   MsgType;
+    if(Info)
+    {
+        Event.Info  =   *Info;
+    }
+    prvMQC_EventQueue(MQCHandler, &Event);
+    return;
+}
+
+#if defined (MQC_TOPIC_DISPATCH)
+/** 
+ * @brief               Take back the handler registered by MQC_CoreSubscribeHandler for a Topic Filter
+ * @param[in]           MQCHandler              Session handle
+ * @param[in]           TopicFilter             Topic Filter of the handler
+ * @param[in]           Handler                 Handler replaced by the registered one
+ * @return              None
+ * @note                The replaced handler is put back in place of the registered one, so no memory is allocated, 
+ *                      the Topic Filter is removed only if no handler was registered for it before.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_TopicHandlerRestore( S_MQC_SESSION_HANDLE* MQCHandler, const S_MQC_UTF8_DATA* TopicFilter, const S_MQC_MSG_SUB_HANDLER* Handler )
+{
+    if(Handler->Replaced)
+    {
+        (void)MQC_TopicTrie_insert(&(MQCHandler->SessionCtx.TopicTrie), TopicFilter, &(Handler->Previous));
+    }
+    else
+    {
+        (void)MQC_TopicTrie_remove(&(MQCHandler->SessionCtx.TopicTrie), TopicFilter);
+    }
+    return;
+}
+
+/** 
+ * @brief               Notify the handler of a Topic Filter the PUBLISH Message after the session is unlocked
+ * @param[in]           Handler                 Handler of the matched Topic Filter
+ * @param[in,out]       UsrData                 Context of matching (S_MQC_TOPIC_MATCH_CTX)
+ * @return              None
+ * @note                Only the first event copies the Message out of the receive buffer, the later events of the
+ *                      same Message share the copy which is freed with the first one.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_TopicNotify( const S_MQC_TOPIC_HANDLER* Handler, void* UsrData )
+{
+    S_MQC_TOPIC_MATCH_CTX*  MatchCtx    =   (S_MQC_TOPIC_MATCH_CTX*)UsrData;
+    S_MQC_EVENT_LIST*       List        =   &(MatchCtx->MQCHandler->SessionCtx.EventList);
+    uint32_t                Num         =   List->Num;
+    S_MQC_EVENT             Event;
+    
+    memset(&Event, 0, sizeof(S_MQC_EVENT));
+    Event.Type      =   E_MQC_EVENT_TOPIC;
+    Event.MsgType   =   E_MQC_MSG_PUBLISH;
+    Event.Info      =   MatchCtx->Info;
+    Event.Handler   =   *Handler;
+    prvMQC_EventQueue(MatchCtx->MQCHandler, &Event);
+    
+    if(List->Num == Num + 1)
+    {
+        /* Queued, the later events use the same data */
+        MatchCtx->Info = List->Event[Num].Info;
+    }
+    else
+    {
+        /* Notified at once and the events queued before are freed */
+        MatchCtx->Info = MatchCtx->Origin;
+    }
+    return;
+}
+#endif /* MQC_TOPIC_DISPATCH */
+
+/** 
+ * @brief               Notify user the result of the CONNECT Message after the session is unlocked
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Result                  Result
+ * @param[in]           SrvResCode              Return code of the CONNACK Message
+ * @param[in]           SessionPresent          Session Present flag of the CONNACK Message
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_OpenResetNotify( S_MQC_SESSION_HANDLE* MQCHandler, E_MQC_BEHAVIOR_RESULT Result, uint8_t SrvResCode, bool SessionPresent )
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    i                       =   0;
-    size_t      WriteDataSize           =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
+    S_MQC_EVENT     Event;
     
-    /* calculate the RemainingLength of SUBSCRIBE Message */
-    RemainingLength = RemainingLength + D_MQC_SUBSCRIBE_MSG_VARIABLE_HEADER_SIZE;
-    for(i = 0; i < ListNum; i++)
+    if(!MQCHandler->OpenResetFuncCB)
     {
-        /* Topic Filter */
-        RemainingLength = RemainingLength + sizeof(uint16_t) + TopicFilterList[i].Length;
-        /* Requested QoS */
-        RemainingLength = RemainingLength + 1;
-    }
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
-    {
-        return (-1);
+        return;
     }
-    /* calculate the Total Message Size of CONNECT Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
+    memset(&Event, 0, sizeof(S_MQC_EVENT));
+    Event.Type              =   E_MQC_EVENT_OPENRESET;
+    Event.Result            =   Result;
+    Event.SrvResCode        =   SrvResCode;
+    Event.SessionPresent    =   SessionPresent;
+    prvMQC_EventQueue(MQCHandler, &Event);
+    return;
+}
+
+#if defined (MQC_PERSISTENCE)
+/** 
+ * @brief               Judge if a Message is kept in the store
+ * @param[in]           Type                    Message Type
+ * @retval              true                    PUBLISH, PUBREC or PUBREL Message
+ * @retval              false                   The other Messages
+ * @note                Only the QoS1/QoS2 PUBLISH Message waits in the queue, so the QoS is not checked
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvMQC_PersistCheck(uint8_t Type)
+{
+    return ( (E_MQC_MSG_PUBLISH == Type) || (E_MQC_MSG_PUBREC == Type) || (E_MQC_MSG_PUBREL == Type) );
+}
+
+/** 
+ * @brief               Save a Message pushed into the queue into the store
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Message                 Message in the queue
+ * @return              None
+ * @note                The Message is still sent if the store fails, it is just not resumed after the restart
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PersistSave(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MSG_CTX* Message)
+{
+    S_MQC_PERSIST_FUNC*     Func    =   MQCHandler->PersistFunc;
+    
+    if( MQCHandler->SessionCtx.PersistEnable && prvMQC_PersistCheck(Message->MsgData[0] >> 4) )
     {
-        *Dstlen = WriteDataSize;
-        return (0);
+        (void)Func->SaveFuncCB(Func->Ctx, (E_MQC_MSG_TYPE)(Message->MsgData[0] >> 4), Message->PacketIdentifier, Message->MsgData, Message->MsgLength);
+        MQCHandler->SessionCtx.PersistDirty = true;
     }
-    if(*Dstlen < WriteDataSize)
+    return;
+}
+
+/** 
+ * @brief               Delete a Message sliced from the queue from the store
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Message                 Message which is not in the queue any more
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PersistDelete(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MSG_CTX* Message)
+{
+    S_MQC_PERSIST_FUNC*     Func    =   MQCHandler->PersistFunc;
+    
+    if( MQCHandler->SessionCtx.PersistEnable && prvMQC_PersistCheck(Message->MsgData[0] >> 4) )
     {
-        /* No enough Buffer */
-        return (-1);
+        (void)Func->DeleteFuncCB(Func->Ctx, (E_MQC_MSG_TYPE)(Message->MsgData[0] >> 4), Message->PacketIdentifier);
+        MQCHandler->SessionCtx.PersistDirty = true;
     }
+    return;
+}
+
+/** 
+ * @brief               Delete all Messages from the store
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PersistClear(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    S_MQC_PERSIST_FUNC*     Func    =   MQCHandler->PersistFunc;
     
-    /* Make the Message Data */
-    EndPtr = Dst;
-    
-    /* Fixed Header */
-    *EndPtr = (E_MQC_MSG_SUBSCRIBE << 4) + (1<<1);
-    EndPtr++;
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    if(MQCHandler->SessionCtx.PersistEnable)
     {
-        return (-1);
+        (void)Func->ClearFuncCB(Func->Ctx);
+        MQCHandler->SessionCtx.PersistDirty = true;
     }
-    EndPtr = EndPtr + EncodeRemainingLength;
-    /* PacketIdentifier */
-    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    /* Topic Filter */
-    for(i = 0; i < ListNum; i++)
+    return;
+}
+
+/** 
+ * @brief               Make the changes of the store durable
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                Called once for each API call, so the changes by one MQC_Read are synced together
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PersistSync(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    S_MQC_PERSIST_FUNC*     Func    =   MQCHandler->PersistFunc;
+    
+    if(MQCHandler->SessionCtx.PersistDirty)
     {
-        *((uint16_t*)EndPtr) = MQC_htons(TopicFilterList[i].Length);
-        EndPtr = EndPtr + sizeof(uint16_t);
-        if(TopicFilterList[i].Length)
-        {
-            memcpy(EndPtr, TopicFilterList[i].Data, TopicFilterList[i].Length);
-        }
-        if(ExtData)
+        MQCHandler->SessionCtx.PersistDirty = false;
+        if(Func->SyncFuncCB)
         {
-            ExtData->TopicFilterList[i].Data = (TopicFilterList[i].Length)?EndPtr:NULL;
-            ExtData->TopicFilterList[i].Length = TopicFilterList[i].Length;
-            ExtData->ListNum = ListNum;
+            (void)Func->SyncFuncCB(Func->Ctx);
         }
-        EndPtr = EndPtr + TopicFilterList[i].Length;
-        *EndPtr = QoSList[i];
-        EndPtr++;
     }
-    *Dstlen = WriteDataSize;
-    return (0);
+    return;
 }
 
 /** 
- * @brief               Encode a buffer into MQTT UNSUBSCRIBE Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
+ * @brief               Resume a Message loaded from the store into the queue
+ * @param[in,out]       UsrData                 MQTT client handler
+ * @param[in]           Type                    Message Type
  * @param[in]           PacketIdentifier        Packet Identifier
- * @param[in]           TopicFilterList         Topic Filter List
- * @param[in]           ListNum                 The Count of the topic filter list
- * @param[out]          ExtData                 Extra Data used to store some customized information
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
- * @author              zhaozhenge@outlook.com
- * @date                2018/11/21
+ * @param[in]           Data                    Encoded Message
+ * @param[in]           Size                    Size of the encoded Message
+ * @retval              0                       Resumed or skipped
+ * @retval              -1                      No enough memory (stop loading)
+ * @note                The broken Message is skipped. The PUBLISH Message is sent again with the DUP flag
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_UnsubscribeMessageEncode(uint8_t* Dst, size_t* Dstlen, uint16_t PacketIdentifier, S_MQC_UTF8_DATA* TopicFilterList, uint32_t ListNum, S_MQC_MSG_UNSUB_DATA* ExtData)
+static int32_t prvMQC_PersistResume(void* UsrData, E_MQC_MSG_TYPE Type, uint16_t PacketIdentifier, const uint8_t* Data, size_t Size)
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    i                       =   0;
-    size_t      WriteDataSize           =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
-    
-    /* calculate the RemainingLength of UNSUBSCRIBE Message */
-    RemainingLength = RemainingLength + D_MQC_UNSUBSCRIBE_MSG_VARIABLE_HEADER_SIZE;
-    for(i = 0; i < ListNum; i++)
+    S_MQC_SESSION_HANDLE*   MQCHandler      =   (S_MQC_SESSION_HANDLE*)UsrData;
+    S_MQC_MSG_QUEUE*        MsgQueue        =   &(MQCHandler->SessionCtx.MessageQueue);
+    S_MQC_MSG_PUB_DATA*     PubData         =   NULL;
+    S_MQC_MSG_CTX*          PacketCtx       =   NULL;
+    uint32_t                RemainingLength =   0;
+    uint32_t                Multiplier      =   1;
+    uint32_t                Offset          =   1;
+    uint16_t                TopicLength     =   0;
+    uint32_t                PropertySize    =   0;
+#if defined (MQC_MQTT5)
+    uint32_t                PropertyLength  =   0;
+#endif /* MQC_MQTT5 */
+    
+    /* Check the Fixed Header and the Remaining Length */
+    if( (!prvMQC_PersistCheck(Type)) || (4 > Size) || ((Data[0] >> 4) != Type) )
+    {
+        return 0;
+    }
+    do
     {
-        /* Topic Filter */
-        RemainingLength = RemainingLength + sizeof(uint16_t) + TopicFilterList[i].Length;
+        RemainingLength += (Data[Offset] & 127) * Multiplier;
+        Multiplier *= 128;
+    }while( (Data[Offset++] & 128) && (Offset < 5) && (Offset < Size) );
+    if( (Data[Offset - 1] & 128) || ((Offset + RemainingLength) != Size) )
+    {
+        return 0;
     }
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    if(E_MQC_MSG_PUBLISH == Type)
     {
-        return (-1);
+        if( (E_MQC_QOS_0 == ((Data[0] & 0x06) >> 1)) || ((sizeof(uint16_t) * 2) > RemainingLength) )
+        {
+            return 0;
+        }
+        TopicLength = (uint16_t)((Data[Offset] << 8) | Data[Offset + 1]);
+        if( (sizeof(uint16_t) * 2 + TopicLength) > RemainingLength )
+        {
+            return 0;
+        }
+        Offset = Offset + sizeof(uint16_t) + TopicLength;
     }
-    /* calculate the Total Message Size of CONNECT Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
+    else if(sizeof(uint16_t) != RemainingLength)
     {
-        *Dstlen = WriteDataSize;
-        return (0);
+        return 0;
     }
-    if(*Dstlen < WriteDataSize)
+    /* Packet Identifier follows the Topic Name */
+    if( PacketIdentifier != (uint16_t)((Data[Offset] << 8) | Data[Offset + 1]) )
     {
-        /* No enough Buffer */
-        return (-1);
+        return 0;
     }
+#if defined (MQC_MQTT5)
+    /* Properties follow the Packet Identifier (the store should be used with the same ProtocolVersion) */
+    if( (E_MQC_MSG_PUBLISH == Type) && prvMQC_Version5(MQCHandler) )
+    {
+        PropertySize = prvMQC_VariableIntegerDecode(Data + Offset + sizeof(uint16_t), (uint32_t)(Size - Offset - sizeof(uint16_t)), &PropertyLength);
+        if( (!PropertySize) || ((sizeof(uint16_t) * 2 + TopicLength + PropertySize + PropertyLength) > RemainingLength) )
+        {
+            return 0;
+        }
+        PropertySize = PropertySize + PropertyLength;
+    }
+#endif /* MQC_MQTT5 */
     
-    /* Make the Message Data */
-    EndPtr = Dst;
+    /* The same Message is resumed only once */
+    if(MQC_MsgQueue_search(MsgQueue, PacketIdentifier, Type))
+    {
+        return 0;
+    }
+    /* The Packet Identifier of the client is in use until the flow completes */
+    if( (E_MQC_MSG_PUBREC != Type) && (!MQC_MsgQueue_reserve(MsgQueue, PacketIdentifier)) )
+    {
+        return 0;
+    }
     
-    /* Fixed Header */
-    *EndPtr = (E_MQC_MSG_UNSUBSCRIBE << 4) + (1<<1);
-    EndPtr++;
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    PacketCtx = prvMQC_ObjectMalloc(MQCHandler, sizeof(S_MQC_MSG_CTX));
+    if(PacketCtx)
     {
-        return (-1);
+        memset(PacketCtx, 0, sizeof(S_MQC_MSG_CTX));
+        PacketCtx->MsgData = prvMQC_ObjectMalloc(MQCHandler, Size);
     }
-    EndPtr = EndPtr + EncodeRemainingLength;
-    /* PacketIdentifier */
-    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    /* Topic Filter */
-    for(i = 0; i < ListNum; i++)
+    if( (!PacketCtx) || (!PacketCtx->MsgData) )
     {
-        *((uint16_t*)EndPtr) = MQC_htons(TopicFilterList[i].Length);
-        EndPtr = EndPtr + sizeof(uint16_t);
-        memcpy(EndPtr, TopicFilterList[i].Data, TopicFilterList[i].Length);
-        if(ExtData)
+        if(PacketCtx)
         {
-            ExtData->TopicFilterList[i].Data = EndPtr;
-            ExtData->TopicFilterList[i].Length = TopicFilterList[i].Length;
-            ExtData->ListNum = ListNum;
+            prvMQC_ObjectFree(MQCHandler, PacketCtx);
         }
-        EndPtr = EndPtr + TopicFilterList[i].Length;
+        if(E_MQC_MSG_PUBREC != Type)
+        {
+            MQC_MsgQueue_release(MsgQueue, PacketIdentifier);
+        }
+        return (-1);
     }
-    *Dstlen = WriteDataSize;
-    return (0);
+    memcpy(PacketCtx->MsgData, Data, Size);
+    PacketCtx->MsgLength                        =   (uint32_t)Size;
+    PacketCtx->PacketIdentifier                 =   PacketIdentifier;
+    /* Sent again at the next process as the suspended session does */
+    PacketCtx->SendCount                        =   MQCHandler->MessageRetryCount + 1;
+    PacketCtx->Timeout                          =   MQCHandler->MessageRetryInterval*1000;
+    if(E_MQC_MSG_PUBLISH == Type)
+    {
+        /* Set DUP (retry) flag to true, it may have been sent before the restart */
+        CLIB_BIT_SET(PacketCtx->MsgData[0], 3);
+        PubData = &(PacketCtx->ExtData.Publish);
+        PubData->ResultFuncCB           =   MQCHandler->PersistFunc->ResultFuncCB;
+        PubData->Message.Topic.Data     =   PacketCtx->MsgData + Offset - TopicLength;
+        PubData->Message.Topic.Length   =   TopicLength;
+        PubData->Message.Length         =   RemainingLength - sizeof(uint16_t) * 2 - TopicLength - PropertySize;
+        PubData->Message.Content        =   (PubData->Message.Length)?(PacketCtx->MsgData + Offset + sizeof(uint16_t) + PropertySize):(NULL);
+    }
+    if(E_MQC_MSG_PUBREC != Type)
+    {
+        /* PUBREC Message belongs to a QoS2 flow of the server, only the flows of the client use the in-flight window */
+        MQCHandler->SessionCtx.InflightCount++;
+    }
+    (void)MQC_MsgQueue_push(MsgQueue, PacketCtx);
+    
+    return 0;
 }
 
 /** 
- * @brief               Encode a buffer into MQTT PUBLISH Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
- * @param[in]           PacketIdentifier        Packet Identifier
- * @param[in]           Message                 Publish Message
- * @param[in]           Retry                   Retry (DUP) flag of the Publish Message (false: first send / true: retry)
- * @param[in]           QoS                     QoS level of the Publish Message
- * @param[in]           Retain                  If a Retain Message
- * @param[out]          ExtData                 Extra Data used to store some customized information
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
- * @author              zhaozhenge@outlook.com
- * @date                2018/12/18
+ * @brief               Resume the Messages in the store when the session starts
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                The store is cleared instead if CleanSession is true
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_PublishMessageEncode(uint8_t* Dst, size_t* Dstlen, uint16_t PacketIdentifier, S_MQC_MESSAGE_INFO* Message, bool Retry, E_MQC_QOS_LEVEL QoS, bool Retain, S_MQC_MSG_PUB_DATA* ExtData)
+static void prvMQC_PersistStart(S_MQC_SESSION_HANDLE* MQCHandler)
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    size_t      WriteDataSize           =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
-    
-    /* calculate the RemainingLength of PUBLISH Message */
-    RemainingLength = RemainingLength + sizeof(uint16_t) + Message->Topic.Length;
-    if( E_MQC_QOS_0 != QoS )
-    {
-        RemainingLength = RemainingLength + sizeof(uint16_t);
-    }
-    
-    RemainingLength = RemainingLength + Message->Length;
+    S_MQC_PERSIST_FUNC*     Func    =   MQCHandler->PersistFunc;
     
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    if(!Func)
     {
-        return (-1);
+        return;
     }
-    /* calculate the Total Message Size of PUBLISH Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
+    MQCHandler->SessionCtx.PersistEnable = true;
+    if(MQCHandler->CleanSession)
     {
-        *Dstlen = WriteDataSize;
-        return (0);
+        prvMQC_PersistClear(MQCHandler);
     }
-    if(*Dstlen < WriteDataSize)
+    else
     {
-        /* No enough Buffer */
-        return (-1);
+        (void)Func->LoadFuncCB(Func->Ctx, prvMQC_PersistResume, MQCHandler);
+        MQC_MsgQueue_expire(&(MQCHandler->SessionCtx.MessageQueue));
+        MQCHandler->SessionCtx.InflightPeak = MQCHandler->SessionCtx.InflightCount;
     }
+    prvMQC_PersistSync(MQCHandler);
+    return;
+}
+#endif /* MQC_PERSISTENCE */
+
+/** 
+ * @brief               Unlock the session and notify user the events queued while it was locked
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                The session is locked once more to free the events if there is any
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_CoreUnlock( S_MQC_SESSION_HANDLE* MQCHandler )
+{
+    S_MQC_EVENT_LIST    List;
     
-    /* Make the Message Data */
-    EndPtr = Dst;
+#if defined (MQC_PERSISTENCE)
+    /* Sync the store once for all changes by this call */
+    prvMQC_PersistSync(MQCHandler);
+#endif /* MQC_PERSISTENCE */
     
-    /* Fixed Header */
-    Retry = Retry ? (1):(0);
-    *EndPtr = ( E_MQC_MSG_PUBLISH << 4 ) + 
-              ( (( E_MQC_QOS_0 != QoS )?Retry:0) << 3 ) +
-              ( QoS << 1 ) +
-              ( Retain?(1):(0) );
-    EndPtr++; 
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    if(!MQCHandler->SessionCtx.EventList.Num)
     {
-        return (-1);
+        if(MQCHandler->UnlockFunc)
+        {
+            MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
+        }
+        return;
     }
-    EndPtr = EndPtr + EncodeRemainingLength;
-    /* Topic Name */
-    *((uint16_t*)EndPtr) = MQC_htons(Message->Topic.Length);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    memcpy(EndPtr, Message->Topic.Data, Message->Topic.Length);
-    if(ExtData)
+    
+    prvMQC_EventTake(MQCHandler, &List);
+    if(MQCHandler->UnlockFunc)
     {
-        ExtData->Message.Topic.Data = EndPtr;
-        ExtData->Message.Topic.Length = Message->Topic.Length;
+        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
     }
-    EndPtr = EndPtr + Message->Topic.Length;
-    /* PacketIdentifier */
-    if( E_MQC_QOS_0 != QoS )
+    prvMQC_EventDispatch(MQCHandler, &List);
+    if(MQCHandler->LockFunc)
     {
-        *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
-        EndPtr = EndPtr + sizeof(uint16_t);
+        MQCHandler->LockFunc(MQCHandler->UsrCtx);
     }
-    /* Message Content */
-    memcpy(EndPtr, Message->Content, Message->Length);
-    if(ExtData)
+    prvMQC_EventFree(MQCHandler, &List, NULL);
+    if(MQCHandler->UnlockFunc)
     {
-        ExtData->Message.Length = Message->Length;
-        ExtData->Message.Content = (Message->Length) ? EndPtr : NULL;
+        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
     }
-    *Dstlen = WriteDataSize;
-    return (0);  
+    return;
 }
 
 /** 
- * @brief               Encode a buffer into MQTT PUBACK Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
- * @param[in]           PacketIdentifier        Packet Identifier
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
- * @author              zhaozhenge@outlook.com
- * @date                2018/11/21
+ * @brief               Notify User an event of the Message delivered in chunks
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Event                   Event of the chunked delivery
+ * @param[in]           Content                 Fragment of the payload (only for E_MQC_CHUNK_DATA)
+ * @param[in]           Length                  Fragment Length
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_PubackMessageEncode(uint8_t* Dst, size_t* Dstlen, uint16_t PacketIdentifier)
+static int32_t prvMQC_ChunkNotify( S_MQC_SESSION_HANDLE* MQCHandler, E_MQC_CHUNK_EVENT Event, uint8_t* Content, uint32_t Length )
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    size_t      WriteDataSize           =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
-    
-    /* calculate the RemainingLength of PUBACK Message */
-    RemainingLength = RemainingLength + D_MQC_PUBACK_MSG_VARIABLE_HEADER_SIZE;
-    
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
-    {
-        return (-1);
-    }
-    /* calculate the Total Message Size of PUBACK Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
-    {
-        *Dstlen = WriteDataSize;
-        return (0);
-    }
-    if(*Dstlen < WriteDataSize)
-    {
-        /* No enough Buffer */
-        return (-1);
+    S_MQC_CHUNK_CTX*    ChunkCtx    =   &(MQCHandler->SessionCtx.ChunkCtx);
+    S_MQC_CHUNK_INFO    Info;
+    S_MQC_EVENT         ChunkEvent;
+    
+    Info.Topic.Data         =   ChunkCtx->Topic;
+    Info.Topic.Length       =   ChunkCtx->TopicLength;
+    Info.PacketIdentifier   =   ChunkCtx->PacketIdentifier;
+    Info.QoS                =   (E_MQC_QOS_LEVEL)((ChunkCtx->FixedHeader & 0x06) >> 1);
+    Info.TotalLength        =   ChunkCtx->TotalLength;
+    Info.Offset             =   ChunkCtx->Offset;
+    Info.Content            =   Content;
+    Info.Length             =   Length;
+    
+    if(!MQCHandler->ReadChunkFuncCB)
+    {
+        return D_MQC_RET_OK;
     }
     
-    /* Make the Message Data */
-    EndPtr = Dst;
+    memset(&ChunkEvent, 0, sizeof(S_MQC_EVENT));
+    ChunkEvent.Type         =   E_MQC_EVENT_CHUNK;
+    ChunkEvent.ChunkEvent   =   Event;
+    ChunkEvent.ChunkInfo    =   &Info;
     
-    /* Fixed Header */
-    *EndPtr = ( E_MQC_MSG_PUBACK << 4 );
-    EndPtr++; 
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    /* Not deferred, the response of the Message is sent after user notified the end of it */
+    return prvMQC_EventCallNow(MQCHandler, &ChunkEvent);
+}
+
+#if defined (MQC_PAYLOAD_CODEC)
+/** 
+ * @brief               Release the decode buffer grown for a big Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                The decode buffer is kept for the next Message unless it is larger than MQC_RECV_BUFFER_KEEP_SIZE
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_DecodeShrink( S_MQC_SESSION_HANDLE* MQCHandler )
+{
+    if( MQCHandler->SessionCtx.DecodeData && (MQCHandler->SessionCtx.DecodeBufferSize > MQC_RECV_BUFFER_KEEP_SIZE) )
     {
-        return (-1);
+        MQCHandler->FreeFunc(MQCHandler->SessionCtx.DecodeData);
+        MQCHandler->SessionCtx.DecodeData = NULL;
+        MQCHandler->SessionCtx.DecodeBufferSize = 0;
     }
-    EndPtr = EndPtr + EncodeRemainingLength;
-    /* PacketIdentifier */
-    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    *Dstlen = WriteDataSize;
-    return (0);
+    return;
 }
+#endif /* MQC_PAYLOAD_CODEC */
 
 /** 
- * @brief               Encode a buffer into MQTT PUBREC Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
- * @param[in]           PacketIdentifier        Packet Identifier
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
+ * @brief               Release the received data
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                The receive buffer is kept for the next message unless it is larger than 
+ *                      MQC_RECV_BUFFER_KEEP_SIZE. \n
+ *                      The Message being delivered in chunks is aborted.
  * @author              zhaozhenge@outlook.com
- * @date                2018/11/21
+ * @date                2018/04/12
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_PubrecMessageEncode(uint8_t* Dst, size_t* Dstlen, uint16_t PacketIdentifier)
+static void prvMQC_PackageFree( S_MQC_SESSION_HANDLE* MQCHandler )
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    size_t      WriteDataSize           =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
-    
-    /* calculate the RemainingLength of PUBREC Message */
-    RemainingLength = RemainingLength + D_MQC_PUBREC_MSG_VARIABLE_HEADER_SIZE;
-    
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    if(MQCHandler->SessionCtx.ChunkCtx.Notified && !MQCHandler->SessionCtx.ChunkCtx.Discard)
     {
-        return (-1);
+        /* Message delivered in chunks is not complete */
+        MQCHandler->SessionCtx.ChunkCtx.Notified = false;
+        (void)prvMQC_ChunkNotify(MQCHandler, E_MQC_CHUNK_ABORT, NULL, 0);
     }
-    /* calculate the Total Message Size of PUBREC Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
+    memset(&(MQCHandler->SessionCtx.ChunkCtx), 0, sizeof(S_MQC_CHUNK_CTX));
+    if( MQCHandler->SessionCtx.RecvData && (MQCHandler->SessionCtx.RecvBufferSize > MQC_RECV_BUFFER_KEEP_SIZE) )
     {
-        *Dstlen = WriteDataSize;
-        return (0);
+        /* Shrink the buffer allocated for a big message */
+        MQCHandler->FreeFunc(MQCHandler->SessionCtx.RecvData);
+        MQCHandler->SessionCtx.RecvData = NULL;
+        MQCHandler->SessionCtx.RecvBufferSize = 0;
     }
-    if(*Dstlen < WriteDataSize)
+#if defined (MQC_PAYLOAD_CODEC)
+    prvMQC_DecodeShrink(MQCHandler);
+#endif /* MQC_PAYLOAD_CODEC */
+    MQCHandler->SessionCtx.RecvDataSize = 0;
+    MQCHandler->SessionCtx.TotalRecvDataSize = 0;
+    MQCHandler->SessionCtx.HeaderDataSize = 0;
+    return;
+}
+
+/** 
+ * @brief               Release the received data and the receive buffer
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PackageRelease( S_MQC_SESSION_HANDLE* MQCHandler )
+{
+    prvMQC_PackageFree(MQCHandler);
+    if(MQCHandler->SessionCtx.RecvData)
     {
-        /* No enough Buffer */
-        return (-1);
+        MQCHandler->FreeFunc(MQCHandler->SessionCtx.RecvData);
     }
-    
-    /* Make the Message Data */
-    EndPtr = Dst;
-    
-    /* Fixed Header */
-    *EndPtr = ( E_MQC_MSG_PUBREC << 4 );
-    EndPtr++; 
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    MQCHandler->SessionCtx.RecvData = NULL;
+    MQCHandler->SessionCtx.RecvBufferSize = 0;
+#if defined (MQC_PAYLOAD_CODEC)
+    if(MQCHandler->SessionCtx.DecodeData)
     {
-        return (-1);
+        MQCHandler->FreeFunc(MQCHandler->SessionCtx.DecodeData);
     }
-    EndPtr = EndPtr + EncodeRemainingLength;
-    /* PacketIdentifier */
-    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    *Dstlen = WriteDataSize;
-    return (0);
+    MQCHandler->SessionCtx.DecodeData = NULL;
+    MQCHandler->SessionCtx.DecodeBufferSize = 0;
+#endif /* MQC_PAYLOAD_CODEC */
+    return;
 }
 
 /** 
- * @brief               Encode a buffer into MQTT PUBREL Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
- * @param[in]           PacketIdentifier        Packet Identifier
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
+ * @brief               Notify User the result of a Message sent by the client and free the Message
+ * @param[in,out]       MQCHandler      MQTT client handler
+ * @param[in]           Message         Message which is not in the queue (freed after the notification)
+ * @param[in]           Result          Result of the Message
+ * @param[in]           CodeList        Return codes of the SUBACK Message (freed after the notification, can be NULL)
+ * @return              None
+ * @note                User is notified after the session is unlocked
  * @author              zhaozhenge@outlook.com
- * @date                2018/11/21
+ * @date                2018/12/14
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_PubrelMessageEncode(uint8_t* Dst, size_t* Dstlen, uint16_t PacketIdentifier)
+static void prvMQC_MessageNotify(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MSG_CTX*  Message, E_MQC_BEHAVIOR_RESULT Result, E_MQC_RETURN_CODE* CodeList)
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    size_t      WriteDataSize           =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
+    S_MQC_EVENT     Event;
+    bool            Notify  =   false;
     
-    /* calculate the RemainingLength of PUBREL Message */
-    RemainingLength = RemainingLength + D_MQC_PUBREL_MSG_VARIABLE_HEADER_SIZE;
-    
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
-    {
-        return (-1);
-    }
-    /* calculate the Total Message Size of PUBREL Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
+    switch( Message->MsgData[0] >> 4 )
     {
-        *Dstlen = WriteDataSize;
-        return (0);
+        case E_MQC_MSG_SUBSCRIBE:
+            Notify = (NULL != Message->ExtData.Subscribe.ResultFuncCB);
+            break;
+        case E_MQC_MSG_UNSUBSCRIBE:
+            Notify = (NULL != Message->ExtData.UnSubscribe.ResultFuncCB);
+            break;
+        case E_MQC_MSG_PUBLISH:
+            Notify = (NULL != Message->ExtData.Publish.ResultFuncCB);
+            break;
+        default:
+            /* Do nothing */
+            break;
     }
-    if(*Dstlen < WriteDataSize)
+    
+    memset(&Event, 0, sizeof(S_MQC_EVENT));
+    Event.Type      =   E_MQC_EVENT_RESULT;
+    Event.Result    =   Result;
+    Event.Message   =   Message;
+    Event.CodeList  =   CodeList;
+    if(Notify)
     {
-        /* No enough Buffer */
-        return (-1);
+        prvMQC_EventQueue(MQCHandler, &Event);
     }
-    
-    /* Make the Message Data */
-    EndPtr = Dst;
-    
-    /* Fixed Header */
-    *EndPtr = ( E_MQC_MSG_PUBREL << 4 ) + ( 1<<1 );
-    EndPtr++; 
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    else
     {
-        return (-1);
+        prvMQC_EventRelease(MQCHandler, &Event);
     }
-    EndPtr = EndPtr + EncodeRemainingLength;
-    /* PacketIdentifier */
-    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    *Dstlen = WriteDataSize;
-    return (0);
+    return;
 }
 
 /** 
- * @brief               Encode a buffer into MQTT PUBCOMP Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
- * @param[in]           PacketIdentifier        Packet Identifier
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
- * @author              zhaozhenge@outlook.com
- * @date                2018/11/21
+ * @brief               End the flow of a QoS1/QoS2 PUBLISH Message sent by the client
+ * @param[in,out]       MQCHandler          MQTT client handler
+ * @param[in]           PacketIdentifier    Packet Identifier of the PUBLISH Message
+ * @return              None
+ * @note                The Packet Identifier and the slot of the in-flight window can be used again. \n
+ *                      Only the PUBLISH and PUBREL Messages of the client end here, each of them was counted 
+ *                      when it was sent or resumed (the PUBREC Messages of the server flows are never counted)
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_PubcompMessageEncode(uint8_t* Dst, size_t* Dstlen, uint16_t PacketIdentifier)
+static void prvMQC_PublishFlowEnd(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t PacketIdentifier)
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    size_t      WriteDataSize           =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
-    
-    /* calculate the RemainingLength of PUBCOMP Message */
-    RemainingLength = RemainingLength + D_MQC_PUBCOMP_MSG_VARIABLE_HEADER_SIZE;
-    
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
-    {
-        return (-1);
-    }
-    /* calculate the Total Message Size of PUBCOMP Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
-    {
-        *Dstlen = WriteDataSize;
-        return (0);
-    }
-    if(*Dstlen < WriteDataSize)
+    MQC_MsgQueue_release(&(MQCHandler->SessionCtx.MessageQueue), PacketIdentifier);
+    MQCHandler->SessionCtx.InflightCount--;
+    return;
+}
+
+/** 
+ * @brief               Release the Packet Identifier of a Message which is discarded
+ * @param[in,out]       MQCHandler      MQTT client handler
+ * @param[in]           Message         Discarded Message
+ * @return              None
+ * @note                PUBREC Message uses the Packet Identifier of the server, so it is not released
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PacketIdentifierRelease(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MSG_CTX*  Message)
+{
+    switch( Message->MsgData[0] >> 4 )
     {
-        /* No enough Buffer */
-        return (-1);
+        case E_MQC_MSG_SUBSCRIBE:
+        case E_MQC_MSG_UNSUBSCRIBE:
+            MQC_MsgQueue_release(&(MQCHandler->SessionCtx.MessageQueue), Message->PacketIdentifier);
+            break;
+        case E_MQC_MSG_PUBLISH:
+        case E_MQC_MSG_PUBREL:
+            prvMQC_PublishFlowEnd(MQCHandler, Message->PacketIdentifier);
+            break;
+        default:
+            /* Do nothing */
+            break;
     }
+    return;
+}
+
+/** 
+ * @brief               Write the Messages waiting in the output batch by one WriteFuncCB call
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              Return value of WriteFuncCB (0 if nothing is waiting)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_BatchFlush(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    int32_t     Ret     =   0;
     
-    /* Make the Message Data */
-    EndPtr = Dst;
-    
-    /* Fixed Header */
-    *EndPtr = ( E_MQC_MSG_PUBCOMP << 4 );
-    EndPtr++; 
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    if(MQCHandler->SessionCtx.BatchLength)
     {
-        return (-1);
+        Ret = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, MQCHandler->SessionCtx.BatchData, MQCHandler->SessionCtx.BatchLength);
+        MQCHandler->SessionCtx.BatchLength = 0;
     }
-    EndPtr = EndPtr + EncodeRemainingLength;
-    /* PacketIdentifier */
-    *((uint16_t*)EndPtr) = MQC_htons(PacketIdentifier);
-    EndPtr = EndPtr + sizeof(uint16_t);
-    *Dstlen = WriteDataSize;
-    return (0);
+    return Ret;
 }
 
 /** 
- * @brief               Encode a buffer into MQTT PINGREQ Message format
- * @param[in]           Dst                     Destination buffer (can be NULL for checking size)
- * @param[in,out]       Dstlen                  \b in   :   Size of the destination buffer \n
- *                                              \b out  :   Number of bytes written
- * @retval              0                       success
- * @retval              -1                      Destination buffer too small
- * @note                Input \a *Dstlen = 0 to obtain the required buffer size in \a *Dstlen
- * @author              zhaozhenge@outlook.com
- * @date                2018/11/21
+ * @brief               Write a Message in segments through the output batch
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Vec                     Segments of the Message
+ * @param[in]           VecNum                  Number of the segments
+ * @return              Return value of the write callback function (0 if the Message is kept in the output batch)
+ * @note                The Message smaller than WriteBatchSize is appended to the output batch, and the batch is written 
+ *                      when it is full. The others are written at once after the batch, so the order is kept. \n
+ *                      More than one segment is only used with WriteVecFuncCB.
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_PingreqMessageEncode(uint8_t* Dst, size_t* Dstlen)
+static int32_t prvMQC_CoreWriteVec(S_MQC_SESSION_HANDLE* MQCHandler, const S_MQC_IOVEC* Vec, uint32_t VecNum)
 {
-    uint32_t    RemainingLength         =   0;
-    uint32_t    EncodeRemainingLength   =   0;
-    size_t      WriteDataSize           =   0;
-    int32_t     Ret                     =   0;
-    uint8_t*    EndPtr                  =   NULL;
+    S_MQC_SESSION_CTX*  SessionCtx  =   &(MQCHandler->SessionCtx);
+    size_t              Size        =   0;
+    uint32_t            i           =   0;
+    int32_t             Ret         =   0;
+    int32_t             WriteRet    =   0;
     
-    /* calculate the RemainingLength of PINGREQ Message */
-    RemainingLength = RemainingLength + D_MQC_PINGREQ_MSG_VARIABLE_HEADER_SIZE;
+    for(i = 0; i < VecNum; i++)
+    {
+        Size = Size + Vec[i].Size;
+    }
     
-    Ret = prvMQC_RemainingLengthEncode( NULL, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
+    if( (Size < MQCHandler->WriteBatchSize) && (!SessionCtx->BatchData) )
     {
-        return (-1);
+        /* The buffer is allocated at the first use, and kept until MQC_Stop */
+        SessionCtx->BatchData = MQCHandler->MallocFunc(MQCHandler->WriteBatchSize);
+        SessionCtx->BatchBufferSize = (SessionCtx->BatchData)?(MQCHandler->WriteBatchSize):(0);
     }
-    /* calculate the Total Message Size of PINGREQ Message */
-    WriteDataSize = EncodeRemainingLength + RemainingLength + 1;
-    if( (NULL == Dst) || (0 == *Dstlen) )
+    
+    if( Size < SessionCtx->BatchBufferSize )
     {
-        *Dstlen = WriteDataSize;
-        return (0);
+        if( (SessionCtx->BatchLength + Size) > SessionCtx->BatchBufferSize )
+        {
+            Ret = prvMQC_BatchFlush(MQCHandler);
+        }
+        for(i = 0; i < VecNum; i++)
+        {
+            memcpy(SessionCtx->BatchData + SessionCtx->BatchLength, Vec[i].Data, Vec[i].Size);
+            SessionCtx->BatchLength = SessionCtx->BatchLength + Vec[i].Size;
+        }
+        if(SessionCtx->BatchLength == SessionCtx->BatchBufferSize)
+        {
+            WriteRet = prvMQC_BatchFlush(MQCHandler);
+        }
     }
-    if(*Dstlen < WriteDataSize)
+    else
     {
-        /* No enough Buffer */
-        return (-1);
+        /* Too large for the output batch (or no batch), write the Messages before it first */
+        Ret = prvMQC_BatchFlush(MQCHandler);
+        if(1 == VecNum)
+        {
+            WriteRet = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, Vec[0].Data, Vec[0].Size);
+        }
+        else
+        {
+            WriteRet = MQCHandler->WriteVecFuncCB(MQCHandler->UsrCtx, Vec, VecNum);
+        }
     }
     
-    /* Make the Message Data */
-    EndPtr = Dst;
+    return (Ret)?(Ret):(WriteRet);
+}
+
+/** 
+ * @brief               Write a Message through the output batch
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Data                    Message data
+ * @param[in]           Size                    Message data size
+ * @return              Return value of WriteFuncCB (0 if the Message is kept in the output batch)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_CoreWrite(S_MQC_SESSION_HANDLE* MQCHandler, const uint8_t* Data, size_t Size)
+{
+    S_MQC_IOVEC Vec     =   { Data, Size };
     
-    /* Fixed Header */
-    *EndPtr = ( E_MQC_MSG_PINGREQ << 4 );
-    EndPtr++; 
-    /* Remaining Length */
-    Ret = prvMQC_RemainingLengthEncode( EndPtr, &EncodeRemainingLength, RemainingLength );
-    if(Ret)
-    {
-        return (-1);
-    }
-    *Dstlen = WriteDataSize;
-    return (0);
+    return prvMQC_CoreWriteVec(MQCHandler, &Vec, 1);
 }
 
+#if defined (MQC_MQTT5)
 /** 
- * @brief               Release the received data
+ * @brief               Forget the Topic Aliases of the connection
  * @param[in,out]       MQCHandler              MQTT client handler
  * @return              None
- * @author              zhaozhenge@outlook.com
- * @date                2018/04/12
+ * @note                The Topic Aliases only live as long as the network connection
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static void prvMQC_PackageFree( S_MQC_SESSION_HANDLE* MQCHandler )
+static void prvMQC_TopicAliasReset(S_MQC_SESSION_HANDLE* MQCHandler)
 {
-    if(MQCHandler->SessionCtx.RecvData)
-    {
-        MQCHandler->FreeFunc(MQCHandler->SessionCtx.RecvData);
-    }
-    MQCHandler->SessionCtx.RecvData = NULL;
-    MQCHandler->SessionCtx.RecvDataSize = 0;
-    MQCHandler->SessionCtx.TotalRecvDataSize = 0;
-    MQCHandler->SessionCtx.HeaderDataSize = 0;
+    (void)MQC_TopicAlias_delete(&(MQCHandler->SessionCtx.SendAlias));
+    (void)MQC_TopicAlias_delete(&(MQCHandler->SessionCtx.RecvAlias));
+    MQCHandler->SessionCtx.RecvAliasTopic = NULL;
     return;
 }
 
 /** 
- * @brief               Notify User there is Message that is discarded
- * @param[in,out]       MQCHandler      MQTT client handler
- * @param[in]           Message         Discarded Message
- * @param[in]           Result          Discard Reasion
+ * @brief               Send a PUBLISH Message with the Topic Alias of the client
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           FixedHeader             The first byte of the Fixed Header
+ * @param[in]           Message                 Publish Message
+ * @param[in]           PacketIdentifier        Packet Identifier (not used when QoS Level = 0)
  * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_NOTIFY     No Topic Alias is used, the caller sends the Message with the Topic Name
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_CALLBACK_ERROR
- * @author              zhaozhenge@outlook.com
- * @date                2018/12/14
+ * @note                The Topic Name is omitted if the server knows its Topic Alias, otherwise it is sent with
+ *                      a free (or the least recently used) Topic Alias. \n
+ *                      The Topic Aliases are forgotten if the Message cannot be written, because the server may
+ *                      not know the last one.
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMessageDiscardNotify(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MSG_CTX*  Message, E_MQC_BEHAVIOR_RESULT Result)
+static int32_t prvMQC_PublishAliasWrite(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t FixedHeader, S_MQC_MESSAGE_INFO* Message, uint16_t PacketIdentifier)
 {
-    int32_t Ret = D_MQC_RET_OK;
-    switch( Message->MsgData[0] >> 4 )
+    S_MQC_SESSION_CTX*  SessionCtx      =   &(MQCHandler->SessionCtx);
+    S_MQC_ENCODE_BUFFER Buffer          =   { NULL, 0, false };
+    uint8_t             Header[D_MQC_PUBLISH_VEC_HEADER_SIZE];
+    S_MQC_IOVEC         Vec[D_MQC_PUBLISH_VEC_NUM];
+    uint32_t            VecNum          =   0;
+    uint32_t            RemainingLength =   0;
+    uint16_t            TopicAlias      =   0;
+    uint16_t            Num             =   0;
+    bool                TopicOmit       =   false;
+    size_t              Size            =   0;
+    uint8_t*            EndPtr          =   NULL;
+    uint32_t            i               =   0;
+    int32_t             Ret             =   D_MQC_RET_OK;
+    
+    /* The Topic Alias is not shorter than the Topic Name */
+    if( (!SessionCtx->SendAlias.Num) || (D_MQC_TOPIC_ALIAS_PROPERTY_SIZE >= Message->Topic.Length) )
+    {
+        return D_MQC_RET_NO_NOTIFY;
+    }
+    TopicAlias = MQC_TopicAlias_search(&(SessionCtx->SendAlias), &(Message->Topic));
+    TopicOmit = (0 != TopicAlias);
+    if(!TopicOmit)
     {
-        case E_MQC_MSG_SUBSCRIBE:
-            D_MQC_CALLBACK_SAFECALL(Ret, Message->ExtData.Subscribe.ResultFuncCB, Result, Message->ExtData.Subscribe.TopicFilterList, NULL, Message->ExtData.Subscribe.ListNum);
-            break;
-        case E_MQC_MSG_UNSUBSCRIBE:
-            D_MQC_CALLBACK_SAFECALL(Ret, Message->ExtData.UnSubscribe.ResultFuncCB, Result, Message->ExtData.UnSubscribe.TopicFilterList, Message->ExtData.UnSubscribe.ListNum);
-            break;
-        case E_MQC_MSG_PUBLISH:
-            D_MQC_CALLBACK_SAFECALL(Ret, Message->ExtData.Publish.ResultFuncCB, Result, &(Message->ExtData.Publish.Message));
+        TopicAlias = MQC_TopicAlias_insert(&(SessionCtx->SendAlias), &(Message->Topic));
+        if(!TopicAlias)
+        {
+            return D_MQC_RET_NO_NOTIFY;
+        }
+    }
+    
+    do
+    {
+        Ret = prvMQC_PublishMessageEncodeVec(MQCHandler, Header, Vec, &VecNum, FixedHeader, Message, PacketIdentifier, TopicAlias, TopicOmit);
+        if(Ret)
+        {
             break;
-        default:
-            /* Do nothing */
+        }
+        for(i = 0; i < VecNum; i++)
+        {
+            Size = Size + Vec[i].Size;
+        }
+        if(!MQCHandler->WriteVecFuncCB)
+        {
+            /* Join the segments in the send buffer of the session */
+            EndPtr = prvMQC_EncodeBufferGet(MQCHandler, &Buffer, Size);
+            if(!EndPtr)
+            {
+                Ret = D_MQC_RET_NO_MEMORY;
+                break;
+            }
+            for(i = 0; i < VecNum; i++)
+            {
+                memcpy(EndPtr, Vec[i].Data, Vec[i].Size);
+                EndPtr = EndPtr + Vec[i].Size;
+            }
+            Vec[0].Data = Buffer.Data;
+            Vec[0].Size = Buffer.Size;
+            VecNum = 1;
+        }
+        Ret = prvMQC_CoreWriteVec(MQCHandler, Vec, VecNum);
+        if(Ret)
+        {
+            Ret = D_MQC_RET_CALLBACK_ERROR;
             break;
+        }
+        
+        if(TopicOmit)
+        {
+            /* Size of the Message with the Topic Name and without the Topic Alias */
+            RemainingLength = sizeof(uint16_t) + Message->Topic.Length + ((FixedHeader & 0x06)?(sizeof(uint16_t)):(0)) + 1 + Message->Length;
+            SessionCtx->AliasHitCount++;
+            SessionCtx->AliasSavedBytes += (1 + prvMQC_RemainingLengthSize(RemainingLength) + RemainingLength) - Size;
+        }
+        else
+        {
+            SessionCtx->AliasMapCount++;
+        }
+        Ret = D_MQC_RET_OK;
+        
+    }while(0);
+    
+    prvMQC_EncodeBufferRelease(MQCHandler, &Buffer);
+    
+    if(D_MQC_RET_OK != Ret)
+    {
+        Num = SessionCtx->SendAlias.Num;
+        (void)MQC_TopicAlias_delete(&(SessionCtx->SendAlias));
+        (void)MQC_TopicAlias_create(&(SessionCtx->SendAlias), Num, MQCHandler->MallocFunc, MQCHandler->FreeFunc);
     }
     return Ret;
 }
+#endif /* MQC_MQTT5 */
 
 /** 
  * @brief               Send CONNECT Message
@@ -1136,40 +2828,39 @@ static int32_t prvMessageDiscardNotify(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_M
  */
 static int32_t prvMQC_CoreConnect(S_MQC_SESSION_HANDLE* MQCHandler, bool CleanSession)
 {
-    size_t      WriteDataSize   =   0;  
-    uint8_t*    WriteData       =   NULL;
-    int32_t     Ret             =   D_MQC_RET_OK;
+    S_MQC_ENCODE_BUFFER Buffer          =   { NULL, 0, false };
+    int32_t             Ret             =   D_MQC_RET_OK;
     
     do
     {
-        /* Get the data size */
-        Ret = prvMQC_ConnectMessageEncode( WriteData, &WriteDataSize, CleanSession, &(MQCHandler->WillMessage), 
-                                         &(MQCHandler->Authorition), MQCHandler->KeepAliveInterval, &(MQCHandler->ClientId) );
-        if(Ret)
-        {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
-        }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
+#if defined (MQC_MQTT5)
+        /* The Topic Aliases and the limits of the former connection are not used any more */
+        prvMQC_TopicAliasReset(MQCHandler);
+        MQCHandler->SessionCtx.ServerReceiveMaximum     = 0;
+        MQCHandler->SessionCtx.ServerMaximumPacketSize  = 0;
+        if(prvMQC_Version5(MQCHandler))
         {
-            Ret = D_MQC_RET_NO_MEMORY;
-            break;
+            /* The server may use the Topic Aliases as soon as the CONNECT Message is sent */
+            Ret = MQC_TopicAlias_create(&(MQCHandler->SessionCtx.RecvAlias), MQCHandler->TopicAliasMaximum, MQCHandler->MallocFunc, MQCHandler->FreeFunc);
+            if(Ret)
+            {
+                break;
+            }
         }
-        
-        /* Encode CONNECT Message data */
-        Ret = prvMQC_ConnectMessageEncode( WriteData, &WriteDataSize, CleanSession, &(MQCHandler->WillMessage), 
+#endif /* MQC_MQTT5 */
+        /* Encode CONNECT Message data into the send buffer of the session */
+        Ret = prvMQC_ConnectMessageEncode( MQCHandler, &Buffer, CleanSession, &(MQCHandler->WillMessage), 
                                          &(MQCHandler->Authorition), MQCHandler->KeepAliveInterval, &(MQCHandler->ClientId) );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
+        /* The Messages left in the output batch belong to the former connection */
+        MQCHandler->SessionCtx.BatchLength = 0;
+        
         /* Use callback function to send data */
-        Ret = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
+        Ret = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, Buffer.Data, Buffer.Size);
         
         if(Ret)
         {
@@ -1181,12 +2872,7 @@ static int32_t prvMQC_CoreConnect(S_MQC_SESSION_HANDLE* MQCHandler, bool CleanSe
         }
     }while(0);
     
-    /* Free the malloc memory */
-    if(WriteData)
-    {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
-    }
+    prvMQC_EncodeBufferRelease(MQCHandler, &Buffer);
     
     return Ret;
 }
@@ -1204,15 +2890,30 @@ static void prvMQC_CoreCleanSession(S_MQC_SESSION_HANDLE* MQCHandler)
 {
     S_MQC_MSG_CTX*  Message =   NULL;
     
+#if defined (MQC_PERSISTENCE)
+    /* The Messages are discarded together from the store */
+    prvMQC_PersistClear(MQCHandler);
+#endif /* MQC_PERSISTENCE */
+    
     do
     {
         Message = MQC_MsgQueue_pop(&(MQCHandler->SessionCtx.MessageQueue));
         if(Message)
         {
             /* Notify the application this message discarded via callback function */
-            (void)prvMessageDiscardNotify(MQCHandler, Message, E_MQC_BEHAVIOR_CANCEL);
-            MQCHandler->FreeFunc(Message->MsgData);
-            MQCHandler->FreeFunc(Message);
+            prvMQC_PacketIdentifierRelease(MQCHandler, Message);
+            prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_CANCEL, NULL);
+        }
+    }while(Message);
+    
+    /* The Messages in the pending list have not been sent */
+    do
+    {
+        Message = MQC_MsgQueue_unhold(&(MQCHandler->SessionCtx.MessageQueue));
+        if(Message)
+        {
+            /* Notify the application this message discarded via callback function */
+            prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_CANCEL, NULL);
         }
     }while(Message);
     
@@ -1233,156 +2934,231 @@ static void prvMQC_CoreCleanSession(S_MQC_SESSION_HANDLE* MQCHandler)
  */
 static int32_t prvMQC_CoreDisconnect(S_MQC_SESSION_HANDLE* MQCHandler)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    uint8_t             WriteData[D_MQC_ACK_MSG_SIZE];
+    S_MQC_ENCODE_BUFFER Buffer          =   { WriteData, sizeof(WriteData), false };
+    int32_t             Ret             =   D_MQC_RET_OK;
     
     do
     {
-        /* Get the data size */
-        Ret = prvMQC_DisconnectMessageEncode( WriteData, &WriteDataSize );
+        /* Encode DISCONNECT Message data */
+        Ret = prvMQC_DisconnectMessageEncode( MQCHandler, &Buffer );
+        if(Ret)
+        {
+            break;
+        }
         
+        /* Use callback function to send data, nothing is left in the output batch after DISCONNECT */
+        Ret = prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
+        if(!Ret)
+        {
+            Ret = prvMQC_BatchFlush(MQCHandler);
+        }
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
+            Ret = D_MQC_RET_CALLBACK_ERROR;
+            break;
+        }
+        
+        Ret = D_MQC_RET_OK;
+        
+    }while(0);
+    
+    return Ret;
+}
+
+/** 
+ * @brief               Send SUBSCRIBE Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilterList         Topic Filter List
+ * @param[in]           QoSList                 Topic Filter QoS List
+ * @param[in]           ListNum                 The Count of the topic filter list
+ * @param[in]           ResultFuncCB            Callback function will be called when received response
+ * @param[in]           HandlerList             Handlers replaced by the Topic Filters (copied, NULL if no handler is registered)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/12/03
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_CoreSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, uint32_t ListNum, F_SUBSCRIBE_RES_CBFUNC ResultFuncCB, const S_MQC_MSG_SUB_HANDLER* HandlerList)
+{
+    S_MQC_ENCODE_BUFFER Buffer              =   { NULL, 0, true };
+    S_MQC_MSG_CTX*      PacketCtx           =   NULL;
+    uint16_t            PacketIdentifier    =   0;
+    int32_t             Ret                 =   D_MQC_RET_OK;
+    
+    do
+    {
+        /* Allocate a Packet Identifier which is not in use */
+        PacketIdentifier = MQC_MsgQueue_allocate(&(MQCHandler->SessionCtx.MessageQueue));
+        if(!PacketIdentifier)
+        {
+            Ret = D_MQC_RET_BUSY;
             break;
         }
         
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
+        /* alloc memory to buffer the message in queue (the replaced handlers are kept after the Topic Filters) */
+        PacketCtx = prvMQC_ObjectMalloc(MQCHandler, sizeof(S_MQC_MSG_CTX) + ListNum * sizeof(S_MQC_UTF8_DATA) + 
+                                                    ((HandlerList)?(ListNum * sizeof(S_MQC_MSG_SUB_HANDLER)):(0)));
+        if(!PacketCtx)
         {
             Ret = D_MQC_RET_NO_MEMORY;
             break;
         }
+        PacketCtx->ExtData.Subscribe.HandlerList = NULL;
+        if(HandlerList)
+        {
+            PacketCtx->ExtData.Subscribe.HandlerList = (S_MQC_MSG_SUB_HANDLER*)&(PacketCtx->ExtData.Subscribe.TopicFilterList[ListNum]);
+            memcpy(PacketCtx->ExtData.Subscribe.HandlerList, HandlerList, ListNum * sizeof(S_MQC_MSG_SUB_HANDLER));
+        }
         
-        /* Encode PUBLISH Message data */
-        Ret = prvMQC_DisconnectMessageEncode( WriteData, &WriteDataSize );
+        /* Encode SUBSCRIBE Message data into the buffer kept in queue */
+        Ret = prvMQC_SubscribeMessageEncode( MQCHandler, &Buffer, PacketIdentifier, TopicFilterList, QoSList, ListNum, &(PacketCtx->ExtData.Subscribe) );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
+        PacketCtx->SendCount                        =   MQCHandler->MessageRetryCount;
+        PacketCtx->Timeout                          =   MQCHandler->MessageRetryInterval*1000;
+        PacketCtx->MsgLength                        =   Buffer.Size;
+        PacketCtx->MsgData                          =   Buffer.Data;
+        PacketCtx->PacketIdentifier                 =   PacketIdentifier;
+        PacketCtx->ExtData.Subscribe.ResultFuncCB   =   ResultFuncCB;
+        
+        /* Push the Message data in queue */
+        PacketCtx = MQC_MsgQueue_push( &(MQCHandler->SessionCtx.MessageQueue), PacketCtx );
+        
         /* Use callback function to send data */
-        Ret = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
-        if(Ret)
+        (void)prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
+        
+        if(PacketCtx)
         {
-            Ret = D_MQC_RET_CALLBACK_ERROR;
-            break;
+            /* Notify the application this message discarded via callback function */
+            prvMQC_MessageNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL, NULL);
         }
+        /* The Message data is kept by the queue or freed with the popped Message */
+        Buffer.Data = NULL;
+        PacketCtx = NULL;
         
         Ret = D_MQC_RET_OK;
         
     }while(0);
     
     /* Free the malloc memory */
-    if(WriteData)
+    if(Buffer.Data)
+    {
+        prvMQC_ObjectFree(MQCHandler, Buffer.Data);
+        Buffer.Data = NULL;
+    }
+    
+    /* Give back the Packet Identifier if the Message has not been queued */
+    if( (D_MQC_RET_OK != Ret) && PacketIdentifier )
+    {
+        MQC_MsgQueue_release(&(MQCHandler->SessionCtx.MessageQueue), PacketIdentifier);
+    }
+    
+    if(PacketCtx)
     {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
+        prvMQC_ObjectFree(MQCHandler, PacketCtx);
+        PacketCtx = NULL;
     }
     
     return Ret;
 }
 
 /** 
- * @brief               Send SUBSCRIBE Message
+ * @brief               Send UNSUBSCRIBE Message
  * @param[in,out]       MQCHandler              MQTT client handler
  * @param[in]           TopicFilterList         Topic Filter List
- * @param[in]           QoSList                 Topic Filter QoS List
  * @param[in]           ListNum                 The Count of the topic filter list
  * @param[in]           ResultFuncCB            Callback function will be called when received response
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @author              zhaozhenge@outlook.com
  * @date                2018/12/03
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_CoreSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, uint32_t ListNum, F_SUBSCRIBE_RES_CBFUNC ResultFuncCB)
+static int32_t prvMQC_CoreUnSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, uint32_t ListNum, F_UNSUBSCRIBE_RES_CBFUNC ResultFuncCB)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    S_MQC_MSG_CTX*  PacketCtx       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    S_MQC_ENCODE_BUFFER Buffer              =   { NULL, 0, true };
+    S_MQC_MSG_CTX*      PacketCtx           =   NULL;
+    uint16_t            PacketIdentifier    =   0;
+    int32_t             Ret                 =   D_MQC_RET_OK;
     
     do
     {
-        MQCHandler->SessionCtx.MessageQueue.PacketIdentifier = (65535 == MQCHandler->SessionCtx.MessageQueue.PacketIdentifier)?1:(MQCHandler->SessionCtx.MessageQueue.PacketIdentifier+1);
-        
-        /* Get the data size */
-        Ret = prvMQC_SubscribeMessageEncode( WriteData, &WriteDataSize, MQCHandler->SessionCtx.MessageQueue.PacketIdentifier, TopicFilterList, QoSList, ListNum, NULL );
-        if(Ret)
-        {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
-        }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
+        /* Allocate a Packet Identifier which is not in use */
+        PacketIdentifier = MQC_MsgQueue_allocate(&(MQCHandler->SessionCtx.MessageQueue));
+        if(!PacketIdentifier)
         {
-            Ret = D_MQC_RET_NO_MEMORY;
+            Ret = D_MQC_RET_BUSY;
             break;
         }
         
         /* alloc memory to buffer the message in queue */
-        PacketCtx = MQCHandler->MallocFunc(sizeof(S_MQC_MSG_CTX) + ListNum * sizeof(S_MQC_UTF8_DATA));
+        PacketCtx = prvMQC_ObjectMalloc(MQCHandler, sizeof(S_MQC_MSG_CTX) + ListNum * sizeof(S_MQC_UTF8_DATA));
         if(!PacketCtx)
         {
             Ret = D_MQC_RET_NO_MEMORY;
             break;
         }
         
-        /* Encode SUBSCRIBE Message data */
-        Ret = prvMQC_SubscribeMessageEncode( WriteData, &WriteDataSize, MQCHandler->SessionCtx.MessageQueue.PacketIdentifier, TopicFilterList, QoSList, ListNum, &(PacketCtx->ExtData.Subscribe) );
+        /* Encode UNSUBSCRIBE Message data into the buffer kept in queue */
+        Ret = prvMQC_UnsubscribeMessageEncode( MQCHandler, &Buffer, PacketIdentifier, TopicFilterList, ListNum, &(PacketCtx->ExtData.UnSubscribe) );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
         PacketCtx->SendCount                        =   MQCHandler->MessageRetryCount;
-        PacketCtx->ExpireTime                       =   MQCHandler->MessageRetryInterval*1000;
         PacketCtx->Timeout                          =   MQCHandler->MessageRetryInterval*1000;
-        PacketCtx->MsgLength                        =   WriteDataSize;
-        PacketCtx->MsgData                          =   WriteData;
-        PacketCtx->PacketIdentifier                 =   MQCHandler->SessionCtx.MessageQueue.PacketIdentifier;
-        PacketCtx->ExtData.Subscribe.ResultFuncCB   =   ResultFuncCB;
+        PacketCtx->MsgLength                        =   Buffer.Size;
+        PacketCtx->MsgData                          =   Buffer.Data;
+        PacketCtx->PacketIdentifier                 =   PacketIdentifier;
+        PacketCtx->ExtData.UnSubscribe.ResultFuncCB =   ResultFuncCB;
         
         /* Push the Message data in queue */
         PacketCtx = MQC_MsgQueue_push( &(MQCHandler->SessionCtx.MessageQueue), PacketCtx );
         
         /* Use callback function to send data */
-        (void)MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
+        (void)prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
         
         if(PacketCtx)
         {
             /* Notify the application this message discarded via callback function */
-            Ret = prvMessageDiscardNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL);
-            WriteData = PacketCtx->MsgData;
-        }
-        else
-        {
-            WriteData = NULL;
+            prvMQC_MessageNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL, NULL);
         }
+        /* The Message data is kept by the queue or freed with the popped Message */
+        Buffer.Data = NULL;
+        PacketCtx = NULL;
         
         Ret = D_MQC_RET_OK;
         
     }while(0);
     
     /* Free the malloc memory */
-    if(WriteData)
+    if(Buffer.Data)
+    {
+        prvMQC_ObjectFree(MQCHandler, Buffer.Data);
+        Buffer.Data = NULL;
+    }
+    
+    /* Give back the Packet Identifier if the Message has not been queued */
+    if( (D_MQC_RET_OK != Ret) && PacketIdentifier )
     {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
+        MQC_MsgQueue_release(&(MQCHandler->SessionCtx.MessageQueue), PacketIdentifier);
     }
     
     if(PacketCtx)
     {
-        MQCHandler->FreeFunc(PacketCtx);
+        prvMQC_ObjectFree(MQCHandler, PacketCtx);
         PacketCtx = NULL;
     }
     
@@ -1390,174 +3166,633 @@ static int32_t prvMQC_CoreSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8
 }
 
 /** 
- * @brief               Send UNSUBSCRIBE Message
+ * @brief               Send PUBLISH Message (QoS Level = 0)
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Message                 Message Content
+ * @param[in]           Retain                  Retain Message Flag
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @note                QoS0 level Message has no response
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/12/03
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_CorePublish_withoutQoS(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_INFO* Message, bool Retain)
+{
+    S_MQC_ENCODE_BUFFER Buffer          =   { NULL, 0, false };
+    uint8_t             Header[D_MQC_PUBLISH_VEC_HEADER_SIZE];
+    S_MQC_IOVEC         Vec[D_MQC_PUBLISH_VEC_NUM];
+    uint32_t            VecNum          =   0;
+    int32_t             Ret             =   D_MQC_RET_OK;
+    
+    do
+    {
+#if defined (MQC_MQTT5)
+        Ret = prvMQC_PublishAliasWrite( MQCHandler, ( E_MQC_MSG_PUBLISH << 4 ) + ( Retain?(1):(0) ), Message, 0 );
+        if(D_MQC_RET_NO_NOTIFY != Ret)
+        {
+            break;
+        }
+#endif /* MQC_MQTT5 */
+        if(MQCHandler->WriteVecFuncCB)
+        {
+            /* Send the Topic Name and the payload of the user directly */
+            Ret = prvMQC_PublishMessageEncodeVec( MQCHandler, Header, Vec, &VecNum, ( E_MQC_MSG_PUBLISH << 4 ) + ( Retain?(1):(0) ), Message, 0, 0, false );
+            if(Ret)
+            {
+                break;
+            }
+            Ret = prvMQC_CoreWriteVec(MQCHandler, Vec, VecNum);
+        }
+        else
+        {
+            /* Encode PUBLISH Message data into the send buffer of the session */
+            Ret = prvMQC_PublishMessageEncode( MQCHandler, &Buffer, 0, Message, false, E_MQC_QOS_0, Retain, NULL );
+            if(Ret)
+            {
+                break;
+            }
+            /* Use callback function to send data */
+            Ret = prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
+        }
+        if(Ret)
+        {
+            Ret = D_MQC_RET_CALLBACK_ERROR;
+            break;
+        }
+        
+        Ret = D_MQC_RET_OK;
+        
+    }while(0);
+    
+    prvMQC_EncodeBufferRelease(MQCHandler, &Buffer);
+    
+    return Ret;
+}
+
+/** 
+ * @brief               Send a PUBLISH Message (QoS Level = 1 or 2) with a Packet Identifier and keep it in queue
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           PacketCtx               PUBLISH Message encoded without Packet Identifier
+ * @param[in]           PacketIdentifier        Packet Identifier allocated for the Message
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PublishSend(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MSG_CTX* PacketCtx, uint16_t PacketIdentifier)
+{
+    S_MQC_MSG_PUB_DATA* PubData     =   &(PacketCtx->ExtData.Publish);
+    S_MQC_MSG_CTX*      PopCtx      =   NULL;
+    int32_t             Ret         =   D_MQC_RET_NO_NOTIFY;
+    
+#if defined (MQC_MQTT5)
+    /* The Message buffered before the connection may be larger than the Maximum Packet Size of the server */
+    if( MQCHandler->SessionCtx.ServerMaximumPacketSize && (PacketCtx->MsgLength > MQCHandler->SessionCtx.ServerMaximumPacketSize) )
+    {
+        MQC_MsgQueue_release(&(MQCHandler->SessionCtx.MessageQueue), PacketIdentifier);
+        prvMQC_MessageNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL, NULL);
+        return;
+    }
+#endif /* MQC_MQTT5 */
+    
+    /* Packet Identifier follows the Topic Name */
+    *((uint16_t*)(PubData->Message.Topic.Data + PubData->Message.Topic.Length)) = MQC_htons(PacketIdentifier);
+    
+    PacketCtx->SendCount                        =   MQCHandler->MessageRetryCount;
+    PacketCtx->Timeout                          =   MQCHandler->MessageRetryInterval*1000;
+    PacketCtx->PacketIdentifier                 =   PacketIdentifier;
+    
+#if defined (MQC_PERSISTENCE)
+    /* Save the Message data before it is sent */
+    prvMQC_PersistSave(MQCHandler, PacketCtx);
+#endif /* MQC_PERSISTENCE */
+    /* Push the Message data in queue */
+    PopCtx = MQC_MsgQueue_push( &(MQCHandler->SessionCtx.MessageQueue), PacketCtx );
+    MQCHandler->SessionCtx.InflightCount++;
+    if(MQCHandler->SessionCtx.InflightPeak < MQCHandler->SessionCtx.InflightCount)
+    {
+        MQCHandler->SessionCtx.InflightPeak = MQCHandler->SessionCtx.InflightCount;
+    }
+    
+#if defined (MQC_MQTT5)
+    /* Only the first send uses the Topic Alias, the Message kept in queue has the Topic Name for the retry */
+    Ret = prvMQC_PublishAliasWrite(MQCHandler, PacketCtx->MsgData[0], &(PubData->Message), PacketIdentifier);
+#endif /* MQC_MQTT5 */
+    if(D_MQC_RET_NO_NOTIFY == Ret)
+    {
+        /* Use callback function to send data */
+        (void)prvMQC_CoreWrite(MQCHandler, PacketCtx->MsgData, PacketCtx->MsgLength);
+    }
+    /* Set DUP (retry) flag to true */
+    CLIB_BIT_SET(PacketCtx->MsgData[0], 3);
+    
+    if(PopCtx)
+    {
+        /* Notify the application this message discarded via callback function */
+        prvMQC_PacketIdentifierRelease(MQCHandler, PopCtx);
+        prvMQC_MessageNotify(MQCHandler, PopCtx, E_MQC_BEHAVIOR_CANCEL, NULL);
+    }
+    return;
+}
+
+/** 
+ * @brief               Get the size of the in-flight window of the PUBLISH Message
+ * @param[in]           MQCHandler              MQTT client handler
+ * @return              Maximum number of the PUBLISH Messages (QoS Level = 1 or 2) in flight (0 means no limit)
+ * @note                With MQTT 5.0 the window is also limited by the Receive Maximum of the server
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvMQC_InflightMaximum(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    uint32_t    InflightMaximum =   MQCHandler->MaxInflight;
+    
+#if defined (MQC_MQTT5)
+    if( MQCHandler->SessionCtx.ServerReceiveMaximum && 
+        ( (!InflightMaximum) || (InflightMaximum > MQCHandler->SessionCtx.ServerReceiveMaximum) ) )
+    {
+        InflightMaximum = MQCHandler->SessionCtx.ServerReceiveMaximum;
+    }
+#endif /* MQC_MQTT5 */
+    return InflightMaximum;
+}
+
+/** 
+ * @brief               Judge if the in-flight window of the PUBLISH Message is full
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              true                    No more PUBLISH Message (QoS Level = 1 or 2) can be sent now
+ * @retval              false                   PUBLISH Message (QoS Level = 1 or 2) can be sent
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvMQC_PublishWindowFull(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    uint32_t    InflightMaximum =   prvMQC_InflightMaximum(MQCHandler);
+    
+    return ( InflightMaximum && (MQCHandler->SessionCtx.InflightCount >= InflightMaximum) );
+}
+
+#if defined (MQC_PAYLOAD_CODEC)
+/** 
+ * @brief               Encode the payload of a PUBLISH Message by the codec of its Topic
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Message                 Publish Message
+ * @param[out]          Encoded                 Publish Message with the encoded payload (the same as Message if no codec)
+ * @param[out]          EncodeData              Buffer of the encoded payload, freed by prvMQC_PayloadEncodeEnd (NULL if no codec)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @note                The empty payload is not encoded, so it still clears the retained Message. \n
+ *                      The format byte goes first, and the payload is sent as it is (D_MQC_CODEC_FORMAT_RAW) 
+ *                      if the codec does not make it smaller
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PayloadEncode(S_MQC_SESSION_HANDLE* MQCHandler, const S_MQC_MESSAGE_INFO* Message, S_MQC_MESSAGE_INFO* Encoded, uint8_t** EncodeData)
+{
+    const S_MQC_CODEC*  Codec       =   NULL;
+    size_t              Bound       =   0;
+    size_t              Size        =   0;
+    
+    *Encoded = *Message;
+    *EncodeData = NULL;
+    if(!Message->Length)
+    {
+        return D_MQC_RET_OK;
+    }
+    Codec = MQC_Codec_search(&(MQCHandler->SessionCtx.CodecTable), &(Message->Topic));
+    if(!Codec)
+    {
+        return D_MQC_RET_OK;
+    }
+    
+    /* The buffer is taken from the pool of the session when it fits, it can also keep the raw payload */
+    Bound = Codec->BoundFuncCB(Codec->Ctx, Message->Length);
+    if(!Bound)
+    {
+        return D_MQC_RET_CALLBACK_ERROR;
+    }
+    *EncodeData = (uint8_t*)prvMQC_ObjectMalloc(MQCHandler, 1 + ((Bound > Message->Length)?(Bound):(Message->Length)));
+    if(!(*EncodeData))
+    {
+        return D_MQC_RET_NO_MEMORY;
+    }
+    Size = Bound;
+    if( Codec->EncodeFuncCB(Codec->Ctx, Message->Content, Message->Length, *EncodeData + 1, &Size) || (Size > Bound) )
+    {
+        prvMQC_ObjectFree(MQCHandler, *EncodeData);
+        *EncodeData = NULL;
+        return D_MQC_RET_CALLBACK_ERROR;
+    }
+    if(Size < Message->Length)
+    {
+        (*EncodeData)[0] = D_MQC_CODEC_FORMAT_ENCODED;
+    }
+    else
+    {
+        /* Nothing is saved, send the payload as it is */
+        (*EncodeData)[0] = D_MQC_CODEC_FORMAT_RAW;
+        memcpy(*EncodeData + 1, Message->Content, Message->Length);
+        Size = Message->Length;
+    }
+    Encoded->Content = *EncodeData;
+    Encoded->Length = (uint32_t)(1 + Size);
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Count the payload encoded by prvMQC_PayloadEncode and free its buffer
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Message                 Publish Message given by user
+ * @param[in]           Encoded                 Publish Message with the encoded payload
+ * @param[in]           EncodeData              Buffer of the encoded payload (NULL if no codec)
+ * @param[in]           Ret                     Result of the publish, only the Messages accepted are counted
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PayloadEncodeEnd(S_MQC_SESSION_HANDLE* MQCHandler, const S_MQC_MESSAGE_INFO* Message, const S_MQC_MESSAGE_INFO* Encoded, uint8_t* EncodeData, int32_t Ret)
+{
+    if(!EncodeData)
+    {
+        return;
+    }
+    if(D_MQC_RET_OK == Ret)
+    {
+        MQCHandler->SessionCtx.EncodeCount++;
+        MQCHandler->SessionCtx.EncodeRawBytes += Message->Length;
+        MQCHandler->SessionCtx.EncodeBytes += Encoded->Length;
+    }
+    /* The encoded payload has been copied into the Message */
+    prvMQC_ObjectFree(MQCHandler, EncodeData);
+    return;
+}
+
+/** 
+ * @brief               Decode the payload of a received PUBLISH Message by the codec of its Topic
  * @param[in,out]       MQCHandler              MQTT client handler
- * @param[in]           TopicFilterList         Topic Filter List
- * @param[in]           ListNum                 The Count of the topic filter list
- * @param[in]           ResultFuncCB            Callback function will be called when received response
+ * @param[in,out]       Message                 Publish Message (the payload is replaced by the decoded one)
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_NO_MEMORY
- * @retval              D_MQC_RET_UNEXPECTED_ERROR
- * @author              zhaozhenge@outlook.com
- * @date                2018/12/03
+ * @retval              D_MQC_RET_BAD_FORMAT
+ * @note                The decoded payload is kept in the decode buffer of the session until the Message is notified, 
+ *                      it is copied if the notification is deferred. \n
+ *                      The payload sent as it is (D_MQC_CODEC_FORMAT_RAW) only loses its format byte. \n
+ *                      The size told by the codec comes from the other side, so it is checked with DecodeMaxSize 
+ *                      before the decode buffer grows for it.
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_CoreUnSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, uint32_t ListNum, F_UNSUBSCRIBE_RES_CBFUNC ResultFuncCB)
+static int32_t prvMQC_PayloadDecode(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_INFO* Message)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    S_MQC_MSG_CTX*  PacketCtx       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    S_MQC_SESSION_CTX*  SessionCtx  =   &(MQCHandler->SessionCtx);
+    const S_MQC_CODEC*  Codec       =   NULL;
+    size_t              Size        =   0;
+    size_t              MaxSize     =   MQCHandler->DecodeMaxSize;
+    int32_t             Ret         =   D_MQC_RET_BAD_FORMAT;
+    
+    if(!Message->Length)
+    {
+        return D_MQC_RET_OK;
+    }
+    Codec = MQC_Codec_search(&(SessionCtx->CodecTable), &(Message->Topic));
+    if(!Codec)
+    {
+        return D_MQC_RET_OK;
+    }
     
     do
     {
-        MQCHandler->SessionCtx.MessageQueue.PacketIdentifier = (65535 == MQCHandler->SessionCtx.MessageQueue.PacketIdentifier)?1:(MQCHandler->SessionCtx.MessageQueue.PacketIdentifier+1);
-        
-        /* Get the data size */
-        Ret = prvMQC_UnsubscribeMessageEncode( WriteData, &WriteDataSize, MQCHandler->SessionCtx.MessageQueue.PacketIdentifier, TopicFilterList, ListNum, NULL );
-        if(Ret)
+        if(D_MQC_CODEC_FORMAT_RAW == Message->Content[0])
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
+            /* The other side did not encode it */
+            Message->Content = (Message->Length > 1)?(Message->Content + 1):(NULL);
+            Message->Length = Message->Length - 1;
+            SessionCtx->DecodeCount++;
+            return D_MQC_RET_OK;
         }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
+        if(D_MQC_CODEC_FORMAT_ENCODED != Message->Content[0])
         {
-            Ret = D_MQC_RET_NO_MEMORY;
             break;
         }
         
-        /* alloc memory to buffer the message in queue */
-        PacketCtx = MQCHandler->MallocFunc(sizeof(S_MQC_MSG_CTX) + ListNum * sizeof(S_MQC_UTF8_DATA));
-        if(!PacketCtx)
+        /* Size of the decoded payload */
+        if(!MaxSize)
         {
-            Ret = D_MQC_RET_NO_MEMORY;
-            break;
+#if defined (MQC_MQTT5)
+            MaxSize = (MQCHandler->MaximumPacketSize)?(MQCHandler->MaximumPacketSize):(MQC_DECODE_MAX_SIZE);
+#else
+            MaxSize = MQC_DECODE_MAX_SIZE;
+#endif /* MQC_MQTT5 */
         }
-        
-        /* Encode UNSUBSCRIBE Message data */
-        Ret = prvMQC_UnsubscribeMessageEncode( WriteData, &WriteDataSize, MQCHandler->SessionCtx.MessageQueue.PacketIdentifier, TopicFilterList, ListNum, &(PacketCtx->ExtData.UnSubscribe) );
-        if(Ret)
+        if( Codec->DecodeFuncCB(Codec->Ctx, Message->Content + 1, Message->Length - 1, NULL, &Size) || (Size > MaxSize) )
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
-        
-        PacketCtx->SendCount                        =   MQCHandler->MessageRetryCount;
-        PacketCtx->ExpireTime                       =   MQCHandler->MessageRetryInterval*1000;
-        PacketCtx->Timeout                          =   MQCHandler->MessageRetryInterval*1000;
-        PacketCtx->MsgLength                        =   WriteDataSize;
-        PacketCtx->MsgData                          =   WriteData;
-        PacketCtx->PacketIdentifier                 =   MQCHandler->SessionCtx.MessageQueue.PacketIdentifier;
-        PacketCtx->ExtData.UnSubscribe.ResultFuncCB =   ResultFuncCB;
-        
-        /* Push the Message data in queue */
-        PacketCtx = MQC_MsgQueue_push( &(MQCHandler->SessionCtx.MessageQueue), PacketCtx);
-        
-        /* Use callback function to send data */
-        (void)MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
-        
-        if(PacketCtx)
+        if(Size > SessionCtx->DecodeBufferSize)
         {
-            /* Notify the application this message discarded via callback function */
-            Ret = prvMessageDiscardNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL);
-            WriteData = PacketCtx->MsgData;
+            /* Extend the buffer */
+            if(SessionCtx->DecodeData)
+            {
+                MQCHandler->FreeFunc(SessionCtx->DecodeData);
+            }
+            SessionCtx->DecodeBufferSize = 0;
+            SessionCtx->DecodeData = (uint8_t*)MQCHandler->MallocFunc(Size);
+            if(!SessionCtx->DecodeData)
+            {
+                Ret = D_MQC_RET_NO_MEMORY;
+                break;
+            }
+            SessionCtx->DecodeBufferSize = Size;
         }
-        else
+        if( Size && Codec->DecodeFuncCB(Codec->Ctx, Message->Content + 1, Message->Length - 1, SessionCtx->DecodeData, &Size) )
         {
-            WriteData = NULL;
+            break;
         }
-        
-        Ret = D_MQC_RET_OK;
+        Message->Content = (Size)?(SessionCtx->DecodeData):(NULL);
+        Message->Length = (uint32_t)Size;
+        SessionCtx->DecodeCount++;
+        return D_MQC_RET_OK;
         
     }while(0);
     
-    /* Free the malloc memory */
-    if(WriteData)
+    SessionCtx->DecodeErrorCount++;
+    return Ret;
+}
+#endif /* MQC_PAYLOAD_CODEC */
+
+#if defined (MQC_OFFLINE_BUFFER)
+/** 
+ * @brief               Judge if the oldest Message of the offline buffer can be sent now
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              true                    The Message can be sent
+ * @retval              false                   The buffer is empty or the Message must wait
+ * @note                The Messages of the buffer wait until the pending list is empty to keep the order,
+ *                      and the QoS1/QoS2 ones also wait for a free slot of the in-flight window
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvMQC_OfflineReady(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    S_MQC_MSG_CTX*      Message     =   MQC_MsgQueue_parked(&(MQCHandler->SessionCtx.MessageQueue));
+    
+    if( (!Message) || (E_MQC_STATUS_WORK != MQCHandler->SessionCtx.Status) || MQCHandler->SessionCtx.MessageQueue.PendingCount )
     {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
+        return false;
     }
-    
-    if(PacketCtx)
+    if( (Message->MsgData[0] & 0x06) && prvMQC_PublishWindowFull(MQCHandler) )
     {
-        MQCHandler->FreeFunc(PacketCtx);
-        PacketCtx = NULL;
+        return false;
     }
+    return true;
+}
+
+/** 
+ * @brief               Send the Messages of the offline buffer in order
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @note                OfflineFlushNum Messages are sent at most each time, so the buffer is not sent at once after reconnect
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_OfflineFlush(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    S_MQC_MSG_QUEUE*    MsgQueue            =   &(MQCHandler->SessionCtx.MessageQueue);
+    S_MQC_MSG_CTX*      Message             =   NULL;
+    uint16_t            PacketIdentifier    =   0;
+    uint32_t            Num                 =   0;
+    int32_t             Ret                 =   D_MQC_RET_NO_NOTIFY;
     
-    return Ret;
+    while( prvMQC_OfflineReady(MQCHandler) && ((!MQCHandler->OfflineFlushNum) || (Num < MQCHandler->OfflineFlushNum)) )
+    {
+        if(MQC_MsgQueue_parked(MsgQueue)->MsgData[0] & 0x06)
+        {
+            PacketIdentifier = MQC_MsgQueue_allocate(MsgQueue);
+            if(!PacketIdentifier)
+            {
+                /* Try again when a Packet Identifier is released */
+                break;
+            }
+            Message = MQC_MsgQueue_unpark(MsgQueue);
+            prvMQC_PublishSend(MQCHandler, Message, PacketIdentifier);
+        }
+        else
+        {
+            Message = MQC_MsgQueue_unpark(MsgQueue);
+#if defined (MQC_MQTT5)
+            if( MQCHandler->SessionCtx.ServerMaximumPacketSize && (Message->MsgLength > MQCHandler->SessionCtx.ServerMaximumPacketSize) )
+            {
+                /* The server does not accept the Message */
+                Ret = D_MQC_RET_BAD_INPUT_DATA;
+            }
+            else
+            {
+                Ret = prvMQC_PublishAliasWrite(MQCHandler, Message->MsgData[0], &(Message->ExtData.Publish.Message), 0);
+            }
+#endif /* MQC_MQTT5 */
+            if(D_MQC_RET_NO_NOTIFY == Ret)
+            {
+                (void)prvMQC_CoreWrite(MQCHandler, Message->MsgData, Message->MsgLength);
+            }
+            /* QoS0 Message has no result callback, just free it */
+            prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_COMPLETE, NULL);
+        }
+        Num++;
+    }
+    return;
 }
 
 /** 
- * @brief               Send PUBLISH Message (QoS Level = 0)
+ * @brief               Keep a PUBLISH Message in the offline buffer
  * @param[in,out]       MQCHandler              MQTT client handler
- * @param[in]           Message                 Message Content
+ * @param[in]           Message                 Message Content (the payload is encoded already)
+ * @param[in]           QoS                     QoS Level
  * @param[in]           Retain                  Retain Message Flag
+ * @param[in]           ResultFuncCB            Callback function will be called when received response (not for QoS0)
  * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_NOTIFY     The Message is discarded (E_MQC_OFFLINE_DROP_NEWEST)
+ * @retval              D_MQC_RET_BUSY          The buffer is full (E_MQC_OFFLINE_BLOCK)
  * @retval              D_MQC_RET_NO_MEMORY
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
- * @retval              D_MQC_RET_CALLBACK_ERROR
- * @note                QoS0 level Message has no response
- * @author              zhaozhenge@outlook.com
- * @date                2018/12/03
+ * @note                The Message is encoded without Packet Identifier, it is set when the Message is sent
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_CorePublish_withoutQoS(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_INFO* Message, bool Retain)
+static int32_t prvMQC_OfflinePark(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_INFO* Message, E_MQC_QOS_LEVEL QoS, bool Retain, F_PUBLISH_RES_CBFUNC ResultFuncCB)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    S_MQC_MSG_QUEUE*    MsgQueue            =   &(MQCHandler->SessionCtx.MessageQueue);
+    S_MQC_ENCODE_BUFFER Buffer              =   { NULL, 0, true };
+    S_MQC_MSG_CTX*      PacketCtx           =   NULL;
+    uint32_t            RemainingLength     =   0;
+    size_t              Size                =   0;
+    
+    /* Size of the encoded Message */
+    RemainingLength = sizeof(uint16_t) + Message->Topic.Length + ((E_MQC_QOS_0 != QoS)?sizeof(uint16_t):0) + Message->Length;
+    RemainingLength = RemainingLength + ((prvMQC_Version5(MQCHandler))?(1):(0));
+    if(!prvMQC_RemainingLengthSize(RemainingLength))
+    {
+        return D_MQC_RET_UNEXPECTED_ERROR;
+    }
+    Size = 1 + prvMQC_RemainingLengthSize(RemainingLength) + RemainingLength;
+    if( MQCHandler->OfflineMaxSize && (Size > MQCHandler->OfflineMaxSize) )
+    {
+        return D_MQC_RET_NO_MEMORY;
+    }
     
-    do
+    /* Make room for the Message */
+    while( (MsgQueue->OfflineCount >= MQCHandler->OfflineMaxNum) 
+          || (MQCHandler->OfflineMaxSize && (MsgQueue->OfflineSize + Size > MQCHandler->OfflineMaxSize)) )
     {
-        /* Get the data size */
-        Ret = prvMQC_PublishMessageEncode( WriteData, &WriteDataSize, 0, Message, false, E_MQC_QOS_0, Retain, NULL );
-        if(Ret)
-        {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
-        }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
-        {
-            Ret = D_MQC_RET_NO_MEMORY;
-            break;
-        }
-        
-        /* Encode UNSUBSCRIBE Message data */
-        Ret = prvMQC_PublishMessageEncode( WriteData, &WriteDataSize, 0, Message, false, E_MQC_QOS_0, Retain, NULL );
-        if(Ret)
+        if(E_MQC_OFFLINE_BLOCK == MQCHandler->OfflinePolicy)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
+            return D_MQC_RET_BUSY;
         }
-        
-        /* Use callback function to send data */
-        Ret = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
-        if(Ret)
+        MQCHandler->SessionCtx.OfflineDropCount++;
+        if(E_MQC_OFFLINE_DROP_NEWEST == MQCHandler->OfflinePolicy)
         {
-            Ret = D_MQC_RET_CALLBACK_ERROR;
-            break;
+            return D_MQC_RET_NO_NOTIFY;
         }
-        
-        Ret = D_MQC_RET_OK;
-        
-    }while(0);
+        prvMQC_MessageNotify(MQCHandler, MQC_MsgQueue_unpark(MsgQueue), E_MQC_BEHAVIOR_CANCEL, NULL);
+    }
     
-    /* Free the malloc memory */
-    if(WriteData)
+    /* alloc memory to buffer the message in the offline list */
+    PacketCtx = prvMQC_ObjectMalloc(MQCHandler, sizeof(S_MQC_MSG_CTX));
+    if(!PacketCtx)
+    {
+        return D_MQC_RET_NO_MEMORY;
+    }
+    if( prvMQC_PublishMessageEncode( MQCHandler, &Buffer, 0, Message, false, QoS, Retain, &(PacketCtx->ExtData.Publish) ) )
+    {
+        prvMQC_ObjectFree(MQCHandler, PacketCtx);
+        return D_MQC_RET_NO_MEMORY;
+    }
+    PacketCtx->MsgLength                        =   Buffer.Size;
+    PacketCtx->MsgData                          =   Buffer.Data;
+    PacketCtx->PacketIdentifier                 =   0;
+    PacketCtx->ExtData.Publish.ResultFuncCB     =   (E_MQC_QOS_0 != QoS)?(ResultFuncCB):(NULL);
+    MQC_MsgQueue_park(MsgQueue, PacketCtx);
+    
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Encode the payload of a PUBLISH Message and keep it in the offline buffer
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Message                 Message Content
+ * @param[in]           QoS                     QoS Level
+ * @param[in]           Retain                  Retain Message Flag
+ * @param[in]           ResultFuncCB            Callback function will be called when received response (not for QoS0)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_NOTIFY     The Message is discarded (E_MQC_OFFLINE_DROP_NEWEST)
+ * @retval              D_MQC_RET_BUSY          The buffer is full (E_MQC_OFFLINE_BLOCK)
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_OfflinePublish(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_INFO* Message, E_MQC_QOS_LEVEL QoS, bool Retain, F_PUBLISH_RES_CBFUNC ResultFuncCB)
+{
+#if defined (MQC_PAYLOAD_CODEC)
+    S_MQC_MESSAGE_INFO  Encoded;
+    uint8_t*            EncodeData          =   NULL;
+    int32_t             Ret                 =   D_MQC_RET_OK;
+    
+    if( (E_MQC_OFFLINE_BLOCK == MQCHandler->OfflinePolicy) && 
+        (MQCHandler->SessionCtx.MessageQueue.OfflineCount >= MQCHandler->OfflineMaxNum) )
     {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
+        /* Nothing is encoded for the Message which can not be kept */
+        return D_MQC_RET_BUSY;
     }
     
+    /* The size kept depends on the encoded payload */
+    Ret = prvMQC_PayloadEncode(MQCHandler, Message, &Encoded, &EncodeData);
+    if(D_MQC_RET_OK == Ret)
+    {
+        Ret = prvMQC_OfflinePark(MQCHandler, &Encoded, QoS, Retain, ResultFuncCB);
+        prvMQC_PayloadEncodeEnd(MQCHandler, Message, &Encoded, EncodeData, Ret);
+    }
     return Ret;
+#else
+    return prvMQC_OfflinePark(MQCHandler, Message, QoS, Retain, ResultFuncCB);
+#endif /* MQC_PAYLOAD_CODEC */
+}
+
+/** 
+ * @brief               Discard all Messages of the offline buffer
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_OfflineClear(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    S_MQC_MSG_CTX*      Message     =   NULL;
+    
+    while( NULL != (Message = MQC_MsgQueue_unpark(&(MQCHandler->SessionCtx.MessageQueue))) )
+    {
+        /* Notify the application this message discarded via callback function */
+        prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_CANCEL, NULL);
+    }
+    return;
+}
+#endif /* MQC_OFFLINE_BUFFER */
+
+/** 
+ * @brief               Send the PUBLISH Messages in the pending list while the in-flight window has free slot
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMQC_PendingDrain(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    S_MQC_MSG_CTX*      PacketCtx           =   NULL;
+    uint16_t            PacketIdentifier    =   0;
+    
+    while( MQCHandler->SessionCtx.MessageQueue.PendingCount && (!prvMQC_PublishWindowFull(MQCHandler)) )
+    {
+        PacketIdentifier = MQC_MsgQueue_allocate(&(MQCHandler->SessionCtx.MessageQueue));
+        if(!PacketIdentifier)
+        {
+            /* Try again when a Packet Identifier is released */
+            break;
+        }
+        PacketCtx = MQC_MsgQueue_unhold(&(MQCHandler->SessionCtx.MessageQueue));
+        prvMQC_PublishSend(MQCHandler, PacketCtx, PacketIdentifier);
+    }
+#if defined (MQC_OFFLINE_BUFFER)
+    /* The offline buffer follows the pending list */
+    prvMQC_OfflineFlush(MQCHandler);
+#endif /* MQC_OFFLINE_BUFFER */
+    return;
 }
 
 /** 
@@ -1567,99 +3802,76 @@ static int32_t prvMQC_CorePublish_withoutQoS(S_MQC_SESSION_HANDLE* MQCHandler, S
  * @param[in]           QoS                     QoS Level
  * @param[in]           Retain                  Retain Message Flag
  * @param[in]           ResultFuncCB            Callback function will be called when received response
+ * @param[in]           PacketIdentifier        Packet Identifier allocated by prvMQC_CorePublish (0 means the Message waits)
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_NO_MEMORY
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @note                Response callback called means server has received the message 
+ * @note                If the in-flight window is full, the Message waits in the pending list and D_MQC_RET_OK is returned
+ * @note                The Packet Identifier is given back by the caller if the Message is not queued
  * @author              zhaozhenge@outlook.com
  * @date                2018/12/03
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_CorePublish_withQoS(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_INFO* Message, E_MQC_QOS_LEVEL QoS, bool Retain, F_PUBLISH_RES_CBFUNC ResultFuncCB)
+static int32_t prvMQC_CorePublish_withQoS(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_INFO* Message, E_MQC_QOS_LEVEL QoS, bool Retain, F_PUBLISH_RES_CBFUNC ResultFuncCB, uint16_t PacketIdentifier)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    S_MQC_MSG_CTX*  PacketCtx       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    S_MQC_ENCODE_BUFFER Buffer              =   { NULL, 0, true };
+    S_MQC_MSG_CTX*      PacketCtx           =   NULL;
+    int32_t             Ret                 =   D_MQC_RET_OK;
     
     do
     {
-        MQCHandler->SessionCtx.MessageQueue.PacketIdentifier = (65535 == MQCHandler->SessionCtx.MessageQueue.PacketIdentifier)?1:(MQCHandler->SessionCtx.MessageQueue.PacketIdentifier+1);
-        
-        /* Get the data size */
-        Ret = prvMQC_PublishMessageEncode( WriteData, &WriteDataSize, MQCHandler->SessionCtx.MessageQueue.PacketIdentifier, Message, false, QoS, Retain, NULL );
-        if(Ret)
-        {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
-        }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
-        {
-            Ret = D_MQC_RET_NO_MEMORY;
-            break;
-        }
-        
         /* alloc memory to buffer the message in queue */
-        PacketCtx = MQCHandler->MallocFunc(sizeof(S_MQC_MSG_CTX));
+        PacketCtx = prvMQC_ObjectMalloc(MQCHandler, sizeof(S_MQC_MSG_CTX));
         if(!PacketCtx)
         {
             Ret = D_MQC_RET_NO_MEMORY;
             break;
         }
         
-        /* Encode Publish Message data */
-        Ret = prvMQC_PublishMessageEncode( WriteData, &WriteDataSize, MQCHandler->SessionCtx.MessageQueue.PacketIdentifier, Message, false, QoS, Retain, &(PacketCtx->ExtData.Publish) );
+        /* Encode PUBLISH Message data into the buffer kept in queue (Packet Identifier is set when send) */
+        Ret = prvMQC_PublishMessageEncode( MQCHandler, &Buffer, 0, Message, false, QoS, Retain, &(PacketCtx->ExtData.Publish) );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
-        PacketCtx->SendCount                        =   MQCHandler->MessageRetryCount;
-        PacketCtx->ExpireTime                       =   MQCHandler->MessageRetryInterval*1000;
-        PacketCtx->Timeout                          =   MQCHandler->MessageRetryInterval*1000;
-        PacketCtx->MsgLength                        =   WriteDataSize;
-        PacketCtx->MsgData                          =   WriteData;
-        PacketCtx->PacketIdentifier                 =   MQCHandler->SessionCtx.MessageQueue.PacketIdentifier;
+        PacketCtx->MsgLength                        =   Buffer.Size;
+        PacketCtx->MsgData                          =   Buffer.Data;
+        PacketCtx->PacketIdentifier                 =   0;
         PacketCtx->ExtData.Publish.ResultFuncCB     =   ResultFuncCB;
         
-        /* Push the Message data in queue */
-        PacketCtx = MQC_MsgQueue_push( &(MQCHandler->SessionCtx.MessageQueue), PacketCtx);
-        
-        /* Use callback function to send data */
-        (void)MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
-        /* Set DUP (retry) flag to true */
-        CLIB_BIT_SET(WriteData[0], 3);
-        
-        if(PacketCtx)
+        if(PacketIdentifier)
         {
-            /* Notify the application this message discarded via callback function */
-            Ret = prvMessageDiscardNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL);
-            WriteData = PacketCtx->MsgData;
+            prvMQC_PublishSend(MQCHandler, PacketCtx, PacketIdentifier);
         }
         else
         {
-            WriteData = NULL;
+            /* Wait in the pending list until a slot of the in-flight window is free */
+            MQC_MsgQueue_hold(&(MQCHandler->SessionCtx.MessageQueue), PacketCtx);
+            if(MQCHandler->SessionCtx.PendingPeak < MQCHandler->SessionCtx.MessageQueue.PendingCount)
+            {
+                MQCHandler->SessionCtx.PendingPeak = MQCHandler->SessionCtx.MessageQueue.PendingCount;
+            }
         }
+        Buffer.Data = NULL;
+        PacketCtx   = NULL;
         
         Ret = D_MQC_RET_OK;
         
     }while(0);
     
     /* Free the malloc memory */
-    if(WriteData)
+    if(Buffer.Data)
     {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
+        prvMQC_ObjectFree(MQCHandler, Buffer.Data);
+        Buffer.Data = NULL;
     }
     
     if(PacketCtx)
     {
-        MQCHandler->FreeFunc(PacketCtx);
+        prvMQC_ObjectFree(MQCHandler, PacketCtx);
         PacketCtx = NULL;
     }
     
@@ -1675,6 +3887,7 @@ static int32_t prvMQC_CorePublish_withQoS(S_MQC_SESSION_HANDLE* MQCHandler, S_MQ
  * @param[in]           ResultFuncCB            Callback function will be called when received response
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_CALLBACK_ERROR
  * @note                If QoS Level = 0, the ResultFuncCB param will be discarded. (Result will be returned immediately by the function)
@@ -1685,15 +3898,67 @@ static int32_t prvMQC_CorePublish_withQoS(S_MQC_SESSION_HANDLE* MQCHandler, S_MQ
  */
 static int32_t prvMQC_CorePublish(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_INFO* Message, E_MQC_QOS_LEVEL QoS, bool Retain, F_PUBLISH_RES_CBFUNC ResultFuncCB)
 {
-    int32_t         Ret             =   D_MQC_RET_OK;
+    uint16_t            PacketIdentifier    =   0;
+    int32_t             Ret                 =   D_MQC_RET_OK;
+#if defined (MQC_PAYLOAD_CODEC)
+    S_MQC_MESSAGE_INFO* Raw                 =   Message;
+    S_MQC_MESSAGE_INFO  Encoded;
+    uint8_t*            EncodeData          =   NULL;
+#endif /* MQC_PAYLOAD_CODEC */
+    
+    /* Keep the order of the Messages, the pending ones are sent first */
+    if( (E_MQC_QOS_0 != QoS) && (!prvMQC_PublishWindowFull(MQCHandler)) && (!MQCHandler->SessionCtx.MessageQueue.PendingCount) )
+    {
+        /* Allocate a Packet Identifier which is not in use */
+        PacketIdentifier = MQC_MsgQueue_allocate(&(MQCHandler->SessionCtx.MessageQueue));
+        if(!PacketIdentifier)
+        {
+            return D_MQC_RET_BUSY;
+        }
+    }
     
-    if(E_MQC_QOS_0 == QoS)
+    do
     {
-        Ret = prvMQC_CorePublish_withoutQoS(MQCHandler, Message, Retain);
-    }
-    else
+#if defined (MQC_PAYLOAD_CODEC)
+        /* Encode the payload once the Message is accepted */
+        Ret = prvMQC_PayloadEncode(MQCHandler, Raw, &Encoded, &EncodeData);
+        if(Ret)
+        {
+            break;
+        }
+        Message = &Encoded;
+#endif /* MQC_PAYLOAD_CODEC */
+        
+#if defined (MQC_MQTT5)
+        /* Topic Length + Topic Name + Packet Identifier + Property Length + payload */
+        if( prvMQC_PacketOversize(MQCHandler->SessionCtx.ServerMaximumPacketSize, 
+                                  sizeof(uint16_t) + Message->Topic.Length + ((E_MQC_QOS_0 != QoS)?sizeof(uint16_t):0) + 1 + Message->Length) )
+        {
+            /* The server does not accept the Message */
+            Ret = D_MQC_RET_BAD_INPUT_DATA;
+            break;
+        }
+#endif /* MQC_MQTT5 */
+        
+        if(E_MQC_QOS_0 == QoS)
+        {
+            Ret = prvMQC_CorePublish_withoutQoS(MQCHandler, Message, Retain);
+        }
+        else
+        {
+            Ret = prvMQC_CorePublish_withQoS(MQCHandler, Message, QoS, Retain, ResultFuncCB, PacketIdentifier);
+        }
+        
+    }while(0);
+    
+#if defined (MQC_PAYLOAD_CODEC)
+    prvMQC_PayloadEncodeEnd(MQCHandler, Raw, Message, EncodeData, Ret);
+#endif /* MQC_PAYLOAD_CODEC */
+    
+    /* Give back the Packet Identifier if the Message has not been queued */
+    if( (D_MQC_RET_OK != Ret) && PacketIdentifier )
     {
-        Ret = prvMQC_CorePublish_withQoS(MQCHandler, Message, QoS, Retain, ResultFuncCB);
+        MQC_MsgQueue_release(&(MQCHandler->SessionCtx.MessageQueue), PacketIdentifier);
     }
     
     return Ret;
@@ -1714,38 +3979,21 @@ static int32_t prvMQC_CorePublish(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAG
  */
 static int32_t prvMQC_CorePuback(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t PacketIdentifier)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    uint8_t             WriteData[D_MQC_ACK_MSG_SIZE];
+    S_MQC_ENCODE_BUFFER Buffer          =   { WriteData, sizeof(WriteData), false };
+    int32_t             Ret             =   D_MQC_RET_OK;
     
     do
     {
-        /* Get the data size */
-        Ret = prvMQC_PubackMessageEncode( WriteData, &WriteDataSize, PacketIdentifier );
-        if(Ret)
-        {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
-        }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
-        {
-            Ret = D_MQC_RET_NO_MEMORY;
-            break;
-        }
-        
         /* Encode PUBACK Message data */
-        Ret = prvMQC_PubackMessageEncode( WriteData, &WriteDataSize, PacketIdentifier );
+        Ret = prvMQC_PubackMessageEncode( MQCHandler, &Buffer, PacketIdentifier );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
         /* Use callback function to send data */
-        Ret = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
+        Ret = prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
         if(Ret)
         {
             Ret = D_MQC_RET_CALLBACK_ERROR;
@@ -1753,15 +4001,8 @@ static int32_t prvMQC_CorePuback(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t Pack
         }
         
         Ret = D_MQC_RET_OK;
-        
-    }while(0);
-    
-    /* Free the malloc memory */
-    if(WriteData)
-    {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
-    }
+        
+    }while(0);
     
     return Ret;
 }
@@ -1780,83 +4021,66 @@ static int32_t prvMQC_CorePuback(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t Pack
  */
 static int32_t prvMQC_CorePubrec(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t PacketIdentifier)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    S_MQC_MSG_CTX*  PacketCtx       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    S_MQC_ENCODE_BUFFER Buffer          =   { NULL, 0, true };
+    S_MQC_MSG_CTX*      PacketCtx       =   NULL;
+    int32_t             Ret             =   D_MQC_RET_OK;
     
     do
     {
-        /* Get the data size */
-        Ret = prvMQC_PubrecMessageEncode( WriteData, &WriteDataSize, PacketIdentifier );
-        if(Ret)
-        {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
-        }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
-        {
-            Ret = D_MQC_RET_NO_MEMORY;
-            break;
-        }
-        
         /* alloc memory to buffer the message in queue */
-        PacketCtx = MQCHandler->MallocFunc(sizeof(S_MQC_MSG_CTX));
+        PacketCtx = prvMQC_ObjectMalloc(MQCHandler, sizeof(S_MQC_MSG_CTX));
         if(!PacketCtx)
         {
             Ret = D_MQC_RET_NO_MEMORY;
             break;
         }
         
-        /* Encode UNSUBSCRIBE Message data */
-        Ret = prvMQC_PubrecMessageEncode( WriteData, &WriteDataSize, PacketIdentifier );
+        /* Encode PUBREC Message data into the buffer kept in queue */
+        Ret = prvMQC_PubrecMessageEncode( MQCHandler, &Buffer, PacketIdentifier );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
         PacketCtx->SendCount                        =   MQCHandler->MessageRetryCount;
-        PacketCtx->ExpireTime                       =   MQCHandler->MessageRetryInterval*1000;
         PacketCtx->Timeout                          =   MQCHandler->MessageRetryInterval*1000;
-        PacketCtx->MsgLength                        =   WriteDataSize;
-        PacketCtx->MsgData                          =   WriteData;
+        PacketCtx->MsgLength                        =   Buffer.Size;
+        PacketCtx->MsgData                          =   Buffer.Data;
         PacketCtx->PacketIdentifier                 =   PacketIdentifier;
         
+#if defined (MQC_PERSISTENCE)
+        /* Save the Message data before it is sent */
+        prvMQC_PersistSave(MQCHandler, PacketCtx);
+#endif /* MQC_PERSISTENCE */
         /* Push the Message data in queue */
         PacketCtx = MQC_MsgQueue_push( &(MQCHandler->SessionCtx.MessageQueue), PacketCtx);
         
         /* Use callback function to send data */
-        (void)MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
+        (void)prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
         
         if(PacketCtx)
         {
             /* Notify the application this message discarded via callback function */
-            Ret = prvMessageDiscardNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL);
-            WriteData = PacketCtx->MsgData;
-        }
-        else
-        {
-            WriteData = NULL;
+            prvMQC_MessageNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL, NULL);
         }
+        /* The Message data is kept by the queue or freed with the popped Message */
+        Buffer.Data = NULL;
+        PacketCtx = NULL;
         
         Ret = D_MQC_RET_OK;
         
     }while(0);
     
     /* Free the malloc memory */
-    if(WriteData)
+    if(Buffer.Data)
     {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
+        prvMQC_ObjectFree(MQCHandler, Buffer.Data);
+        Buffer.Data = NULL;
     }
     
     if(PacketCtx)
     {
-        MQCHandler->FreeFunc(PacketCtx);
+        prvMQC_ObjectFree(MQCHandler, PacketCtx);
         PacketCtx = NULL;
     }
     
@@ -1877,83 +4101,66 @@ static int32_t prvMQC_CorePubrec(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t Pack
  */
 static int32_t prvMQC_CorePubrel(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t PacketIdentifier)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    S_MQC_MSG_CTX*  PacketCtx       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    S_MQC_ENCODE_BUFFER Buffer          =   { NULL, 0, true };
+    S_MQC_MSG_CTX*      PacketCtx       =   NULL;
+    int32_t             Ret             =   D_MQC_RET_OK;
     
     do
     {
-        /* Get the data size */
-        Ret = prvMQC_PubrelMessageEncode( WriteData, &WriteDataSize, PacketIdentifier );
-        if(Ret)
-        {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
-        }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
-        {
-            Ret = D_MQC_RET_NO_MEMORY;
-            break;
-        }
-        
         /* alloc memory to buffer the message in queue */
-        PacketCtx = MQCHandler->MallocFunc(sizeof(S_MQC_MSG_CTX));
+        PacketCtx = prvMQC_ObjectMalloc(MQCHandler, sizeof(S_MQC_MSG_CTX));
         if(!PacketCtx)
         {
             Ret = D_MQC_RET_NO_MEMORY;
             break;
         }
         
-        /* Encode UNSUBSCRIBE Message data */
-        Ret = prvMQC_PubrelMessageEncode( WriteData, &WriteDataSize, PacketIdentifier );
+        /* Encode PUBREL Message data into the buffer kept in queue */
+        Ret = prvMQC_PubrelMessageEncode( MQCHandler, &Buffer, PacketIdentifier );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
         PacketCtx->SendCount                        =   MQCHandler->MessageRetryCount;
-        PacketCtx->ExpireTime                       =   MQCHandler->MessageRetryInterval*1000;
         PacketCtx->Timeout                          =   MQCHandler->MessageRetryInterval*1000;
-        PacketCtx->MsgLength                        =   WriteDataSize;
-        PacketCtx->MsgData                          =   WriteData;
+        PacketCtx->MsgLength                        =   Buffer.Size;
+        PacketCtx->MsgData                          =   Buffer.Data;
         PacketCtx->PacketIdentifier                 =   PacketIdentifier;
         
+#if defined (MQC_PERSISTENCE)
+        /* Save the Message data before it is sent */
+        prvMQC_PersistSave(MQCHandler, PacketCtx);
+#endif /* MQC_PERSISTENCE */
         /* Push the Message data in queue */
         PacketCtx = MQC_MsgQueue_push( &(MQCHandler->SessionCtx.MessageQueue), PacketCtx);
         
         /* Use callback function to send data */
-        (void)MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
+        (void)prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
         
         if(PacketCtx)
         {
             /* Notify the application this message discarded via callback function */
-            Ret = prvMessageDiscardNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL);
-            WriteData = PacketCtx->MsgData;
-        }
-        else
-        {
-            WriteData = NULL;
+            prvMQC_MessageNotify(MQCHandler, PacketCtx, E_MQC_BEHAVIOR_CANCEL, NULL);
         }
+        /* The Message data is kept by the queue or freed with the popped Message */
+        Buffer.Data = NULL;
+        PacketCtx = NULL;
         
         Ret = D_MQC_RET_OK;
         
     }while(0);
     
     /* Free the malloc memory */
-    if(WriteData)
+    if(Buffer.Data)
     {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
+        prvMQC_ObjectFree(MQCHandler, Buffer.Data);
+        Buffer.Data = NULL;
     }
     
     if(PacketCtx)
     {
-        MQCHandler->FreeFunc(PacketCtx);
+        prvMQC_ObjectFree(MQCHandler, PacketCtx);
         PacketCtx = NULL;
     }
     
@@ -1975,38 +4182,21 @@ static int32_t prvMQC_CorePubrel(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t Pack
  */
 static int32_t prvMQC_CorePubcomp(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t PacketIdentifier)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    uint8_t             WriteData[D_MQC_ACK_MSG_SIZE];
+    S_MQC_ENCODE_BUFFER Buffer          =   { WriteData, sizeof(WriteData), false };
+    int32_t             Ret             =   D_MQC_RET_OK;
     
     do
     {
-        /* Get the data size */
-        Ret = prvMQC_PubcompMessageEncode( WriteData, &WriteDataSize, PacketIdentifier );
-        if(Ret)
-        {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
-            break;
-        }
-        
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
-        {
-            Ret = D_MQC_RET_NO_MEMORY;
-            break;
-        }
-        
-        /* Encode PUBACK Message data */
-        Ret = prvMQC_PubcompMessageEncode( WriteData, &WriteDataSize, PacketIdentifier );
+        /* Encode PUBCOMP Message data */
+        Ret = prvMQC_PubcompMessageEncode( MQCHandler, &Buffer, PacketIdentifier );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
         /* Use callback function to send data */
-        Ret = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
+        Ret = prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
         if(Ret)
         {
             Ret = D_MQC_RET_CALLBACK_ERROR;
@@ -2017,18 +4207,11 @@ static int32_t prvMQC_CorePubcomp(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t Pac
         
     }while(0);
     
-    /* Free the malloc memory */
-    if(WriteData)
-    {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
-    }
-    
     return Ret;
 }
 
 /** 
- * @brief               Send PUBCOMP Message
+ * @brief               Send PINGREQ Message
  * @param[in,out]       MQCHandler              MQTT client handler
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_NO_MEMORY
@@ -2041,106 +4224,548 @@ static int32_t prvMQC_CorePubcomp(S_MQC_SESSION_HANDLE* MQCHandler, uint16_t Pac
  */
 static int32_t prvMQC_CorePing(S_MQC_SESSION_HANDLE* MQCHandler)
 {
-    size_t          WriteDataSize   =   0;  
-    uint8_t*        WriteData       =   NULL;
-    int32_t         Ret             =   D_MQC_RET_OK;
+    uint8_t             WriteData[D_MQC_ACK_MSG_SIZE];
+    S_MQC_ENCODE_BUFFER Buffer          =   { WriteData, sizeof(WriteData), false };
+    int32_t             Ret             =   D_MQC_RET_OK;
     
     do
     {
-        /* Get the data size */
-        Ret = prvMQC_PingreqMessageEncode( WriteData, &WriteDataSize);
+        /* Encode PINGREQ Message data */
+        Ret = prvMQC_PingreqMessageEncode( MQCHandler, &Buffer );
         if(Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
         }
         
-        /* alloc memory to buffer the send data */
-        WriteData = MQCHandler->MallocFunc(WriteDataSize);
-        if(!WriteData)
+        /* Use callback function to send data */
+        Ret = prvMQC_CoreWrite(MQCHandler, Buffer.Data, Buffer.Size);
+        if(Ret)
         {
-            Ret = D_MQC_RET_NO_MEMORY;
+            Ret = D_MQC_RET_CALLBACK_ERROR;
             break;
         }
         
-        /* Encode UNSUBSCRIBE Message data */
-        Ret = prvMQC_PingreqMessageEncode( WriteData, &WriteDataSize );
-        if(Ret)
+        Ret = D_MQC_RET_OK;
+        
+    }while(0);
+    
+    return Ret;
+}
+
+/** 
+ * @brief               Read the Remaining Length of Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_FORMAT
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/12/03
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_ReadMessageRemainingLength( S_MQC_SESSION_HANDLE* MQCHandler )
+{
+    int32_t     Ret         =   D_MQC_RET_OK;
+    
+    do
+    {
+        Ret = prvMQC_RemainingLengthDecode( MQCHandler->SessionCtx.RecvData + 1, MQCHandler->SessionCtx.RecvDataSize - 1, &(MQCHandler->SessionCtx.TotalRecvDataSize) );
+        if(-1 == Ret)
         {
-            Ret = D_MQC_RET_UNEXPECTED_ERROR;
+            /* Bad Format */
+            Ret = D_MQC_RET_BAD_FORMAT;
             break;
         }
-        
-        /* Use callback function to send data */
-        Ret = MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, WriteData, WriteDataSize);
-        if(Ret)
+        else if(1 == Ret)
         {
-            Ret = D_MQC_RET_CALLBACK_ERROR;
-            break;
+            /* continue to receive Remaining Length data */
+            Ret = D_MQC_RET_OK;
+        }
+        else
+        {
+            /* Get the total message length  */
+            MQCHandler->SessionCtx.HeaderDataSize = MQCHandler->SessionCtx.RecvDataSize;
+#if defined (MQC_MQTT5)
+            if( prvMQC_Version5(MQCHandler) && prvMQC_PacketOversize(MQCHandler->MaximumPacketSize, MQCHandler->SessionCtx.TotalRecvDataSize) )
+            {
+                /* Larger than the Maximum Packet Size of the client, refused before the buffer is reserved */
+                Ret = D_MQC_RET_BAD_FORMAT;
+                break;
+            }
+#endif /* MQC_MQTT5 */
+            if(prvMQC_ChunkCheck(MQCHandler, MQCHandler->SessionCtx.RecvData[0], MQCHandler->SessionCtx.TotalRecvDataSize))
+            {
+                /* The payload will be delivered in chunks without storing */
+                MQCHandler->SessionCtx.ChunkCtx.Enable = true;
+            }
+            MQCHandler->SessionCtx.TotalRecvDataSize += MQCHandler->SessionCtx.HeaderDataSize;
+            if(!MQCHandler->SessionCtx.ChunkCtx.Enable)
+            {
+                Ret = prvMQC_RecvBufferReserve(MQCHandler, MQCHandler->SessionCtx.TotalRecvDataSize);
+                if(D_MQC_RET_OK != Ret)
+                {
+                    break;
+                }
+            }
         }
         
-        Ret = D_MQC_RET_OK;
+        return Ret;
         
     }while(0);
     
-    /* Free the malloc memory */
-    if(WriteData)
+    /* package free */
+    prvMQC_PackageFree(MQCHandler);
+        
+    return Ret;
+}
+
+#if defined (MQC_MQTT5)
+/** 
+ * @brief               Decode the Properties of the received PUBLISH Message
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Data                    Property Length and the Properties
+ * @param[in]           DataSize                Size of the data
+ * @param[in,out]       Topic                   Topic Name of the Message (got from the Topic Alias if it is omitted)
+ * @param[out]          PropertySize            Size of the Property Length and the Properties (NULL if not need)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_FORMAT
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @note                The Topic Alias given with the Topic Name is mapped to it for the next Messages
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_PublishPropertyDecode( S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, uint32_t DataSize, S_MQC_UTF8_DATA* Topic, uint32_t* PropertySize )
+{
+    S_MQC_TOPIC_ALIAS*  RecvAlias       =   &(MQCHandler->SessionCtx.RecvAlias);
+    uint8_t*            Property        =   NULL;
+    uint32_t            PropertyLength  =   0;
+    uint32_t            Size            =   0;
+    uint8_t             Identifier      =   0;
+    uint32_t            Value           =   0;
+    uint32_t            TopicAlias      =   0;
+    int32_t             Ret             =   D_MQC_RET_OK;
+    
+    Size = prvMQC_PropertyGet(Data, DataSize, &Property, &PropertyLength);
+    if(!Size)
+    {
+        return D_MQC_RET_BAD_FORMAT;
+    }
+    while(PropertyLength)
+    {
+        if(prvMQC_PropertyNext(&Property, &PropertyLength, &Identifier, &Value))
+        {
+            return D_MQC_RET_BAD_FORMAT;
+        }
+        if(D_MQC_PROPERTY_TOPIC_ALIAS == Identifier)
+        {
+            /* The Topic Alias is given only once and must be in the range of Topic Alias Maximum */
+            if( TopicAlias || (!Value) || (Value > RecvAlias->Num) )
+            {
+                return D_MQC_RET_BAD_FORMAT;
+            }
+            TopicAlias = Value;
+        }
+    }
+    
+    if(Topic->Length)
+    {
+        if(TopicAlias)
+        {
+            Ret = MQC_TopicAlias_set(RecvAlias, (uint16_t)TopicAlias, Topic);
+            if(D_MQC_RET_OK != Ret)
+            {
+                return (D_MQC_RET_NO_MEMORY == Ret)?(D_MQC_RET_NO_MEMORY):(D_MQC_RET_BAD_FORMAT);
+            }
+        }
+    }
+    else
+    {
+        /* The Topic Name is omitted, it must be mapped by a former Message */
+        if( (!TopicAlias) || MQC_TopicAlias_get(RecvAlias, (uint16_t)TopicAlias, Topic) )
+        {
+            return D_MQC_RET_BAD_FORMAT;
+        }
+        MQCHandler->SessionCtx.RecvAliasTopic = Topic->Data;
+    }
+    
+    if(PropertySize)
+    {
+        *PropertySize = Size;
+    }
+    return D_MQC_RET_OK;
+}
+#endif /* MQC_MQTT5 */
+
+/** 
+ * @brief               Get the Reason Code of the acknowledgement Message with the Packet Identifier
+ * @param[in]           MQCHandler              MQTT client handler
+ * @param[in]           Data                    Message variable header
+ * @param[in]           DataSize                Message remaining length
+ * @param[out]          ReasonCode              Reason Code (0 for MQTT 3.1.1 which has no Reason Code)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_FORMAT
+ * @note                The Reason Code and the Properties of MQTT 5.0 may be omitted, which means success
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_AckReasonCode( S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, uint32_t DataSize, uint8_t* ReasonCode )
+{
+#if defined (MQC_MQTT5)
+    uint8_t*    Property        =   NULL;
+    uint32_t    PropertyLength  =   0;
+#endif /* MQC_MQTT5 */
+    
+    *ReasonCode = 0;
+    if(!prvMQC_Version5(MQCHandler))
+    {
+        return (sizeof(uint16_t) == DataSize)?(D_MQC_RET_OK):(D_MQC_RET_BAD_FORMAT);
+    }
+    if(sizeof(uint16_t) > DataSize)
+    {
+        return D_MQC_RET_BAD_FORMAT;
+    }
+#if defined (MQC_MQTT5)
+    if(sizeof(uint16_t) < DataSize)
+    {
+        *ReasonCode = Data[sizeof(uint16_t)];
+    }
+    if( (sizeof(uint16_t) + 1 < DataSize) && 
+        ((DataSize - sizeof(uint16_t) - 1) != prvMQC_PropertyGet(Data + sizeof(uint16_t) + 1, DataSize - sizeof(uint16_t) - 1, &Property, &PropertyLength)) )
+    {
+        return D_MQC_RET_BAD_FORMAT;
+    }
+#endif /* MQC_MQTT5 */
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Decode the variable header of the PUBLISH Message delivered in chunks
+ * @param[in]           FixedHeader             Fixed Header
+ * @param[in]           Src                     Variable header received
+ * @param[in]           Srclen                  Size of the variable header received
+ * @param[in]           RemainingLength         Remaining Length of the Message
+ * @param[in]           Property                The variable header has the Properties (MQTT 5.0)
+ * @param[out]          HeaderSize              \b 0  :   Size of the variable header \n
+ *                                              \b 1  :   Size of the data need to be received for decode
+ * @retval              0                       success
+ * @retval              1                       data not enough
+ * @retval              -1                      Decode error
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_ChunkHeaderDecode( uint8_t FixedHeader, uint8_t* Src, uint32_t Srclen, uint32_t RemainingLength, bool Property, uint32_t* HeaderSize )
+{
+    uint16_t    TopicLength =   0;
+#if defined (MQC_MQTT5)
+    uint32_t    PropertyLength  =   0;
+    uint32_t    PropertySize    =   0;
+#endif /* MQC_MQTT5 */
+    
+    if( E_MQC_QOS_2 < ((FixedHeader & 0x06) >> 1) )
+    {
+        return (-1);
+    }
+    
+    *HeaderSize = sizeof(uint16_t);
+    if(Srclen < *HeaderSize)
+    {
+        return (1);
+    }
+    
+    TopicLength = MQC_ntohs(*((uint16_t*)Src));
+    /* The Topic Name may be omitted with the Topic Alias */
+    if( (!TopicLength) && (!Property) )
+    {
+        return (-1);
+    }
+    *HeaderSize += TopicLength;
+    if( E_MQC_QOS_0 != ((FixedHeader & 0x06) >> 1) )
+    {
+        *HeaderSize += sizeof(uint16_t);
+    }
+    if(*HeaderSize > RemainingLength)
+    {
+        return (-1);
+    }
+    
+#if defined (MQC_MQTT5)
+    if(Property)
+    {
+        if(Srclen <= *HeaderSize)
+        {
+            *HeaderSize += 1;
+            return (*HeaderSize > RemainingLength) ? (-1) : (1);
+        }
+        /* Property Length */
+        PropertySize = prvMQC_VariableIntegerDecode(Src + *HeaderSize, Srclen - *HeaderSize, &PropertyLength);
+        if(!PropertySize)
+        {
+            if( 4 <= (Srclen - *HeaderSize) )
+            {
+                return (-1);
+            }
+            *HeaderSize = Srclen + 1;
+            return (*HeaderSize > RemainingLength) ? (-1) : (1);
+        }
+        *HeaderSize += PropertySize + PropertyLength;
+        if(*HeaderSize > RemainingLength)
+        {
+            return (-1);
+        }
+    }
+#endif /* MQC_MQTT5 */
+    
+    return (Srclen < *HeaderSize) ? (1) : (0);
+}
+
+/** 
+ * @brief               Begin to deliver the PUBLISH Message in chunks
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           FixedHeader             Fixed Header
+ * @param[in]           Topic                   Topic of the Message
+ * @param[in]           PacketIdentifier        Packet Identifier of the Message
+ * @param[in]           TotalLength             Total length of the Message payload
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_ChunkBegin( S_MQC_SESSION_HANDLE* MQCHandler, uint8_t FixedHeader, S_MQC_UTF8_DATA* Topic, uint16_t PacketIdentifier, uint32_t TotalLength )
+{
+    S_MQC_CHUNK_CTX*    ChunkCtx    =   &(MQCHandler->SessionCtx.ChunkCtx);
+    
+    ChunkCtx->Enable            =   true;
+    ChunkCtx->FixedHeader       =   FixedHeader;
+    ChunkCtx->Topic             =   Topic->Data;
+    ChunkCtx->TopicLength       =   Topic->Length;
+    ChunkCtx->PacketIdentifier  =   PacketIdentifier;
+    ChunkCtx->TotalLength       =   TotalLength;
+    ChunkCtx->Offset            =   0;
+    
+    /* QoS2 */
+    if( E_MQC_QOS_2 == ((FixedHeader & 0x06) >> 1) )
+    {
+        /* Search message in the queue */
+        if(MQC_MsgQueue_search(&(MQCHandler->SessionCtx.MessageQueue), PacketIdentifier, E_MQC_MSG_PUBREC))
+        {
+            /* Discard */
+            ChunkCtx->Discard = true;
+            return D_MQC_RET_OK;
+        }
+    }
+    
+    /* Notify User message begin */
+    ChunkCtx->Notified = true;
+    (void)prvMQC_ChunkNotify(MQCHandler, E_MQC_CHUNK_BEGIN, NULL, 0);
+    
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Deliver a fragment of the PUBLISH Message payload
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Content                 Fragment of the payload
+ * @param[in]           Length                  Fragment Length
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_ChunkData( S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Content, uint32_t Length )
+{
+    S_MQC_CHUNK_CTX*    ChunkCtx    =   &(MQCHandler->SessionCtx.ChunkCtx);
+    
+    if(ChunkCtx->Enable && !ChunkCtx->Discard)
+    {
+        /* Notify User the fragment received */
+        (void)prvMQC_ChunkNotify(MQCHandler, E_MQC_CHUNK_DATA, Content, Length);
+    }
+    ChunkCtx->Offset += Length;
+    
+    return D_MQC_RET_OK;
+}
+
+/** 
+ * @brief               Complete the PUBLISH Message delivered in chunks
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @note                The response is sent to server after User is notified the Message complete
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_ChunkEnd( S_MQC_SESSION_HANDLE* MQCHandler )
+{
+    int32_t             Ret         =   D_MQC_RET_OK;
+    S_MQC_CHUNK_CTX*    ChunkCtx    =   &(MQCHandler->SessionCtx.ChunkCtx);
+    
+    if(ChunkCtx->Enable && !ChunkCtx->Discard)
     {
-        MQCHandler->FreeFunc(WriteData);
-        WriteData = NULL;
+        /* Notify User message complete (The Message cannot be aborted any more) */
+        ChunkCtx->Notified = false;
+        (void)prvMQC_ChunkNotify(MQCHandler, E_MQC_CHUNK_END, NULL, 0);
+        
+        /* User may close the session in callback function, so check the context again */
+        if(ChunkCtx->Enable)
+        {
+            /* Send response to server */
+            switch( (ChunkCtx->FixedHeader & 0x06) >> 1 )
+            {
+                case E_MQC_QOS_1:
+                    Ret = prvMQC_CorePuback(MQCHandler, ChunkCtx->PacketIdentifier);
+                    break;
+                case E_MQC_QOS_2:
+                    Ret = prvMQC_CorePubrec(MQCHandler, ChunkCtx->PacketIdentifier);
+                    break;
+                default:
+                    /* Do nothing */
+                    break;
+            }
+        }
     }
+    memset(ChunkCtx, 0, sizeof(S_MQC_CHUNK_CTX));
     
     return Ret;
 }
 
 /** 
- * @brief               Read the Remaining Length of Message
+ * @brief               Read the PUBLISH Message delivered in chunks
  * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Data                    Data read from the network
+ * @param[in]           Size                    Size of the Data
+ * @param[out]          ReadSize                Number of bytes consumed
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_BAD_FORMAT
  * @retval              D_MQC_RET_NO_MEMORY
- * @author              zhaozhenge@outlook.com
- * @date                2018/12/03
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @note                Only the variable header is stored in the receive buffer, 
+ *                      the payload is delivered to User directly from \a Data.
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_ReadMessageRemainingLength( S_MQC_SESSION_HANDLE* MQCHandler )
+static int32_t prvMQC_CoreReadChunk( S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, size_t Size, size_t* ReadSize )
 {
-    int32_t     Ret         =   D_MQC_RET_OK;
-    uint8_t*    StartPtr    =   NULL;
+    int32_t             Ret             =   D_MQC_RET_OK;
+    S_MQC_CHUNK_CTX*    ChunkCtx        =   &(MQCHandler->SessionCtx.ChunkCtx);
+    uint32_t            RemainingLength =   0;
+    uint32_t            HeaderSize      =   0;
+    uint8_t*            VariableHeader  =   NULL;
+    uint16_t            PacketIdentifier=   0;
+    size_t              CopySize        =   0;
+    S_MQC_UTF8_DATA     Topic;
+    
+    *ReadSize = 0;
+    RemainingLength = MQCHandler->SessionCtx.TotalRecvDataSize - MQCHandler->SessionCtx.HeaderDataSize;
     
     do
     {
-        Ret = prvMQC_RemainingLengthDecode( MQCHandler->SessionCtx.RecvData + 1, MQCHandler->SessionCtx.RecvDataSize - 1, &(MQCHandler->SessionCtx.TotalRecvDataSize) );
-        if(-1 == Ret)
+        if(!ChunkCtx->VariableHeaderSize)
         {
-            /* Bad Format */
-            Ret = D_MQC_RET_BAD_FORMAT;
-            break;
+            /* Store the variable header */
+            while( 1 == (Ret = prvMQC_ChunkHeaderDecode(MQCHandler->SessionCtx.RecvData[0], 
+                                                        MQCHandler->SessionCtx.RecvData + MQCHandler->SessionCtx.HeaderDataSize, 
+                                                        MQCHandler->SessionCtx.RecvDataSize - MQCHandler->SessionCtx.HeaderDataSize, 
+                                                        RemainingLength, prvMQC_Version5(MQCHandler), &HeaderSize)) )
+            {
+                if(*ReadSize == Size)
+                {
+                    /* Wait for more data */
+                    return D_MQC_RET_OK;
+                }
+                Ret = prvMQC_RecvBufferReserve(MQCHandler, MQCHandler->SessionCtx.HeaderDataSize + HeaderSize);
+                if(D_MQC_RET_OK != Ret)
+                {
+                    break;
+                }
+                CopySize = MQCHandler->SessionCtx.HeaderDataSize + HeaderSize - MQCHandler->SessionCtx.RecvDataSize;
+                if(CopySize > (Size - *ReadSize))
+                {
+                    CopySize = Size - *ReadSize;
+                }
+                memcpy(MQCHandler->SessionCtx.RecvData + MQCHandler->SessionCtx.RecvDataSize, Data + *ReadSize, CopySize);
+                MQCHandler->SessionCtx.RecvDataSize += CopySize;
+                *ReadSize += CopySize;
+            }
+            if(-1 == Ret)
+            {
+                /* Bad Format */
+                Ret = D_MQC_RET_BAD_FORMAT;
+                break;
+            }
+            if(D_MQC_RET_OK != Ret)
+            {
+                break;
+            }
+            
+            /* Get Topic and Packet Identifier */
+            VariableHeader      =   MQCHandler->SessionCtx.RecvData + MQCHandler->SessionCtx.HeaderDataSize;
+            Topic.Length        =   MQC_ntohs(*((uint16_t*)VariableHeader));
+            Topic.Data          =   VariableHeader + sizeof(uint16_t);
+            VariableHeader      =   Topic.Data + Topic.Length;
+            if( E_MQC_QOS_0 != ((MQCHandler->SessionCtx.RecvData[0] & 0x06) >> 1) )
+            {
+                PacketIdentifier = MQC_ntohs(*((uint16_t*)VariableHeader));
+                VariableHeader = VariableHeader + sizeof(uint16_t);
+            }
+#if defined (MQC_MQTT5)
+            if(prvMQC_Version5(MQCHandler))
+            {
+                /* Get the Topic Name of the Topic Alias */
+                Ret = prvMQC_PublishPropertyDecode(MQCHandler, VariableHeader, 
+                                                   (uint32_t)(MQCHandler->SessionCtx.RecvData + MQCHandler->SessionCtx.HeaderDataSize + HeaderSize - VariableHeader), 
+                                                   &Topic, NULL);
+                if(D_MQC_RET_OK != Ret)
+                {
+                    break;
+                }
+            }
+#endif /* MQC_MQTT5 */
+            ChunkCtx->VariableHeaderSize = HeaderSize;
+            Ret = prvMQC_ChunkBegin(MQCHandler, MQCHandler->SessionCtx.RecvData[0], &Topic, PacketIdentifier, RemainingLength - HeaderSize);
+            if( (D_MQC_RET_OK != Ret) || (!ChunkCtx->Enable) )
+            {
+                /* Session may be closed in callback function */
+                return Ret;
+            }
         }
-        else if(1 == Ret)
+        
+        /* Deliver the payload directly */
+        CopySize = ChunkCtx->TotalLength - ChunkCtx->Offset;
+        if(CopySize > (Size - *ReadSize))
         {
-            /* continue to receive Remaining Length data */
-            Ret = D_MQC_RET_OK;
+            CopySize = Size - *ReadSize;
         }
-        else
+        if(CopySize)
         {
-            /* Get the total message length  */
-            MQCHandler->SessionCtx.HeaderDataSize = MQCHandler->SessionCtx.RecvDataSize;
-            MQCHandler->SessionCtx.TotalRecvDataSize += MQCHandler->SessionCtx.HeaderDataSize;
-            if(D_MQC_MAX_MESSAGE_HEADER_SIZE < MQCHandler->SessionCtx.TotalRecvDataSize)
+            Ret = prvMQC_ChunkData(MQCHandler, Data + *ReadSize, CopySize);
+            *ReadSize += CopySize;
+            if( (D_MQC_RET_OK != Ret) || (!ChunkCtx->Enable) )
             {
-                StartPtr = MQCHandler->MallocFunc(MQCHandler->SessionCtx.TotalRecvDataSize);
-                if(!StartPtr)
-                {
-                    Ret = D_MQC_RET_NO_MEMORY;
-                    break;
-                }
-                memcpy(StartPtr, MQCHandler->SessionCtx.RecvData, MQCHandler->SessionCtx.RecvDataSize);
-                MQCHandler->FreeFunc(MQCHandler->SessionCtx.RecvData);
-                MQCHandler->SessionCtx.RecvData = StartPtr;
+                /* Session may be closed in callback function */
+                return Ret;
             }
-            Ret = D_MQC_RET_OK;
+        }
+        
+        if(ChunkCtx->Offset == ChunkCtx->TotalLength)
+        {
+            /* Message complete */
+            Ret = prvMQC_ChunkEnd(MQCHandler);
+            break;
         }
         
         return Ret;
@@ -2149,7 +4774,7 @@ static int32_t prvMQC_ReadMessageRemainingLength( S_MQC_SESSION_HANDLE* MQCHandl
     
     /* package free */
     prvMQC_PackageFree(MQCHandler);
-        
+    
     return Ret;
 }
 
@@ -2172,6 +4797,15 @@ static int32_t prvMQC_processConnack(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
     int32_t                 Ret             =   D_MQC_RET_OK;
     E_MQC_BEHAVIOR_RESULT   Result          =   E_MQC_BEHAVIOR_COMPLETE;
     bool                    SessionPresent  =   false;
+#if defined (MQC_MQTT5)
+    uint8_t*                Property        =   NULL;
+    uint32_t                PropertyLength  =   0;
+    uint8_t                 Identifier      =   0;
+    uint32_t                Value           =   0;
+    uint16_t                TopicAliasMaximum   =   0;
+    uint16_t                ReceiveMaximum      =   0;
+    uint32_t                MaximumPacketSize   =   0;
+#endif /* MQC_MQTT5 */
     
     do
     {
@@ -2190,13 +4824,59 @@ static int32_t prvMQC_processConnack(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
             break;
         }
         
-        if(2 != DataSize)
+        if( (2 != DataSize) && ( (!prvMQC_Version5(MQCHandler)) || (2 > DataSize) ) )
         {
             /* Bad Format */
             Ret = D_MQC_RET_BAD_FORMAT;
             break;
         }
         
+#if defined (MQC_MQTT5)
+        /* Properties (may be omitted) */
+        if(2 < DataSize)
+        {
+            if( (DataSize - 2) != prvMQC_PropertyGet(Data + 2, DataSize - 2, &Property, &PropertyLength) )
+            {
+                /* Bad Format */
+                Ret = D_MQC_RET_BAD_FORMAT;
+                break;
+            }
+            while(PropertyLength)
+            {
+                Ret = prvMQC_PropertyNext(&Property, &PropertyLength, &Identifier, &Value);
+                if(D_MQC_RET_OK != Ret)
+                {
+                    break;
+                }
+                if(D_MQC_PROPERTY_TOPIC_ALIAS_MAXIMUM == Identifier)
+                {
+                    TopicAliasMaximum = (uint16_t)Value;
+                }
+                else if( (D_MQC_PROPERTY_RECEIVE_MAXIMUM == Identifier) || (D_MQC_PROPERTY_MAXIMUM_PACKET_SIZE == Identifier) )
+                {
+                    if(!Value)
+                    {
+                        /* 0 is not allowed */
+                        Ret = D_MQC_RET_BAD_FORMAT;
+                        break;
+                    }
+                    if(D_MQC_PROPERTY_RECEIVE_MAXIMUM == Identifier)
+                    {
+                        ReceiveMaximum = (uint16_t)Value;
+                    }
+                    else
+                    {
+                        MaximumPacketSize = Value;
+                    }
+                }
+            }
+            if(D_MQC_RET_OK != Ret)
+            {
+                break;
+            }
+        }
+#endif /* MQC_MQTT5 */
+        
         if( 0 != (Data[0] & 0xfe) )
         {
             /* Bad Format */
@@ -2239,6 +4919,22 @@ static int32_t prvMQC_processConnack(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
                 MQCHandler->SessionCtx.Status = E_MQC_STATUS_WORK;
                 /* Keep Alive Timer Start */
                 MQCHandler->SessionCtx.TimeoutCount = MQCHandler->KeepAliveInterval * 1000;
+#if defined (MQC_MQTT5)
+                /* Topic Aliases of the client are limited by Topic Alias Maximum of the server */
+                if(TopicAliasMaximum > MQCHandler->TopicAliasSendMaximum)
+                {
+                    TopicAliasMaximum = MQCHandler->TopicAliasSendMaximum;
+                }
+                (void)MQC_TopicAlias_delete(&(MQCHandler->SessionCtx.SendAlias));
+                (void)MQC_TopicAlias_create(&(MQCHandler->SessionCtx.SendAlias), TopicAliasMaximum, MQCHandler->MallocFunc, MQCHandler->FreeFunc);
+                /* The in-flight window and the size of the Messages sent are limited by the server */
+                MQCHandler->SessionCtx.ServerReceiveMaximum     = ReceiveMaximum;
+                MQCHandler->SessionCtx.ServerMaximumPacketSize  = MaximumPacketSize;
+#endif /* MQC_MQTT5 */
+#if defined (MQC_OFFLINE_BUFFER)
+                /* Send the Messages published while the session was not connected */
+                prvMQC_OfflineFlush(MQCHandler);
+#endif /* MQC_OFFLINE_BUFFER */
             }
             else
             {
@@ -2250,7 +4946,7 @@ static int32_t prvMQC_processConnack(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
         }
         
         /* Notify user the connect result */
-        D_MQC_CALLBACK_SAFECALL(Ret, MQCHandler->OpenResetFuncCB, MQCHandler->UsrCtx, Result, Data[1], SessionPresent);
+        prvMQC_OpenResetNotify(MQCHandler, Result, Data[1], SessionPresent);
         
         Ret = D_MQC_RET_OK;
 
@@ -2280,7 +4976,16 @@ static int32_t prvMQC_processPublish(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
     int32_t             Ret                 =   D_MQC_RET_OK;
     uint8_t             QoS                 =   0;
     uint16_t            PacketIdentifier    =   0;
+    uint32_t            RemainingLength     =   DataSize;
     S_MQC_MESSAGE_INFO  Message;
+#if defined (MQC_TOPIC_DISPATCH)
+    S_MQC_TOPIC_MATCH_CTX   MatchCtx;
+#endif /* MQC_TOPIC_DISPATCH */
+#if defined (MQC_MQTT5)
+    uint32_t            PropertySize        =   0;
+    
+    MQCHandler->SessionCtx.RecvAliasTopic = NULL;
+#endif /* MQC_MQTT5 */
     
     QoS = (FixedHeader & 0x06) >> 1;
     switch( QoS )
@@ -2296,7 +5001,8 @@ static int32_t prvMQC_processPublish(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
                 break;
             }
             Message.Topic.Length = MQC_ntohs(*((uint16_t*)Data));
-            if( !Message.Topic.Length )
+            /* The Topic Name may be omitted with the Topic Alias */
+            if( (!Message.Topic.Length) && (!prvMQC_Version5(MQCHandler)) )
             {
                 /* Bad Format */
                 Ret = D_MQC_RET_BAD_FORMAT;
@@ -2326,6 +5032,33 @@ static int32_t prvMQC_processPublish(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
                 DataSize = DataSize - sizeof(uint16_t);
                 Data = Data + sizeof(uint16_t);
             }
+#if defined (MQC_MQTT5)
+            /* Get Properties */
+            if(prvMQC_Version5(MQCHandler))
+            {
+                Ret = prvMQC_PublishPropertyDecode(MQCHandler, Data, DataSize, &(Message.Topic), &PropertySize);
+                if(D_MQC_RET_OK != Ret)
+                {
+                    break;
+                }
+                DataSize = DataSize - PropertySize;
+                Data = Data + PropertySize;
+            }
+#endif /* MQC_MQTT5 */
+            /* Deliver the Message in chunks */
+            if(prvMQC_ChunkCheck(MQCHandler, FixedHeader, RemainingLength))
+            {
+                Ret = prvMQC_ChunkBegin(MQCHandler, FixedHeader, &(Message.Topic), PacketIdentifier, DataSize);
+                if( (D_MQC_RET_OK == Ret) && DataSize )
+                {
+                    Ret = prvMQC_ChunkData(MQCHandler, Data, DataSize);
+                }
+                if(D_MQC_RET_OK == Ret)
+                {
+                    Ret = prvMQC_ChunkEnd(MQCHandler);
+                }
+                break;
+            }
             /* QoS2 */
             if(E_MQC_QOS_2 == QoS)
             {
@@ -2358,8 +5091,27 @@ static int32_t prvMQC_processPublish(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
             {
                 break;
             }
+#if defined (MQC_PAYLOAD_CODEC)
+            /* Decode the payload by the codec of the Topic */
+            if(D_MQC_RET_OK != prvMQC_PayloadDecode(MQCHandler, &Message))
+            {
+                /* Discard the Message which has been acknowledged */
+                Ret = D_MQC_RET_OK;
+                break;
+            }
+#endif /* MQC_PAYLOAD_CODEC */
             /* Notify User message received */
-            D_MQC_CALLBACK_SAFECALL(Ret, MQCHandler->ReadFuncCB, MQCHandler->UsrCtx, E_MQC_MSG_PUBLISH, &Message);
+#if defined (MQC_TOPIC_DISPATCH)
+            MatchCtx.MQCHandler = MQCHandler;
+            MatchCtx.Origin = Message;
+            MatchCtx.Info = Message;
+            if(MQC_TopicTrie_match(&(MQCHandler->SessionCtx.TopicTrie), &(Message.Topic), prvMQC_TopicNotify, &MatchCtx))
+            {
+                Ret = D_MQC_RET_OK;
+                break;
+            }
+#endif /* MQC_TOPIC_DISPATCH */
+            prvMQC_ReadNotify(MQCHandler, E_MQC_MSG_PUBLISH, &Message);
             Ret = D_MQC_RET_OK;
             break;
         default:
@@ -2367,6 +5119,10 @@ static int32_t prvMQC_processPublish(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
             break;
     }
     
+#if defined (MQC_PAYLOAD_CODEC)
+    /* The decoded payload has been notified (or copied for the deferred notification) */
+    prvMQC_DecodeShrink(MQCHandler);
+#endif /* MQC_PAYLOAD_CODEC */
     return Ret;
 }
 
@@ -2388,6 +5144,7 @@ static int32_t prvMQC_processPuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
     int32_t         Ret                 =   D_MQC_RET_OK;
     uint16_t        PacketIdentifier    =   0;
     S_MQC_MSG_CTX*  Message             =   NULL;
+    uint8_t         ReasonCode          =   0;
     
     do
     {
@@ -2398,7 +5155,7 @@ static int32_t prvMQC_processPuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
             break;
         }
         
-        if(sizeof(uint16_t) != DataSize)
+        if(prvMQC_AckReasonCode(MQCHandler, Data, DataSize, &ReasonCode))
         {
             /* Bad Format */
             Ret = D_MQC_RET_BAD_FORMAT;
@@ -2422,13 +5179,18 @@ static int32_t prvMQC_processPuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
             
             /* delete this message from the queue */
             MQC_MsgQueue_slice(&(MQCHandler->SessionCtx.MessageQueue), Message);
+#if defined (MQC_PERSISTENCE)
+            prvMQC_PersistDelete(MQCHandler, Message);
+#endif /* MQC_PERSISTENCE */
             
-            /* Notify user the publish complete */
-            D_MQC_CALLBACK_SAFECALL(Ret, Message->ExtData.Publish.ResultFuncCB, E_MQC_BEHAVIOR_COMPLETE, &(Message->ExtData.Publish.Message));
+            /* The flow completes, so the Packet Identifier can be used again */
+            prvMQC_PublishFlowEnd(MQCHandler, PacketIdentifier);
             
-            /* Free the memory */
-            MQCHandler->FreeFunc(Message->MsgData);
-            MQCHandler->FreeFunc(Message);
+            /* Notify user the publish complete (or refused by server with MQTT 5.0) */
+            prvMQC_MessageNotify(MQCHandler, Message, (0x80 > ReasonCode)?(E_MQC_BEHAVIOR_COMPLETE):(E_MQC_BEHAVIOR_CANCEL), NULL);
+            
+            /* Send the pending Messages with the free slot */
+            prvMQC_PendingDrain(MQCHandler);
         }
         
         Ret = D_MQC_RET_OK;
@@ -2455,9 +5217,9 @@ static int32_t prvMQC_processPuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
 static int32_t prvMQC_processPubrec(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t FixedHeader, uint8_t* Data, uint32_t DataSize)
 {
     int32_t         Ret                 =   D_MQC_RET_OK;
-    int32_t         Err                 =   0;
     uint16_t        PacketIdentifier    =   0;
     S_MQC_MSG_CTX*  Message             =   NULL;
+    uint8_t         ReasonCode          =   0;
     
     do
     {
@@ -2468,7 +5230,7 @@ static int32_t prvMQC_processPubrec(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
             break;
         }
         
-        if(sizeof(uint16_t) != DataSize)
+        if(prvMQC_AckReasonCode(MQCHandler, Data, DataSize, &ReasonCode))
         {
             /* Bad Format */
             Ret = D_MQC_RET_BAD_FORMAT;
@@ -2493,15 +5255,38 @@ static int32_t prvMQC_processPubrec(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
             /* delete this message from the queue */
             MQC_MsgQueue_slice(&(MQCHandler->SessionCtx.MessageQueue), Message);
             
+            if(0x80 <= ReasonCode)
+            {
+                /* Refused by server (MQTT 5.0), the flow ends without PUBREL Message */
+#if defined (MQC_PERSISTENCE)
+                prvMQC_PersistDelete(MQCHandler, Message);
+#endif /* MQC_PERSISTENCE */
+                prvMQC_PublishFlowEnd(MQCHandler, PacketIdentifier);
+                prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_CANCEL, NULL);
+                prvMQC_PendingDrain(MQCHandler);
+                Ret = D_MQC_RET_OK;
+                break;
+            }
+            
             /* Send PUBREL Message */
             Ret = prvMQC_CorePubrel(MQCHandler, PacketIdentifier);
+            if(Ret)
+            {
+                /* PUBREL Message can not be queued, the flow ends here */
+                prvMQC_PublishFlowEnd(MQCHandler, PacketIdentifier);
+            }
+#if defined (MQC_PERSISTENCE)
+            /* Deleted after PUBREL is saved, so the flow is in the store all the time */
+            prvMQC_PersistDelete(MQCHandler, Message);
+#endif /* MQC_PERSISTENCE */
             
             /* Notify user the publish complete */
-            D_MQC_CALLBACK_SAFECALL(Err, Message->ExtData.Publish.ResultFuncCB, E_MQC_BEHAVIOR_COMPLETE, &(Message->ExtData.Publish.Message));
-            
-            /* Free the memory */
-            MQCHandler->FreeFunc(Message->MsgData);
-            MQCHandler->FreeFunc(Message);
+            prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_COMPLETE, NULL);
+            if(Ret)
+            {
+                /* The slot is free, send the pending Messages (after the store has forgotten the Packet Identifier) */
+                prvMQC_PendingDrain(MQCHandler);
+            }
         }
         
     }while(0);
@@ -2530,6 +5315,7 @@ static int32_t prvMQC_processPubrel(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
     int32_t         Ret                 =   D_MQC_RET_OK;
     uint16_t        PacketIdentifier    =   0;
     S_MQC_MSG_CTX*  Message             =   NULL;
+    uint8_t         ReasonCode          =   0;
     
     do
     {
@@ -2540,7 +5326,7 @@ static int32_t prvMQC_processPubrel(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
             break;
         }
         
-        if(sizeof(uint16_t) != DataSize)
+        if(prvMQC_AckReasonCode(MQCHandler, Data, DataSize, &ReasonCode))
         {
             /* Bad Format */
             Ret = D_MQC_RET_BAD_FORMAT;
@@ -2556,10 +5342,13 @@ static int32_t prvMQC_processPubrel(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
         {
             /* delete this message from the queue */
             MQC_MsgQueue_slice(&(MQCHandler->SessionCtx.MessageQueue), Message);
+#if defined (MQC_PERSISTENCE)
+            prvMQC_PersistDelete(MQCHandler, Message);
+#endif /* MQC_PERSISTENCE */
             
             /* Free the memory */
-            MQCHandler->FreeFunc(Message->MsgData);
-            MQCHandler->FreeFunc(Message);
+            prvMQC_ObjectFree(MQCHandler, Message->MsgData);
+            prvMQC_ObjectFree(MQCHandler, Message);
         }
         
         /* Send PUBCOMP Message */
@@ -2588,6 +5377,7 @@ static int32_t prvMQC_processPubcomp(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
     int32_t         Ret                 =   D_MQC_RET_OK;
     uint16_t        PacketIdentifier    =   0;
     S_MQC_MSG_CTX*  Message             =   NULL;
+    uint8_t         ReasonCode          =   0;
     
     do
     {
@@ -2598,7 +5388,7 @@ static int32_t prvMQC_processPubcomp(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
             break;
         }
         
-        if(sizeof(uint16_t) != DataSize)
+        if(prvMQC_AckReasonCode(MQCHandler, Data, DataSize, &ReasonCode))
         {
             /* Bad Format */
             Ret = D_MQC_RET_BAD_FORMAT;
@@ -2614,10 +5404,19 @@ static int32_t prvMQC_processPubcomp(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t F
         {          
             /* delete this message from the queue */
             MQC_MsgQueue_slice(&(MQCHandler->SessionCtx.MessageQueue), Message);
+#if defined (MQC_PERSISTENCE)
+            prvMQC_PersistDelete(MQCHandler, Message);
+#endif /* MQC_PERSISTENCE */
+            
+            /* The flow completes, so the Packet Identifier can be used again */
+            prvMQC_PublishFlowEnd(MQCHandler, PacketIdentifier);
             
             /* Free the memory */
-            MQCHandler->FreeFunc(Message->MsgData);
-            MQCHandler->FreeFunc(Message);
+            prvMQC_ObjectFree(MQCHandler, Message->MsgData);
+            prvMQC_ObjectFree(MQCHandler, Message);
+            
+            /* Send the pending Messages with the free slot */
+            prvMQC_PendingDrain(MQCHandler);
         }
         
         Ret = D_MQC_RET_OK;
@@ -2648,6 +5447,11 @@ static int32_t prvMQC_processSuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
     uint32_t            i                   =   0;
     S_MQC_MSG_CTX*      Message             =   NULL;
     E_MQC_RETURN_CODE*  CodeList            =   NULL;
+#if defined (MQC_MQTT5)
+    uint8_t*            Property            =   NULL;
+    uint32_t            PropertyLength      =   0;
+    uint32_t            PropertySize        =   0;
+#endif /* MQC_MQTT5 */
     
     do
     {
@@ -2670,6 +5474,22 @@ static int32_t prvMQC_processSuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
         Data = Data + sizeof(uint16_t);
         DataSize = DataSize - sizeof(uint16_t);
         
+#if defined (MQC_MQTT5)
+        /* Skip Properties */
+        if(prvMQC_Version5(MQCHandler))
+        {
+            PropertySize = prvMQC_PropertyGet(Data, DataSize, &Property, &PropertyLength);
+            if(!PropertySize)
+            {
+                /* Bad Format */
+                Ret = D_MQC_RET_BAD_FORMAT;
+                break;
+            }
+            Data = Data + PropertySize;
+            DataSize = DataSize - PropertySize;
+        }
+#endif /* MQC_MQTT5 */
+        
         if(!DataSize)
         {
             /* Bad Format */
@@ -2677,7 +5497,7 @@ static int32_t prvMQC_processSuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
             break;
         }
         
-        CodeList = MQCHandler->MallocFunc( sizeof(E_MQC_RETURN_CODE) * DataSize);
+        CodeList = prvMQC_ObjectMalloc(MQCHandler, sizeof(E_MQC_RETURN_CODE) * DataSize);
         if(!CodeList)
         {
             Ret = D_MQC_RET_NO_MEMORY;
@@ -2695,6 +5515,12 @@ static int32_t prvMQC_processSuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
                     CodeList[i] = (E_MQC_RETURN_CODE)(*Data);
                     break;
                 default:
+                    if( (0x80 < *Data) && prvMQC_Version5(MQCHandler) )
+                    {
+                        /* Failure Reason Codes of MQTT 5.0 */
+                        CodeList[i] = E_MQC_CODE_FAIL;
+                        break;
+                    }
                     /* Bad Format */
                     Ret = D_MQC_RET_BAD_FORMAT;
                     break;
@@ -2721,12 +5547,23 @@ static int32_t prvMQC_processSuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
             /* delete this message from the queue */
             MQC_MsgQueue_slice(&(MQCHandler->SessionCtx.MessageQueue), Message);
             
-            /* Notify user the subscribe complete */
-            D_MQC_CALLBACK_SAFECALL(Ret, Message->ExtData.Subscribe.ResultFuncCB, E_MQC_BEHAVIOR_COMPLETE, Message->ExtData.Subscribe.TopicFilterList, CodeList, DataSize);
+            /* The flow completes, so the Packet Identifier can be used again */
+            MQC_MsgQueue_release(&(MQCHandler->SessionCtx.MessageQueue), PacketIdentifier);
             
-            /* Free the memory */
-            MQCHandler->FreeFunc(Message->MsgData);
-            MQCHandler->FreeFunc(Message);
+#if defined (MQC_TOPIC_DISPATCH)
+            /* The handlers registered for the Topic Filters refused by server are taken back (in reverse order for the same Topic Filter) */
+            for(i = DataSize; Message->ExtData.Subscribe.HandlerList && (i > 0); i--)
+            {
+                if(E_MQC_CODE_FAIL == CodeList[i - 1])
+                {
+                    prvMQC_TopicHandlerRestore(MQCHandler, &(Message->ExtData.Subscribe.TopicFilterList[i - 1]), &(Message->ExtData.Subscribe.HandlerList[i - 1]));
+                }
+            }
+#endif /* MQC_TOPIC_DISPATCH */
+            
+            /* Notify user the subscribe complete */
+            prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_COMPLETE, CodeList);
+            CodeList = NULL;
         }
         
         Ret = D_MQC_RET_OK;
@@ -2735,7 +5572,7 @@ static int32_t prvMQC_processSuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t Fi
     
     if(CodeList)
     {
-        MQCHandler->FreeFunc(CodeList);
+        prvMQC_ObjectFree(MQCHandler, CodeList);
     }
     
     return Ret;
@@ -2759,6 +5596,10 @@ static int32_t prvMQC_processUnsuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t
     int32_t         Ret                 =   D_MQC_RET_OK;
     uint16_t        PacketIdentifier    =   0;
     S_MQC_MSG_CTX*  Message             =   NULL;
+#if defined (MQC_MQTT5)
+    uint8_t*        Property            =   NULL;
+    uint32_t        PropertyLength      =   0;
+#endif /* MQC_MQTT5 */
     
     do
     {
@@ -2769,12 +5610,23 @@ static int32_t prvMQC_processUnsuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t
             break;
         }
         
-        if( sizeof(uint16_t) != DataSize )
+        if( (sizeof(uint16_t) != DataSize) && (!prvMQC_Version5(MQCHandler)) )
+        {
+            /* Bad Format */
+            Ret = D_MQC_RET_BAD_FORMAT;
+            break;
+        }
+        
+#if defined (MQC_MQTT5)
+        /* Properties and the Reason Codes of MQTT 5.0 (the Reason Codes are not notified) */
+        if( prvMQC_Version5(MQCHandler) && 
+            ( (sizeof(uint16_t) >= DataSize) || (!prvMQC_PropertyGet(Data + sizeof(uint16_t), DataSize - sizeof(uint16_t), &Property, &PropertyLength)) ) )
         {
             /* Bad Format */
             Ret = D_MQC_RET_BAD_FORMAT;
             break;
         }
+#endif /* MQC_MQTT5 */
         
         /* Get Packet Identifier */
         PacketIdentifier = MQC_ntohs(*((uint16_t*)Data));
@@ -2786,12 +5638,11 @@ static int32_t prvMQC_processUnsuback(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t
             /* delete this message from the queue */
             MQC_MsgQueue_slice(&(MQCHandler->SessionCtx.MessageQueue), Message);
             
-            /* Notify user the subscribe complete */
-            D_MQC_CALLBACK_SAFECALL(Ret, Message->ExtData.UnSubscribe.ResultFuncCB, E_MQC_BEHAVIOR_COMPLETE, Message->ExtData.UnSubscribe.TopicFilterList, Message->ExtData.UnSubscribe.ListNum);
+            /* The flow completes, so the Packet Identifier can be used again */
+            MQC_MsgQueue_release(&(MQCHandler->SessionCtx.MessageQueue), PacketIdentifier);
             
-            /* Free the memory */
-            MQCHandler->FreeFunc(Message->MsgData);
-            MQCHandler->FreeFunc(Message);
+            /* Notify user the subscribe complete */
+            prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_COMPLETE, NULL);
         }
         
         Ret = D_MQC_RET_OK;
@@ -2835,7 +5686,7 @@ static int32_t prvMQC_processPingresp(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t
         }
         
         /* Notify User message received */
-        D_MQC_CALLBACK_SAFECALL(Ret, MQCHandler->ReadFuncCB, MQCHandler->UsrCtx, E_MQC_MSG_PINGRESP, NULL);
+        prvMQC_ReadNotify(MQCHandler, E_MQC_MSG_PINGRESP, NULL);
         
         Ret = D_MQC_RET_OK;
         
@@ -2845,39 +5696,64 @@ static int32_t prvMQC_processPingresp(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t
 }
 
 /** 
- * @brief               Check and Process Message Data
+ * @brief               Dispatch a complete MQTT Message to its process function
  * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           FixedHeader             Fixed Header
+ * @param[in]           Data                    Message variable header and payload
+ * @param[in]           DataSize                Message remaining length (variable header size + payload size)
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_BAD_FORMAT
  * @retval              D_MQC_RET_NO_MEMORY
  * @retval              D_MQC_RET_CALLBACK_ERROR
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_BAD_SEQUEUE
- * @author              zhaozhenge@outlook.com
- * @date                2018/12/03
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static int32_t prvMQC_ReadMessageData( S_MQC_SESSION_HANDLE* MQCHandler )
+static int32_t prvMQC_DispatchMessage(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t FixedHeader, uint8_t* Data, uint32_t DataSize)
 {
-    int32_t     Ret     =   D_MQC_RET_OK;
+    int32_t     Ret     =   D_MQC_RET_BAD_FORMAT;
     uint32_t    Length  =   0;
     uint8_t     Type    =   0;
     uint32_t    i       =   0;
     
     Length  =   sizeof(ProtocolData) / sizeof(S_MQC_PROTOCOL_DATA);
-    Type    =   MQCHandler->SessionCtx.RecvData[0] >> 4;
-    Ret     =   D_MQC_RET_BAD_FORMAT;
+    Type    =   FixedHeader >> 4;
     
     for(i = 0; i < Length; i++)
     {
         if(ProtocolData[i].Type == Type)
         {
-            Ret = ProtocolData[i].processFunc(MQCHandler, MQCHandler->SessionCtx.RecvData[0], MQCHandler->SessionCtx.RecvData + MQCHandler->SessionCtx.HeaderDataSize, MQCHandler->SessionCtx.TotalRecvDataSize - MQCHandler->SessionCtx.HeaderDataSize);
+            Ret = ProtocolData[i].processFunc(MQCHandler, FixedHeader, Data, DataSize);
             break;
         }
     }
     
+    return Ret;
+}
+
+/** 
+ * @brief               Check and Process Message Data
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_FORMAT
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_BAD_SEQUEUE
+ * @author              zhaozhenge@outlook.com
+ * @date                2018/12/03
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_ReadMessageData( S_MQC_SESSION_HANDLE* MQCHandler )
+{
+    int32_t     Ret     =   D_MQC_RET_OK;
+    
+    Ret = prvMQC_DispatchMessage(MQCHandler, MQCHandler->SessionCtx.RecvData[0], MQCHandler->SessionCtx.RecvData + MQCHandler->SessionCtx.HeaderDataSize, MQCHandler->SessionCtx.TotalRecvDataSize - MQCHandler->SessionCtx.HeaderDataSize);
+    
     /* package free */
     prvMQC_PackageFree(MQCHandler);
     
@@ -2906,14 +5782,13 @@ static int32_t prvMQC_CoreReadMessage(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t
     do
     {
         /* Read MQTT Message */
-        if(!MQCHandler->SessionCtx.RecvData)
+        if(!MQCHandler->SessionCtx.RecvDataSize)
         {
-            /* If have not received any data, create the buffer to store the received data */
-            MQCHandler->SessionCtx.RecvData = MQCHandler->MallocFunc(D_MQC_MAX_MESSAGE_HEADER_SIZE);
-            if(!MQCHandler->SessionCtx.RecvData)
+            /* If have not received any data, make sure the buffer can store the message header */
+            Ret = prvMQC_RecvBufferReserve(MQCHandler, D_MQC_MAX_MESSAGE_HEADER_SIZE);
+            if(D_MQC_RET_OK != Ret)
             {
                 /* Have no enouh memory */
-                Ret = D_MQC_RET_NO_MEMORY;
                 break;
             }
         }
@@ -2941,6 +5816,112 @@ static int32_t prvMQC_CoreReadMessage(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t
     return Ret;
 }
 
+/** 
+ * @brief               Read one MQTT Message frame from the data read from network
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           Data                    Data read from the network
+ * @param[in]           Size                    Size of the Data (must not be 0)
+ * @param[out]          ReadSize                Number of bytes consumed
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_FORMAT
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_BAD_SEQUEUE
+ * @note                A message contained completely in \a Data is processed in place without copy.
+ *                      Only a message which spans several reads is stored in the session receive buffer.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static int32_t prvMQC_CoreReadFrame(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, size_t Size, size_t* ReadSize)
+{
+    int32_t     Ret             =   D_MQC_RET_OK;
+    uint32_t    RemainingLength =   0;
+    size_t      CopySize        =   0;
+    size_t      i               =   0;
+    
+    *ReadSize = 0;
+    
+    do
+    {
+        if(!MQCHandler->SessionCtx.RecvDataSize)
+        {
+            /* Find the end of the Remaining Length */
+            for(i = 1; (i < Size) && (i < D_MQC_MAX_MESSAGE_HEADER_SIZE); i++)
+            {
+                if( !(Data[i] & 128) )
+                {
+                    break;
+                }
+            }
+            if(D_MQC_MAX_MESSAGE_HEADER_SIZE == i)
+            {
+                /* Bad Format */
+                Ret = D_MQC_RET_BAD_FORMAT;
+                break;
+            }
+            if(i < Size)
+            {
+                (void)prvMQC_RemainingLengthDecode(Data + 1, i, &RemainingLength);
+#if defined (MQC_MQTT5)
+                if( prvMQC_Version5(MQCHandler) && prvMQC_PacketOversize(MQCHandler->MaximumPacketSize, RemainingLength) )
+                {
+                    /* Larger than the Maximum Packet Size of the client */
+                    Ret = D_MQC_RET_BAD_FORMAT;
+                    break;
+                }
+#endif /* MQC_MQTT5 */
+                if( RemainingLength <= (Size - i - 1) )
+                {
+                    /* The whole message is in the data, process it in place */
+                    *ReadSize = i + 1 + RemainingLength;
+                    Ret = prvMQC_DispatchMessage(MQCHandler, Data[0], Data + i + 1, RemainingLength);
+                    break;
+                }
+            }
+        }
+        
+        /* The message spans reads, store the fixed header byte by byte */
+        while( (*ReadSize < Size) && (0 == MQCHandler->SessionCtx.TotalRecvDataSize) )
+        {
+            Ret = prvMQC_CoreReadMessage(MQCHandler, Data[*ReadSize]);
+            (*ReadSize)++;
+            if( (D_MQC_RET_OK != Ret) || (!MQCHandler->SessionCtx.RecvDataSize) )
+            {
+                /* Error occurred or message has been processed */
+                return Ret;
+            }
+        }
+        
+        if(MQCHandler->SessionCtx.ChunkCtx.Enable)
+        {
+            /* Deliver the payload in chunks without storing it */
+            Ret = prvMQC_CoreReadChunk(MQCHandler, Data + *ReadSize, Size - *ReadSize, &CopySize);
+            *ReadSize += CopySize;
+            break;
+        }
+        
+        /* Store the rest of the message at once */
+        CopySize = MQCHandler->SessionCtx.TotalRecvDataSize - MQCHandler->SessionCtx.RecvDataSize;
+        if(CopySize > (Size - *ReadSize))
+        {
+            CopySize = Size - *ReadSize;
+        }
+        memcpy(MQCHandler->SessionCtx.RecvData + MQCHandler->SessionCtx.RecvDataSize, Data + *ReadSize, CopySize);
+        MQCHandler->SessionCtx.RecvDataSize += CopySize;
+        *ReadSize += CopySize;
+        if(MQCHandler->SessionCtx.TotalRecvDataSize == MQCHandler->SessionCtx.RecvDataSize)
+        {
+            /* Read the total message data */
+            Ret = prvMQC_ReadMessageData(MQCHandler);
+        }
+    }while(0);
+    
+    return Ret;
+}
+
 /** 
  * @brief               Callback function for Send a MQTT Message when process the Message Queue
  * @param[in,out]       Message                 Message Information
@@ -2956,7 +5937,7 @@ static void prvMQC_WriteCBForProcess(S_MQC_MSG_CTX*  Message, void* UserCtx)
     S_MQC_SESSION_HANDLE*   MQCHandler  =   (S_MQC_SESSION_HANDLE*)UserCtx;
     
     /* Use callback function to send data */
-    (void)MQCHandler->WriteFuncCB(MQCHandler->UsrCtx, Message->MsgData, Message->MsgLength);
+    (void)prvMQC_CoreWrite(MQCHandler, Message->MsgData, Message->MsgLength);
     return;
 }
 
@@ -2974,10 +5955,12 @@ static void prvMQC_TimeoutCBForProcess(S_MQC_MSG_CTX*  Message, void* UserCtx)
 {
     S_MQC_SESSION_HANDLE*   MQCHandler  =   (S_MQC_SESSION_HANDLE*)UserCtx;
     
+#if defined (MQC_PERSISTENCE)
+    prvMQC_PersistDelete(MQCHandler, Message);
+#endif /* MQC_PERSISTENCE */
     /* Notify the application this message timeout via callback function */
-    (void)prvMessageDiscardNotify(MQCHandler, Message, E_MQC_BEHAVIOR_TIMEOUT);
-    MQCHandler->FreeFunc(Message->MsgData);
-    MQCHandler->FreeFunc(Message);
+    prvMQC_PacketIdentifierRelease(MQCHandler, Message);
+    prvMQC_MessageNotify(MQCHandler, Message, E_MQC_BEHAVIOR_TIMEOUT, NULL);
     
     return;
 }
@@ -2997,7 +5980,6 @@ static void prvMQC_ForeachCBForReset(S_MQC_MSG_CTX*  Message, void* UserCtx)
     S_MQC_SESSION_HANDLE*   MQCHandler  =   (S_MQC_SESSION_HANDLE*)UserCtx;
     
     Message->SendCount  =   MQCHandler->MessageRetryCount + 1;
-    Message->ExpireTime =   0;
     
     return;
 }
@@ -3035,11 +6017,27 @@ extern int32_t MQC_CoreStart(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
         {
             break;
         }
+#if defined (D_MQC_POOL_ENABLED)
+        /* Create the fixed size pool */
+        prvMQC_PoolCreate(MQCHandler);
+#endif /* D_MQC_POOL_ENABLED */
+#if defined (MQC_TOPIC_DISPATCH)
+        /* Init the Topic Filter Trie */
+        (void)MQC_TopicTrie_create(&(MQCHandler->SessionCtx.TopicTrie), MQCHandler->MallocFunc, MQCHandler->FreeFunc);
+#endif /* MQC_TOPIC_DISPATCH */
+#if defined (MQC_PAYLOAD_CODEC)
+        /* Init the codec table */
+        (void)MQC_Codec_create(&(MQCHandler->SessionCtx.CodecTable), MQCHandler->MallocFunc, MQCHandler->FreeFunc);
+#endif /* MQC_PAYLOAD_CODEC */
         /* Set Recv Data to None */
         prvMQC_PackageFree(MQCHandler);
         /* Cancel the timer */
         MQCHandler->SessionCtx.TimeoutCount = 0;
         MQCHandler->SessionCtx.SystimeCount = SystimeCount;
+#if defined (MQC_PERSISTENCE)
+        /* Resume the Messages in flight before the restart */
+        prvMQC_PersistStart(MQCHandler);
+#endif /* MQC_PERSISTENCE */
         
         /* Session Created */
         MQCHandler->SessionCtx.Status = E_MQC_STATUS_OPEN;
@@ -3068,13 +6066,23 @@ extern int32_t MQC_CoreStart(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
  */
 extern int32_t MQC_CoreStop(S_MQC_SESSION_HANDLE* MQCHandler)
 {
-    int32_t Ret = D_MQC_RET_OK;
+    int32_t             Ret         =   D_MQC_RET_OK;
+    T_LIST_NODE*        HashList    =   NULL;
+    S_MQC_EVENT_LIST    List;
     
     if(MQCHandler->LockFunc)
     {
         MQCHandler->LockFunc(MQCHandler->UsrCtx);
     }
     
+#if defined (MQC_PERSISTENCE)
+    if(!MQCHandler->CleanSession)
+    {
+        /* Keep the Messages in the store for the next start */
+        MQCHandler->SessionCtx.PersistEnable = false;
+    }
+#endif /* MQC_PERSISTENCE */
+    
     /* Status check */
     switch (MQCHandler->SessionCtx.Status)
     {
@@ -3096,13 +6104,59 @@ extern int32_t MQC_CoreStop(S_MQC_SESSION_HANDLE* MQCHandler)
             return Ret;
     }
     
-    /* Set Recv Data to None */
-    prvMQC_PackageFree(MQCHandler);
+#if defined (MQC_OFFLINE_BUFFER)
+    /* The Messages of the offline buffer are discarded with the session */
+    prvMQC_OfflineClear(MQCHandler);
+#endif /* MQC_OFFLINE_BUFFER */
+#if defined (MQC_PERSISTENCE)
+    prvMQC_PersistSync(MQCHandler);
+#endif /* MQC_PERSISTENCE */
+    /* The discarded Messages are notified after the session is released (the list keeps the pool until then) */
+    prvMQC_EventTake(MQCHandler, &List);
+    
+    /* Release Recv Data and the receive buffer */
+    prvMQC_PackageRelease(MQCHandler);
+    /* Release the send buffer */
+    if(MQCHandler->SessionCtx.SendData)
+    {
+        MQCHandler->FreeFunc(MQCHandler->SessionCtx.SendData);
+        MQCHandler->SessionCtx.SendData = NULL;
+    }
+    MQCHandler->SessionCtx.SendBufferSize = 0;
+    /* Release the output batch */
+    if(MQCHandler->SessionCtx.BatchData)
+    {
+        MQCHandler->FreeFunc(MQCHandler->SessionCtx.BatchData);
+        MQCHandler->SessionCtx.BatchData = NULL;
+    }
+    MQCHandler->SessionCtx.BatchBufferSize = 0;
+    MQCHandler->SessionCtx.BatchLength = 0;
     /* Cancel the timer */
     MQCHandler->SessionCtx.TimeoutCount = 0;
     MQCHandler->SessionCtx.SystimeCount = 0;
-    /* Finalize Message Queue */
+    /* Finalize Message Queue and release the index allocated at MQC_Open */
+    HashList = MQC_MsgQueue_rehash(&(MQCHandler->SessionCtx.MessageQueue), NULL, 0);
+    if(HashList)
+    {
+        MQCHandler->FreeFunc(HashList);
+    }
     MQC_MsgQueue_delete(&(MQCHandler->SessionCtx.MessageQueue));
+#if defined (D_MQC_POOL_ENABLED)
+    /* Release the fixed size pool */
+    prvMQC_PoolDelete(MQCHandler);
+#endif /* D_MQC_POOL_ENABLED */
+#if defined (MQC_TOPIC_DISPATCH)
+    /* Release the handlers of the Topic Filters */
+    (void)MQC_TopicTrie_delete(&(MQCHandler->SessionCtx.TopicTrie));
+#endif /* MQC_TOPIC_DISPATCH */
+#if defined (MQC_MQTT5)
+    /* Release the Topic Aliases */
+    prvMQC_TopicAliasReset(MQCHandler);
+#endif /* MQC_MQTT5 */
+#if defined (MQC_PAYLOAD_CODEC)
+    /* Release the codecs */
+    (void)MQC_Codec_delete(&(MQCHandler->SessionCtx.CodecTable));
+#endif /* MQC_PAYLOAD_CODEC */
     MQCHandler->SessionCtx.Status = E_MQC_STATUS_INVALID;
     
     memset(&(MQCHandler->SessionCtx), 0, sizeof(S_MQC_SESSION_CTX));
@@ -3112,6 +6166,18 @@ extern int32_t MQC_CoreStop(S_MQC_SESSION_HANDLE* MQCHandler)
         MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
     }
     
+    /* Notify user the events taken above, the session can be started again by the callbacks */
+    prvMQC_EventDispatch(MQCHandler, &List);
+    if(MQCHandler->LockFunc)
+    {
+        MQCHandler->LockFunc(MQCHandler->UsrCtx);
+    }
+    prvMQC_EventFree(MQCHandler, &List, NULL);
+    if(MQCHandler->UnlockFunc)
+    {
+        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
+    }
+    
     return Ret;
 }
 
@@ -3144,6 +6210,8 @@ extern int32_t MQC_CoreOpen(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Timeout)
     {
         /* Status check */
         case E_MQC_STATUS_OPEN:
+            /* Size the index of the Message Queue by MaxInflight */
+            prvMQC_QueueIndexResize(MQCHandler);
             /* Connect with server */
             Ret = prvMQC_CoreConnect(MQCHandler, MQCHandler->CleanSession);
             if(D_MQC_RET_OK == Ret)
@@ -3216,10 +6284,14 @@ extern int32_t MQC_CoreClose(S_MQC_SESSION_HANDLE* MQCHandler)
             {
                 /* Suspend Session */
                 MQC_MsgQueue_foreach(&(MQCHandler->SessionCtx.MessageQueue), prvMQC_ForeachCBForReset, MQCHandler);
+                MQC_MsgQueue_expire(&(MQCHandler->SessionCtx.MessageQueue));
             }
             Ret = prvMQC_CoreDisconnect(MQCHandler);
             /* Set Recv Data to None */
             prvMQC_PackageFree(MQCHandler);
+#if defined (MQC_MQTT5)
+            prvMQC_TopicAliasReset(MQCHandler);
+#endif /* MQC_MQTT5 */
             /* Cancel the timer */
             MQCHandler->SessionCtx.TimeoutCount = 0;
             MQCHandler->SessionCtx.Status = E_MQC_STATUS_OPEN;
@@ -3229,10 +6301,8 @@ extern int32_t MQC_CoreClose(S_MQC_SESSION_HANDLE* MQCHandler)
             break;
     }
 
-    if(MQCHandler->UnlockFunc)
-    {
-        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
-    }
+    /* Notify user the events after the session is unlocked */
+    prvMQC_CoreUnlock(MQCHandler);
     
     return Ret;
 }
@@ -3287,10 +6357,8 @@ extern int32_t MQC_CoreReset(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Timeout)
             break;
     }
 
-    if(MQCHandler->UnlockFunc)
-    {
-        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
-    }
+    /* Notify user the events after the session is unlocked */
+    prvMQC_CoreUnlock(MQCHandler);
     
     return Ret;
 }
@@ -3306,6 +6374,7 @@ extern int32_t MQC_CoreReset(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t Timeout)
  * @retval              D_MQC_RET_BAD_SEQUEUE
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/19
  * @callgraph
@@ -3331,20 +6400,102 @@ extern int32_t MQC_CoreSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DA
         case E_MQC_STATUS_WORK:  
         case E_MQC_STATUS_RESET:
             /* MQTT V3.1.1 allow client to send message before receive CONNACK */
-            Ret = prvMQC_CoreSubscribe(MQCHandler, TopicFilterList, QoSList, ListNum, ResultFuncCB);
+            Ret = prvMQC_CoreSubscribe(MQCHandler, TopicFilterList, QoSList, ListNum, ResultFuncCB, NULL);
             break;
         default:
             Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
     }
 
-    if(MQCHandler->UnlockFunc)
+    /* Notify user the events after the session is unlocked */
+    prvMQC_CoreUnlock(MQCHandler);
+    
+    return Ret;
+}
+
+#if defined (MQC_TOPIC_DISPATCH)
+/** 
+ * @brief               Subscribe topic via MQTT Session with a handler for each Topic Filter.
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilterList         Topic Filter List
+ * @param[in]           QoSList                 Topic Filter's QoS List
+ * @param[in]           HandlerList             Topic Filter's Handler List
+ * @param[in]           ListNum                 Count of the topic filter list
+ * @param[in]           ResultFuncCB            Callback function will be called to notify if received Server Response
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_SEQUEUE
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @note                The handlers are registered before the SUBSCRIBE Message is sent, so the PUBLISH Messages
+ *                      received right after SUBACK are dispatched. If it cannot be sent, or a Topic Filter is refused 
+ *                      by SUBACK, the handler registered before for the same Topic Filter is restored.
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_CoreSubscribeHandler(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_QOS_LEVEL* QoSList, S_MQC_TOPIC_HANDLER* HandlerList, uint32_t ListNum, F_SUBSCRIBE_RES_CBFUNC ResultFuncCB)
+{
+    S_MQC_MSG_SUB_HANDLER*  Replaced    =   NULL;
+    int32_t                 Ret         =   D_MQC_RET_OK;
+    uint32_t                Num         =   0;
+
+    if(MQCHandler->LockFunc)
     {
-        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
+        MQCHandler->LockFunc(MQCHandler->UsrCtx);
+    }
+    
+    /* Status check */
+    switch (MQCHandler->SessionCtx.Status)
+    {
+        /* Status check */
+        case E_MQC_STATUS_OPEN:
+            Ret = D_MQC_RET_BAD_SEQUEUE;
+            break;
+        case E_MQC_STATUS_CONNECT:
+        case E_MQC_STATUS_WORK:  
+        case E_MQC_STATUS_RESET:
+            Replaced = (S_MQC_MSG_SUB_HANDLER*)prvMQC_ObjectMalloc(MQCHandler, ListNum * sizeof(S_MQC_MSG_SUB_HANDLER));
+            if(!Replaced)
+            {
+                Ret = D_MQC_RET_NO_MEMORY;
+                break;
+            }
+            /* Register the handlers, keeping the ones they replace */
+            for(Num = 0; Num < ListNum; Num++)
+            {
+                Replaced[Num].Replaced = (D_MQC_RET_OK == MQC_TopicTrie_search(&(MQCHandler->SessionCtx.TopicTrie), &(TopicFilterList[Num]), &(Replaced[Num].Previous)));
+                Ret = MQC_TopicTrie_insert(&(MQCHandler->SessionCtx.TopicTrie), &(TopicFilterList[Num]), &(HandlerList[Num]));
+                if(D_MQC_RET_OK != Ret)
+                {
+                    break;
+                }
+            }
+            if(D_MQC_RET_OK == Ret)
+            {
+                /* MQTT V3.1.1 allow client to send message before receive CONNACK */
+                Ret = prvMQC_CoreSubscribe(MQCHandler, TopicFilterList, QoSList, ListNum, ResultFuncCB, Replaced);
+            }
+            /* Take back the handlers registered (in reverse order for the same Topic Filter) */
+            for(; (D_MQC_RET_OK != Ret) && (Num > 0); Num--)
+            {
+                prvMQC_TopicHandlerRestore(MQCHandler, &(TopicFilterList[Num - 1]), &(Replaced[Num - 1]));
+            }
+            prvMQC_ObjectFree(MQCHandler, Replaced);
+            break;
+        default:
+            Ret = D_MQC_RET_UNEXPECTED_ERROR;
+            break;
     }
+
+    /* Notify user the events after the session is unlocked */
+    prvMQC_CoreUnlock(MQCHandler);
     
     return Ret;
 }
+#endif /* MQC_TOPIC_DISPATCH */
 
 /** 
  * @brief               Cancel a subscribed topic via MQTT Session.
@@ -3356,6 +6507,7 @@ extern int32_t MQC_CoreSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DA
  * @retval              D_MQC_RET_BAD_SEQUEUE
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @author              zhaozhenge@outlook.com
  * @date                2018/12/04
  * @callgraph
@@ -3364,6 +6516,9 @@ extern int32_t MQC_CoreSubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DA
 extern int32_t MQC_CoreUnsubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilterList, uint32_t ListNum, F_UNSUBSCRIBE_RES_CBFUNC ResultFuncCB)
 {
     int32_t Ret = D_MQC_RET_OK;
+#if defined (MQC_TOPIC_DISPATCH)
+    uint32_t i  = 0;
+#endif /* MQC_TOPIC_DISPATCH */
 
     if(MQCHandler->LockFunc)
     {
@@ -3382,16 +6537,21 @@ extern int32_t MQC_CoreUnsubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_
         case E_MQC_STATUS_RESET:
             /* MQTT V3.1.1 allow client to send message before receive CONNACK */
             Ret = prvMQC_CoreUnSubscribe(MQCHandler, TopicFilterList, ListNum, ResultFuncCB);
+#if defined (MQC_TOPIC_DISPATCH)
+            /* The handlers are removed at once, the Messages received before UNSUBACK go to ReadFuncCB */
+            for(i = 0; (D_MQC_RET_OK == Ret) && (i < ListNum); i++)
+            {
+                (void)MQC_TopicTrie_remove(&(MQCHandler->SessionCtx.TopicTrie), &(TopicFilterList[i]));
+            }
+#endif /* MQC_TOPIC_DISPATCH */
             break;
         default:
             Ret = D_MQC_RET_UNEXPECTED_ERROR;
             break;
     }
 
-    if(MQCHandler->UnlockFunc)
-    {
-        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
-    }
+    /* Notify user the events after the session is unlocked */
+    prvMQC_CoreUnlock(MQCHandler);
     
     return Ret;
 }
@@ -3406,6 +6566,7 @@ extern int32_t MQC_CoreUnsubscribe(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_
  * @retval              D_MQC_RET_OK
  * @retval              D_MQC_RET_UNEXPECTED_ERROR
  * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BUSY
  * @retval              D_MQC_RET_CALLBACK_ERROR
  * @author              zhaozhenge@outlook.com
  * @date                2018/06/19
@@ -3426,11 +6587,28 @@ extern int32_t MQC_CorePublish(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_I
     {
         /* Status check */
         case E_MQC_STATUS_OPEN:
+#if defined (MQC_OFFLINE_BUFFER)
+            if(MQCHandler->OfflineMaxNum)
+            {
+                /* Keep the Message until the session is connected */
+                Ret = prvMQC_OfflinePublish(MQCHandler, Message, QoS, Retain, ResultFuncCB);
+                break;
+            }
+#endif /* MQC_OFFLINE_BUFFER */
             Ret = D_MQC_RET_BAD_SEQUEUE;
             break;
         case E_MQC_STATUS_CONNECT:
         case E_MQC_STATUS_WORK:  
         case E_MQC_STATUS_RESET:
+#if defined (MQC_OFFLINE_BUFFER)
+            if(MQCHandler->SessionCtx.MessageQueue.OfflineCount)
+            {
+                /* Keep the order, the Messages of the offline buffer are sent first */
+                Ret = prvMQC_OfflinePublish(MQCHandler, Message, QoS, Retain, ResultFuncCB);
+                prvMQC_OfflineFlush(MQCHandler);
+                break;
+            }
+#endif /* MQC_OFFLINE_BUFFER */
             /* MQTT V3.1.1 allow client to send message before receive CONNACK */
             Ret = prvMQC_CorePublish(MQCHandler, Message, QoS, Retain, ResultFuncCB);
             break;
@@ -3439,10 +6617,8 @@ extern int32_t MQC_CorePublish(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_MESSAGE_I
             break;
     }
 
-    if(MQCHandler->UnlockFunc)
-    {
-        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
-    }
+    /* Notify user the events after the session is unlocked */
+    prvMQC_CoreUnlock(MQCHandler);
     
     return Ret;
 }
@@ -3514,7 +6690,7 @@ extern int32_t MQC_CorePing(S_MQC_SESSION_HANDLE* MQCHandler)
  */
 extern int32_t MQC_CoreRead(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, size_t Size)
 {
-    uint8_t     CurData     =   0;
+    size_t      ReadSize    =   0;
     int32_t     Ret         =   D_MQC_RET_OK;
     
     if(MQCHandler->LockFunc)
@@ -3522,10 +6698,9 @@ extern int32_t MQC_CoreRead(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, siz
         MQCHandler->LockFunc(MQCHandler->UsrCtx);
     }
     
-    while(Size-- > 0)
+    while(Size > 0)
     {
-        CurData = *Data++;
-        /* Status check */
+        /* Status check (user may change the status in callback function, so check it for each message) */
         switch (MQCHandler->SessionCtx.Status)
         {
             /* Status check */
@@ -3536,7 +6711,7 @@ extern int32_t MQC_CoreRead(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, siz
             case E_MQC_STATUS_WORK:
             case E_MQC_STATUS_RESET:
                 /* Read MQTT Message */
-                Ret = prvMQC_CoreReadMessage(MQCHandler, CurData);
+                Ret = prvMQC_CoreReadFrame(MQCHandler, Data, Size, &ReadSize);
                 break;
             default:
                 Ret = D_MQC_RET_UNEXPECTED_ERROR;
@@ -3546,13 +6721,19 @@ extern int32_t MQC_CoreRead(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, siz
         {
             break;
         }
+        Data = Data + ReadSize;
+        Size = Size - ReadSize;
     }
     
-    if(MQCHandler->UnlockFunc)
+    /* Write the responses of the Messages read above at once */
+    if( prvMQC_BatchFlush(MQCHandler) && (D_MQC_RET_OK == Ret) )
     {
-        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
+        Ret = D_MQC_RET_CALLBACK_ERROR;
     }
     
+    /* Notify user the events after the session is unlocked */
+    prvMQC_CoreUnlock(MQCHandler);
+    
     return Ret;
 }
 
@@ -3569,7 +6750,6 @@ extern int32_t MQC_CoreRead(S_MQC_SESSION_HANDLE* MQCHandler, uint8_t* Data, siz
 extern void MQC_CoreContinue(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeCount)
 {
     uint32_t    PassedTime  = 0;
-    int32_t     Ret         = 0;
     
     if(MQCHandler->LockFunc)
     {
@@ -3588,6 +6768,8 @@ extern void MQC_CoreContinue(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
             PassedTime = prvMQC_CheckPassTime(MQCHandler->SessionCtx.SystimeCount, SystimeCount);
             MQCHandler->SessionCtx.SystimeCount = SystimeCount;
             MQC_MsgQueue_process(&(MQCHandler->SessionCtx.MessageQueue), SystimeCount, prvMQC_WriteCBForProcess, prvMQC_TimeoutCBForProcess, MQCHandler);
+            /* Slots of the in-flight window may be freed by timeout or by reconnect */
+            prvMQC_PendingDrain(MQCHandler);
             break;
         default:
             break;
@@ -3614,7 +6796,7 @@ extern void MQC_CoreContinue(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
                     prvMQC_CoreCleanSession(MQCHandler);
                 }
                 /* Call the callback function */
-                D_MQC_CALLBACK_SAFECALL(Ret, MQCHandler->OpenResetFuncCB, MQCHandler->UsrCtx, E_MQC_BEHAVIOR_TIMEOUT, 0, false);
+                prvMQC_OpenResetNotify(MQCHandler, E_MQC_BEHAVIOR_TIMEOUT, 0, false);
             }
             else
             {
@@ -3627,7 +6809,7 @@ extern void MQC_CoreContinue(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
                 if( PassedTime >= MQCHandler->SessionCtx.TimeoutCount )
                 {
                     /* Timeout */
-                    Ret = prvMQC_CorePing(MQCHandler);
+                    (void)prvMQC_CorePing(MQCHandler);
                     MQCHandler->SessionCtx.TimeoutCount = MQCHandler->KeepAliveInterval * 1000;
                 }
                 else
@@ -3639,11 +6821,241 @@ extern void MQC_CoreContinue(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeC
         default:
             break;
     }
+    
+    /* Write the Messages sent above (and before) at once */
+    (void)prvMQC_BatchFlush(MQCHandler);
  
+    /* Notify user the events after the session is unlocked */
+    prvMQC_CoreUnlock(MQCHandler);
+    
+    return;
+}
+
+/** 
+ * @brief               Get the time until MQC_CoreContinue has work to do next
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           SystimeCount            System timer count with millisecond
+ * @return              Milliseconds until the next retry, keep alive or CONNACK timeout \n
+ *                      0 when the output batch or the offline buffer has Messages to send \n
+ *                      D_MQC_DEADLINE_INFINITE when no timer is running
+ * @note                The same timers as MQC_CoreContinue are checked, the time passed since its last call is counted
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint32_t MQC_CoreNextDeadline(S_MQC_SESSION_HANDLE* MQCHandler, uint32_t SystimeCount)
+{
+    uint32_t    Remaining   = D_MQC_DEADLINE_INFINITE;
+    uint32_t    PassedTime  = 0;
+    
+    if(MQCHandler->LockFunc)
+    {
+        MQCHandler->LockFunc(MQCHandler->UsrCtx);
+    }
+    
+    /* Status check */
+    switch (MQCHandler->SessionCtx.Status)
+    {
+        case E_MQC_STATUS_CONNECT:
+        case E_MQC_STATUS_RESET:
+        case E_MQC_STATUS_WORK:
+            Remaining = MQC_MsgQueue_remaining(&(MQCHandler->SessionCtx.MessageQueue), SystimeCount);
+            if( (E_MQC_STATUS_WORK != MQCHandler->SessionCtx.Status) || MQCHandler->KeepAliveInterval )
+            {
+                /* CONNACK timeout or keep alive */
+                PassedTime = prvMQC_CheckPassTime(MQCHandler->SessionCtx.SystimeCount, SystimeCount);
+                if( PassedTime >= MQCHandler->SessionCtx.TimeoutCount )
+                {
+                    Remaining = 0;
+                }
+                else if( (MQCHandler->SessionCtx.TimeoutCount - PassedTime) < Remaining )
+                {
+                    Remaining = MQCHandler->SessionCtx.TimeoutCount - PassedTime;
+                }
+            }
+            break;
+        default:
+            /* No timer before MQC_Open */
+            break;
+    }
+#if defined (MQC_OFFLINE_BUFFER)
+    if(prvMQC_OfflineReady(MQCHandler))
+    {
+        /* MQC_Continue sends the next Messages of the offline buffer */
+        Remaining = 0;
+    }
+#endif /* MQC_OFFLINE_BUFFER */
+    if(MQCHandler->SessionCtx.BatchLength)
+    {
+        /* MQC_Continue writes the Messages waiting in the output batch */
+        Remaining = 0;
+    }
+    
     if(MQCHandler->UnlockFunc)
     {
         MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
     }
     
-    return;
+    return Remaining;
+}
+
+/** 
+ * @brief               Get the statistics of the MQTT Session
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[out]          Statistics              Statistics of the MQTT Session
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_CoreStatistics(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_STATISTICS* Statistics)
+{
+    int32_t Ret = D_MQC_RET_OK;
+
+    if(MQCHandler->LockFunc)
+    {
+        MQCHandler->LockFunc(MQCHandler->UsrCtx);
+    }
+    
+    /* Status check */
+    switch (MQCHandler->SessionCtx.Status)
+    {
+        case E_MQC_STATUS_OPEN:
+        case E_MQC_STATUS_CONNECT:
+        case E_MQC_STATUS_WORK:
+        case E_MQC_STATUS_RESET:
+            Statistics->InflightCount   = MQCHandler->SessionCtx.InflightCount;
+            Statistics->InflightPeak    = MQCHandler->SessionCtx.InflightPeak;
+            Statistics->PendingCount    = MQCHandler->SessionCtx.MessageQueue.PendingCount;
+            Statistics->PendingPeak     = MQCHandler->SessionCtx.PendingPeak;
+            Statistics->QueueCount      = MQCHandler->SessionCtx.MessageQueue.ListCount;
+#if defined (MQC_OFFLINE_BUFFER)
+            Statistics->OfflineCount    = MQCHandler->SessionCtx.MessageQueue.OfflineCount;
+            Statistics->OfflineSize     = MQCHandler->SessionCtx.MessageQueue.OfflineSize;
+            Statistics->OfflineDropCount= MQCHandler->SessionCtx.OfflineDropCount;
+#endif /* MQC_OFFLINE_BUFFER */
+#if defined (MQC_MQTT5)
+            Statistics->TopicAliasCount     = MQCHandler->SessionCtx.SendAlias.Used;
+            Statistics->TopicAliasMapCount  = MQCHandler->SessionCtx.AliasMapCount;
+            Statistics->TopicAliasHitCount  = MQCHandler->SessionCtx.AliasHitCount;
+            Statistics->TopicAliasSavedBytes= MQCHandler->SessionCtx.AliasSavedBytes;
+            Statistics->InflightMaximum     = prvMQC_InflightMaximum(MQCHandler);
+            Statistics->ServerMaximumPacketSize = MQCHandler->SessionCtx.ServerMaximumPacketSize;
+#endif /* MQC_MQTT5 */
+#if defined (MQC_PAYLOAD_CODEC)
+            Statistics->CodecEncodeCount    = MQCHandler->SessionCtx.EncodeCount;
+            Statistics->CodecRawBytes       = MQCHandler->SessionCtx.EncodeRawBytes;
+            Statistics->CodecEncodedBytes   = MQCHandler->SessionCtx.EncodeBytes;
+            Statistics->CodecDecodeCount    = MQCHandler->SessionCtx.DecodeCount;
+            Statistics->CodecDecodeErrorCount = MQCHandler->SessionCtx.DecodeErrorCount;
+#endif /* MQC_PAYLOAD_CODEC */
+            break;
+        default:
+            Ret = D_MQC_RET_UNEXPECTED_ERROR;
+            break;
+    }
+
+    if(MQCHandler->UnlockFunc)
+    {
+        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
+    }
+    
+    return Ret;
+}
+
+/** 
+ * @brief               Write the Messages waiting in the output batch at once
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_CALLBACK_ERROR
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_CoreFlush(S_MQC_SESSION_HANDLE* MQCHandler)
+{
+    int32_t Ret = D_MQC_RET_OK;
+
+    if(MQCHandler->LockFunc)
+    {
+        MQCHandler->LockFunc(MQCHandler->UsrCtx);
+    }
+    
+    /* Status check */
+    switch (MQCHandler->SessionCtx.Status)
+    {
+        case E_MQC_STATUS_OPEN:
+            /* No connection, the output batch is dropped by the next CONNECT */
+            break;
+        case E_MQC_STATUS_CONNECT:
+        case E_MQC_STATUS_WORK:
+        case E_MQC_STATUS_RESET:
+            if(prvMQC_BatchFlush(MQCHandler))
+            {
+                Ret = D_MQC_RET_CALLBACK_ERROR;
+            }
+            break;
+        default:
+            Ret = D_MQC_RET_UNEXPECTED_ERROR;
+            break;
+    }
+
+    if(MQCHandler->UnlockFunc)
+    {
+        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
+    }
+    
+    return Ret;
+}
+
+#if defined (MQC_PAYLOAD_CODEC)
+/** 
+ * @brief               Set the codec of the payload of the PUBLISH Messages with the Topics matched by a Topic Filter
+ * @param[in,out]       MQCHandler              MQTT client handler
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Codec                   Codec of the Topic Filter (NULL means remove the codec)
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_UNEXPECTED_ERROR
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_CoreCodecSet(S_MQC_SESSION_HANDLE* MQCHandler, S_MQC_UTF8_DATA* TopicFilter, const S_MQC_CODEC* Codec)
+{
+    int32_t Ret = D_MQC_RET_OK;
+
+    if(MQCHandler->LockFunc)
+    {
+        MQCHandler->LockFunc(MQCHandler->UsrCtx);
+    }
+    
+    /* Status check */
+    switch (MQCHandler->SessionCtx.Status)
+    {
+        case E_MQC_STATUS_OPEN:
+        case E_MQC_STATUS_CONNECT:
+        case E_MQC_STATUS_WORK:
+        case E_MQC_STATUS_RESET:
+            Ret = MQC_Codec_set(&(MQCHandler->SessionCtx.CodecTable), TopicFilter, Codec);
+            break;
+        default:
+            Ret = D_MQC_RET_UNEXPECTED_ERROR;
+            break;
+    }
+
+    if(MQCHandler->UnlockFunc)
+    {
+        MQCHandler->UnlockFunc(MQCHandler->UsrCtx);
+    }
+    
+    return Ret;
 }
+#endif /* MQC_PAYLOAD_CODEC */
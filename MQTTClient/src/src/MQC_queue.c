@@ -29,6 +29,17 @@
  * @version     00.00.02 
  *              - 2018/12/12 : zhaozhenge@outlook.com 
  *                  -# Modify some comment
+ * @version     00.00.03 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Index the Messages by Packet Identifier
+ *                  -# Fix the Message number of the Queue is not counted when push
+ *                  -# Schedule the Messages by the absolute Deadline, only the expired Messages are visited
+ *                  -# Allocate the Packet Identifier which is not in use by a bitmap
+ *                  -# Hold the Messages which can not be sent yet in the pending list
+ *                  -# Tell the time until the earliest Deadline
+ *                  -# Mark the Packet Identifier of the resumed Message in use
+ *                  -# Keep the PUBLISH Messages in the offline list while the session is not connected
+ *                  -# Keep a small index in the handler and move it to the larger lists given by MQC_MsgQueue_rehash
  */
 
 /**************************************************************
@@ -37,32 +48,121 @@
 
 #include "../inc/MQC_queue.h"
 
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+/** Get the Message from one of its List Node */
+#define D_MQC_MSG_ENTRY(NodePtr, Member)    ((S_MQC_MSG_CTX*)((uint8_t*)(NodePtr) - offsetof(S_MQC_MSG_CTX, Member)))
+
+/** Mark the Packet Identifier in use */
+#define D_MQC_PACKET_ID_SET(Map, Id)        ((Map)[(Id) >> 5] |= ((uint32_t)1 << ((Id) & 31)))
+
+/** Mark the Packet Identifier free */
+#define D_MQC_PACKET_ID_CLEAR(Map, Id)      ((Map)[(Id) >> 5] &= ~((uint32_t)1 << ((Id) & 31)))
+
+/** Check if the Packet Identifier is in use */
+#define D_MQC_PACKET_ID_CHECK(Map, Id)      ((Map)[(Id) >> 5] & ((uint32_t)1 << ((Id) & 31)))
+
 /**************************************************************
 **  Interface
 **************************************************************/
 
 /** 
- * @brief               calculate the time passed
- * @param[in]           SystimeCountOrig        Base System timer Count
- * @param[in]           SystimeCountNow         Now System timer Count
- * @return              Passed time
- * @author              zhaozhenge@outlook.com
- * @date                2018/11/30
+ * @brief               Check if the Deadline has passed
+ * @param[in]           Deadline                System timer count of the Deadline
+ * @param[in]           SysTimeCount            Now System timer count
+ * @retval              true                    Deadline has passed
+ * @retval              false                   Deadline has not come
+ * @note                The difference is compared as signed, so the wrap around of the timer count is no problem
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvDeadlinePassed(uint32_t Deadline, uint32_t SysTimeCount)
+{
+    return ((int32_t)(SysTimeCount - Deadline) >= 0);
+}
+
+/** 
+ * @brief               Insert the Message into the Timer list by its Deadline
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           Message                 The Message which want to be inserted
+ * @return              None
+ * @note                Search from the tail, the Messages with the same Timeout are just appended
+ * @author              agent@local
+ * @date                2026/10/17
  * @callgraph
  * @callergraph
  */
-static uint32_t prvCheckPassTime(uint32_t SystimeCountOrig, uint32_t SystimeCountNow)
+static void prvTimerInsert(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message)
 {
-    uint32_t Ret = 0;
-    if(SystimeCountOrig <= SystimeCountNow)
+    T_LIST_NODE*    Head    =   &(MsgQueue->TimerList);
+    T_LIST_NODE*    Node    =   Head->prev;
+    
+    while( (Node != Head) && ((int32_t)(Message->Deadline - D_MQC_MSG_ENTRY(Node, TimerNode)->Deadline) < 0) )
     {
-        Ret = SystimeCountNow - SystimeCountOrig;
+        Node = Node->prev;
     }
-    else
+    list_insert(&(Message->TimerNode), Node, Node->next);
+    return;
+}
+
+/** 
+ * @brief               Get the position of the lowest set bit
+ * @param[in]           Value                   Value (should not be 0)
+ * @return              Position of the lowest set bit (0~31)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvLowestBit(uint32_t Value)
+{
+    static const uint8_t DeBruijnTable[32] = 
     {
-        Ret = 0xFFFFFFFF - SystimeCountOrig + SystimeCountNow;
-    }
-    return Ret;
+        0,  1,  28, 2,  29, 14, 24, 3,  30, 22, 20, 15, 25, 17, 4,  8, 
+        31, 27, 13, 23, 21, 19, 16, 7,  26, 12, 18, 6,  11, 5,  10, 9
+    };
+    return DeBruijnTable[((uint32_t)((Value & (~Value + 1)) * 0x077CB531u)) >> 27];
+}
+
+/** 
+ * @brief               Get the index list of the Messages with the Packet Identifier
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           PacketIdentifier        Packet Identifier
+ * @return              Head of the index list
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static T_LIST_NODE* prvHashList(S_MQC_MSG_QUEUE* MsgQueue, uint16_t PacketIdentifier)
+{
+    return &(MsgQueue->HashList[PacketIdentifier & MsgQueue->HashMask]);
+}
+
+/** 
+ * @brief               Remove the Message from the Queue (both the Message list and the index)
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           Message                 The Message which want to be removed from the Queue
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvRemove(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message)
+{
+    T_LIST_NODE* Node = &(Message->Node);
+    list_delete(Node, Node->prev, Node->next);
+    Node = &(Message->HashNode);
+    list_delete(Node, Node->prev, Node->next);
+    Node = &(Message->TimerNode);
+    list_delete(Node, Node->prev, Node->next);
+    MsgQueue->ListCount--;
+    return;
 }
 
 /** 
@@ -77,6 +177,8 @@ static uint32_t prvCheckPassTime(uint32_t SystimeCountOrig, uint32_t SystimeCoun
  */
 extern int32_t MQC_MsgQueue_create(S_MQC_MSG_QUEUE* MsgQueue, uint32_t SysTimeCount)
 {
+    uint32_t    i   =   0;
+    
     /* Internal module , do not need to check the input data */
     memset(MsgQueue, 0, sizeof(S_MQC_MSG_QUEUE));
     MsgQueue->ListCount         =   0;
@@ -84,6 +186,23 @@ extern int32_t MQC_MsgQueue_create(S_MQC_MSG_QUEUE* MsgQueue, uint32_t SysTimeCo
     MsgQueue->PacketIdentifier  =   0;
     list_init(&(MsgQueue->MsgList));
     list_init(&(MsgQueue->ExecMsgList));
+    list_init(&(MsgQueue->TimerList));
+    list_init(&(MsgQueue->PendingList));
+#if defined (MQC_OFFLINE_BUFFER)
+    list_init(&(MsgQueue->OfflineList));
+#endif /* MQC_OFFLINE_BUFFER */
+    MsgQueue->HashList          =   MsgQueue->HashLocal;
+    MsgQueue->HashMask          =   D_MQC_MSG_QUEUE_HASH_LOCAL - 1;
+    for(i = 0; i < D_MQC_MSG_QUEUE_HASH_LOCAL; i++)
+    {
+        list_init(&(MsgQueue->HashList[i]));
+    }
+    /* Packet Identifier 0 and the ones larger than MQC_PACKET_ID_MAX are never free */
+    D_MQC_PACKET_ID_SET(MsgQueue->PacketIdentifierMap, 0);
+    for(i = MQC_PACKET_ID_MAX + 1; i < D_MQC_PACKET_ID_MAP_SIZE * 32; i++)
+    {
+        D_MQC_PACKET_ID_SET(MsgQueue->PacketIdentifierMap, i);
+    }
     return D_MQC_RET_OK;
 }
 
@@ -103,6 +222,55 @@ extern int32_t MQC_MsgQueue_delete(S_MQC_MSG_QUEUE* MsgQueue)
     return D_MQC_RET_OK;
 }
 
+/** 
+ * @brief               Move the index of the Messages to other lists
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           HashList                Lists of the new index (NULL means the lists kept in the handler)
+ * @param[in]           BucketNum               Number of the lists (power of 2, ignored if HashList is NULL)
+ * @return              Lists of the former index given by the caller (NULL if it was the one kept in the handler)
+ * @note                The caller frees the lists returned. The index should be moved back to the handler 
+ *                      with HashList NULL before MQC_MsgQueue_delete
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern T_LIST_NODE* MQC_MsgQueue_rehash(S_MQC_MSG_QUEUE* MsgQueue, T_LIST_NODE* HashList, uint32_t BucketNum)
+{
+    T_LIST_NODE*    Former      =   MsgQueue->HashList;
+    uint32_t        FormerNum   =   MsgQueue->HashMask + 1;
+    T_LIST_NODE*    Node        =   NULL;
+    S_MQC_MSG_CTX*  Message     =   NULL;
+    uint32_t        i           =   0;
+    
+    if(!HashList)
+    {
+        HashList    =   MsgQueue->HashLocal;
+        BucketNum   =   D_MQC_MSG_QUEUE_HASH_LOCAL;
+    }
+    if(HashList == Former)
+    {
+        return NULL;
+    }
+    for(i = 0; i < BucketNum; i++)
+    {
+        list_init(&(HashList[i]));
+    }
+    MsgQueue->HashList  =   HashList;
+    MsgQueue->HashMask  =   BucketNum - 1;
+    for(i = 0; i < FormerNum; i++)
+    {
+        while(!list_empty(&(Former[i])))
+        {
+            Node = Former[i].next;
+            list_delete(Node, Node->prev, Node->next);
+            Message = D_MQC_MSG_ENTRY(Node, HashNode);
+            list_insert_tail(Node, prvHashList(MsgQueue, Message->PacketIdentifier));
+        }
+    }
+    return (Former == MsgQueue->HashLocal)?(NULL):(Former);
+}
+
 /** 
  * @brief               Search a Message by Packet Identifier and Message Type from the Message Queue
  * @param[in,out]       MsgQueue                Message Queue Management handler
@@ -118,14 +286,16 @@ extern int32_t MQC_MsgQueue_delete(S_MQC_MSG_QUEUE* MsgQueue)
  */
 extern S_MQC_MSG_CTX* MQC_MsgQueue_search(S_MQC_MSG_QUEUE* MsgQueue, uint16_t PacketIdentifier, E_MQC_MSG_TYPE MsgType)
 {
+    T_LIST_NODE*    Head        =   NULL;
     T_LIST_NODE*    Node        =   NULL;
     T_LIST_NODE*    TmpNode     =   NULL;
     S_MQC_MSG_CTX*  Message     =   NULL;
     
-    /* Search the Message in queue */
-    list_for_each((&(MsgQueue->MsgList)), Node, TmpNode)
+    /* Search the Message in the index list of the Packet Identifier */
+    Head = prvHashList(MsgQueue, PacketIdentifier);
+    list_for_each(Head, Node, TmpNode)
     {
-        Message = (S_MQC_MSG_CTX*)Node;
+        Message = D_MQC_MSG_ENTRY(Node, HashNode);
         if( (Message->PacketIdentifier == PacketIdentifier) && ((Message->MsgData[0] >> 4) == MsgType) )
         {
             return Message;
@@ -141,6 +311,7 @@ extern S_MQC_MSG_CTX* MQC_MsgQueue_search(S_MQC_MSG_QUEUE* MsgQueue, uint16_t Pa
  * @return              NULL or The pointer of the popped Message 
  * @note                If the Queue is full, will pop the head data of the Queue to create space
  * @note                NULL will be returned if No Data popped
+ * @note                The Deadline of the Message is set by its Timeout
  * @author              zhaozhenge@outlook.com
  * @date                2018/12/03
  * @callgraph
@@ -153,6 +324,11 @@ extern S_MQC_MSG_CTX* MQC_MsgQueue_push( S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CT
     /* Insert */
     Node = (T_LIST_NODE*)Message;
     list_insert_tail(Node, (&(MsgQueue->MsgList)));
+    list_insert_tail(&(Message->HashNode), prvHashList(MsgQueue, Message->PacketIdentifier));
+    /* The timeout is counted from the last process */
+    Message->Deadline = MsgQueue->MnotonicTime + Message->Timeout;
+    prvTimerInsert(MsgQueue, Message);
+    MsgQueue->ListCount++;
     return NULL;
 }
 
@@ -168,14 +344,12 @@ extern S_MQC_MSG_CTX* MQC_MsgQueue_push( S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CT
  */
 extern S_MQC_MSG_CTX* MQC_MsgQueue_pop(S_MQC_MSG_QUEUE* MsgQueue)
 {
-    T_LIST_NODE*    Node        =   NULL;
     S_MQC_MSG_CTX*  Message     =   NULL;
     
     if( !list_empty((&(MsgQueue->MsgList))) )
     {
-        Node = list_delete_head((&(MsgQueue->MsgList)));
-        Message = (S_MQC_MSG_CTX*)Node;
-        MsgQueue->ListCount--;
+        Message = (S_MQC_MSG_CTX*)(MsgQueue->MsgList.next);
+        prvRemove(MsgQueue, Message);
     }
     return Message;
 }
@@ -193,12 +367,223 @@ extern S_MQC_MSG_CTX* MQC_MsgQueue_pop(S_MQC_MSG_QUEUE* MsgQueue)
  */
 extern void MQC_MsgQueue_slice(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message)
 {
-    T_LIST_NODE* Node = (T_LIST_NODE*)Message;
-    list_delete(Node, Node->prev, Node->next);
-    MsgQueue->ListCount--;
+    prvRemove(MsgQueue, Message);
+    return;
+}
+
+/** 
+ * @brief               Let all of the Messages in the Queue time out at the next process
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              None
+ * @note                The Messages will be processed in the order they were pushed
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_MsgQueue_expire(S_MQC_MSG_QUEUE* MsgQueue)
+{
+    T_LIST_NODE*        Node        =   NULL;
+    T_LIST_NODE*        TmpNode     =   NULL;
+    S_MQC_MSG_CTX*      Message     =   NULL;
+    
+    /* Rebuild the Timer list with the order of the Message list */
+    list_init(&(MsgQueue->TimerList));
+    list_for_each((&(MsgQueue->MsgList)), Node, TmpNode)
+    {
+        Message = (S_MQC_MSG_CTX*)Node;
+        Message->Deadline = MsgQueue->MnotonicTime;
+        list_insert_tail(&(Message->TimerNode), &(MsgQueue->TimerList));
+    }
+    return;
+}
+
+/** 
+ * @brief               Allocate a Packet Identifier which is not in use
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              The allocated Packet Identifier
+ * @note                0 will be returned if all of the Packet Identifiers are in use
+ * @note                Search from the last allocated one, so the Packet Identifiers are used in turn
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint16_t MQC_MsgQueue_allocate(S_MQC_MSG_QUEUE* MsgQueue)
+{
+    uint32_t    Start       =   0;
+    uint32_t    Word        =   0;
+    uint32_t    Free        =   0;
+    uint32_t    i           =   0;
+    uint16_t    Ret         =   0;
+    
+    Start   = (MQC_PACKET_ID_MAX <= MsgQueue->PacketIdentifier)?1:(MsgQueue->PacketIdentifier + 1);
+    Word    = Start >> 5;
+    Free    = ~(MsgQueue->PacketIdentifierMap[Word]) & ((uint32_t)0xFFFFFFFF << (Start & 31));
+    
+    /* Check word by word, the start word is checked again at last for the bits before Start */
+    for(i = 0; i <= D_MQC_PACKET_ID_MAP_SIZE; i++)
+    {
+        if(Free)
+        {
+            Ret = (uint16_t)((Word << 5) + prvLowestBit(Free));
+            D_MQC_PACKET_ID_SET(MsgQueue->PacketIdentifierMap, Ret);
+            MsgQueue->PacketIdentifier = Ret;
+            break;
+        }
+        Word = (Word + 1 < D_MQC_PACKET_ID_MAP_SIZE)?(Word + 1):0;
+        Free = ~(MsgQueue->PacketIdentifierMap[Word]);
+    }
+    return Ret;
+}
+
+/** 
+ * @brief               Release a Packet Identifier when its flow completes
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           PacketIdentifier        Packet Identifier allocated by MQC_MsgQueue_allocate
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_MsgQueue_release(S_MQC_MSG_QUEUE* MsgQueue, uint16_t PacketIdentifier)
+{
+    if( (0 < PacketIdentifier) && (MQC_PACKET_ID_MAX >= PacketIdentifier) )
+    {
+        D_MQC_PACKET_ID_CLEAR(MsgQueue->PacketIdentifierMap, PacketIdentifier);
+    }
     return;
 }
 
+/** 
+ * @brief               Mark a known Packet Identifier in use
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           PacketIdentifier        Packet Identifier of the Message resumed from the store
+ * @retval              true                    Marked
+ * @retval              false                   Out of range or already in use
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern bool MQC_MsgQueue_reserve(S_MQC_MSG_QUEUE* MsgQueue, uint16_t PacketIdentifier)
+{
+    if( (0 == PacketIdentifier) || (MQC_PACKET_ID_MAX < PacketIdentifier) )
+    {
+        return false;
+    }
+    if( D_MQC_PACKET_ID_CHECK(MsgQueue->PacketIdentifierMap, PacketIdentifier) )
+    {
+        return false;
+    }
+    D_MQC_PACKET_ID_SET(MsgQueue->PacketIdentifierMap, PacketIdentifier);
+    return true;
+}
+
+/** 
+ * @brief               Hold the Message in the pending list until it can be sent
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           Message                 Message that want to be held
+ * @return              None
+ * @note                The held Message is not searched, processed nor popped until it is taken out by MQC_MsgQueue_unhold
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_MsgQueue_hold(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message)
+{
+    list_insert_tail(&(Message->Node), &(MsgQueue->PendingList));
+    MsgQueue->PendingCount++;
+    return;
+}
+
+/** 
+ * @brief               Take the oldest Message out of the pending list
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              The pointer of the Message taken out
+ * @note                NULL maybe returned if the pending list is empty
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern S_MQC_MSG_CTX* MQC_MsgQueue_unhold(S_MQC_MSG_QUEUE* MsgQueue)
+{
+    S_MQC_MSG_CTX*  Message     =   NULL;
+    
+    if( !list_empty((&(MsgQueue->PendingList))) )
+    {
+        Message = (S_MQC_MSG_CTX*)list_delete_head(&(MsgQueue->PendingList));
+        MsgQueue->PendingCount--;
+    }
+    return Message;
+}
+
+#if defined (MQC_OFFLINE_BUFFER)
+/** 
+ * @brief               Keep a PUBLISH Message in the offline list until the session is connected
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @param[in]           Message                 Message that want to be kept
+ * @return              None
+ * @note                The kept Message is not searched, processed nor popped until it is taken out by MQC_MsgQueue_unpark
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern void MQC_MsgQueue_park(S_MQC_MSG_QUEUE* MsgQueue, S_MQC_MSG_CTX* Message)
+{
+    list_insert_tail(&(Message->Node), &(MsgQueue->OfflineList));
+    MsgQueue->OfflineCount++;
+    MsgQueue->OfflineSize += Message->MsgLength;
+    return;
+}
+
+/** 
+ * @brief               Take the oldest Message out of the offline list
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              The pointer of the Message taken out
+ * @note                NULL maybe returned if the offline list is empty
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern S_MQC_MSG_CTX* MQC_MsgQueue_unpark(S_MQC_MSG_QUEUE* MsgQueue)
+{
+    S_MQC_MSG_CTX*  Message     =   NULL;
+    
+    if( !list_empty((&(MsgQueue->OfflineList))) )
+    {
+        Message = (S_MQC_MSG_CTX*)list_delete_head(&(MsgQueue->OfflineList));
+        MsgQueue->OfflineCount--;
+        MsgQueue->OfflineSize -= Message->MsgLength;
+    }
+    return Message;
+}
+
+/** 
+ * @brief               Get the oldest Message of the offline list without taking it out
+ * @param[in,out]       MsgQueue                Message Queue Management handler
+ * @return              The pointer of the oldest Message
+ * @note                NULL maybe returned if the offline list is empty
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern S_MQC_MSG_CTX* MQC_MsgQueue_parked(S_MQC_MSG_QUEUE* MsgQueue)
+{
+    if( list_empty((&(MsgQueue->OfflineList))) )
+    {
+        return NULL;
+    }
+    return D_MQC_MSG_ENTRY(MsgQueue->OfflineList.next, Node);
+}
+#endif /* MQC_OFFLINE_BUFFER */
+
 /** 
  * @brief               Judge if the Message Queue is empty
  * @param[in,out]       MsgQueue        Message Queue Management handler
@@ -214,6 +599,34 @@ extern bool MQC_MsgQueue_empty( S_MQC_MSG_QUEUE* MsgQueue )
     return list_empty((&(MsgQueue->MsgList)));
 }
 
+/** 
+ * @brief               Get the time until the earliest Deadline of the Messages
+ * @param[in,out]       MsgQueue        Message Queue Management handler
+ * @param[in]           SysTimeCount    Now System timer count
+ * @return              Milliseconds until the earliest Deadline (0 when it has passed) \n
+ *                      D_MQC_DEADLINE_INFINITE when no Message waits for the response
+ * @note                The Timer list is sorted by the Deadline, so only the head is checked
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint32_t MQC_MsgQueue_remaining( S_MQC_MSG_QUEUE* MsgQueue, uint32_t SysTimeCount )
+{
+    uint32_t    Deadline    =   0;
+    
+    if( list_empty((&(MsgQueue->TimerList))) )
+    {
+        return D_MQC_DEADLINE_INFINITE;
+    }
+    Deadline = D_MQC_MSG_ENTRY(MsgQueue->TimerList.next, TimerNode)->Deadline;
+    if( prvDeadlinePassed(Deadline, SysTimeCount) )
+    {
+        return 0;
+    }
+    return (Deadline - SysTimeCount);
+}
+
 /** 
  * @brief               Message Queue process iterator
  * @param[in,out]       MsgQueue                Message Queue Management handler
@@ -232,42 +645,45 @@ extern void  MQC_MsgQueue_process(S_MQC_MSG_QUEUE* MsgQueue, uint32_t SysTimeCou
                                     void (*TimeoutFuncCB)(S_MQC_MSG_CTX*  Message, void* UserCtx), 
                                     void* UsrData)
 {
-    uint32_t            PassTime    =   0;
+    T_LIST_NODE         DueList;
     T_LIST_NODE*        Node        =   NULL;
     T_LIST_NODE*        TmpNode     =   NULL;
     S_MQC_MSG_CTX*      Message     =   NULL;
     
-    /* check the expire time */
-    PassTime = prvCheckPassTime(MsgQueue->MnotonicTime, SysTimeCount);
     MsgQueue->MnotonicTime = SysTimeCount;
     
-    /* Search the iterat the message in queue */
-    list_for_each((&(MsgQueue->MsgList)), Node, TmpNode)
+    /* Take out the Messages whose Deadline has passed, the others are not touched */
+    list_init(&DueList);
+    while( !list_empty((&(MsgQueue->TimerList))) )
     {
-        Message = (S_MQC_MSG_CTX*)Node;
-        /* Check timeout */
-        if(PassTime >= Message->ExpireTime)
+        Node = MsgQueue->TimerList.next;
+        if( !prvDeadlinePassed(D_MQC_MSG_ENTRY(Node, TimerNode)->Deadline, SysTimeCount) )
+        {
+            break;
+        }
+        list_delete(Node, Node->prev, Node->next);
+        list_insert_tail(Node, &DueList);
+    }
+    
+    /* Iterate the expired Messages */
+    list_for_each((&DueList), Node, TmpNode)
+    {
+        Message = D_MQC_MSG_ENTRY(Node, TimerNode);
+        Message->SendCount = (0 == Message->SendCount)?0:Message->SendCount-1;
+        if(Message->SendCount)
         {
-            Message->SendCount = (0 == Message->SendCount)?0:Message->SendCount-1;
-            if(Message->SendCount)
-            {
-                /* timeout recount */
-                Message->ExpireTime = Message->Timeout;
-                /* ReSend the message */
-                WriteFuncCB(Message, UsrData);
-            }
-            else
-            {
-                /* Timeout and should call the callback function */
-                list_delete(Node, Node->prev, Node->next);
-                MsgQueue->ListCount--;
-                list_insert_tail( Node,  &(MsgQueue->ExecMsgList));
-            }
+            /* timeout recount */
+            list_delete(Node, Node->prev, Node->next);
+            Message->Deadline = SysTimeCount + Message->Timeout;
+            prvTimerInsert(MsgQueue, Message);
+            /* ReSend the message */
+            WriteFuncCB(Message, UsrData);
         }
         else
         {
-            /* Update expire time count */
-            Message->ExpireTime = Message->ExpireTime - PassTime;
+            /* Timeout and should call the callback function */
+            prvRemove(MsgQueue, Message);
+            list_insert_tail( &(Message->Node),  &(MsgQueue->ExecMsgList));
         }
     }
     
@@ -0,0 +1,675 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @file        MQC_trie.c
+ * @brief       MQTT Client Library Topic Filter Trie
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Add MQC_TopicTrie_search
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <string.h>
+#include "../inc/MQC_trie.h"
+
+#if defined (MQC_TOPIC_DISPATCH)
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_MQC_TRIE_BUCKET_INIT_NUM      (16)    /*!< Bucket number of the hash table allocated first */
+#define D_MQC_TRIE_LEVEL_SEPARATOR      ('/')   /*!< Topic level separator */
+#define D_MQC_TRIE_SINGLE_WILDCARD      ('+')   /*!< Single-level wildcard */
+#define D_MQC_TRIE_MULTI_WILDCARD       ('#')   /*!< Multi-level wildcard */
+#define D_MQC_TRIE_SYSTEM_PREFIX        ('$')   /*!< Prefix of the topics used by the server */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of matching a topic
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_MQC_TRIE_MATCH_CTX
+{
+    S_MQC_TOPIC_TRIE*   Trie;
+    /*!< Topic Filter Trie */
+
+    void                (*MatchFuncCB)(const S_MQC_TOPIC_HANDLER* Handler, void* UsrData);
+    /*!< Callback function called for each matched Topic Filter */
+
+    void*               UsrData;
+    /*!< User Data used for callback function */
+
+    uint32_t            Count;
+    /*!< Number of the matched Topic Filters */
+}S_MQC_TRIE_MATCH_CTX;
+
+/**************************************************************
+**  Global Param
+**************************************************************/
+
+static void prvMatch(S_MQC_TRIE_MATCH_CTX* MatchCtx, const S_MQC_TOPIC_NODE* Node, const uint8_t* Level, uint16_t Rest);
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Calculate the hash value of a level
+ * @param[in]           Parent                  Node of the upper level
+ * @param[in]           Level                   Level name
+ * @param[in]           Length                  Length of the level name
+ * @return              Hash value
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint32_t prvHash(const S_MQC_TOPIC_NODE* Parent, const uint8_t* Level, uint16_t Length)
+{
+    /* FNV-1a of the level name, seeded by the parent node */
+    uint32_t    Hash    =   2166136261u ^ (uint32_t)((uintptr_t)Parent >> 4);
+    uint16_t    i       =   0;
+
+    for(i = 0; i < Length; i++)
+    {
+        Hash = (Hash ^ Level[i]) * 16777619u;
+    }
+    return Hash;
+}
+
+/**
+ * @brief               Get the length of the level at the head of a topic
+ * @param[in]           Level                   Head of the level
+ * @param[in]           Length                  Length of the rest of the topic
+ * @return              Length of the level
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static uint16_t prvLevelLength(const uint8_t* Level, uint16_t Length)
+{
+    const uint8_t*  Separator   =   (const uint8_t*)memchr(Level, D_MQC_TRIE_LEVEL_SEPARATOR, Length);
+
+    return (Separator)?((uint16_t)(Separator - Level)):(Length);
+}
+
+/**
+ * @brief               Search the child of a node by the level name
+ * @param[in]           Trie                    Topic Filter Trie
+ * @param[in]           Parent                  Node of the upper level
+ * @param[in]           Level                   Level name
+ * @param[in]           Length                  Length of the level name
+ * @return              The child (NULL if not found)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static S_MQC_TOPIC_NODE* prvSearch(S_MQC_TOPIC_TRIE* Trie, const S_MQC_TOPIC_NODE* Parent, const uint8_t* Level, uint16_t Length)
+{
+    uint32_t            Hash    =   prvHash(Parent, Level, Length);
+    S_MQC_TOPIC_NODE*   Node    =   Trie->Bucket[Hash & (Trie->BucketNum - 1)];
+
+    for( ; Node; Node = Node->HashNext )
+    {
+        if( (Node->HashValue == Hash) && (Node->Parent == Parent) && (Node->Length == Length) && !memcmp(Node->Level, Level, Length) )
+        {
+            return Node;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief               Double the bucket number of the hash table when it is full
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @return              None
+ * @note                The hash table is kept as it is if no enough memory
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvGrow(S_MQC_TOPIC_TRIE* Trie)
+{
+    S_MQC_TOPIC_NODE**  Bucket      =   NULL;
+    S_MQC_TOPIC_NODE*   Node        =   NULL;
+    S_MQC_TOPIC_NODE*   Next        =   NULL;
+    uint32_t            BucketNum   =   Trie->BucketNum * 2;
+    uint32_t            i           =   0;
+
+    if(Trie->NodeNum < Trie->BucketNum)
+    {
+        return;
+    }
+    Bucket = (S_MQC_TOPIC_NODE**)Trie->MallocFunc(sizeof(S_MQC_TOPIC_NODE*) * BucketNum);
+    if(!Bucket)
+    {
+        return;
+    }
+    memset(Bucket, 0, sizeof(S_MQC_TOPIC_NODE*) * BucketNum);
+    for(i = 0; i < Trie->BucketNum; i++)
+    {
+        for(Node = Trie->Bucket[i]; Node; Node = Next)
+        {
+            Next = Node->HashNext;
+            Node->HashNext = Bucket[Node->HashValue & (BucketNum - 1)];
+            Bucket[Node->HashValue & (BucketNum - 1)] = Node;
+        }
+    }
+    Trie->FreeFunc(Trie->Bucket);
+    Trie->Bucket = Bucket;
+    Trie->BucketNum = BucketNum;
+    return;
+}
+
+/**
+ * @brief               Add a child to a node
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in,out]       Parent                  Node of the upper level
+ * @param[in]           Level                   Level name
+ * @param[in]           Length                  Length of the level name
+ * @return              The child (NULL means no enough memory)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static S_MQC_TOPIC_NODE* prvAddChild(S_MQC_TOPIC_TRIE* Trie, S_MQC_TOPIC_NODE* Parent, const uint8_t* Level, uint16_t Length)
+{
+    S_MQC_TOPIC_NODE*   Node    =   (S_MQC_TOPIC_NODE*)Trie->MallocFunc(sizeof(S_MQC_TOPIC_NODE) + Length);
+    S_MQC_TOPIC_NODE**  Head    =   NULL;
+
+    if(!Node)
+    {
+        return NULL;
+    }
+    memset(Node, 0, sizeof(S_MQC_TOPIC_NODE));
+    memcpy(Node->Level, Level, Length);
+    Node->Length = Length;
+    Node->Parent = Parent;
+    Node->HashValue = prvHash(Parent, Level, Length);
+
+    /* Index the child */
+    Head = &(Trie->Bucket[Node->HashValue & (Trie->BucketNum - 1)]);
+    Node->HashNext = *Head;
+    *Head = Node;
+    Trie->NodeNum++;
+    Parent->ChildNum++;
+
+    /* Wildcards are also linked to the parent for matching */
+    if( (1 == Length) && (D_MQC_TRIE_SINGLE_WILDCARD == Level[0]) )
+    {
+        Parent->PlusChild = Node;
+    }
+    else if( (1 == Length) && (D_MQC_TRIE_MULTI_WILDCARD == Level[0]) )
+    {
+        Parent->HashChild = Node;
+    }
+
+    prvGrow(Trie);
+    return Node;
+}
+
+/**
+ * @brief               Remove the nodes which are not used by any Topic Filter, from a node up to the root
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           Node                    The lowest node to check
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvPrune(S_MQC_TOPIC_TRIE* Trie, S_MQC_TOPIC_NODE* Node)
+{
+    S_MQC_TOPIC_NODE*   Parent  =   NULL;
+    S_MQC_TOPIC_NODE**  Link    =   NULL;
+
+    while( Node && (Node != Trie->Root) && !Node->Subscribed && !Node->ChildNum )
+    {
+        Parent = Node->Parent;
+
+        /* Remove from the index */
+        for(Link = &(Trie->Bucket[Node->HashValue & (Trie->BucketNum - 1)]); *Link != Node; Link = &((*Link)->HashNext))
+        {
+        }
+        *Link = Node->HashNext;
+        Trie->NodeNum--;
+
+        if(Parent->PlusChild == Node)
+        {
+            Parent->PlusChild = NULL;
+        }
+        if(Parent->HashChild == Node)
+        {
+            Parent->HashChild = NULL;
+        }
+        Parent->ChildNum--;
+        Trie->FreeFunc(Node);
+        Node = Parent;
+    }
+    return;
+}
+
+/**
+ * @brief               Check the format of a Topic Filter
+ * @param[in]           TopicFilter             Topic Filter
+ * @retval              true                    The wildcards are used correctly
+ * @retval              false                   Bad Topic Filter
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static bool prvFilterCheck(const S_MQC_UTF8_DATA* TopicFilter)
+{
+    const uint8_t*  Level       =   TopicFilter->Data;
+    uint16_t        Rest        =   TopicFilter->Length;
+    uint16_t        Length      =   0;
+
+    if( !Level || !Rest )
+    {
+        return false;
+    }
+    while(1)
+    {
+        Length = prvLevelLength(Level, Rest);
+        /* The wildcard must occupy an entire level */
+        if( (Length > 1) && ( memchr(Level, D_MQC_TRIE_SINGLE_WILDCARD, Length) || memchr(Level, D_MQC_TRIE_MULTI_WILDCARD, Length) ) )
+        {
+            return false;
+        }
+        if(Length == Rest)
+        {
+            return true;
+        }
+        /* '#' must be the last level */
+        if( (1 == Length) && (D_MQC_TRIE_MULTI_WILDCARD == Level[0]) )
+        {
+            return false;
+        }
+        Level = Level + Length + 1;
+        Rest = Rest - Length - 1;
+    }
+}
+
+/**
+ * @brief               Find the node of a Topic Filter
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Create                  Create the nodes which do not exist
+ * @return              The node of the last level (NULL if not found or no enough memory)
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static S_MQC_TOPIC_NODE* prvFind(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* TopicFilter, bool Create)
+{
+    S_MQC_TOPIC_NODE*   Node        =   Trie->Root;
+    S_MQC_TOPIC_NODE*   Child       =   NULL;
+    const uint8_t*      Level       =   TopicFilter->Data;
+    uint16_t            Rest        =   TopicFilter->Length;
+    uint16_t            Length      =   0;
+
+    while(Node)
+    {
+        Length = prvLevelLength(Level, Rest);
+        Child = prvSearch(Trie, Node, Level, Length);
+        if( !Child && Create )
+        {
+            Child = prvAddChild(Trie, Node, Level, Length);
+            if(!Child)
+            {
+                /* Remove the nodes created for this Topic Filter */
+                prvPrune(Trie, Node);
+            }
+        }
+        if( !Child || (Length == Rest) )
+        {
+            return Child;
+        }
+        Node = Child;
+        Level = Level + Length + 1;
+        Rest = Rest - Length - 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief               Notify a matched Topic Filter
+ * @param[in,out]       MatchCtx                Context of matching
+ * @param[in]           Node                    Node of the Topic Filter (can be NULL)
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMatched(S_MQC_TRIE_MATCH_CTX* MatchCtx, const S_MQC_TOPIC_NODE* Node)
+{
+    if( Node && Node->Subscribed )
+    {
+        MatchCtx->MatchFuncCB(&(Node->Handler), MatchCtx->UsrData);
+        MatchCtx->Count++;
+    }
+    return;
+}
+
+/**
+ * @brief               Go down to a child which matches the current level of a topic
+ * @param[in,out]       MatchCtx                Context of matching
+ * @param[in]           Child                   The matched child (can be NULL)
+ * @param[in]           Level                   Head of the current level
+ * @param[in]           Length                  Length of the current level
+ * @param[in]           Rest                    Length of the current level and the rest levels
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvVisit(S_MQC_TRIE_MATCH_CTX* MatchCtx, const S_MQC_TOPIC_NODE* Child, const uint8_t* Level, uint16_t Length, uint16_t Rest)
+{
+    if(!Child)
+    {
+        return;
+    }
+    if(Length == Rest)
+    {
+        prvMatched(MatchCtx, Child);
+        /* "a/#" also matches "a" */
+        prvMatched(MatchCtx, Child->HashChild);
+    }
+    else if(Child->ChildNum)
+    {
+        prvMatch(MatchCtx, Child, Level + Length + 1, Rest - Length - 1);
+    }
+    return;
+}
+
+/**
+ * @brief               Match the rest levels of a topic under a node
+ * @param[in,out]       MatchCtx                Context of matching
+ * @param[in]           Node                    Node matched by the former levels
+ * @param[in]           Level                   Head of the rest levels
+ * @param[in]           Rest                    Length of the rest levels
+ * @return              None
+ * @note                Called recursively for each level, so the depth is limited by the levels of the Topic Filters
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+static void prvMatch(S_MQC_TRIE_MATCH_CTX* MatchCtx, const S_MQC_TOPIC_NODE* Node, const uint8_t* Level, uint16_t Rest)
+{
+    const S_MQC_TOPIC_NODE* Child       =   NULL;
+    uint16_t                Length      =   prvLevelLength(Level, Rest);
+    bool                    Wildcard    =   true;
+
+    if( (Node == MatchCtx->Trie->Root) && Length && (D_MQC_TRIE_SYSTEM_PREFIX == Level[0]) )
+    {
+        /* The wildcard at the first level does not match the topic beginning with '$' */
+        Wildcard = false;
+    }
+
+    if(Wildcard)
+    {
+        /* '#' matches this level and all the rest */
+        prvMatched(MatchCtx, Node->HashChild);
+    }
+
+    /* The exact level name */
+    Child = prvSearch(MatchCtx->Trie, Node, Level, Length);
+    prvVisit(MatchCtx, Child, Level, Length, Rest);
+
+    /* '+' matches this level (the topic level "+" is found by the search above) */
+    if( Wildcard && Node->PlusChild && (Node->PlusChild != Child) )
+    {
+        prvVisit(MatchCtx, Node->PlusChild, Level, Length, Rest);
+    }
+    return;
+}
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Create a Topic Filter Trie
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           MallocFunc              malloc callback function
+ * @param[in]           FreeFunc                free callback function
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_create(S_MQC_TOPIC_TRIE* Trie, void* (*MallocFunc)(size_t), void (*FreeFunc)(void*))
+{
+    /* Internal module , do not need to check the input data */
+    memset(Trie, 0, sizeof(S_MQC_TOPIC_TRIE));
+    Trie->MallocFunc = MallocFunc;
+    Trie->FreeFunc = FreeFunc;
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Delete a Topic Filter Trie and all Topic Filters in it
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @retval              D_MQC_RET_OK
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_delete(S_MQC_TOPIC_TRIE* Trie)
+{
+    S_MQC_TOPIC_NODE*   Node    =   NULL;
+    S_MQC_TOPIC_NODE*   Next    =   NULL;
+    uint32_t            i       =   0;
+
+    /* All nodes except the root are in the hash table */
+    for(i = 0; i < Trie->BucketNum; i++)
+    {
+        for(Node = Trie->Bucket[i]; Node; Node = Next)
+        {
+            Next = Node->HashNext;
+            Trie->FreeFunc(Node);
+        }
+    }
+    if(Trie->Bucket)
+    {
+        Trie->FreeFunc(Trie->Bucket);
+    }
+    if(Trie->Root)
+    {
+        Trie->FreeFunc(Trie->Root);
+    }
+    memset(Trie, 0, sizeof(S_MQC_TOPIC_TRIE));
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Insert a Topic Filter with its handler
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[in]           Handler                 Handler of the Topic Filter
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_BAD_INPUT_DATA
+ * @retval              D_MQC_RET_NO_MEMORY
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_insert(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* TopicFilter, const S_MQC_TOPIC_HANDLER* Handler)
+{
+    S_MQC_TOPIC_NODE*   Node    =   NULL;
+
+    if( !prvFilterCheck(TopicFilter) || !Handler->HandlerFuncCB )
+    {
+        return D_MQC_RET_BAD_INPUT_DATA;
+    }
+
+    if(!Trie->Root)
+    {
+        Trie->Bucket = (S_MQC_TOPIC_NODE**)Trie->MallocFunc(sizeof(S_MQC_TOPIC_NODE*) * D_MQC_TRIE_BUCKET_INIT_NUM);
+        Trie->Root = (S_MQC_TOPIC_NODE*)Trie->MallocFunc(sizeof(S_MQC_TOPIC_NODE));
+        if( !Trie->Bucket || !Trie->Root )
+        {
+            if(Trie->Bucket)
+            {
+                Trie->FreeFunc(Trie->Bucket);
+            }
+            if(Trie->Root)
+            {
+                Trie->FreeFunc(Trie->Root);
+            }
+            Trie->Bucket = NULL;
+            Trie->Root = NULL;
+            return D_MQC_RET_NO_MEMORY;
+        }
+        memset(Trie->Bucket, 0, sizeof(S_MQC_TOPIC_NODE*) * D_MQC_TRIE_BUCKET_INIT_NUM);
+        memset(Trie->Root, 0, sizeof(S_MQC_TOPIC_NODE));
+        Trie->BucketNum = D_MQC_TRIE_BUCKET_INIT_NUM;
+    }
+
+    Node = prvFind(Trie, TopicFilter, true);
+    if(!Node)
+    {
+        return D_MQC_RET_NO_MEMORY;
+    }
+    if(!Node->Subscribed)
+    {
+        Node->Subscribed = true;
+        Trie->FilterNum++;
+    }
+    Node->Handler = *Handler;
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Remove a Topic Filter
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           TopicFilter             Topic Filter
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_NOTIFY
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_remove(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* TopicFilter)
+{
+    S_MQC_TOPIC_NODE*   Node    =   NULL;
+
+    if( !Trie->FilterNum || !TopicFilter->Data || !TopicFilter->Length )
+    {
+        return D_MQC_RET_NO_NOTIFY;
+    }
+    Node = prvFind(Trie, TopicFilter, false);
+    if( !Node || !Node->Subscribed )
+    {
+        return D_MQC_RET_NO_NOTIFY;
+    }
+    Node->Subscribed = false;
+    memset(&(Node->Handler), 0, sizeof(S_MQC_TOPIC_HANDLER));
+    Trie->FilterNum--;
+    prvPrune(Trie, Node);
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Get the handler of a Topic Filter
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           TopicFilter             Topic Filter
+ * @param[out]          Handler                 Handler of the Topic Filter
+ * @retval              D_MQC_RET_OK
+ * @retval              D_MQC_RET_NO_NOTIFY
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern int32_t MQC_TopicTrie_search(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* TopicFilter, S_MQC_TOPIC_HANDLER* Handler)
+{
+    S_MQC_TOPIC_NODE*   Node    =   NULL;
+
+    if( !Trie->FilterNum || !TopicFilter->Data || !TopicFilter->Length )
+    {
+        return D_MQC_RET_NO_NOTIFY;
+    }
+    Node = prvFind(Trie, TopicFilter, false);
+    if( !Node || !Node->Subscribed )
+    {
+        return D_MQC_RET_NO_NOTIFY;
+    }
+    *Handler = Node->Handler;
+    return D_MQC_RET_OK;
+}
+
+/**
+ * @brief               Find the handlers of all Topic Filters which match a topic
+ * @param[in,out]       Trie                    Topic Filter Trie
+ * @param[in]           Topic                   Topic Name of the PUBLISH Message
+ * @param[in]           MatchFuncCB             Callback function called for each matched Topic Filter
+ * @param[in]           UsrData                 User Data used for callback function
+ * @return              Number of the matched Topic Filters
+ * @author              agent@local
+ * @date                2026/10/17
+ * @callgraph
+ * @callergraph
+ */
+extern uint32_t MQC_TopicTrie_match(S_MQC_TOPIC_TRIE* Trie, const S_MQC_UTF8_DATA* Topic,
+                                    void (*MatchFuncCB)(const S_MQC_TOPIC_HANDLER* Handler, void* UsrData), void* UsrData)
+{
+    S_MQC_TRIE_MATCH_CTX    MatchCtx;
+
+    if( !Trie->FilterNum || !Topic->Data || !Topic->Length )
+    {
+        return 0;
+    }
+    MatchCtx.Trie           =   Trie;
+    MatchCtx.MatchFuncCB    =   MatchFuncCB;
+    MatchCtx.UsrData        =   UsrData;
+    MatchCtx.Count          =   0;
+    prvMatch(&MatchCtx, Trie->Root, Topic->Data, Topic->Length);
+    return MatchCtx.Count;
+}
+
+#endif /* MQC_TOPIC_DISPATCH */
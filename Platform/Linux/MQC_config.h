@@ -26,6 +26,22 @@
  * @version     00.00.01 
  *              - 2018/11/30 : zhaozhenge@outlook.com 
  *                  -# New
+ * @version     00.00.02 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add MQC_RECV_BUFFER_KEEP_SIZE
+ *                  -# Add MQC_SEND_BUFFER_KEEP_SIZE
+ *                  -# Add MQC_MSG_QUEUE_HASH_SIZE
+ *                  -# Add MQC_PACKET_ID_MAX
+ *                  -# Add MQC_POOL_MSG_NUM, MQC_POOL_SMALL_SIZE and MQC_POOL_SMALL_NUM
+ *                  -# Add MQC_EVENT_KEEP_NUM
+ *                  -# Add MQC_TOPIC_DISPATCH
+ *                  -# Add MQC_PERSISTENCE
+ *                  -# Add MQC_OFFLINE_BUFFER
+ *                  -# Add MQC_MQTT5
+ *                  -# Add MQC_PAYLOAD_CODEC
+ * @version     00.00.03 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add MQC_DECODE_MAX_SIZE
  */
 
 #ifndef _MQC_CONFIG_H_
@@ -70,6 +86,165 @@
 #define MQC_ntohl(a)                MQC_Wrap_ntohl(a)
 #endif  /* MQC_NET_API */
 
+/**********************************************************//**
+**  @def MQC_RECV_BUFFER_KEEP_SIZE
+**  
+**  The receive buffer of the session is kept and reused for the
+**  following messages while its size (bytes) is not larger than
+**  this value. The buffer grown for a bigger message is released
+**  after the message is processed.
+**
+**  Set it to 0 to release the receive buffer after each message.
+**************************************************************/
+#define MQC_RECV_BUFFER_KEEP_SIZE   (1024)
+
+/**********************************************************//**
+**  @def MQC_SEND_BUFFER_KEEP_SIZE
+**  
+**  The send buffer of the session is kept and reused to encode the
+**  following messages while its size (bytes) is not larger than
+**  this value. The messages waiting for the response are always
+**  encoded into their own buffers.
+**
+**  Set it to 0 to release the send buffer after each message.
+**************************************************************/
+#define MQC_SEND_BUFFER_KEEP_SIZE   (1024)
+
+/**********************************************************//**
+**  @def MQC_MSG_QUEUE_HASH_SIZE
+**  
+**  Maximum number of the index lists which the messages waiting
+**  for the response are hashed into by their Packet Identifier.
+**  The session handle keeps 16 lists (or this value if smaller).
+**  MQC_Open allocates MaxInflight lists (rounded up to a power of
+**  2, this value if MaxInflight is 0 or larger) by MallocFunc,
+**  two pointers per list, and they are freed by MQC_Stop.
+**
+**  Must be a power of 2.
+**************************************************************/
+#define MQC_MSG_QUEUE_HASH_SIZE     (4096)
+
+/**********************************************************//**
+**  @def MQC_PACKET_ID_MAX
+**  
+**  Maximum Packet Identifier used by the client (1~65535). The
+**  identifiers in use are kept in a bitmap of (MQC_PACKET_ID_MAX/8)
+**  bytes in the session handle, and it is also the maximum number
+**  of the client's own Messages waiting for the response.
+**************************************************************/
+#define MQC_PACKET_ID_MAX           (65535)
+
+/**********************************************************//**
+**  @def MQC_POOL_MSG_NUM
+**  
+**  Number of the message contexts kept in the fixed size pool of
+**  the session. The messages waiting for the response take their
+**  contexts from the pool first, and use MallocFunc only when the
+**  pool is used up. The pool is allocated by MQC_Start at once.
+**
+**  Set it and MQC_POOL_SMALL_NUM to 0 to use MallocFunc only.
+**************************************************************/
+#define MQC_POOL_MSG_NUM            (64)
+
+/**********************************************************//**
+**  @def MQC_POOL_SMALL_SIZE
+**  
+**  Block size (bytes) of the small buffers in the pool, used for
+**  the acknowledge messages waiting for the response (PUBREC,
+**  PUBREL), the return codes of SUBACK and the small QoS1/QoS2
+**  PUBLISH messages.
+**************************************************************/
+#define MQC_POOL_SMALL_SIZE         (64)
+
+/**********************************************************//**
+**  @def MQC_POOL_SMALL_NUM
+**  
+**  Number of the small buffers in the pool.
+**************************************************************/
+#define MQC_POOL_SMALL_NUM          (64)
+
+/**********************************************************//**
+**  @def MQC_EVENT_KEEP_NUM
+**  
+**  The callbacks are called after the session is unlocked, the
+**  events found while it is locked wait in the event list of the
+**  session. The list is kept and reused while it can keep not
+**  more than this number of events.
+**
+**  Set it to 0 to release the event list after each call.
+**************************************************************/
+#define MQC_EVENT_KEEP_NUM          (64)
+
+/**********************************************************//**
+**  @def MQC_TOPIC_DISPATCH
+**  
+**  Enable MQC_SubscribeHandler to register a handler for each
+**  Topic Filter. The received PUBLISH Message is delivered to the
+**  handlers of all matched Topic Filters, and to ReadFuncCB only
+**  when no Topic Filter matches.
+**
+**  Comment this macro to remove the topic filter trie
+**************************************************************/
+#define MQC_TOPIC_DISPATCH
+
+/**********************************************************//**
+**  @def MQC_PERSISTENCE
+**  
+**  Enable PersistFunc of the session handler to save the QoS1
+**  and QoS2 Messages in flight into a store, so the session
+**  (CleanSession is false) resumes them after the restart.
+**
+**  Comment this macro to remove the store hooks
+**************************************************************/
+#define MQC_PERSISTENCE
+
+/**********************************************************//**
+**  @def MQC_OFFLINE_BUFFER
+**  
+**  Enable OfflineMaxNum of the session handler to keep the
+**  PUBLISH Messages while the session is not connected. They
+**  are sent in order after CONNACK is received.
+**
+**  Comment this macro to remove the offline buffer
+**************************************************************/
+#define MQC_OFFLINE_BUFFER
+
+/**********************************************************//**
+**  @def MQC_MQTT5
+**  
+**  Enable ProtocolVersion of the session handler to connect
+**  with MQTT 5.0, and the Topic Alias of the PUBLISH Messages.
+**  The session connects with MQTT 3.1.1 unless ProtocolVersion
+**  is set.
+**
+**  Comment this macro to remove the MQTT 5.0 support
+**************************************************************/
+#define MQC_MQTT5
+
+/**********************************************************//**
+**  @def MQC_PAYLOAD_CODEC
+**  
+**  Enable MQC_CodecSet to register a codec for a Topic Filter.
+**  The payload of the PUBLISH Message sent to a matched Topic is
+**  encoded (e.g. compressed) by the codec, and the received one
+**  is decoded before it is notified. The built-in LZ codec is
+**  set by MQC_CodecLz with CLIB_LZ_MODULE_ENABLED.
+**
+**  Comment this macro to remove the codec stage
+**************************************************************/
+#define MQC_PAYLOAD_CODEC
+
+/**********************************************************//**
+**  @def MQC_DECODE_MAX_SIZE
+**  
+**  Default maximum size (bytes) of the decoded payload of a
+**  received PUBLISH Message, used when DecodeMaxSize of the
+**  session handler is 0 and no Maximum Packet Size is set.
+**  A Message which the codec tells larger is discarded before
+**  the decode buffer grows for it.
+**************************************************************/
+#define MQC_DECODE_MAX_SIZE         (65536)
+
 /**
  * @}
  */
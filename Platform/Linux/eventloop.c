@@ -0,0 +1,792 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     eventloop.c
+ * @brief       Event Loop of many MQTT Sessions for Linux Platform
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Queue the sessions added or removed by the callback functions of another worker thread
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     /* eventfd(), timerfd_create() */
+#endif
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "wrapper.h"
+#include "eventloop.h"
+
+/**************************************************************
+**  Global Param
+**************************************************************/
+
+static __thread S_EVENT_WORKER*     s_SelfWorker    =   NULL;   /*!< Worker thread of the caller (NULL for the other threads) */
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Check if the caller is the worker thread
+ * @param[in]           Worker              Worker thread
+ * @retval              true                Called in the worker thread
+ * @retval              false               Called in the other thread
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static bool prvInWorker(S_EVENT_WORKER* Worker)
+{
+    return pthread_equal(pthread_self(), Worker->Thread) ? true : false;
+}
+
+/**
+ * @brief               Check if the caller is another worker thread
+ * @param[in]           Worker              Worker thread
+ * @retval              true                Called in a worker thread which is not Worker
+ * @retval              false               Called in Worker or in a thread which is not a worker thread
+ * @note                Such a caller may hold the mutex of its own worker, so it must not wait for Worker,
+ *                      whose callback functions may be waiting for the caller's worker at the same time.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static bool prvInOtherWorker(S_EVENT_WORKER* Worker)
+{
+    return ( s_SelfWorker && (s_SelfWorker != Worker) ) ? true : false;
+}
+
+/**
+ * @brief               Take a session out of a queue of the worker thread
+ * @param[in,out]       Head                Head of the queue
+ * @param[in,out]       Session             Session to take out
+ * @retval              true                The session was in the queue
+ * @retval              false               The session was not in the queue
+ * @note                Called with QueueMutex of the worker locked
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static bool prvDequeue(S_EVENT_SESSION** Head, S_EVENT_SESSION* Session)
+{
+    S_EVENT_SESSION**   Link    =   Head;
+
+    while(*Link)
+    {
+        if(*Link == Session)
+        {
+            *Link = Session->QueueNext;
+            Session->QueueNext = NULL;
+            return true;
+        }
+        Link = &((*Link)->QueueNext);
+    }
+    return false;
+}
+
+/**
+ * @brief               Detach a session from the worker thread
+ * @param[in,out]       Worker              Worker thread
+ * @param[in,out]       Session             Session to detach
+ * @retval              true                A removal requested by another worker thread was waiting
+ * @retval              false               No removal requested by another worker thread was waiting
+ * @note                A removal still waiting in the queue is dropped, so the session is not used after it is closed
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static bool prvDetach(S_EVENT_WORKER* Worker, S_EVENT_SESSION* Session)
+{
+    bool    Async   =   false;
+
+    pthread_mutex_lock(&(Worker->QueueMutex));
+    if(prvDequeue(&(Worker->RemoveHead), Session))
+    {
+        Async = Session->RemoveAsync;
+    }
+    Session->RemoveAsync = false;
+    Session->Worker = NULL;
+    pthread_mutex_unlock(&(Worker->QueueMutex));
+    return Async;
+}
+
+/**
+ * @brief               Wake up the worker thread waiting in epoll_wait()
+ * @param[in]           Worker              Worker thread
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvWake(S_EVENT_WORKER* Worker)
+{
+    uint64_t    Value   =   1;
+
+    if(sizeof(Value) != write(Worker->WakeFd, &Value, sizeof(Value)))
+    {
+        D_MQC_PRINT( " failed\n  ! write() eventfd errno %d\n\n", errno );
+    }
+    return;
+}
+
+/**
+ * @brief               Remove a session from the worker thread
+ * @param[in,out]       Worker              Worker thread
+ * @param[in,out]       Session             Session to remove
+ * @retval              true                A removal requested by another worker thread was waiting
+ * @retval              false               No removal requested by another worker thread was waiting
+ * @note                Called in the worker thread, or with the mutex of the worker locked. \n
+ *                      The events of the session not handled yet are dropped.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static bool prvUnlink(S_EVENT_WORKER* Worker, S_EVENT_SESSION* Session)
+{
+    int     i   =   0;
+
+    (void)epoll_ctl(Worker->EpollFd, EPOLL_CTL_DEL, Session->SocketFd, NULL);
+
+    if(Session->Prev)
+    {
+        Session->Prev->Next = Session->Next;
+    }
+    else
+    {
+        Worker->Head = Session->Next;
+    }
+    if(Session->Next)
+    {
+        Session->Next->Prev = Session->Prev;
+    }
+    Worker->SessionNum--;
+
+    /* Keep the loops of the worker thread going on */
+    if(Worker->Cursor == Session)
+    {
+        Worker->Cursor = Session->Next;
+    }
+    if(Worker->Current == Session)
+    {
+        Worker->Current = NULL;
+    }
+    for(i = 0; i < Worker->EventNum; i++)
+    {
+        if(Worker->Events[i].data.ptr == Session)
+        {
+            Worker->Events[i].data.ptr = NULL;
+        }
+    }
+
+    Session->Prev = NULL;
+    Session->Next = NULL;
+    return prvDetach(Worker, Session);
+}
+
+/**
+ * @brief               Add a session to the worker thread
+ * @param[in,out]       Worker              Worker thread
+ * @param[in,out]       Session             Session to add
+ * @retval              0 for successful
+ * @retval              errno of epoll_ctl() for fail
+ * @note                Called in the worker thread, or with the mutex of the worker locked
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvLink(S_EVENT_WORKER* Worker, S_EVENT_SESSION* Session)
+{
+    struct epoll_event  Event;
+    int32_t             Err     =   0;
+
+    memset(&Event, 0, sizeof(Event));
+    Event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    Event.data.ptr = Session;
+    if(epoll_ctl(Worker->EpollFd, EPOLL_CTL_ADD, Session->SocketFd, &Event))
+    {
+        Err = errno;
+        D_MQC_PRINT( " failed\n  ! epoll_ctl() errno %d\n\n", Err );
+        return Err;
+    }
+
+    Session->Prev = NULL;
+    Session->Next = Worker->Head;
+    if(Worker->Head)
+    {
+        Worker->Head->Prev = Session;
+    }
+    Worker->Head = Session;
+    Worker->SessionNum++;
+    return 0;
+}
+
+/**
+ * @brief               Read all data of a session until the socket has no more
+ * @param[in,out]       Worker              Worker thread
+ * @param[in,out]       Session             Session to read
+ * @return              None
+ * @note                The socket is edge-triggered, so it must be read until EAGAIN
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvRead(S_EVENT_WORKER* Worker, S_EVENT_SESSION* Session)
+{
+    E_EVENT_CLOSE_REASON    Reason  =   E_EVENT_CLOSE_PEER;
+    ssize_t                 Size    =   0;
+    int32_t                 Err     =   0;
+
+    Worker->Current = Session;
+    while(1)
+    {
+        Size = recv(Session->SocketFd, Worker->ReadData, D_EVENT_LOOP_READ_SIZE, MSG_DONTWAIT);
+        if(0 < Size)
+        {
+            Err = MQC_Read(Session->Handler, Worker->ReadData, (size_t)Size);
+            if(D_MQC_RET_OK != Err)
+            {
+                Reason = E_EVENT_CLOSE_PROTOCOL;
+                break;
+            }
+            if(Worker->Current != Session)
+            {
+                /* Removed by the callback function */
+                return;
+            }
+            continue;
+        }
+        if(0 == Size)
+        {
+            Reason = E_EVENT_CLOSE_PEER;
+            Err = 0;
+            break;
+        }
+        if(EINTR == errno)
+        {
+            continue;
+        }
+        if( (EAGAIN == errno) || (EWOULDBLOCK == errno) )
+        {
+            Worker->Current = NULL;
+            return;
+        }
+        Reason = E_EVENT_CLOSE_NETWORK;
+        Err = errno;
+        break;
+    }
+
+    /* The connection can not be used any more */
+    if(Worker->Current == Session)
+    {
+        (void)prvUnlink(Worker, Session);
+        if(Session->CloseFuncCB)
+        {
+            Session->CloseFuncCB(Session, Reason, Err);
+        }
+    }
+    Worker->Current = NULL;
+    return;
+}
+
+/**
+ * @brief               Call MQC_Continue of all sessions of the worker thread
+ * @param[in,out]       Worker              Worker thread
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvTick(S_EVENT_WORKER* Worker)
+{
+    S_EVENT_SESSION*    Session     =   NULL;
+    uint64_t            Expired     =   0;
+    uint32_t            Now         =   systick_wrapper();
+
+    if(sizeof(Expired) != read(Worker->TimerFd, &Expired, sizeof(Expired)))
+    {
+        return;
+    }
+    Worker->Cursor = Worker->Head;
+    while(Worker->Cursor)
+    {
+        Session = Worker->Cursor;
+        Worker->Cursor = Session->Next;
+        MQC_Continue(Session->Handler, Now);
+    }
+    return;
+}
+
+/**
+ * @brief               Add the sessions queued by the other worker threads
+ * @param[in,out]       Worker              Worker thread
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvAddPending(S_EVENT_WORKER* Worker)
+{
+    S_EVENT_SESSION*    Session     =   NULL;
+    int32_t             Err         =   0;
+
+    while(1)
+    {
+        pthread_mutex_lock(&(Worker->QueueMutex));
+        Session = Worker->AddHead;
+        if(Session)
+        {
+            Worker->AddHead = Session->QueueNext;
+            Session->QueueNext = NULL;
+        }
+        pthread_mutex_unlock(&(Worker->QueueMutex));
+        if(!Session)
+        {
+            break;
+        }
+
+        Err = prvLink(Worker, Session);
+        if(Err)
+        {
+            (void)prvDetach(Worker, Session);
+            /* A thread may be waiting for its removal */
+            pthread_cond_broadcast(&(Worker->Cond));
+            if(Session->CloseFuncCB)
+            {
+                Session->CloseFuncCB(Session, E_EVENT_CLOSE_NETWORK, Err);
+            }
+        }
+    }
+    return;
+}
+
+/**
+ * @brief               Remove the sessions requested by the other threads
+ * @param[in,out]       Worker              Worker thread
+ * @return              None
+ * @note                The threads waiting for the removal are signaled, and the removal requested by the other
+ *                      worker threads is reported by CloseFuncCB.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvRemovePending(S_EVENT_WORKER* Worker)
+{
+    S_EVENT_SESSION*    Session     =   NULL;
+    bool                Async       =   false;
+    bool                Removed     =   false;
+
+    while(1)
+    {
+        pthread_mutex_lock(&(Worker->QueueMutex));
+        Session = Worker->RemoveHead;
+        if(Session)
+        {
+            Worker->RemoveHead = Session->QueueNext;
+            Session->QueueNext = NULL;
+            Async = Session->RemoveAsync;
+        }
+        pthread_mutex_unlock(&(Worker->QueueMutex));
+        if(!Session)
+        {
+            break;
+        }
+
+        (void)prvUnlink(Worker, Session);
+        Removed = true;
+        if( Async && Session->CloseFuncCB )
+        {
+            Session->CloseFuncCB(Session, E_EVENT_CLOSE_REMOVED, 0);
+        }
+    }
+    if(Removed)
+    {
+        pthread_cond_broadcast(&(Worker->Cond));
+    }
+    return;
+}
+
+/**
+ * @brief               Main function of the worker thread
+ * @param[in,out]       Arg                 Worker thread
+ * @return              NULL
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void* prvWorkerMain(void* Arg)
+{
+    S_EVENT_WORKER*     Worker  =   (S_EVENT_WORKER*)Arg;
+    struct epoll_event  Events[D_EVENT_LOOP_EVENT_NUM];
+    uint64_t            Value   =   0;
+    void*               Data    =   NULL;
+    int                 Num     =   0;
+    int                 i       =   0;
+
+    s_SelfWorker = Worker;
+    while(1)
+    {
+        Num = epoll_wait(Worker->EpollFd, Events, D_EVENT_LOOP_EVENT_NUM, -1);
+        if( (0 > Num) && (EINTR != errno) )
+        {
+            D_MQC_PRINT( " failed\n  ! epoll_wait() errno %d\n\n", errno );
+            break;
+        }
+
+        pthread_mutex_lock(&(Worker->Mutex));
+        Worker->Events = Events;
+        Worker->EventNum = (0 < Num)?(Num):(0);
+        prvAddPending(Worker);
+        /* The events of the removed sessions are dropped here */
+        prvRemovePending(Worker);
+        if(!Worker->Running)
+        {
+            pthread_mutex_unlock(&(Worker->Mutex));
+            break;
+        }
+        for(i = 0; i < Worker->EventNum; i++)
+        {
+            Data = Events[i].data.ptr;
+            if(!Data)
+            {
+                continue;
+            }
+            else if(Data == &(Worker->WakeFd))
+            {
+                (void)read(Worker->WakeFd, &Value, sizeof(Value));
+            }
+            else if(Data == &(Worker->TimerFd))
+            {
+                prvTick(Worker);
+            }
+            else
+            {
+                prvRead(Worker, (S_EVENT_SESSION*)Data);
+            }
+        }
+        Worker->EventNum = 0;
+        Worker->Events = NULL;
+        pthread_mutex_unlock(&(Worker->Mutex));
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief               Release the resources of a worker thread
+ * @param[in,out]       Worker              Worker thread
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvWorkerDelete(S_EVENT_WORKER* Worker)
+{
+    if(0 <= Worker->EpollFd)
+    {
+        close(Worker->EpollFd);
+    }
+    if(0 <= Worker->TimerFd)
+    {
+        close(Worker->TimerFd);
+    }
+    if(0 <= Worker->WakeFd)
+    {
+        close(Worker->WakeFd);
+    }
+    if(Worker->ReadData)
+    {
+        free_wrapper(Worker->ReadData);
+    }
+    pthread_mutex_destroy(&(Worker->QueueMutex));
+    pthread_cond_destroy(&(Worker->Cond));
+    pthread_mutex_destroy(&(Worker->Mutex));
+    memset(Worker, 0, sizeof(S_EVENT_WORKER));
+    return;
+}
+
+/**
+ * @brief               Create a worker thread
+ * @param[in,out]       Worker              Worker thread
+ * @param[in]           TickInterval        Interval with millisecond to call MQC_Continue of the sessions
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvWorkerCreate(S_EVENT_WORKER* Worker, uint32_t TickInterval)
+{
+    struct epoll_event  Event;
+    struct itimerspec   Timer;
+
+    memset(Worker, 0, sizeof(S_EVENT_WORKER));
+    pthread_mutex_init(&(Worker->Mutex), NULL);
+    pthread_cond_init(&(Worker->Cond), NULL);
+    pthread_mutex_init(&(Worker->QueueMutex), NULL);
+    Worker->EpollFd = epoll_create1(EPOLL_CLOEXEC);
+    Worker->TimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    Worker->WakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    Worker->ReadData = (uint8_t*)malloc_wrapper(D_EVENT_LOOP_READ_SIZE);
+    if( (0 > Worker->EpollFd) || (0 > Worker->TimerFd) || (0 > Worker->WakeFd) || !Worker->ReadData )
+    {
+        D_MQC_PRINT( " failed\n  ! event loop worker create errno %d\n\n", errno );
+        prvWorkerDelete(Worker);
+        return (-1);
+    }
+
+    /* Timer of MQC_Continue */
+    memset(&Timer, 0, sizeof(Timer));
+    Timer.it_interval.tv_sec = TickInterval / 1000;
+    Timer.it_interval.tv_nsec = (long)(TickInterval % 1000) * 1000000L;
+    Timer.it_value = Timer.it_interval;
+    memset(&Event, 0, sizeof(Event));
+    Event.events = EPOLLIN;
+    Event.data.ptr = &(Worker->TimerFd);
+    if( timerfd_settime(Worker->TimerFd, 0, &Timer, NULL) || epoll_ctl(Worker->EpollFd, EPOLL_CTL_ADD, Worker->TimerFd, &Event) )
+    {
+        D_MQC_PRINT( " failed\n  ! event loop timer errno %d\n\n", errno );
+        prvWorkerDelete(Worker);
+        return (-1);
+    }
+    Event.data.ptr = &(Worker->WakeFd);
+    if(epoll_ctl(Worker->EpollFd, EPOLL_CTL_ADD, Worker->WakeFd, &Event))
+    {
+        D_MQC_PRINT( " failed\n  ! event loop wake errno %d\n\n", errno );
+        prvWorkerDelete(Worker);
+        return (-1);
+    }
+
+    Worker->Running = true;
+    if(pthread_create(&(Worker->Thread), NULL, prvWorkerMain, Worker))
+    {
+        D_MQC_PRINT( " failed\n  ! pthread_create() failed\n\n" );
+        prvWorkerDelete(Worker);
+        return (-1);
+    }
+    return 0;
+}
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Start the worker threads of an event loop
+ * @param[in,out]       Loop                Event Loop
+ * @param[in]           WorkerNum           Number of the worker threads
+ * @param[in]           TickInterval        Interval with millisecond to call MQC_Continue of the sessions
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t eventloop_start(S_EVENT_LOOP* Loop, uint32_t WorkerNum, uint32_t TickInterval)
+{
+    uint32_t    i   =   0;
+
+    if( !WorkerNum || (WorkerNum > D_EVENT_LOOP_WORKER_MAX) || !TickInterval )
+    {
+        return (-1);
+    }
+    memset(Loop, 0, sizeof(S_EVENT_LOOP));
+    Loop->Worker = (S_EVENT_WORKER*)malloc_wrapper(sizeof(S_EVENT_WORKER) * WorkerNum);
+    if(!Loop->Worker)
+    {
+        return (-1);
+    }
+    pthread_mutex_init(&(Loop->Mutex), NULL);
+    for(i = 0; i < WorkerNum; i++)
+    {
+        if(prvWorkerCreate(&(Loop->Worker[i]), TickInterval))
+        {
+            eventloop_stop(Loop);
+            return (-1);
+        }
+        Loop->WorkerNum++;
+    }
+    return 0;
+}
+
+/**
+ * @brief               Stop the worker threads of an event loop
+ * @param[in,out]       Loop                Event Loop
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern void eventloop_stop(S_EVENT_LOOP* Loop)
+{
+    S_EVENT_WORKER* Worker  =   NULL;
+    uint32_t        i       =   0;
+
+    for(i = 0; i < Loop->WorkerNum; i++)
+    {
+        Worker = &(Loop->Worker[i]);
+        pthread_mutex_lock(&(Worker->Mutex));
+        Worker->Running = false;
+        pthread_mutex_unlock(&(Worker->Mutex));
+        prvWake(Worker);
+        pthread_join(Worker->Thread, NULL);
+        prvWorkerDelete(Worker);
+    }
+    if(Loop->Worker)
+    {
+        free_wrapper(Loop->Worker);
+        pthread_mutex_destroy(&(Loop->Mutex));
+    }
+    memset(Loop, 0, sizeof(S_EVENT_LOOP));
+    return;
+}
+
+/**
+ * @brief               Add a session to an event loop
+ * @param[in,out]       Loop                Event Loop
+ * @param[in,out]       Session             Session to add (kept by the loop until removed)
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t eventloop_add(S_EVENT_LOOP* Loop, S_EVENT_SESSION* Session)
+{
+    S_EVENT_WORKER*     Worker  =   NULL;
+    bool                Locked  =   false;
+    int32_t             Err     =   0;
+
+    if( !Loop->WorkerNum || !Session->Handler || (0 > Session->SocketFd) || Session->Worker )
+    {
+        return (-1);
+    }
+
+    /* Pin the session to one worker thread */
+    pthread_mutex_lock(&(Loop->Mutex));
+    Worker = &(Loop->Worker[Loop->NextWorker]);
+    Loop->NextWorker = (Loop->NextWorker + 1) % Loop->WorkerNum;
+    pthread_mutex_unlock(&(Loop->Mutex));
+
+    Session->Prev = NULL;
+    Session->Next = NULL;
+    Session->QueueNext = NULL;
+    Session->RemoveAsync = false;
+
+    if(prvInOtherWorker(Worker))
+    {
+        /* The worker thread adds it, because the caller can not wait for the worker thread */
+        pthread_mutex_lock(&(Worker->QueueMutex));
+        Session->Worker = Worker;
+        Session->QueueNext = Worker->AddHead;
+        Worker->AddHead = Session;
+        pthread_mutex_unlock(&(Worker->QueueMutex));
+        prvWake(Worker);
+        return 0;
+    }
+
+    Locked = !prvInWorker(Worker);
+    if(Locked)
+    {
+        pthread_mutex_lock(&(Worker->Mutex));
+    }
+
+    Err = prvLink(Worker, Session);
+    if(!Err)
+    {
+        pthread_mutex_lock(&(Worker->QueueMutex));
+        Session->Worker = Worker;
+        pthread_mutex_unlock(&(Worker->QueueMutex));
+    }
+
+    if(Locked)
+    {
+        pthread_mutex_unlock(&(Worker->Mutex));
+    }
+    return (Err)?(-1):(0);
+}
+
+/**
+ * @brief               Remove a session from its event loop
+ * @param[in,out]       Session             Session to remove
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern void eventloop_remove(S_EVENT_SESSION* Session)
+{
+    S_EVENT_WORKER*     Worker  =   Session->Worker;
+    bool                Locked  =   false;
+    bool                Added   =   true;
+
+    if(!Worker)
+    {
+        return;
+    }
+
+    if(prvInWorker(Worker))
+    {
+        pthread_mutex_lock(&(Worker->QueueMutex));
+        if(prvDequeue(&(Worker->AddHead), Session))
+        {
+            /* Queued by another worker thread and not added yet */
+            Session->Worker = NULL;
+            Added = false;
+        }
+        pthread_mutex_unlock(&(Worker->QueueMutex));
+        if( Added && prvUnlink(Worker, Session) && Session->CloseFuncCB )
+        {
+            Session->CloseFuncCB(Session, E_EVENT_CLOSE_REMOVED, 0);
+        }
+        return;
+    }
+
+    /* The worker thread removes it, because it may have got the events of the session */
+    Locked = !prvInOtherWorker(Worker);
+    if(Locked)
+    {
+        pthread_mutex_lock(&(Worker->Mutex));
+    }
+    pthread_mutex_lock(&(Worker->QueueMutex));
+    if(Session->Worker == Worker)
+    {
+        if(prvDequeue(&(Worker->AddHead), Session))
+        {
+            /* Not added yet, so the worker thread has never used it */
+            Session->Worker = NULL;
+        }
+        else
+        {
+            (void)prvDequeue(&(Worker->RemoveHead), Session);
+            Session->RemoveAsync = Session->RemoveAsync || !Locked;
+            Session->QueueNext = Worker->RemoveHead;
+            Worker->RemoveHead = Session;
+            prvWake(Worker);
+        }
+    }
+    pthread_mutex_unlock(&(Worker->QueueMutex));
+
+    if(Locked)
+    {
+        while(Session->Worker)
+        {
+            pthread_cond_wait(&(Worker->Cond), &(Worker->Mutex));
+        }
+        pthread_mutex_unlock(&(Worker->Mutex));
+    }
+    return;
+}
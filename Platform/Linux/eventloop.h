@@ -0,0 +1,210 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     eventloop.h
+ * @brief       Event Loop of many MQTT Sessions for Linux Platform Header
+ * @details     Each worker thread waits the sockets of its sessions by one epoll instance (edge-triggered),
+ *              feeds the received data to MQC_Read and calls MQC_Continue of all its sessions by one timer.
+ *              A session is kept by the same worker thread until it is removed, so one thread serves
+ *              thousands of sessions instead of one thread for each session.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Queue the sessions added or removed by the callback functions of another worker thread
+ */
+
+#ifndef __EVENTLOOP_H__
+#define __EVENTLOOP_H__
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include "MQC_api.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_EVENT_LOOP_WORKER_MAX     (64)        /*!< Max number of the worker threads */
+#define D_EVENT_LOOP_EVENT_NUM      (256)       /*!< Max number of the events got by one epoll_wait() */
+#define D_EVENT_LOOP_READ_SIZE      (16384)     /*!< Size of the buffer to read the socket */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Reason of the session removed by the event loop
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef enum _E_EVENT_CLOSE_REASON
+{
+    E_EVENT_CLOSE_PEER      =   0,          /*!< The connection is closed by the server */
+    E_EVENT_CLOSE_NETWORK,                  /*!< recv() failed */
+    E_EVENT_CLOSE_PROTOCOL,                 /*!< MQC_Read() failed */
+    E_EVENT_CLOSE_REMOVED,                  /*!< Removed by eventloop_remove called in another worker thread */
+}E_EVENT_CLOSE_REASON;
+
+/**
+ * @brief      MQTT Session served by the event loop
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_EVENT_SESSION
+{
+    S_MQC_SESSION_HANDLE*       Handler;
+    /*!< MQTT client handler (started by MQC_Start before added) */
+
+    int                         SocketFd;
+    /*!< Socket connected to the server */
+
+    void                        (*CloseFuncCB)(struct _S_EVENT_SESSION* Session, E_EVENT_CLOSE_REASON Reason, int32_t Err);
+    /*!< Callback function called in the worker thread after the session is removed because of the connection,
+         or after the removal requested by another worker thread is done. \n
+         Err is errno for E_EVENT_CLOSE_NETWORK and the return value of MQC_Read for E_EVENT_CLOSE_PROTOCOL */
+
+    void*                       UsrCtx;
+    /*!< User Data */
+
+    struct _S_EVENT_WORKER*     Worker;
+    /*!< Worker thread which serves the session (User not use) */
+
+    struct _S_EVENT_SESSION*    Prev;
+    /*!< Previous session of the worker thread (User not use) */
+
+    struct _S_EVENT_SESSION*    Next;
+    /*!< Next session of the worker thread (User not use) */
+
+    struct _S_EVENT_SESSION*    QueueNext;
+    /*!< Next session waiting to be added or removed by the worker thread (User not use) */
+
+    bool                        RemoveAsync;
+    /*!< The removal is requested by another worker thread and reported by CloseFuncCB (User not use) */
+}S_EVENT_SESSION;
+
+/**
+ * @brief      Worker thread of the event loop
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_EVENT_WORKER
+{
+    pthread_t               Thread;             /*!< Worker thread */
+    pthread_mutex_t         Mutex;              /*!< Locked while the worker thread handles the events */
+    pthread_cond_t          Cond;               /*!< Signaled when the sessions waiting to be removed are removed */
+    pthread_mutex_t         QueueMutex;         /*!< Lock of AddHead, RemoveHead and Worker of the sessions (never held while waiting) */
+    int                     EpollFd;            /*!< epoll instance */
+    int                     TimerFd;            /*!< Timer to call MQC_Continue */
+    int                     WakeFd;             /*!< eventfd to wake up the worker thread */
+    bool                    Running;            /*!< The worker thread keeps running */
+    S_EVENT_SESSION*        Head;               /*!< Sessions served by the worker thread */
+    uint32_t                SessionNum;         /*!< Number of the sessions */
+    S_EVENT_SESSION*        AddHead;            /*!< Sessions waiting to be added by the worker thread */
+    S_EVENT_SESSION*        RemoveHead;         /*!< Sessions waiting to be removed by the worker thread */
+    S_EVENT_SESSION*        Current;            /*!< Session which is being read (NULL after it is removed) */
+    S_EVENT_SESSION*        Cursor;             /*!< Next session to call MQC_Continue */
+    struct epoll_event*     Events;             /*!< Events got by the last epoll_wait() */
+    int                     EventNum;           /*!< Number of the events */
+    uint8_t*                ReadData;           /*!< Buffer to read the socket */
+}S_EVENT_WORKER;
+
+/**
+ * @brief      Event Loop
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_EVENT_LOOP
+{
+    S_EVENT_WORKER*         Worker;             /*!< Worker threads */
+    uint32_t                WorkerNum;          /*!< Number of the worker threads */
+    uint32_t                NextWorker;         /*!< Worker thread of the next session */
+    pthread_mutex_t         Mutex;              /*!< Lock of NextWorker */
+}S_EVENT_LOOP;
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Start the worker threads of an event loop
+ * @param[in,out]       Loop                Event Loop
+ * @param[in]           WorkerNum           Number of the worker threads
+ * @param[in]           TickInterval        Interval with millisecond to call MQC_Continue of the sessions
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t eventloop_start(S_EVENT_LOOP* Loop, uint32_t WorkerNum, uint32_t TickInterval);
+
+/**
+ * @brief               Stop the worker threads of an event loop
+ * @param[in,out]       Loop                Event Loop
+ * @return              None
+ * @note                The sessions still in the loop are not closed, they can not be used with the loop any more
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern void eventloop_stop(S_EVENT_LOOP* Loop);
+
+/**
+ * @brief               Add a session to an event loop
+ * @param[in,out]       Loop                Event Loop
+ * @param[in,out]       Session             Session to add (kept by the loop until removed)
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @note                The worker threads are chosen in turn. The socket is read by recv() with MSG_DONTWAIT,
+ *                      so it can be kept blocking for WriteFuncCB. \n
+ *                      In the callback functions called by a worker thread, a session given to another worker thread
+ *                      is queued without waiting for it. It is added when that worker thread wakes up, and if
+ *                      epoll_ctl() fails then, CloseFuncCB is called with E_EVENT_CLOSE_NETWORK.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t eventloop_add(S_EVENT_LOOP* Loop, S_EVENT_SESSION* Session);
+
+/**
+ * @brief               Remove a session from its event loop
+ * @param[in,out]       Session             Session to remove
+ * @return              None
+ * @note                It can be called in any thread, including the callback functions called by the worker threads. \n
+ *                      In the worker thread of the session or in a thread which is not a worker thread, the worker
+ *                      thread does not use the session after this function returns. \n
+ *                      In the callback functions called by another worker thread, it does not wait for the worker
+ *                      thread of the session (which may be waiting for the caller's). The session is removed when that
+ *                      worker thread wakes up, and it can be released after CloseFuncCB is called with
+ *                      E_EVENT_CLOSE_REMOVED (or with another reason if the connection is closed before).
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern void eventloop_remove(S_EVENT_SESSION* Session);
+
+#endif /* __EVENTLOOP_H__ */
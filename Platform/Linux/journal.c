@@ -0,0 +1,832 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     journal.c
+ * @brief       Journal of the Messages in flight for Linux Platform
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     /* ftruncate(), O_DIRECTORY */
+#endif
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "wrapper.h"
+#include "journal.h"
+
+#if defined (MQC_PERSISTENCE)
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_JOURNAL_MAGIC             (0x4A43514D)    /*!< "MQCJ" */
+#define D_JOURNAL_VERSION           (1)             /*!< Version of the file format */
+#define D_JOURNAL_OP_ADD            (1)             /*!< Record of a Message saved */
+#define D_JOURNAL_OP_DEL            (2)             /*!< Record of a Message deleted */
+#define D_JOURNAL_INDEX_MIN         (64)            /*!< Initial number of the entries of the hash table */
+#define D_JOURNAL_SEQUENCE_MAX      (0x7FFFFFFF)    /*!< The file is rewritten when the sequence number reaches it */
+
+#define D_JOURNAL_ALIGN(x)          ( ((x) + 7) & ~((size_t)7) )
+#define D_JOURNAL_KEY(t, i)         ( ((uint32_t)(t) << 16) | (uint32_t)(i) )
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Header at the beginning of the journal file
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_JOURNAL_HEADER
+{
+    uint32_t                Magic;              /*!< D_JOURNAL_MAGIC */
+    uint32_t                Version;            /*!< D_JOURNAL_VERSION */
+    uint32_t                Sequence;           /*!< Sequence number of the first record */
+    uint32_t                Reserved;           /*!< Reserved (0) */
+}S_JOURNAL_HEADER;
+
+/**
+ * @brief      Record of the journal file (followed by the data aligned to 8 bytes)
+ * @note       The records are numbered one by one, so the stale records left after the last record
+ *             (by the clear or a broken write) are never taken as the next record.
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_JOURNAL_RECORD
+{
+    uint32_t                Length;             /*!< Size of the data */
+    uint8_t                 Op;                 /*!< D_JOURNAL_OP_ADD or D_JOURNAL_OP_DEL */
+    uint8_t                 Type;               /*!< Message Type */
+    uint16_t                PacketIdentifier;   /*!< Packet Identifier */
+    uint32_t                Sequence;           /*!< Sequence number */
+    uint32_t                Checksum;           /*!< FNV-1a of the fields above and the data */
+}S_JOURNAL_RECORD;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Calculate the checksum of a record
+ * @param[in]           Record              Record
+ * @param[in]           Data                Data of the record
+ * @return              Checksum
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static uint32_t prvChecksum(const S_JOURNAL_RECORD* Record, const uint8_t* Data)
+{
+    const uint8_t*  Field   =   (const uint8_t*)Record;
+    uint32_t        Hash    =   2166136261u;
+    size_t          i       =   0;
+
+    for(i = 0; i < offsetof(S_JOURNAL_RECORD, Checksum); i++)
+    {
+        Hash = (Hash ^ Field[i]) * 16777619u;
+    }
+    for(i = 0; i < Record->Length; i++)
+    {
+        Hash = (Hash ^ Data[i]) * 16777619u;
+    }
+    return Hash;
+}
+
+/**
+ * @brief               Get the size of a record in the file
+ * @param[in]           Length              Size of the data
+ * @return              Size of the record
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static size_t prvRecordSize(size_t Length)
+{
+    return sizeof(S_JOURNAL_RECORD) + D_JOURNAL_ALIGN(Length);
+}
+
+/**
+ * @brief               Find the entry of a Message in the hash table
+ * @param[in]           Journal             Journal
+ * @param[in]           Key                 Message type and Packet Identifier
+ * @return              Entry (NULL if the Message is not live)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static S_JOURNAL_INDEX* prvIndexFind(S_JOURNAL* Journal, uint32_t Key)
+{
+    uint32_t    Mask    =   Journal->IndexSize - 1;
+    uint32_t    Pos     =   0;
+
+    if(!Journal->IndexSize)
+    {
+        return NULL;
+    }
+    for(Pos = (Key * 2654435761u) & Mask; Journal->Index[Pos].Key; Pos = (Pos + 1) & Mask)
+    {
+        if(Key == Journal->Index[Pos].Key)
+        {
+            return &(Journal->Index[Pos]);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief               Make room in the hash table for one more Message
+ * @param[in,out]       Journal             Journal
+ * @retval              0 for successful
+ * @retval              -1 for no memory
+ * @note                The table is doubled when it is half full
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvIndexReserve(S_JOURNAL* Journal)
+{
+    S_JOURNAL_INDEX*    Old     =   Journal->Index;
+    uint32_t            OldSize =   Journal->IndexSize;
+    uint32_t            Size    =   (OldSize)?(OldSize * 2):(D_JOURNAL_INDEX_MIN);
+    uint32_t            Pos     =   0;
+    uint32_t            i       =   0;
+
+    if( (Journal->IndexNum + 1) * 2 <= OldSize )
+    {
+        return 0;
+    }
+    Journal->Index = calloc(Size, sizeof(S_JOURNAL_INDEX));
+    if(!Journal->Index)
+    {
+        Journal->Index = Old;
+        return (-1);
+    }
+    Journal->IndexSize = Size;
+    for(i = 0; i < OldSize; i++)
+    {
+        if(Old[i].Key)
+        {
+            for(Pos = (Old[i].Key * 2654435761u) & (Size - 1); Journal->Index[Pos].Key; Pos = (Pos + 1) & (Size - 1));
+            Journal->Index[Pos] = Old[i];
+        }
+    }
+    free(Old);
+    return 0;
+}
+
+/**
+ * @brief               Set the last record of a Message
+ * @param[in,out]       Journal             Journal
+ * @param[in]           Key                 Message type and Packet Identifier
+ * @param[in]           Offset              Offset of the record
+ * @return              None
+ * @note                prvIndexReserve must be called before
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvIndexPut(S_JOURNAL* Journal, uint32_t Key, uint32_t Offset)
+{
+    uint32_t    Mask    =   Journal->IndexSize - 1;
+    uint32_t    Pos     =   0;
+
+    for(Pos = (Key * 2654435761u) & Mask; Journal->Index[Pos].Key; Pos = (Pos + 1) & Mask)
+    {
+        if(Key == Journal->Index[Pos].Key)
+        {
+            Journal->Index[Pos].Offset = Offset;
+            return;
+        }
+    }
+    Journal->Index[Pos].Key     =   Key;
+    Journal->Index[Pos].Offset  =   Offset;
+    Journal->IndexNum++;
+    return;
+}
+
+/**
+ * @brief               Remove an entry from the hash table
+ * @param[in,out]       Journal             Journal
+ * @param[in,out]       Entry               Entry got by prvIndexFind
+ * @return              None
+ * @note                The entries after it are shifted back, so no deleted mark is left in the table
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvIndexRemove(S_JOURNAL* Journal, S_JOURNAL_INDEX* Entry)
+{
+    uint32_t    Mask    =   Journal->IndexSize - 1;
+    uint32_t    Hole    =   (uint32_t)(Entry - Journal->Index);
+    uint32_t    Pos     =   Hole;
+    uint32_t    Home    =   0;
+
+    for(Pos = (Pos + 1) & Mask; Journal->Index[Pos].Key; Pos = (Pos + 1) & Mask)
+    {
+        Home = (Journal->Index[Pos].Key * 2654435761u) & Mask;
+        /* Move the entry if its home is not between the hole and it */
+        if( ((Pos - Home) & Mask) >= ((Pos - Hole) & Mask) )
+        {
+            Journal->Index[Hole] = Journal->Index[Pos];
+            Hole = Pos;
+        }
+    }
+    Journal->Index[Hole].Key = 0;
+    Journal->IndexNum--;
+    return;
+}
+
+/**
+ * @brief               Get the valid record at an offset
+ * @param[in]           Journal             Journal
+ * @param[in]           Offset              Offset of the record
+ * @param[in]           Sequence            Expected sequence number
+ * @return              Record (NULL if it is the end of the records)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static S_JOURNAL_RECORD* prvRecordGet(S_JOURNAL* Journal, size_t Offset, uint32_t Sequence)
+{
+    S_JOURNAL_RECORD*   Record  =   (S_JOURNAL_RECORD*)(Journal->Map + Offset);
+
+    if(Offset + sizeof(S_JOURNAL_RECORD) > Journal->Size)
+    {
+        return NULL;
+    }
+    if( (Sequence != Record->Sequence) || (Record->Length > Journal->Size - Offset - sizeof(S_JOURNAL_RECORD)) )
+    {
+        return NULL;
+    }
+    if( (D_JOURNAL_OP_ADD != Record->Op) && (D_JOURNAL_OP_DEL != Record->Op) )
+    {
+        return NULL;
+    }
+    if(Record->Checksum != prvChecksum(Record, (uint8_t*)(Record + 1)))
+    {
+        return NULL;
+    }
+    return Record;
+}
+
+/**
+ * @brief               Rebuild the hash table from the records of the file
+ * @param[in,out]       Journal             Journal
+ * @retval              0 for successful
+ * @retval              -1 for no memory
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvReplay(S_JOURNAL* Journal)
+{
+    S_JOURNAL_RECORD*   Record  =   NULL;
+    S_JOURNAL_INDEX*    Entry   =   NULL;
+    uint32_t            Key     =   0;
+
+    Journal->Tail       =   sizeof(S_JOURNAL_HEADER);
+    Journal->Sequence   =   ((S_JOURNAL_HEADER*)Journal->Map)->Sequence;
+    while( NULL != (Record = prvRecordGet(Journal, Journal->Tail, Journal->Sequence)) )
+    {
+        Key     =   D_JOURNAL_KEY(Record->Type, Record->PacketIdentifier);
+        Entry   =   prvIndexFind(Journal, Key);
+        if(Entry)
+        {
+            Journal->LiveBytes -= prvRecordSize(((S_JOURNAL_RECORD*)(Journal->Map + Entry->Offset))->Length);
+        }
+        if(D_JOURNAL_OP_ADD == Record->Op)
+        {
+            if(prvIndexReserve(Journal))
+            {
+                return (-1);
+            }
+            prvIndexPut(Journal, Key, (uint32_t)Journal->Tail);
+            Journal->LiveBytes += prvRecordSize(Record->Length);
+        }
+        else if(Entry)
+        {
+            prvIndexRemove(Journal, Entry);
+        }
+        Journal->Tail += prvRecordSize(Record->Length);
+        Journal->Sequence++;
+    }
+    return 0;
+}
+
+/**
+ * @brief               Flush the directory of the journal file (after it is renamed)
+ * @param[in]           Journal             Journal
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvSyncDir(S_JOURNAL* Journal)
+{
+    char*   Slash   =   strrchr(Journal->Path, '/');
+    char    Dir[D_JOURNAL_PATH_SIZE];
+    int     Fd      =   -1;
+
+    if(!Slash)
+    {
+        strcpy(Dir, ".");
+    }
+    else
+    {
+        memcpy(Dir, Journal->Path, Slash - Journal->Path + 1);
+        Dir[Slash - Journal->Path + 1] = '\0';
+    }
+    Fd = open(Dir, O_RDONLY | O_DIRECTORY);
+    if(0 <= Fd)
+    {
+        (void)fsync(Fd);
+        (void)close(Fd);
+    }
+    return;
+}
+
+/**
+ * @brief               Copy the live records to a new file which replaces the journal file
+ * @param[in,out]       Journal             Journal
+ * @param[in]           Need                Size of the record to append after the compaction
+ * @retval              0 for successful
+ * @retval              -1 for fail (the journal is not changed)
+ * @note                The file is doubled until the live records use less than half of it, so the
+ *                      compaction is not done again soon
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvCompact(S_JOURNAL* Journal, size_t Need)
+{
+    char                TmpPath[D_JOURNAL_PATH_SIZE + 8];
+    S_JOURNAL_HEADER*   Header  =   NULL;
+    S_JOURNAL_RECORD*   Record  =   NULL;
+    S_JOURNAL_RECORD*   Copy    =   NULL;
+    S_JOURNAL_INDEX*    Entry   =   NULL;
+    uint8_t*            Map     =   NULL;
+    size_t              Size    =   Journal->Size;
+    size_t              Offset  =   sizeof(S_JOURNAL_HEADER);
+    size_t              Tail    =   sizeof(S_JOURNAL_HEADER);
+    uint32_t            Seq     =   0;
+    int                 Fd      =   -1;
+
+    while( (sizeof(S_JOURNAL_HEADER) + Journal->LiveBytes + Need) * 2 > Size )
+    {
+        Size = Size * 2;
+    }
+    if(Size > UINT32_MAX)
+    {
+        return (-1);
+    }
+
+    snprintf(TmpPath, sizeof(TmpPath), "%s.tmp", Journal->Path);
+    Fd = open(TmpPath, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if(0 > Fd)
+    {
+        D_MQC_PRINT( " failed\n  ! open() %s errno %d\n\n", TmpPath, errno );
+        return (-1);
+    }
+    if(ftruncate(Fd, (off_t)Size))
+    {
+        D_MQC_PRINT( " failed\n  ! ftruncate() %s errno %d\n\n", TmpPath, errno );
+        (void)close(Fd);
+        (void)unlink(TmpPath);
+        return (-1);
+    }
+    Map = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+    if(MAP_FAILED == Map)
+    {
+        D_MQC_PRINT( " failed\n  ! mmap() %s errno %d\n\n", TmpPath, errno );
+        (void)close(Fd);
+        (void)unlink(TmpPath);
+        return (-1);
+    }
+
+    Header              =   (S_JOURNAL_HEADER*)Map;
+    Header->Magic       =   D_JOURNAL_MAGIC;
+    Header->Version     =   D_JOURNAL_VERSION;
+    Header->Sequence    =   0;
+    Header->Reserved    =   0;
+    /* Copy the live records in the order they were saved, and number them again from 0 */
+    for(Offset = sizeof(S_JOURNAL_HEADER); Offset < Journal->Tail; Offset += prvRecordSize(Record->Length))
+    {
+        Record  =   (S_JOURNAL_RECORD*)(Journal->Map + Offset);
+        Entry   =   prvIndexFind(Journal, D_JOURNAL_KEY(Record->Type, Record->PacketIdentifier));
+        if( Entry && (Offset == Entry->Offset) )
+        {
+            Copy = (S_JOURNAL_RECORD*)(Map + Tail);
+            memcpy(Copy, Record, prvRecordSize(Record->Length));
+            Copy->Sequence  =   Seq++;
+            Copy->Checksum  =   prvChecksum(Copy, (uint8_t*)(Copy + 1));
+            Tail += prvRecordSize(Record->Length);
+        }
+    }
+
+    /* The new file must be complete before it replaces the old one */
+    if(Journal->Fsync)
+    {
+        (void)msync(Map, Tail, MS_SYNC);
+    }
+    if(rename(TmpPath, Journal->Path))
+    {
+        D_MQC_PRINT( " failed\n  ! rename() %s errno %d\n\n", TmpPath, errno );
+        (void)munmap(Map, Size);
+        (void)close(Fd);
+        (void)unlink(TmpPath);
+        return (-1);
+    }
+    if(Journal->Fsync)
+    {
+        prvSyncDir(Journal);
+    }
+
+    /* Point the hash table to the copied records */
+    for(Offset = sizeof(S_JOURNAL_HEADER); Offset < Tail; Offset += prvRecordSize(Copy->Length))
+    {
+        Copy    =   (S_JOURNAL_RECORD*)(Map + Offset);
+        Entry   =   prvIndexFind(Journal, D_JOURNAL_KEY(Copy->Type, Copy->PacketIdentifier));
+        Entry->Offset = (uint32_t)Offset;
+    }
+
+    (void)munmap(Journal->Map, Journal->Size);
+    (void)close(Journal->Fd);
+    Journal->Fd             =   Fd;
+    Journal->Map            =   Map;
+    Journal->Size           =   Size;
+    Journal->Tail           =   Tail;
+    Journal->Sequence       =   Seq;
+    Journal->DirtyStart     =   Tail;
+    Journal->HeaderDirty    =   false;
+    Journal->CompactCount++;
+    return 0;
+}
+
+/**
+ * @brief               Append a record to the journal file
+ * @param[in,out]       Journal             Journal
+ * @param[in]           Op                  D_JOURNAL_OP_ADD or D_JOURNAL_OP_DEL
+ * @param[in]           Type                Message Type
+ * @param[in]           PacketIdentifier    Packet Identifier
+ * @param[in]           Data                Data of the record
+ * @param[in]           Length              Size of the data
+ * @return              Offset of the record (0 for fail)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static size_t prvAppend(S_JOURNAL* Journal, uint8_t Op, uint8_t Type, uint16_t PacketIdentifier, const uint8_t* Data, size_t Length)
+{
+    S_JOURNAL_RECORD*   Record  =   NULL;
+    size_t              Need    =   prvRecordSize(Length);
+    size_t              Offset  =   0;
+
+    if(Journal->Tail + Need > Journal->Size)
+    {
+        if(prvCompact(Journal, Need))
+        {
+            return 0;
+        }
+    }
+    Offset                      =   Journal->Tail;
+    Record                      =   (S_JOURNAL_RECORD*)(Journal->Map + Offset);
+    Record->Length              =   (uint32_t)Length;
+    Record->Op                  =   Op;
+    Record->Type                =   Type;
+    Record->PacketIdentifier    =   PacketIdentifier;
+    Record->Sequence            =   Journal->Sequence++;
+    if(Length)
+    {
+        memcpy(Record + 1, Data, Length);
+    }
+    Record->Checksum            =   prvChecksum(Record, Data);
+    Journal->Tail += Need;
+    return Offset;
+}
+
+/**
+ * @brief               Save an encoded Message to the journal (SaveFuncCB)
+ * @param[in]           Ctx                 Journal
+ * @param[in]           Type                Message Type
+ * @param[in]           PacketIdentifier    Packet Identifier
+ * @param[in]           Data                Encoded Message
+ * @param[in]           Size                Size of the encoded Message
+ * @retval              0 for successful
+ * @retval              -1 for fail (no enough memory or the file can not be compacted)
+ * @note                The record saved before with the same type and Packet Identifier is left in the file as a
+ *                      dead one, it is dropped by the next compaction.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvSave(void* Ctx, E_MQC_MSG_TYPE Type, uint16_t PacketIdentifier, const uint8_t* Data, size_t Size)
+{
+    S_JOURNAL*          Journal =   (S_JOURNAL*)Ctx;
+    S_JOURNAL_INDEX*    Entry   =   NULL;
+    uint32_t            Key     =   D_JOURNAL_KEY(Type, PacketIdentifier);
+    size_t              Offset  =   0;
+
+    if(prvIndexReserve(Journal))
+    {
+        return (-1);
+    }
+    Offset = prvAppend(Journal, D_JOURNAL_OP_ADD, (uint8_t)Type, PacketIdentifier, Data, Size);
+    if(!Offset)
+    {
+        return (-1);
+    }
+    Entry = prvIndexFind(Journal, Key);
+    if(Entry)
+    {
+        Journal->LiveBytes -= prvRecordSize(((S_JOURNAL_RECORD*)(Journal->Map + Entry->Offset))->Length);
+    }
+    prvIndexPut(Journal, Key, (uint32_t)Offset);
+    Journal->LiveBytes += prvRecordSize(Size);
+    return 0;
+}
+
+/**
+ * @brief               Delete a Message from the journal (DeleteFuncCB)
+ * @param[in]           Ctx                 Journal
+ * @param[in]           Type                Message Type
+ * @param[in]           PacketIdentifier    Packet Identifier
+ * @retval              0 for successful (also if the Message is not in the journal)
+ * @retval              -1 for fail (the file can not be compacted)
+ * @note                A delete record is appended, so the Message is not taken again if the file is replayed
+ *                      before the next compaction.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvDelete(void* Ctx, E_MQC_MSG_TYPE Type, uint16_t PacketIdentifier)
+{
+    S_JOURNAL*          Journal =   (S_JOURNAL*)Ctx;
+    S_JOURNAL_INDEX*    Entry   =   NULL;
+    uint32_t            Key     =   D_JOURNAL_KEY(Type, PacketIdentifier);
+
+    if(!prvIndexFind(Journal, Key))
+    {
+        return 0;
+    }
+    if(!prvAppend(Journal, D_JOURNAL_OP_DEL, (uint8_t)Type, PacketIdentifier, NULL, 0))
+    {
+        return (-1);
+    }
+    /* Found again, the compaction may move the entry */
+    Entry = prvIndexFind(Journal, Key);
+    Journal->LiveBytes -= prvRecordSize(((S_JOURNAL_RECORD*)(Journal->Map + Entry->Offset))->Length);
+    prvIndexRemove(Journal, Entry);
+    return 0;
+}
+
+/**
+ * @brief               Delete all Messages of the journal (ClearFuncCB)
+ * @param[in]           Ctx                 Journal
+ * @retval              0 for successful
+ * @retval              -1 for fail (the new file can not be made)
+ * @note                The header tells the records in the file are older than the next sequence number, so the
+ *                      file is not rewritten. A new file is made only when the sequence number is about to wrap.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvClear(void* Ctx)
+{
+    S_JOURNAL*          Journal =   (S_JOURNAL*)Ctx;
+
+    if(Journal->IndexSize)
+    {
+        memset(Journal->Index, 0, Journal->IndexSize * sizeof(S_JOURNAL_INDEX));
+    }
+    Journal->IndexNum   =   0;
+    Journal->LiveBytes  =   0;
+    if(Journal->Sequence >= D_JOURNAL_SEQUENCE_MAX)
+    {
+        /* Start a new file, so the sequence number restarts from 0 */
+        return prvCompact(Journal, 0);
+    }
+    /* The records in the file are older than the first one expected now */
+    ((S_JOURNAL_HEADER*)Journal->Map)->Sequence = Journal->Sequence;
+    Journal->Tail           =   sizeof(S_JOURNAL_HEADER);
+    Journal->DirtyStart     =   Journal->Tail;
+    Journal->HeaderDirty    =   true;
+    return 0;
+}
+
+/**
+ * @brief               Give all Messages of the journal in the order they were saved (LoadFuncCB)
+ * @param[in]           Ctx                 Journal
+ * @param[in]           RecordFuncCB        Callback function called with each Message
+ * @param[in]           UsrData             User data of RecordFuncCB
+ * @retval              0 for successful
+ * @retval              -1 for RecordFuncCB failed (the Messages after it are not given)
+ * @note                Only the live record of each Message is given, the replaced and deleted ones are skipped.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvLoad(void* Ctx, int32_t (*RecordFuncCB)(void* UsrData, E_MQC_MSG_TYPE Type, uint16_t PacketIdentifier, const uint8_t* Data, size_t Size), void* UsrData)
+{
+    S_JOURNAL*          Journal =   (S_JOURNAL*)Ctx;
+    S_JOURNAL_RECORD*   Record  =   NULL;
+    S_JOURNAL_INDEX*    Entry   =   NULL;
+    size_t              Offset  =   0;
+
+    for(Offset = sizeof(S_JOURNAL_HEADER); Offset < Journal->Tail; Offset += prvRecordSize(Record->Length))
+    {
+        Record  =   (S_JOURNAL_RECORD*)(Journal->Map + Offset);
+        Entry   =   prvIndexFind(Journal, D_JOURNAL_KEY(Record->Type, Record->PacketIdentifier));
+        if( Entry && (Offset == Entry->Offset) )
+        {
+            if(RecordFuncCB(UsrData, (E_MQC_MSG_TYPE)Record->Type, Record->PacketIdentifier, (uint8_t*)(Record + 1), Record->Length))
+            {
+                return (-1);
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief               Flush the records appended after the last sync to the disk (SyncFuncCB)
+ * @param[in]           Ctx                 Journal
+ * @retval              0 for successful (or the journal is opened without Fsync)
+ * @retval              -1 for msync() failed
+ * @note                The pages from the first dirty record to the tail are flushed, and the header page too
+ *                      if it was changed.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvSync(void* Ctx)
+{
+    S_JOURNAL*          Journal =   (S_JOURNAL*)Ctx;
+    size_t              Page    =   (size_t)sysconf(_SC_PAGESIZE);
+    size_t              Start   =   (Journal->HeaderDirty)?(0):(Journal->DirtyStart & ~(Page - 1));
+    int32_t             Ret     =   0;
+
+    if( Journal->Fsync && (Journal->Tail > Start) )
+    {
+        if(msync(Journal->Map + Start, Journal->Tail - Start, MS_SYNC))
+        {
+            D_MQC_PRINT( " failed\n  ! msync() errno %d\n\n", errno );
+            Ret = (-1);
+        }
+    }
+    Journal->DirtyStart     =   Journal->Tail;
+    Journal->HeaderDirty    =   false;
+    return Ret;
+}
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Open a journal file (created if not exists)
+ * @param[in,out]       Journal             Journal
+ * @param[in]           Path                Path of the journal file
+ * @param[in]           Capacity            Initial size of the journal file (0 means D_JOURNAL_DEFAULT_CAPACITY)
+ * @param[in]           Fsync               Flush the records to the disk by the sync of the session
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @note                The records of the file are checked, the ones after the first broken record are dropped.
+ *                      The file "Path.tmp" is used by the compaction.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t journal_open(S_JOURNAL* Journal, const char* Path, size_t Capacity, bool Fsync)
+{
+    S_JOURNAL_HEADER*   Header  =   NULL;
+    struct stat         Stat;
+    size_t              Page    =   (size_t)sysconf(_SC_PAGESIZE);
+    size_t              Offset  =   0;
+
+    if( !Journal || !Path || (D_JOURNAL_PATH_SIZE <= strlen(Path)) )
+    {
+        return (-1);
+    }
+    memset(Journal, 0, sizeof(S_JOURNAL));
+    strcpy(Journal->Path, Path);
+    Journal->Fsync = Fsync;
+    if(!Capacity)
+    {
+        Capacity = D_JOURNAL_DEFAULT_CAPACITY;
+    }
+
+    Journal->Fd = open(Path, O_RDWR | O_CREAT, 0600);
+    if(0 > Journal->Fd)
+    {
+        D_MQC_PRINT( " failed\n  ! open() %s errno %d\n\n", Path, errno );
+        return (-1);
+    }
+    if(fstat(Journal->Fd, &Stat))
+    {
+        D_MQC_PRINT( " failed\n  ! fstat() %s errno %d\n\n", Path, errno );
+        (void)close(Journal->Fd);
+        return (-1);
+    }
+    /* Keep the file size if it was grown before */
+    Journal->Size = ( (size_t)Stat.st_size > Capacity )?((size_t)Stat.st_size):(Capacity);
+    Journal->Size = (Journal->Size + Page - 1) & ~(Page - 1);
+    if( (Journal->Size > UINT32_MAX)
+       || (((size_t)Stat.st_size != Journal->Size) && ftruncate(Journal->Fd, (off_t)Journal->Size)) )
+    {
+        D_MQC_PRINT( " failed\n  ! ftruncate() %s errno %d\n\n", Path, errno );
+        (void)close(Journal->Fd);
+        return (-1);
+    }
+    Journal->Map = mmap(NULL, Journal->Size, PROT_READ | PROT_WRITE, MAP_SHARED, Journal->Fd, 0);
+    if(MAP_FAILED == Journal->Map)
+    {
+        D_MQC_PRINT( " failed\n  ! mmap() %s errno %d\n\n", Path, errno );
+        (void)close(Journal->Fd);
+        return (-1);
+    }
+
+    Header = (S_JOURNAL_HEADER*)Journal->Map;
+    if( (D_JOURNAL_MAGIC != Header->Magic) || (D_JOURNAL_VERSION != Header->Version) )
+    {
+        /* New file (or not a journal), start with no record */
+        memset(Journal->Map, 0, Journal->Size);
+        Header->Magic           =   D_JOURNAL_MAGIC;
+        Header->Version         =   D_JOURNAL_VERSION;
+        Journal->HeaderDirty    =   true;
+    }
+    if(prvReplay(Journal))
+    {
+        journal_close(Journal);
+        return (-1);
+    }
+    Journal->DirtyStart = Journal->Tail;
+
+    /* The records after a broken one may be valid but stale, start a clean file not to take them later */
+    for(Offset = Journal->Tail; Offset < Journal->Size; Offset++)
+    {
+        if(Journal->Map[Offset])
+        {
+            if(prvCompact(Journal, 0))
+            {
+                journal_close(Journal);
+                return (-1);
+            }
+            break;
+        }
+    }
+
+    Journal->Func.Ctx           =   Journal;
+    Journal->Func.SaveFuncCB    =   prvSave;
+    Journal->Func.DeleteFuncCB  =   prvDelete;
+    Journal->Func.ClearFuncCB   =   prvClear;
+    Journal->Func.LoadFuncCB    =   prvLoad;
+    Journal->Func.SyncFuncCB    =   prvSync;
+    Journal->Func.ResultFuncCB  =   NULL;
+    return 0;
+}
+
+/**
+ * @brief               Close a journal file
+ * @param[in,out]       Journal             Journal
+ * @return              None
+ * @note                The Messages in the journal are kept in the file
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern void journal_close(S_JOURNAL* Journal)
+{
+    if(!Journal || !Journal->Map)
+    {
+        return;
+    }
+    (void)prvSync(Journal);
+    (void)munmap(Journal->Map, Journal->Size);
+    (void)close(Journal->Fd);
+    free(Journal->Index);
+    Journal->Map        =   NULL;
+    Journal->Fd         =   -1;
+    Journal->Index      =   NULL;
+    Journal->IndexSize  =   0;
+    Journal->IndexNum   =   0;
+    return;
+}
+
+#endif /* MQC_PERSISTENCE */
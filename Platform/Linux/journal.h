@@ -0,0 +1,157 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     journal.h
+ * @brief       Journal of the Messages in flight for Linux Platform Header
+ * @details     The Messages saved and deleted by the session are appended to a memory-mapped file as records,
+ *              so saving a Message is a copy into the mapping. The records of a Message deleted or saved again
+ *              are left in the file until it is full, then the live records are copied to a new file which
+ *              replaces it (grown if most of the records are still live). \n
+ *              The mapping is shared with the page cache, so the records survive a crash of the process.
+ *              To survive a crash of the system, open the journal with Fsync and the records written by one
+ *              API call are flushed to the disk together before it returns.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+#ifndef __JOURNAL_H__
+#define __JOURNAL_H__
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MQC_api.h"
+
+#if defined (MQC_PERSISTENCE)
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_JOURNAL_PATH_SIZE         (256)           /*!< Max length of the journal file path */
+#define D_JOURNAL_DEFAULT_CAPACITY  (1048576)       /*!< Default size of the journal file */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Index entry of a live Message in the journal
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_JOURNAL_INDEX
+{
+    uint32_t                Key;                /*!< Message type and Packet Identifier (0 for the empty entry) */
+    uint32_t                Offset;             /*!< Offset of the last record saved for the Message */
+}S_JOURNAL_INDEX;
+
+/**
+ * @brief      Journal of the Messages in flight
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_JOURNAL
+{
+    S_MQC_PERSIST_FUNC      Func;
+    /*!< Store callback functions of the journal (set PersistFunc of the session handler with it) */
+
+    char                    Path[D_JOURNAL_PATH_SIZE];
+    /*!< Path of the journal file */
+
+    int                     Fd;
+    /*!< Journal file */
+
+    uint8_t*                Map;
+    /*!< Mapping of the journal file */
+
+    size_t                  Size;
+    /*!< Size of the journal file */
+
+    size_t                  Tail;
+    /*!< Offset to append the next record */
+
+    size_t                  LiveBytes;
+    /*!< Size of the live records */
+
+    uint32_t                Sequence;
+    /*!< Sequence number of the next record */
+
+    bool                    Fsync;
+    /*!< Flush the records to the disk by the sync of the session */
+
+    size_t                  DirtyStart;
+    /*!< Offset of the first record not flushed yet */
+
+    bool                    HeaderDirty;
+    /*!< The file header is changed after the last flush */
+
+    S_JOURNAL_INDEX*        Index;
+    /*!< Open addressing hash table of the live Messages */
+
+    uint32_t                IndexSize;
+    /*!< Number of the entries of the hash table (power of 2) */
+
+    uint32_t                IndexNum;
+    /*!< Number of the live Messages */
+
+    uint32_t                CompactCount;
+    /*!< Number of the compactions done after opened */
+}S_JOURNAL;
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Open a journal file (created if not exists)
+ * @param[in,out]       Journal             Journal
+ * @param[in]           Path                Path of the journal file
+ * @param[in]           Capacity            Initial size of the journal file (0 means D_JOURNAL_DEFAULT_CAPACITY)
+ * @param[in]           Fsync               Flush the records to the disk by the sync of the session
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @note                The records of the file are checked, the ones after the first broken record are dropped.
+ *                      The file "Path.tmp" is used by the compaction.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t journal_open(S_JOURNAL* Journal, const char* Path, size_t Capacity, bool Fsync);
+
+/**
+ * @brief               Close a journal file
+ * @param[in,out]       Journal             Journal
+ * @return              None
+ * @note                The Messages in the journal are kept in the file
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern void journal_close(S_JOURNAL* Journal);
+
+#endif /* MQC_PERSISTENCE */
+
+#endif /* __JOURNAL_H__ */
@@ -35,12 +35,21 @@
  * @version     00.00.04 
  *              - 2018/12/12 : zhaozhenge@outlook.com 
  *                  -# Modify some comment
+ * @version     00.00.05 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add TCP/IP Data Send with segments
+ * @version     00.00.06 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Use the pthread mutex for the resource lock
  */
 
 /**************************************************************
 **  Include
 **************************************************************/
 
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     /* PTHREAD_MUTEX_ADAPTIVE_NP */
+#endif
 #include <string.h>
 #include <stdlib.h>
 #include <time.h>
@@ -52,6 +61,7 @@
 #include <sys/sem.h>
 #include <sys/time.h> 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/select.h>
 #include "wrapper.h"
 #include "MQC_wrap.h"
@@ -91,7 +101,11 @@ extern uint32_t MQC_Wrap_ntohl(uint32_t Data)
 extern int32_t wrapper_init(S_PLATFORM_DATA* Ctx)
 {
     int                 Err         =   0;
+#if defined(D_WRAPPER_LOCK_SEMAPHORE)
     int                 val         =   1;
+#else
+    pthread_mutexattr_t Attr;
+#endif
     char*               TmpPtr      =   NULL;
     uint16_t            TmpPort     =   0; 
     do
@@ -104,6 +118,7 @@ extern int32_t wrapper_init(S_PLATFORM_DATA* Ctx)
         Ctx->DstPort = TmpPort;
         Ctx->DstAddress = TmpPtr;
         
+#if defined(D_WRAPPER_LOCK_SEMAPHORE)
         /* Create Semaphore */
         Err = semget((key_t)1234, 1, IPC_CREAT | 0666);
         if(0 > Err)
@@ -118,6 +133,21 @@ extern int32_t wrapper_init(S_PLATFORM_DATA* Ctx)
             D_MQC_PRINT( " failed\n  ! semctl() returned %d\n\n", Err );
             break;
         }
+#else
+        /* Create Mutex, it spins a while before sleeping in the kernel when it is contended (glibc) */
+        pthread_mutexattr_init(&Attr);
+#if defined(PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP)
+        pthread_mutexattr_settype(&Attr, PTHREAD_MUTEX_ADAPTIVE_NP);
+#endif
+        Err = pthread_mutex_init(&(Ctx->Mutex), &Attr);
+        pthread_mutexattr_destroy(&Attr);
+        if(Err)
+        {
+            D_MQC_PRINT( " failed\n  ! pthread_mutex_init() returned %d\n\n", Err );
+            break;
+        }
+        Ctx->MutexCreated = 1;
+#endif
         
         /* Create Random Sequence */
         srand(systick_wrapper());
@@ -218,6 +248,10 @@ extern void wrapper_deinit(S_PLATFORM_DATA* Ctx)
             D_MQC_PRINT( " failed\n  ! semctl() returned %d\n\n", Err );
         }
     }
+    if(1 == Ctx->MutexCreated)
+    {
+        pthread_mutex_destroy(&(Ctx->Mutex));
+    }
     
     network_close_wrapper(Ctx);
     
@@ -254,6 +288,7 @@ extern void random_wrapper(uint8_t* Output, size_t Len)
 extern void lock_wrapper(S_PLATFORM_DATA* Ctx)
 {
     int             Err         =   0;
+#if defined(D_WRAPPER_LOCK_SEMAPHORE)
     struct sembuf   sem_buf;
     
     memset(&sem_buf, 0, sizeof(sem_buf));
@@ -266,6 +301,13 @@ extern void lock_wrapper(S_PLATFORM_DATA* Ctx)
     {
         D_MQC_PRINT( " failed\n  ! semop() returned %d\n\n", Err );
     }
+#else
+    Err = pthread_mutex_lock(&(Ctx->Mutex));
+    if(Err)
+    {
+        D_MQC_PRINT( " failed\n  ! pthread_mutex_lock() returned %d\n\n", Err );
+    }
+#endif
     return;
 }
 
@@ -279,6 +321,7 @@ extern void lock_wrapper(S_PLATFORM_DATA* Ctx)
 extern void unlock_wrapper(S_PLATFORM_DATA* Ctx)
 {
     int             Err         =   0;
+#if defined(D_WRAPPER_LOCK_SEMAPHORE)
     struct sembuf   sem_buf;
 
     memset(&sem_buf, 0, sizeof(sem_buf));
@@ -291,6 +334,13 @@ extern void unlock_wrapper(S_PLATFORM_DATA* Ctx)
     {
         D_MQC_PRINT( " failed\n  ! semop() returned %d\n\n", Err );
     }
+#else
+    Err = pthread_mutex_unlock(&(Ctx->Mutex));
+    if(Err)
+    {
+        D_MQC_PRINT( " failed\n  ! pthread_mutex_unlock() returned %d\n\n", Err );
+    }
+#endif
     return;
 }
 
@@ -337,6 +387,52 @@ extern int32_t tcpwrite_wrapper(S_PLATFORM_DATA* Ctx, const uint8_t* Data, size_
     return Err;
 }
 
+/** 
+ * @brief               wrapper Implement for TCP/IP Data Send with segments
+ * @param[in,out]       Ctx                 User Context
+ * @param[in,out]       Vec                 Segments want to write via network (modified while sending)
+ * @param[in]           VecNum              Number of the segments
+ * @return              The size of data write success ( < 0 means error)
+ * @note                All the segments are sent by sendmsg() without copy, the function returns after all 
+ *                      the data is sent or an error occurs.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t tcpwritev_wrapper(S_PLATFORM_DATA* Ctx, struct iovec* Vec, int32_t VecNum)
+{
+    int32_t         Err         =   0;
+    int32_t         Total       =   0;
+    struct msghdr   Msg;
+    
+    memset(&Msg, 0, sizeof(Msg));
+    Msg.msg_iov     =   Vec;
+    Msg.msg_iovlen  =   VecNum;
+    
+    while(Msg.msg_iovlen)
+    {
+        Err = sendmsg(Ctx->SocketFd, &Msg, 0);
+        if(0 > Err)
+        {
+            return Err;
+        }
+        Total = Total + Err;
+        /* Skip the data already sent */
+        while( Msg.msg_iovlen && ((size_t)Err >= Msg.msg_iov->iov_len) )
+        {
+            Err = Err - Msg.msg_iov->iov_len;
+            Msg.msg_iov++;
+            Msg.msg_iovlen--;
+        }
+        if(Msg.msg_iovlen)
+        {
+            Msg.msg_iov->iov_base = (uint8_t*)Msg.msg_iov->iov_base + Err;
+            Msg.msg_iov->iov_len = Msg.msg_iov->iov_len - Err;
+        }
+    }
+    
+    return Total;
+}
+
 /** 
  * @brief               wrapper Implement for TCP/IP data receive watching 
  * @param[in,out]       Ctx                 User Context
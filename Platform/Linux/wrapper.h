@@ -32,6 +32,12 @@
  * @version     00.00.03 
  *              - 2018/11/30 : zhaozhenge@outlook.com 
  *                  -# Change for MQTT Library
+ * @version     00.00.04 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Add TCP/IP Data Send with segments
+ * @version     00.00.05 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Use the pthread mutex for the resource lock
  */
  
 /**************************************************************
@@ -41,6 +47,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <sys/uio.h>
+#include <pthread.h>
 
 /**************************************************************
 **  Symbol
@@ -50,6 +58,10 @@
 #define malloc_wrapper  malloc
 #define free_wrapper    free
 
+//#define D_WRAPPER_LOCK_SEMAPHORE
+/*!< Use the SysV semaphore for the resource lock like before (a system call in each lock and unlock). \n
+     The pthread mutex is used by default, it takes no system call when there is no contention */
+
 /**************************************************************
 **  Structure
 **************************************************************/
@@ -62,6 +74,8 @@
 typedef struct _S_PLATFORM_DATA
 {
     int                     SemaphoreId;
+    pthread_mutex_t         Mutex;
+    int                     MutexCreated;
     int                     SocketFd;
     char*                   DstAddress;
     uint16_t                DstPort;
@@ -156,6 +170,17 @@ extern void network_close_wrapper(S_PLATFORM_DATA* Ctx);
  */
 extern int32_t tcpwrite_wrapper(S_PLATFORM_DATA* Ctx, const uint8_t* Data, size_t Size);
 
+/** 
+ * @brief               wrapper Implement for TCP/IP Data Send with segments
+ * @param[in,out]       Ctx                 User Context
+ * @param[in,out]       Vec                 Segments want to write via network (modified while sending)
+ * @param[in]           VecNum              Number of the segments
+ * @return              The size of data write success ( < 0 means error)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t tcpwritev_wrapper(S_PLATFORM_DATA* Ctx, struct iovec* Vec, int32_t VecNum);
+
 /** 
  * @brief               wrapper Implement for TCP/IP data receive watching 
  * @param[in,out]       Ctx                 User Context
@@ -32,6 +32,10 @@
  * @version     00.00.03 
  *              - 2018/12/12 : zhaozhenge@outlook.com 
  *                  -# Modify some comment
+ * @version     00.00.04 
+ *              - 2026/10/17 : agent@local 
+ *                  -# Send the QoS0 PUBLISH message in segments
+ *                  -# Wait the socket until MQC_Continue has work to do instead of polling
  */
  
 #if !defined(PLATFORM_LINUX) && !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_OTHER)  
@@ -210,6 +214,42 @@ int32_t WriteTcp_callback(void* Ctx, const uint8_t* Data, size_t Size)
     return 0;
 }
 
+/** 
+ * @brief               TCP/IP Data Send with segments callback function
+ * @param[in,out]       Ctx                 User Context
+ * @param[in]           Vec                 Segments want to write via network
+ * @param[in]           VecNum              Number of the segments
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int32_t WriteVecTcp_callback(void* Ctx, const S_MQC_IOVEC* Vec, uint32_t VecNum)
+{
+    S_USER_DATA*    CustomData  =   (S_USER_DATA*)Ctx;
+    struct iovec    IoVec[4];
+    uint32_t        i           =   0;
+    int32_t         Err         =   0;
+    
+    if(VecNum > sizeof(IoVec)/sizeof(IoVec[0]))
+    {
+        return (-1);
+    }
+    for(i = 0; i < VecNum; i++)
+    {
+        IoVec[i].iov_base   =   (void*)Vec[i].Data;
+        IoVec[i].iov_len    =   Vec[i].Size;
+    }
+    Err = tcpwritev_wrapper( &(CustomData->Platform), IoVec, VecNum );
+    if(0 > Err)
+    {
+        D_MQC_PRINT( " failed\n  ! sendmsg() returned %d\n\n", Err );
+        return (-1);
+    }
+    
+    return 0;
+}
+
 /** 
  * @brief               Open/Reset callback function
  * @param[in,out]       Ctx                 User Context for callback
@@ -342,6 +382,7 @@ int MqttTask( void* Input )
 {
     int32_t     Err         =   D_MQC_RET_OK;
     size_t      Size        =   0;
+    uint32_t    Deadline    =   0;
     uint8_t     Data[64];
     
     UsrData.Platform.DstAddress  =   (char*)D_MQC_MQTT_HOST;
@@ -391,6 +432,7 @@ int MqttTask( void* Input )
     MQCHandler.LockFunc                         =   NULL;
     MQCHandler.UnlockFunc                       =   NULL;
     MQCHandler.WriteFuncCB                      =   WriteTcp_callback;
+    MQCHandler.WriteVecFuncCB                   =   WriteVecTcp_callback;
     MQCHandler.ReadFuncCB                       =   ReadNotify_callback;
     MQCHandler.OpenResetFuncCB                  =   OpenResetNotify_callback;
 
@@ -414,7 +456,14 @@ int MqttTask( void* Input )
     
     while(UsrData.Running)
     {
-        Err = tcpcheck_wrapper(&(UsrData.Platform), 100);
+        Deadline = MQC_NextDeadline(&MQCHandler, systick_wrapper());
+        if(0 == Deadline)
+        {
+            MQC_Continue(&MQCHandler, systick_wrapper());
+            continue;
+        }
+        /* Sleep until the data comes or the next deadline (0 means wait the data only) */
+        Err = tcpcheck_wrapper(&(UsrData.Platform), (D_MQC_DEADLINE_INFINITE == Deadline)?(0):(Deadline));
         if(0 > Err)
         {
             UsrData.Running = false;
@@ -0,0 +1,367 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     multi_client.c
+ * @brief       Many MQTT Sessions served by a few threads of the Linux event loop.
+ *              Usage: multi_client [host] [port] [session number] [worker number] [seconds]
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+#if !defined(PLATFORM_LINUX)
+#error The event loop is only for PLATFORM_LINUX
+#endif
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <unistd.h>
+#include <signal.h>
+#include "../Platform/Linux/wrapper.h"
+#include "../Platform/Linux/eventloop.h"
+#include "MQC_api.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_MQC_MQTT_HOST         "test.mosquitto.org"   /*!< MQTT test Server hostname */
+#define D_MQC_MQTT_PORT         (1883)                 /*!< MQTT test Server port */
+#define D_MQC_SESSION_NUM       (4)                    /*!< Default number of the sessions */
+#define D_MQC_WORKER_NUM        (2)                    /*!< Default number of the worker threads */
+#define D_MQC_RUN_SECONDS       (30)                   /*!< Default running time */
+#define D_MQC_TICK_INTERVAL     (100)                  /*!< Interval with millisecond to call MQC_Continue */
+#define D_MQC_CLIENTID_SIZE     (32)                   /*!< Buffer size of the client identifier */
+#define D_MQC_TOPIC_SIZE        (64)                   /*!< Buffer size of the topic */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Custom User Data of one session
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_USER_DATA
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    S_PLATFORM_DATA         Platform;
+    S_EVENT_SESSION         Event;
+    char                    ClientId[D_MQC_CLIENTID_SIZE];
+    char                    Topic[D_MQC_TOPIC_SIZE];
+    uint32_t                Received;
+    bool                    Running;
+}S_USER_DATA;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Resource Lock callback function
+ * @param[in,out]       Ctx                 User Context
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+void Lock_callback(void* Ctx)
+{
+    lock_wrapper( &(((S_USER_DATA*)Ctx)->Platform) );
+}
+
+/**
+ * @brief               Resource UnLock callback function
+ * @param[in,out]       Ctx                 User Context
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+void Unlock_callback(void* Ctx)
+{
+    unlock_wrapper( &(((S_USER_DATA*)Ctx)->Platform) );
+}
+
+/**
+ * @brief               TCP/IP Data Send callback function
+ * @param[in,out]       Ctx                 User Context
+ * @param[in]           Data                Data want to write via network
+ * @param[in]           Size                Size of the Data
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int32_t WriteTcp_callback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    S_USER_DATA*    CustomData  =   (S_USER_DATA*)Ctx;
+    int32_t         Err         =   0;
+
+    while(Size)
+    {
+        Err = tcpwrite_wrapper( &(CustomData->Platform), Data, Size);
+        if(0 > Err)
+        {
+            D_MQC_PRINT( " failed\n  ! send() returned %d\n\n", Err );
+            return (-1);
+        }
+        Size    =   Size - Err;
+        Data    =   Data + Err;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief               Open/Reset callback function
+ * @param[in,out]       Ctx                 User Context for callback
+ * @param[in]           Result              Result of the Connect Behavior
+ * @param[in]           SrvResCode          Result of the server response
+ * @param[in]           SessionPresent      If server has already hold the MQTT Session
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int32_t OpenResetNotify_callback(void* Ctx, E_MQC_BEHAVIOR_RESULT Result, uint8_t SrvResCode, bool SessionPresent)
+{
+    S_USER_DATA*        CustomData  =   (S_USER_DATA*)Ctx;
+    S_MQC_UTF8_DATA     TopicFilter;
+    E_MQC_QOS_LEVEL     QoS         =   E_MQC_QOS_1;
+    int32_t             Err         =   D_MQC_RET_OK;
+
+    if( (E_MQC_BEHAVIOR_COMPLETE != Result) || (D_MQC_OPEN_SUCCESS_CODE != SrvResCode) )
+    {
+        D_MQC_PRINT( " %s failed\n  ! Connect Result %d Code %d\n\n", CustomData->ClientId, Result, SrvResCode );
+        CustomData->Running = false;
+        return 0;
+    }
+
+    /* Subscribe the topic of the session */
+    TopicFilter.Data    =   (uint8_t*)CustomData->Topic;
+    TopicFilter.Length  =   strlen(CustomData->Topic);
+    Err = MQC_Subscribe(&(CustomData->Handler), &TopicFilter, &QoS, 1, NULL);
+    if( D_MQC_RET_OK != Err)
+    {
+        D_MQC_PRINT( " %s failed\n  ! MQC_Subscribe() returned %d\n\n", CustomData->ClientId, Err );
+        CustomData->Running = false;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief               Message data read callback function
+ * @param[in,out]       Ctx                 User Context for callback
+ * @param[in]           Type                Message Type
+ * @param[in]           Info                Information of the Message
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int32_t ReadNotify_callback(void* Ctx, E_MQC_MSG_TYPE Type, S_MQC_MESSAGE_INFO* Info)
+{
+    S_USER_DATA*    CustomData  =   (S_USER_DATA*)Ctx;
+
+    if(E_MQC_MSG_PUBLISH == Type)
+    {
+        CustomData->Received++;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief               Callback function called when the connection of a session is closed
+ * @param[in,out]       Session             Session removed from the event loop
+ * @param[in]           Reason              Reason of the session removed
+ * @param[in]           Err                 errno or the return value of MQC_Read
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+void Close_callback(S_EVENT_SESSION* Session, E_EVENT_CLOSE_REASON Reason, int32_t Err)
+{
+    S_USER_DATA*    CustomData  =   (S_USER_DATA*)Session->UsrCtx;
+
+    D_MQC_PRINT( " %s closed\n  ! Reason %d Error %d\n\n", CustomData->ClientId, Reason, Err );
+    CustomData->Running = false;
+    return;
+}
+
+/**
+ * @brief               Connect and open a session
+ * @param[in,out]       Loop                Event Loop
+ * @param[in,out]       CustomData          User Data of the session
+ * @param[in]           Host                MQTT Server hostname
+ * @param[in]           Port                MQTT Server port
+ * @param[in]           Index               Index of the session
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int32_t SessionOpen(S_EVENT_LOOP* Loop, S_USER_DATA* CustomData, char* Host, uint16_t Port, uint32_t Index)
+{
+    int32_t     Err     =   D_MQC_RET_OK;
+
+    snprintf(CustomData->ClientId, sizeof(CustomData->ClientId), "multi_client-%d-%u", (int)getpid(), Index);
+    snprintf(CustomData->Topic, sizeof(CustomData->Topic), "multi_client/%s", CustomData->ClientId);
+    CustomData->Platform.DstAddress =   Host;
+    CustomData->Platform.DstPort    =   Port;
+    if(wrapper_init(&(CustomData->Platform)))
+    {
+        return (-1);
+    }
+    if(network_open_wrapper(&(CustomData->Platform)))
+    {
+        return (-1);
+    }
+
+    CustomData->Handler.UsrCtx                  =   CustomData;
+    CustomData->Handler.CleanSession            =   true;
+    CustomData->Handler.ClientId.Data           =   (uint8_t*)CustomData->ClientId;
+    CustomData->Handler.ClientId.Length         =   strlen(CustomData->ClientId);
+    CustomData->Handler.KeepAliveInterval       =   30;
+    CustomData->Handler.MessageRetryInterval    =   5;
+    CustomData->Handler.MessageRetryCount       =   3;
+    CustomData->Handler.MallocFunc              =   malloc_wrapper;
+    CustomData->Handler.FreeFunc                =   free_wrapper;
+    CustomData->Handler.LockFunc                =   Lock_callback;
+    CustomData->Handler.UnlockFunc              =   Unlock_callback;
+    CustomData->Handler.WriteFuncCB             =   WriteTcp_callback;
+    CustomData->Handler.ReadFuncCB              =   ReadNotify_callback;
+    CustomData->Handler.OpenResetFuncCB         =   OpenResetNotify_callback;
+
+    Err = MQC_Start(&(CustomData->Handler), systick_wrapper());
+    if( D_MQC_RET_OK != Err)
+    {
+        D_MQC_PRINT( " failed\n  ! MQC_Start() returned %d\n\n", Err );
+        return (-1);
+    }
+
+    /* The worker thread reads the socket from now on */
+    CustomData->Event.Handler       =   &(CustomData->Handler);
+    CustomData->Event.SocketFd      =   CustomData->Platform.SocketFd;
+    CustomData->Event.CloseFuncCB   =   Close_callback;
+    CustomData->Event.UsrCtx        =   CustomData;
+    CustomData->Running             =   true;
+    if(eventloop_add(Loop, &(CustomData->Event)))
+    {
+        return (-1);
+    }
+
+    Err = MQC_Open(&(CustomData->Handler), 5000);
+    if( D_MQC_RET_OK != Err)
+    {
+        D_MQC_PRINT( " failed\n  ! MQC_Open() returned %d\n\n", Err );
+        return (-1);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief               main function
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main( int argc, char *argv[] )
+{
+    S_EVENT_LOOP        Loop;
+    S_USER_DATA*        UsrData     =   NULL;
+    S_MQC_MESSAGE_INFO  Message;
+    char*               Host        =   (argc > 1)?(argv[1]):((char*)D_MQC_MQTT_HOST);
+    uint16_t            Port        =   (argc > 2)?((uint16_t)atoi(argv[2])):(D_MQC_MQTT_PORT);
+    uint32_t            SessionNum  =   (argc > 3)?((uint32_t)atoi(argv[3])):(D_MQC_SESSION_NUM);
+    uint32_t            WorkerNum   =   (argc > 4)?((uint32_t)atoi(argv[4])):(D_MQC_WORKER_NUM);
+    uint32_t            Seconds     =   (argc > 5)?((uint32_t)atoi(argv[5])):(D_MQC_RUN_SECONDS);
+    uint32_t            Opened      =   0;
+    uint32_t            Received    =   0;
+    uint32_t            i           =   0;
+    uint32_t            j           =   0;
+
+    if(!SessionNum)
+    {
+        return (-1);
+    }
+    /* A session closed by the server must not kill the other sessions in send() */
+    signal(SIGPIPE, SIG_IGN);
+    UsrData = (S_USER_DATA*)calloc(SessionNum, sizeof(S_USER_DATA));
+    if(!UsrData)
+    {
+        return (-1);
+    }
+    if(eventloop_start(&Loop, WorkerNum, D_MQC_TICK_INTERVAL))
+    {
+        free(UsrData);
+        return (-1);
+    }
+
+    for(Opened = 0; Opened < SessionNum; Opened++)
+    {
+        if(SessionOpen(&Loop, &(UsrData[Opened]), Host, Port, Opened))
+        {
+            eventloop_remove(&(UsrData[Opened].Event));
+            (void)MQC_Stop(&(UsrData[Opened].Handler));
+            wrapper_deinit(&(UsrData[Opened].Platform));
+            break;
+        }
+    }
+    D_MQC_PRINT( " %u sessions opened with %u worker threads\n\n", Opened, WorkerNum );
+
+    /* Each session publishes to its own topic once a second */
+    for(i = 0; i < Seconds; i++)
+    {
+        sleep(1);
+        for(j = 0; j < Opened; j++)
+        {
+            if(!UsrData[j].Running)
+            {
+                continue;
+            }
+            Message.Topic.Data      =   (uint8_t*)UsrData[j].Topic;
+            Message.Topic.Length    =   strlen(UsrData[j].Topic);
+            Message.Content         =   (uint8_t*)"50";
+            Message.Length          =   strlen("50");
+            (void)MQC_Publish(&(UsrData[j].Handler), &Message, E_MQC_QOS_1, false, NULL);
+        }
+    }
+
+    for(j = 0; j < Opened; j++)
+    {
+        eventloop_remove(&(UsrData[j].Event));
+        Received = Received + UsrData[j].Received;
+        (void)MQC_Stop(&(UsrData[j].Handler));
+        wrapper_deinit(&(UsrData[j].Platform));
+    }
+    eventloop_stop(&Loop);
+    free(UsrData);
+
+    D_MQC_PRINT( " Program End with %u messages received\n\n", Received );
+
+    return 0;
+}
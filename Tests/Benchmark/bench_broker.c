@@ -0,0 +1,696 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_broker.c
+ * @brief       In-process MQTT 3.1.1 broker stand-in for the benchmarks
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L     /* MSG_NOSIGNAL */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "bench_broker.h"
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Make sure a buffer can hold more data
+ * @param[in,out]       Data                Buffer
+ * @param[in,out]       Size                Size of the buffer
+ * @param[in]           Need                Size needed
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t prvBrokerReserve(uint8_t** Data, size_t* Size, size_t Need)
+{
+    uint8_t*    NewData =   NULL;
+    size_t      NewSize =   (*Size)?(*Size):(D_BROKER_READ_SIZE);
+
+    if(Need <= *Size)
+    {
+        return 0;
+    }
+    while(NewSize < Need)
+    {
+        NewSize *= 2;
+    }
+    NewData = (uint8_t*)realloc(*Data, NewSize);
+    if(NULL == NewData)
+    {
+        return -1;
+    }
+    *Data = NewData;
+    *Size = NewSize;
+    return 0;
+}
+
+/**
+ * @brief               Send the data waiting of a connection as much as the socket accepts
+ * @param[in,out]       Conn                Connection
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvBrokerFlush(S_BROKER_CONN* Conn)
+{
+    size_t      Sent    =   0;
+    ssize_t     Ret     =   0;
+
+    while(Sent < Conn->OutLength)
+    {
+        Ret = send(Conn->Fd, Conn->OutData + Sent, Conn->OutLength - Sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(0 > Ret)
+        {
+            if((EAGAIN != errno) && (EWOULDBLOCK != errno) && (EINTR != errno))
+            {
+                Conn->Closed = true;
+            }
+            break;
+        }
+        Sent += (size_t)Ret;
+    }
+    if(Sent)
+    {
+        memmove(Conn->OutData, Conn->OutData + Sent, Conn->OutLength - Sent);
+        Conn->OutLength -= Sent;
+    }
+    return;
+}
+
+/**
+ * @brief               Queue a packet to send to a client
+ * @param[in,out]       Conn                Connection
+ * @param[in]           Header              Fixed header (first byte)
+ * @param[in]           Head                Data after the Remaining Length (variable header)
+ * @param[in]           HeadLength          Length of the data after the Remaining Length
+ * @param[in]           Body                Data following Head (payload), can be NULL
+ * @param[in]           BodyLength          Length of Body
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvBrokerQueue(S_BROKER_CONN* Conn, uint8_t Header, const uint8_t* Head, size_t HeadLength, const uint8_t* Body, size_t BodyLength)
+{
+    size_t      Remain  =   HeadLength + BodyLength;
+    uint8_t*    Ptr     =   NULL;
+
+    if(Conn->Closed)
+    {
+        return;
+    }
+    if(0 != prvBrokerReserve(&Conn->OutData, &Conn->OutSize, Conn->OutLength + 5 + Remain))
+    {
+        Conn->Closed = true;
+        return;
+    }
+    Ptr     =   Conn->OutData + Conn->OutLength;
+    *Ptr++  =   Header;
+    do
+    {
+        *Ptr = (uint8_t)(Remain & 0x7F);
+        Remain >>= 7;
+        if(Remain)
+        {
+            *Ptr |= 0x80;
+        }
+        Ptr++;
+    }while(Remain);
+    memcpy(Ptr, Head, HeadLength);
+    Ptr += HeadLength;
+    if(BodyLength)
+    {
+        memcpy(Ptr, Body, BodyLength);
+        Ptr += BodyLength;
+    }
+    Conn->OutLength = (size_t)(Ptr - Conn->OutData);
+    return;
+}
+
+/**
+ * @brief               Queue a packet which only has a Packet Identifier (PUBACK PUBREC PUBREL PUBCOMP UNSUBACK)
+ * @param[in,out]       Conn                Connection
+ * @param[in]           Header              Fixed header (first byte)
+ * @param[in]           Id                  Packet Identifier (2 bytes with the network order)
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvBrokerQueueAck(S_BROKER_CONN* Conn, uint8_t Header, const uint8_t* Id)
+{
+    prvBrokerQueue(Conn, Header, Id, 2, NULL, 0);
+    return;
+}
+
+/**
+ * @brief               Check if a Topic Name matches a Topic Filter
+ * @param[in]           Filter              Topic Filter
+ * @param[in]           FilterLength        Length of the Topic Filter
+ * @param[in]           Topic               Topic Name
+ * @param[in]           TopicLength         Length of the Topic Name
+ * @retval              true                Matched
+ * @retval              false               Not matched
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static bool prvBrokerMatch(const char* Filter, uint16_t FilterLength, const char* Topic, uint16_t TopicLength)
+{
+    uint16_t    F   =   0;
+    uint16_t    T   =   0;
+
+    while(F < FilterLength)
+    {
+        if('#' == Filter[F])
+        {
+            return true;
+        }
+        if('+' == Filter[F])
+        {
+            while((T < TopicLength) && ('/' != Topic[T]))
+            {
+                T++;
+            }
+            F++;
+            continue;
+        }
+        if(T >= TopicLength)
+        {
+            /* "a/#" also matches "a" */
+            return ((F + 2 == FilterLength) && ('/' == Filter[F]) && ('#' == Filter[F + 1])) ? true : false;
+        }
+        if(Filter[F] != Topic[T])
+        {
+            return false;
+        }
+        F++;
+        T++;
+    }
+    return (T == TopicLength) ? true : false;
+}
+
+/**
+ * @brief               Forward a PUBLISH Message to all clients which subscribe the Topic
+ * @param[in,out]       Broker              Broker
+ * @param[in]           Topic               Topic Name
+ * @param[in]           TopicLength         Length of the Topic Name
+ * @param[in]           QoS                 QoS of the Message
+ * @param[in]           Payload             Payload
+ * @param[in]           PayloadLength       Length of the Payload
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvBrokerForward(S_BROKER* Broker, const uint8_t* Topic, uint16_t TopicLength, uint8_t QoS, const uint8_t* Payload, size_t PayloadLength)
+{
+    S_BROKER_CONN*  Conn                =   NULL;
+    uint8_t         Head[2 + 65535 + 2];
+    size_t          HeadLength          =   0;
+    uint8_t         SubQoS              =   0;
+    bool            Matched             =   false;
+    uint32_t        Index               =   0;
+    uint32_t        SubIndex            =   0;
+
+    Head[0] = (uint8_t)(TopicLength >> 8);
+    Head[1] = (uint8_t)(TopicLength & 0xFF);
+    memcpy(&Head[2], Topic, TopicLength);
+    for(Index = 0; Index < Broker->ConnNum; Index++)
+    {
+        Conn    =   &Broker->Conn[Index];
+        Matched =   false;
+        SubQoS  =   0;
+        if(Conn->Closed)
+        {
+            continue;
+        }
+        for(SubIndex = 0; SubIndex < Conn->SubNum; SubIndex++)
+        {
+            if(prvBrokerMatch(Conn->Sub[SubIndex].Filter, Conn->Sub[SubIndex].Length, (const char*)Topic, TopicLength))
+            {
+                Matched =   true;
+                SubQoS  =   (Conn->Sub[SubIndex].QoS > SubQoS)?(Conn->Sub[SubIndex].QoS):(SubQoS);
+            }
+        }
+        if(!Matched)
+        {
+            continue;
+        }
+        SubQoS      =   (QoS < SubQoS)?(QoS):(SubQoS);
+        HeadLength  =   2 + TopicLength;
+        if(SubQoS)
+        {
+            Conn->PacketIdentifier++;
+            if(0 == Conn->PacketIdentifier)
+            {
+                Conn->PacketIdentifier = 1;
+            }
+            Head[HeadLength++] = (uint8_t)(Conn->PacketIdentifier >> 8);
+            Head[HeadLength++] = (uint8_t)(Conn->PacketIdentifier & 0xFF);
+        }
+        prvBrokerQueue(Conn, (uint8_t)(0x30 | (SubQoS << 1)), Head, HeadLength, Payload, PayloadLength);
+        Broker->Forwarded++;
+    }
+    return;
+}
+
+/**
+ * @brief               Process a SUBSCRIBE packet
+ * @param[in,out]       Conn                Connection
+ * @param[in]           Data                Data after the Remaining Length
+ * @param[in]           Length              Remaining Length
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvBrokerSubscribe(S_BROKER_CONN* Conn, const uint8_t* Data, size_t Length)
+{
+    uint8_t     Ack[2 + D_BROKER_SUB_MAX];
+    size_t      AckLength   =   2;
+    size_t      Pos         =   2;
+    uint16_t    FilterLength=   0;
+    uint32_t    Index       =   0;
+
+    if(2 > Length)
+    {
+        Conn->Closed = true;
+        return;
+    }
+    memcpy(Ack, Data, 2);
+    while((Pos + 3 <= Length) && (AckLength < sizeof(Ack)))
+    {
+        FilterLength = (uint16_t)((Data[Pos] << 8) | Data[Pos + 1]);
+        if((Pos + 3 + FilterLength > Length) || (D_BROKER_FILTER_SIZE <= FilterLength))
+        {
+            Ack[AckLength++] = 0x80;
+            break;
+        }
+        for(Index = 0; Index < Conn->SubNum; Index++)
+        {
+            if((Conn->Sub[Index].Length == FilterLength) && (0 == memcmp(Conn->Sub[Index].Filter, &Data[Pos + 2], FilterLength)))
+            {
+                break;
+            }
+        }
+        if(Index == D_BROKER_SUB_MAX)
+        {
+            Ack[AckLength++] = 0x80;
+        }
+        else
+        {
+            memcpy(Conn->Sub[Index].Filter, &Data[Pos + 2], FilterLength);
+            Conn->Sub[Index].Length =   FilterLength;
+            Conn->Sub[Index].QoS    =   (uint8_t)(Data[Pos + 2 + FilterLength] & 0x03);
+            if(Index == Conn->SubNum)
+            {
+                Conn->SubNum++;
+            }
+            Ack[AckLength++] = Conn->Sub[Index].QoS;
+        }
+        Pos += 3 + FilterLength;
+    }
+    prvBrokerQueue(Conn, 0x90, Ack, AckLength, NULL, 0);
+    return;
+}
+
+/**
+ * @brief               Process an UNSUBSCRIBE packet
+ * @param[in,out]       Conn                Connection
+ * @param[in]           Data                Data after the Remaining Length
+ * @param[in]           Length              Remaining Length
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvBrokerUnsubscribe(S_BROKER_CONN* Conn, const uint8_t* Data, size_t Length)
+{
+    size_t      Pos         =   2;
+    uint16_t    FilterLength=   0;
+    uint32_t    Index       =   0;
+
+    if(2 > Length)
+    {
+        Conn->Closed = true;
+        return;
+    }
+    while(Pos + 2 <= Length)
+    {
+        FilterLength = (uint16_t)((Data[Pos] << 8) | Data[Pos + 1]);
+        if(Pos + 2 + FilterLength > Length)
+        {
+            break;
+        }
+        for(Index = 0; Index < Conn->SubNum; Index++)
+        {
+            if((Conn->Sub[Index].Length == FilterLength) && (0 == memcmp(Conn->Sub[Index].Filter, &Data[Pos + 2], FilterLength)))
+            {
+                Conn->Sub[Index] = Conn->Sub[--Conn->SubNum];
+                break;
+            }
+        }
+        Pos += 2 + FilterLength;
+    }
+    prvBrokerQueueAck(Conn, 0xB0, Data);
+    return;
+}
+
+/**
+ * @brief               Process a packet received from a client
+ * @param[in,out]       Broker              Broker
+ * @param[in,out]       Conn                Connection
+ * @param[in]           Header              Fixed header (first byte)
+ * @param[in]           Data                Data after the Remaining Length
+ * @param[in]           Length              Remaining Length
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvBrokerPacket(S_BROKER* Broker, S_BROKER_CONN* Conn, uint8_t Header, const uint8_t* Data, size_t Length)
+{
+    static const uint8_t    ConnAck[2]      =   {0x00, 0x00};
+    uint8_t                 QoS             =   (uint8_t)((Header >> 1) & 0x03);
+    uint16_t                TopicLength     =   0;
+    size_t                  Pos             =   0;
+
+    switch(Header >> 4)
+    {
+        case 1:     /* CONNECT */
+            prvBrokerQueue(Conn, 0x20, ConnAck, sizeof(ConnAck), NULL, 0);
+            break;
+        case 3:     /* PUBLISH */
+            if(2 > Length)
+            {
+                Conn->Closed = true;
+                break;
+            }
+            TopicLength = (uint16_t)((Data[0] << 8) | Data[1]);
+            Pos         = 2 + (size_t)TopicLength + ((QoS)?(2):(0));
+            if((3 == QoS) || (Pos > Length))
+            {
+                Conn->Closed = true;
+                break;
+            }
+            if(1 == QoS)
+            {
+                prvBrokerQueueAck(Conn, 0x40, &Data[Pos - 2]);
+            }
+            else if(2 == QoS)
+            {
+                prvBrokerQueueAck(Conn, 0x50, &Data[Pos - 2]);
+            }
+            Broker->Received++;
+            prvBrokerForward(Broker, &Data[2], TopicLength, QoS, &Data[Pos], Length - Pos);
+            break;
+        case 5:     /* PUBREC of a Message forwarded */
+            if(2 <= Length)
+            {
+                prvBrokerQueueAck(Conn, 0x62, Data);
+            }
+            break;
+        case 6:     /* PUBREL */
+            if(2 <= Length)
+            {
+                prvBrokerQueueAck(Conn, 0x70, Data);
+            }
+            break;
+        case 8:     /* SUBSCRIBE */
+            prvBrokerSubscribe(Conn, Data, Length);
+            break;
+        case 10:    /* UNSUBSCRIBE */
+            prvBrokerUnsubscribe(Conn, Data, Length);
+            break;
+        case 12:    /* PINGREQ */
+            prvBrokerQueue(Conn, 0xD0, NULL, 0, NULL, 0);
+            break;
+        case 14:    /* DISCONNECT */
+            Conn->Closed = true;
+            break;
+        default:    /* PUBACK PUBCOMP of a Message forwarded */
+            break;
+    }
+    return;
+}
+
+/**
+ * @brief               Read a connection and process all complete packets
+ * @param[in,out]       Broker              Broker
+ * @param[in,out]       Conn                Connection
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void prvBrokerRead(S_BROKER* Broker, S_BROKER_CONN* Conn)
+{
+    ssize_t     Ret         =   0;
+    size_t      Pos         =   0;
+    size_t      Remain      =   0;
+    size_t      HeadLength  =   0;
+    uint32_t    Shift       =   0;
+    bool        Complete    =   false;
+
+    for(;;)
+    {
+        if(0 != prvBrokerReserve(&Conn->InData, &Conn->InSize, Conn->InLength + D_BROKER_READ_SIZE))
+        {
+            Conn->Closed = true;
+            return;
+        }
+        Ret = recv(Conn->Fd, Conn->InData + Conn->InLength, D_BROKER_READ_SIZE, MSG_DONTWAIT);
+        if(0 < Ret)
+        {
+            Conn->InLength += (size_t)Ret;
+            continue;
+        }
+        if((0 == Ret) || ((EAGAIN != errno) && (EWOULDBLOCK != errno) && (EINTR != errno)))
+        {
+            Conn->Closed = true;
+        }
+        break;
+    }
+
+    while((!Conn->Closed) && (Pos + 2 <= Conn->InLength))
+    {
+        Remain      =   0;
+        Shift       =   0;
+        HeadLength  =   1;
+        Complete    =   false;
+        while(Pos + HeadLength < Conn->InLength)
+        {
+            Remain |= (size_t)(Conn->InData[Pos + HeadLength] & 0x7F) << Shift;
+            Shift  += 7;
+            if(0 == (Conn->InData[Pos + HeadLength++] & 0x80))
+            {
+                Complete = true;
+                break;
+            }
+            if(5 <= HeadLength)
+            {
+                Conn->Closed = true;
+                break;
+            }
+        }
+        if((!Complete) || (Pos + HeadLength + Remain > Conn->InLength))
+        {
+            break;
+        }
+        prvBrokerPacket(Broker, Conn, Conn->InData[Pos], Conn->InData + Pos + HeadLength, Remain);
+        Pos += HeadLength + Remain;
+    }
+    if(Pos)
+    {
+        memmove(Conn->InData, Conn->InData + Pos, Conn->InLength - Pos);
+        Conn->InLength -= Pos;
+    }
+    return;
+}
+
+/**
+ * @brief               Thread of the broker
+ * @param[in,out]       Arg                 Broker
+ * @return              NULL
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void* prvBrokerThread(void* Arg)
+{
+    S_BROKER*       Broker  =   (S_BROKER*)Arg;
+    struct pollfd*  Fds     =   NULL;
+    uint32_t        Num     =   0;
+    uint32_t        Index   =   0;
+    int             Ret     =   0;
+
+    Fds = (struct pollfd*)calloc(Broker->ConnMax, sizeof(struct pollfd));
+    if(NULL == Fds)
+    {
+        printf(" failed\n  ! calloc() broker poll table\n\n");
+        return NULL;
+    }
+    while(__atomic_load_n(&Broker->Running, __ATOMIC_ACQUIRE))
+    {
+        pthread_mutex_lock(&Broker->Mutex);
+        Num = Broker->ConnNum;
+        for(Index = 0; Index < Num; Index++)
+        {
+            Fds[Index].fd       =   (Broker->Conn[Index].Closed)?(-1):(Broker->Conn[Index].Fd);
+            Fds[Index].events   =   (Broker->Conn[Index].OutLength)?(POLLIN | POLLOUT):(POLLIN);
+            Fds[Index].revents  =   0;
+        }
+        pthread_mutex_unlock(&Broker->Mutex);
+
+        Ret = poll(Fds, Num, D_BROKER_POLL_INTERVAL);
+        if(0 > Ret)
+        {
+            if(EINTR == errno)
+            {
+                continue;
+            }
+            printf(" failed\n  ! poll() errno %d\n\n", errno);
+            break;
+        }
+
+        pthread_mutex_lock(&Broker->Mutex);
+        for(Index = 0; Index < Num; Index++)
+        {
+            if(Fds[Index].revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                prvBrokerRead(Broker, &Broker->Conn[Index]);
+            }
+        }
+        /* The Messages forwarded are queued on the other connections, so flush all after reading */
+        for(Index = 0; Index < Num; Index++)
+        {
+            if(Broker->Conn[Index].OutLength)
+            {
+                prvBrokerFlush(&Broker->Conn[Index]);
+            }
+        }
+        pthread_mutex_unlock(&Broker->Mutex);
+    }
+    free(Fds);
+    return NULL;
+}
+
+/**
+ * @brief               Start the thread of a broker
+ * @param[in,out]       Broker              Broker
+ * @param[in]           ConnMax             Max number of the clients
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int32_t broker_start(S_BROKER* Broker, uint32_t ConnMax)
+{
+    memset(Broker, 0, sizeof(S_BROKER));
+    Broker->Conn = (S_BROKER_CONN*)calloc(ConnMax, sizeof(S_BROKER_CONN));
+    if(NULL == Broker->Conn)
+    {
+        return -1;
+    }
+    Broker->ConnMax = ConnMax;
+    Broker->Running = 1;
+    pthread_mutex_init(&Broker->Mutex, NULL);
+    if(0 != pthread_create(&Broker->Thread, NULL, prvBrokerThread, Broker))
+    {
+        pthread_mutex_destroy(&Broker->Mutex);
+        free(Broker->Conn);
+        Broker->Conn = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief               Stop the thread of a broker and close all connections
+ * @param[in,out]       Broker              Broker
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+void broker_stop(S_BROKER* Broker)
+{
+    uint32_t    Index   =   0;
+
+    if(NULL == Broker->Conn)
+    {
+        return;
+    }
+    __atomic_store_n(&Broker->Running, 0, __ATOMIC_RELEASE);
+    pthread_join(Broker->Thread, NULL);
+    for(Index = 0; Index < Broker->ConnNum; Index++)
+    {
+        close(Broker->Conn[Index].Fd);
+        free(Broker->Conn[Index].InData);
+        free(Broker->Conn[Index].OutData);
+    }
+    pthread_mutex_destroy(&Broker->Mutex);
+    free(Broker->Conn);
+    Broker->Conn = NULL;
+    return;
+}
+
+/**
+ * @brief               Create the connection of a new client
+ * @param[in,out]       Broker              Broker
+ * @param[out]          ClientFd            Client side of the socketpair (blocking, closed by the client)
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int32_t broker_connect(S_BROKER* Broker, int* ClientFd)
+{
+    int     Fds[2]  =   {-1, -1};
+    int32_t Ret     =   -1;
+
+    pthread_mutex_lock(&Broker->Mutex);
+    if(Broker->ConnNum < Broker->ConnMax)
+    {
+        if(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, Fds))
+        {
+            fcntl(Fds[0], F_SETFL, fcntl(Fds[0], F_GETFL) | O_NONBLOCK);
+            memset(&Broker->Conn[Broker->ConnNum], 0, sizeof(S_BROKER_CONN));
+            Broker->Conn[Broker->ConnNum].Fd = Fds[0];
+            Broker->ConnNum++;
+            *ClientFd   =   Fds[1];
+            Ret         =   0;
+        }
+    }
+    pthread_mutex_unlock(&Broker->Mutex);
+    return Ret;
+}
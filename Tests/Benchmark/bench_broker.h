@@ -0,0 +1,147 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_broker.h
+ * @brief       In-process MQTT 3.1.1 broker stand-in for the benchmarks Header
+ * @details     The broker serves the clients over socketpair() by one thread, so the end-to-end benchmarks run
+ *              offline and do not depend on an external broker or the network. \n
+ *              Only what the benchmarks need is implemented : CONNECT/CONNACK, SUBSCRIBE/UNSUBSCRIBE with the
+ *              wildcards, PINGREQ, DISCONNECT, and the QoS0/1/2 flows of PUBLISH. A PUBLISH Message is forwarded
+ *              to the matched clients as soon as it is received (with the lower QoS of the Message and the
+ *              subscription), and nothing is kept for the clients which are not connected. \n
+ *              The broker side of the sockets is non-blocking and buffers the data to send, so it never waits
+ *              for a client which does not read.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+#ifndef __BENCH_BROKER_H__
+#define __BENCH_BROKER_H__
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BROKER_SUB_MAX            (8)         /*!< Max number of the Topic Filters of one client */
+#define D_BROKER_FILTER_SIZE        (64)        /*!< Max length of a Topic Filter */
+#define D_BROKER_READ_SIZE          (16384)     /*!< Size to read the socket at once */
+#define D_BROKER_POLL_INTERVAL      (10)        /*!< Interval with millisecond to check the new clients and the stop */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Subscription of a client
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BROKER_SUB
+{
+    char                    Filter[D_BROKER_FILTER_SIZE];   /*!< Topic Filter */
+    uint16_t                Length;                         /*!< Length of the Topic Filter */
+    uint8_t                 QoS;                            /*!< Maximum QoS granted */
+}S_BROKER_SUB;
+
+/**
+ * @brief      Connection of a client
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BROKER_CONN
+{
+    int                     Fd;                 /*!< Broker side of the socketpair */
+    bool                    Closed;             /*!< The connection is closed (DISCONNECT, error or closed by the client) */
+    uint8_t*                InData;             /*!< Data received and not processed yet */
+    size_t                  InLength;           /*!< Length of the data received */
+    size_t                  InSize;             /*!< Size of the receive buffer */
+    uint8_t*                OutData;            /*!< Data waiting to be sent */
+    size_t                  OutLength;          /*!< Length of the data waiting */
+    size_t                  OutSize;            /*!< Size of the send buffer */
+    S_BROKER_SUB            Sub[D_BROKER_SUB_MAX];  /*!< Subscriptions */
+    uint32_t                SubNum;             /*!< Number of the subscriptions */
+    uint16_t                PacketIdentifier;   /*!< Last Packet Identifier of the Messages forwarded */
+}S_BROKER_CONN;
+
+/**
+ * @brief      Broker stand-in
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BROKER
+{
+    pthread_t               Thread;             /*!< Thread which serves all clients */
+    pthread_mutex_t         Mutex;              /*!< Lock of the connection table */
+    int                     Running;            /*!< The thread keeps running */
+    S_BROKER_CONN*          Conn;               /*!< Connection table */
+    uint32_t                ConnNum;            /*!< Number of the connections */
+    uint32_t                ConnMax;            /*!< Size of the connection table */
+    uint64_t                Received;           /*!< PUBLISH Messages received */
+    uint64_t                Forwarded;          /*!< PUBLISH Messages forwarded */
+}S_BROKER;
+
+/**************************************************************
+**  Interface
+**************************************************************/
+
+/**
+ * @brief               Start the thread of a broker
+ * @param[in,out]       Broker              Broker
+ * @param[in]           ConnMax             Max number of the clients
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t broker_start(S_BROKER* Broker, uint32_t ConnMax);
+
+/**
+ * @brief               Stop the thread of a broker and close all connections
+ * @param[in,out]       Broker              Broker
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern void broker_stop(S_BROKER* Broker);
+
+/**
+ * @brief               Create the connection of a new client
+ * @param[in,out]       Broker              Broker
+ * @param[out]          ClientFd            Client side of the socketpair (blocking, closed by the client)
+ * @retval              0 for successful
+ * @retval              -1 for fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+extern int32_t broker_connect(S_BROKER* Broker, int* ClientFd);
+
+#endif /* __BENCH_BROKER_H__ */
@@ -0,0 +1,450 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_codec.c
+ * @brief       Micro benchmark of the built-in LZ payload codec.
+ *              The throughput of the compression and the decompression is measured against the ratio
+ *              for the JSON telemetry of some sizes and for the data which does not compress, with and
+ *              without the preset dictionary. The publish case measures MQC_Publish (QoS0) of the small
+ *              telemetry with and without the codec of the Topic Filter. The forged case reads the PUBLISH
+ *              Messages whose LZ header tells a 4 GB payload, they must be discarded without allocating for it.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_TOPIC           "bench/codec/json"  /*!< Topic of the PUBLISH Message */
+#define D_BENCH_SAMPLE_NUM      (64)                /*!< Payloads used in turn, so each message differs from the last one */
+#define D_BENCH_PAYLOAD_MAX     (4096)              /*!< Maximum size of the payload */
+#define D_BENCH_FORGED_SIZE     (0xFFFFFFFFu)       /*!< Size of the payload told by the forged LZ header */
+
+#if defined (MQC_PAYLOAD_CODEC) && defined (CLIB_LZ_MODULE_ENABLED)
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the codec benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_CODEC_CTX
+{
+    uint8_t                 Sample[D_BENCH_SAMPLE_NUM][D_BENCH_PAYLOAD_MAX];
+    size_t                  SampleSize[D_BENCH_SAMPLE_NUM];
+    uint8_t                 Packed[D_BENCH_SAMPLE_NUM][CLIB_LZ_BOUND(D_BENCH_PAYLOAD_MAX)];
+    size_t                  PackedSize[D_BENCH_SAMPLE_NUM];
+    uint8_t                 Output[CLIB_LZ_BOUND(D_BENCH_PAYLOAD_MAX)];
+    S_MQC_CODEC_DICT*       Dict;
+    uint64_t                RawBytes;
+    uint64_t                PackedBytes;
+    S_MQC_SESSION_HANDLE    Handler;
+    uint64_t                WriteBytes;
+    size_t                  MallocMax;
+    uint8_t                 Sink;
+}S_BENCH_CODEC_CTX;
+
+/**************************************************************
+**  Global Param
+**************************************************************/
+
+static S_BENCH_CODEC_CTX    g_BenchCtx;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Make a JSON telemetry payload
+ * @param[out]          Data                    Payload
+ * @param[in]           Size                    Size of the payload wanted (the records are added until it is reached)
+ * @param[in]           Seed                    Seed of the values
+ * @return              Size of the payload
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static size_t bench_json_make(uint8_t* Data, size_t Size, uint32_t Seed)
+{
+    size_t      Length  =   0;
+    uint32_t    Record  =   0;
+
+    Length = (size_t)snprintf((char*)Data, Size, "[");
+    while(Length + 160 < Size)
+    {
+        Seed = Seed * 1103515245u + 12345u;
+        Length += (size_t)snprintf((char*)Data + Length, Size - Length,
+                                   "%s{\"device\":\"sensor-%04u\",\"seq\":%u,\"temperature\":%u.%02u,"
+                                   "\"humidity\":%u.%u,\"battery\":%u,\"status\":\"%s\"}",
+                                   (Record)?(","):(""), (Seed >> 8) % 10000, Record, 15 + (Seed >> 4) % 15, (Seed >> 12) % 100,
+                                   30 + (Seed >> 16) % 40, (Seed >> 20) % 10, 50 + (Seed >> 24) % 50,
+                                   ((Seed >> 28) & 1)?("ok"):("warn"));
+        Record++;
+    }
+    Length += (size_t)snprintf((char*)Data + Length, Size - Length, "]");
+    return Length;
+}
+
+/**
+ * @brief               Make the payloads of a case
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Size                    Size of the payload
+ * @param[in]           Json                    JSON telemetry (otherwise random bytes which do not compress)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_sample_make(S_BENCH_CODEC_CTX* BenchCtx, size_t Size, bool Json)
+{
+    uint32_t    Seed    =   1;
+    uint32_t    i       =   0;
+    size_t      j       =   0;
+
+    for(i = 0; i < D_BENCH_SAMPLE_NUM; i++)
+    {
+        if(Json)
+        {
+            BenchCtx->SampleSize[i] = bench_json_make(BenchCtx->Sample[i], Size, i + 1);
+            continue;
+        }
+        for(j = 0; j < Size; j++)
+        {
+            Seed = Seed * 1103515245u + 12345u;
+            BenchCtx->Sample[i][j] = (uint8_t)(Seed >> 16);
+        }
+        BenchCtx->SampleSize[i] = Size;
+    }
+}
+
+/**
+ * @brief               Compress some payloads
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the payloads
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_compress(void* Ctx, uint32_t Count)
+{
+    S_BENCH_CODEC_CTX*  BenchCtx    =   (S_BENCH_CODEC_CTX*)Ctx;
+    uint32_t            Index       =   0;
+    uint32_t            i           =   0;
+
+    BenchCtx->RawBytes = 0;
+    BenchCtx->PackedBytes = 0;
+    for(i = 0; i < Count; i++)
+    {
+        Index = i % D_BENCH_SAMPLE_NUM;
+        BenchCtx->PackedSize[Index] = sizeof(BenchCtx->Packed[Index]);
+        if(CLIB_lz_compress( (BenchCtx->Dict)?(BenchCtx->Dict->Data):(NULL), (BenchCtx->Dict)?(BenchCtx->Dict->Size):(0),
+                             BenchCtx->Sample[Index], BenchCtx->SampleSize[Index],
+                             BenchCtx->Packed[Index], &(BenchCtx->PackedSize[Index]) ))
+        {
+            printf("CLIB_lz_compress failed\n");
+            exit(1);
+        }
+        BenchCtx->RawBytes += BenchCtx->SampleSize[Index];
+        BenchCtx->PackedBytes += BenchCtx->PackedSize[Index];
+    }
+}
+
+/**
+ * @brief               Decompress some payloads compressed by bench_compress
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the payloads
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_decompress(void* Ctx, uint32_t Count)
+{
+    S_BENCH_CODEC_CTX*  BenchCtx    =   (S_BENCH_CODEC_CTX*)Ctx;
+    uint32_t            Index       =   0;
+    uint32_t            i           =   0;
+    size_t              Size        =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        Index = i % D_BENCH_SAMPLE_NUM;
+        Size = sizeof(BenchCtx->Output);
+        if( CLIB_lz_decompress( (BenchCtx->Dict)?(BenchCtx->Dict->Data):(NULL), (BenchCtx->Dict)?(BenchCtx->Dict->Size):(0),
+                                BenchCtx->Packed[Index], BenchCtx->PackedSize[Index], BenchCtx->Output, &Size ) ||
+            (Size != BenchCtx->SampleSize[Index]) )
+        {
+            printf("CLIB_lz_decompress failed\n");
+            exit(1);
+        }
+        BenchCtx->Sink ^= BenchCtx->Output[Size - 1];
+    }
+}
+
+/**
+ * @brief               Measure the compression and the decompression of a case
+ * @param[in]           Name                    Name of the case
+ * @param[in]           Size                    Size of the payload
+ * @param[in]           Json                    JSON telemetry (otherwise random bytes)
+ * @param[in]           Dict                    Preset dictionary (NULL means none)
+ * @param[in]           Count                   Operation count of one round
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_codec_case(const char* Name, size_t Size, bool Json, S_MQC_CODEC_DICT* Dict, uint32_t Count)
+{
+    S_BENCH_CODEC_CTX*  BenchCtx    =   &g_BenchCtx;
+    S_BENCH_RESULT      Result;
+    uint64_t            RawBytes    =   0;
+    char                Label[64];
+
+    bench_sample_make(BenchCtx, Size, Json);
+    BenchCtx->Dict = Dict;
+
+    Result = Bench_Run(BenchCtx, bench_compress, Count, D_BENCH_DEFAULT_ROUNDS);
+    RawBytes = BenchCtx->RawBytes;
+    snprintf(Label, sizeof(Label), "codec/%s/compress", Name);
+    Bench_Print(Label, Result);
+    printf("%-32s %12.2f ratio %12.1f MB/s\n", "", (double)BenchCtx->RawBytes / (double)BenchCtx->PackedBytes,
+           (double)RawBytes / Count * 1000.0 / Result.NsPerOp);
+
+    Result = Bench_Run(BenchCtx, bench_decompress, Count, D_BENCH_DEFAULT_ROUNDS);
+    snprintf(Label, sizeof(Label), "codec/%s/decompress", Name);
+    Bench_Print(Label, Result);
+    printf("%-32s %12s       %12.1f MB/s\n", "", "", (double)RawBytes / Count * 1000.0 / Result.NsPerOp);
+}
+
+/**
+ * @brief               Write callback which counts the bytes
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_write_callback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    S_BENCH_CODEC_CTX*  BenchCtx    =   (S_BENCH_CODEC_CTX*)Ctx;
+
+    BenchCtx->WriteBytes += Size;
+    BenchCtx->Sink ^= Data[Size - 1];
+    return 0;
+}
+
+/**
+ * @brief               Malloc callback which keeps the largest size asked
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void* bench_malloc(size_t Size)
+{
+    if(Size > g_BenchCtx.MallocMax)
+    {
+        g_BenchCtx.MallocMax = Size;
+    }
+    return malloc(Size);
+}
+
+/**
+ * @brief               Open a session with the CONNACK given
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_session_open(S_BENCH_CODEC_CTX* BenchCtx)
+{
+    Bench_SessionInit(&BenchCtx->Handler, BenchCtx, bench_write_callback);
+    BenchCtx->Handler.MallocFunc            = bench_malloc;
+    Bench_SessionStart(&BenchCtx->Handler);
+    Bench_SessionConnect(&BenchCtx->Handler);
+}
+
+/**
+ * @brief               Publish some QoS0 messages
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the messages
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_publish(void* Ctx, uint32_t Count)
+{
+    S_BENCH_CODEC_CTX*  BenchCtx    =   (S_BENCH_CODEC_CTX*)Ctx;
+    S_MQC_MESSAGE_INFO  Message;
+    uint32_t            Index       =   0;
+    uint32_t            i           =   0;
+
+    BenchCtx->WriteBytes = 0;
+    Message.Topic.Data      = (uint8_t*)D_BENCH_TOPIC;
+    Message.Topic.Length    = strlen(D_BENCH_TOPIC);
+    for(i = 0; i < Count; i++)
+    {
+        Index = i % D_BENCH_SAMPLE_NUM;
+        Message.Content = BenchCtx->Sample[Index];
+        Message.Length  = (uint32_t)BenchCtx->SampleSize[Index];
+        if(MQC_Publish(&BenchCtx->Handler, &Message, E_MQC_QOS_0, false, NULL))
+        {
+            printf("MQC_Publish failed\n");
+            exit(1);
+        }
+    }
+}
+
+/**
+ * @brief               Measure MQC_Publish of the small telemetry with and without the codec
+ * @param[in]           Name                    Name of the case
+ * @param[in]           Dict                    Preset dictionary
+ * @param[in]           Codec                   Set the codec of the Topic
+ * @param[in]           Count                   Operation count of one round
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_publish_case(const char* Name, S_MQC_CODEC_DICT* Dict, bool Codec, uint32_t Count)
+{
+    S_BENCH_CODEC_CTX*  BenchCtx    =   &g_BenchCtx;
+    S_MQC_UTF8_DATA     TopicFilter =   { (uint8_t*)"bench/codec/#", (uint16_t)strlen("bench/codec/#") };
+    S_MQC_CODEC         LzCodec;
+    char                Label[64];
+
+    bench_sample_make(BenchCtx, 256, true);
+    bench_session_open(BenchCtx);
+    if( Codec && ( MQC_CodecLz(&LzCodec, Dict) || MQC_CodecSet(&BenchCtx->Handler, &TopicFilter, &LzCodec) ) )
+    {
+        printf("Failed to set the codec\n");
+        exit(1);
+    }
+    snprintf(Label, sizeof(Label), "codec/publish/%s", Name);
+    Bench_Print(Label, Bench_Run(BenchCtx, bench_publish, Count, D_BENCH_DEFAULT_ROUNDS));
+    printf("%-32s %12.1f bytes/msg\n", "", (double)BenchCtx->WriteBytes / Count);
+    MQC_Stop(&BenchCtx->Handler);
+}
+
+/**
+ * @brief               Read some PUBLISH Messages with the forged LZ header
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the messages
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_forged(void* Ctx, uint32_t Count)
+{
+    S_BENCH_CODEC_CTX*  BenchCtx    =   (S_BENCH_CODEC_CTX*)Ctx;
+    uint8_t             Packet[64];
+    size_t              Length      =   0;
+    uint32_t            i           =   0;
+
+    /* QoS0 PUBLISH : Topic Name, D_MQC_CODEC_FORMAT_ENCODED and the LZ header of D_BENCH_FORGED_SIZE */
+    Packet[Length++] = (E_MQC_MSG_PUBLISH << 4);
+    Packet[Length++] = 0;
+    Packet[Length++] = 0;
+    Packet[Length++] = (uint8_t)strlen(D_BENCH_TOPIC);
+    memcpy(Packet + Length, D_BENCH_TOPIC, strlen(D_BENCH_TOPIC));
+    Length += strlen(D_BENCH_TOPIC);
+    Packet[Length++] = 0x01;
+    Packet[Length++] = 0xFF;
+    Packet[Length++] = 0xFF;
+    Packet[Length++] = 0xFF;
+    Packet[Length++] = 0xFF;
+    Packet[Length++] = 0x0F;
+    Packet[Length++] = 0x00;
+    Packet[1] = (uint8_t)(Length - 2);
+
+    for(i = 0; i < Count; i++)
+    {
+        if(MQC_Read(&BenchCtx->Handler, Packet, Length))
+        {
+            printf("MQC_Read failed\n");
+            exit(1);
+        }
+    }
+}
+
+/**
+ * @brief               Measure the forged PUBLISH Messages discarded by the decode size check
+ * @param[in]           Count                   Operation count of one round
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_forged_case(uint32_t Count)
+{
+    S_BENCH_CODEC_CTX*  BenchCtx    =   &g_BenchCtx;
+    S_MQC_UTF8_DATA     TopicFilter =   { (uint8_t*)"bench/codec/#", (uint16_t)strlen("bench/codec/#") };
+    S_MQC_CODEC         LzCodec;
+    S_MQC_STATISTICS    Statistics;
+
+    bench_session_open(BenchCtx);
+    if( MQC_CodecLz(&LzCodec, NULL) || MQC_CodecSet(&BenchCtx->Handler, &TopicFilter, &LzCodec) )
+    {
+        printf("Failed to set the codec\n");
+        exit(1);
+    }
+    BenchCtx->MallocMax = 0;
+    Bench_Print("codec/decode/forged", Bench_Run(BenchCtx, bench_forged, Count, D_BENCH_DEFAULT_ROUNDS));
+    memset(&Statistics, 0, sizeof(Statistics));
+    (void)MQC_Statistics(&BenchCtx->Handler, &Statistics);
+    printf("%-32s %12u discarded %12zu bytes max malloc\n", "", Statistics.CodecDecodeErrorCount, BenchCtx->MallocMax);
+    if( Statistics.CodecDecodeCount || !Statistics.CodecDecodeErrorCount || (BenchCtx->MallocMax >= D_BENCH_FORGED_SIZE / 2) )
+    {
+        printf("The forged payload was not discarded\n");
+        exit(1);
+    }
+    MQC_Stop(&BenchCtx->Handler);
+}
+
+/**
+ * @brief               Main function of the codec benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    static uint8_t      Dictionary[D_BENCH_PAYLOAD_MAX];
+    S_MQC_CODEC_DICT    Dict;
+
+    /* The dictionary is a telemetry with the other values */
+    Dict.Data = Dictionary;
+    Dict.Size = bench_json_make(Dictionary, 512, 0x12345678);
+
+    bench_codec_case("json-128", 200, true, NULL, 200000);
+    bench_codec_case("json-128-dict", 200, true, &Dict, 200000);
+    bench_codec_case("json-512", 512, true, NULL, 100000);
+    bench_codec_case("json-512-dict", 512, true, &Dict, 100000);
+    bench_codec_case("json-4k", 4096, true, NULL, 20000);
+    bench_codec_case("json-4k-dict", 4096, true, &Dict, 20000);
+    bench_codec_case("random-4k", 4096, false, NULL, 20000);
+    bench_publish_case("none", NULL, false, 200000);
+    bench_publish_case("lz", NULL, true, 200000);
+    bench_publish_case("lz-dict", &Dict, true, 200000);
+    bench_forged_case(200000);
+    return (g_BenchCtx.Sink == 0xFF)?(1):(0);
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    printf("MQC_PAYLOAD_CODEC or CLIB_LZ_MODULE_ENABLED is not defined\n");
+    return 0;
+}
+
+#endif /* MQC_PAYLOAD_CODEC && CLIB_LZ_MODULE_ENABLED */
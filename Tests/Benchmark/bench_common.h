@@ -0,0 +1,265 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_common.h
+ * @brief       Common helper of the MQTT Client Library micro benchmarks.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+#ifndef __BENCH_COMMON_H__
+#define __BENCH_COMMON_H__
+
+#if !defined(PLATFORM_LINUX)
+#error The benchmarks can only be built for PLATFORM_LINUX
+#endif
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L     /* clock_gettime() */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "MQC_api.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_DEFAULT_ROUNDS  (5)     /*!< Measure rounds of each case, the best one is reported */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Result of one benchmark case
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_RESULT
+{
+    double                  NsPerOp;
+    /*!< Wall clock time of one operation (in nanosecond) */
+
+    double                  CyclesPerOp;
+    /*!< Time stamp counter ticks of one operation (0 if not supported) */
+}S_BENCH_RESULT;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Get the monotonic time
+ * @return              Time with nanosecond
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline uint64_t Bench_NowNs(void)
+{
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (uint64_t)Now.tv_sec * 1000000000ull + (uint64_t)Now.tv_nsec;
+}
+
+/**
+ * @brief               Get the time stamp counter of the CPU
+ * @return              Time stamp counter (always 0 if not supported)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline uint64_t Bench_NowCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief               Run a benchmark case and keep the best round
+ * @param[in]           Ctx                     User context of the case
+ * @param[in]           Function                Function do \a Count operations
+ * @param[in]           Count                   Operation count of one round
+ * @param[in]           Rounds                  Measure rounds
+ * @return              Result of the best round
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline S_BENCH_RESULT Bench_Run(void* Ctx, void (*Function)(void* Ctx, uint32_t Count), uint32_t Count, uint32_t Rounds)
+{
+    S_BENCH_RESULT  Best        =   { 0, 0 };
+    uint64_t        StartNs     =   0;
+    uint64_t        StartCycles =   0;
+    double          NsPerOp     =   0;
+    double          CyclesPerOp =   0;
+    uint32_t        i           =   0;
+
+    /* warm up the cache and the allocator */
+    Function(Ctx, Count / 10 + 1);
+    for(i = 0; i < Rounds; i++)
+    {
+        StartNs     = Bench_NowNs();
+        StartCycles = Bench_NowCycles();
+        Function(Ctx, Count);
+        CyclesPerOp = (double)(Bench_NowCycles() - StartCycles) / Count;
+        NsPerOp     = (double)(Bench_NowNs() - StartNs) / Count;
+        if( (0 == i) || (NsPerOp < Best.NsPerOp) )
+        {
+            Best.NsPerOp        = NsPerOp;
+            Best.CyclesPerOp    = CyclesPerOp;
+        }
+    }
+    return Best;
+}
+
+/**
+ * @brief               Print the result of a benchmark case
+ * @param[in]           Name                    Name of the case
+ * @param[in]           Result                  Result of the case
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline void Bench_Print(const char* Name, S_BENCH_RESULT Result)
+{
+    printf("%-32s %12.1f ns/op %12.1f cycles/op\n", Name, Result.NsPerOp, Result.CyclesPerOp);
+}
+
+/**
+ * @brief               Write callback of the benchmarks (drops the data)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline int32_t Bench_WriteCallback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    return 0;
+}
+
+/**
+ * @brief               Open/Reset callback of the benchmarks (nothing to do)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline int32_t Bench_OpenCallback(void* Ctx, E_MQC_BEHAVIOR_RESULT Result, uint8_t SrvResCode, bool SessionPresent)
+{
+    return 0;
+}
+
+/**
+ * @brief               Read callback of the benchmarks (nothing to do)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline int32_t Bench_ReadCallback(void* Ctx, E_MQC_MSG_TYPE Type, S_MQC_MESSAGE_INFO* Info)
+{
+    return 0;
+}
+
+/**
+ * @brief               Fill the session handle of a benchmark
+ * @param[out]          Handler                 Session handle
+ * @param[in]           UsrCtx                  Context of the callbacks
+ * @param[in]           WriteFuncCB             Write callback of the benchmark
+ * @note                The session is a clean one with malloc/free and the callbacks of this file, the benchmark 
+ *                      may change any of them before Bench_SessionStart.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline void Bench_SessionInit(S_MQC_SESSION_HANDLE* Handler, void* UsrCtx, int32_t (*WriteFuncCB)(void* Ctx, const uint8_t* Data, size_t Size))
+{
+    memset(Handler, 0, sizeof(S_MQC_SESSION_HANDLE));
+    Handler->UsrCtx                 = UsrCtx;
+    Handler->ClientId.Data          = (uint8_t*)"bench_client";
+    Handler->ClientId.Length        = strlen("bench_client");
+    Handler->CleanSession           = true;
+    Handler->KeepAliveInterval      = 60;
+    Handler->MessageRetryInterval   = 10;
+    Handler->MessageRetryCount      = 3;
+    Handler->MallocFunc             = malloc;
+    Handler->FreeFunc               = free;
+    Handler->WriteFuncCB            = WriteFuncCB;
+    Handler->ReadFuncCB             = Bench_ReadCallback;
+    Handler->OpenResetFuncCB        = Bench_OpenCallback;
+}
+
+/**
+ * @brief               Start the session filled by Bench_SessionInit (exit if failed)
+ * @param[in,out]       Handler                 Session handle
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline void Bench_SessionStart(S_MQC_SESSION_HANDLE* Handler)
+{
+    if(MQC_Start(Handler, 0))
+    {
+        printf("Failed to start the session\n");
+        exit(1);
+    }
+}
+
+/**
+ * @brief               Connect the started session by the synthetic CONNACK (exit if failed)
+ * @param[in,out]       Handler                 Session handle
+ * @note                The CONNACK tells the session is present if it is not a clean one.
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline void Bench_SessionConnect(S_MQC_SESSION_HANDLE* Handler)
+{
+    uint8_t     Connack[4]  =   { (E_MQC_MSG_CONNACK << 4), 2, 0, 0 };
+
+    Connack[2] = (Handler->CleanSession)?(0):(1);
+    if( MQC_Open(Handler, 10000) || MQC_Read(Handler, Connack, sizeof(Connack)) )
+    {
+        printf("Failed to open the session\n");
+        exit(1);
+    }
+}
+
+/**
+ * @brief               Fill, start and connect the session of a benchmark (exit if failed)
+ * @param[out]          Handler                 Session handle
+ * @param[in]           UsrCtx                  Context of the callbacks
+ * @param[in]           WriteFuncCB             Write callback of the benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline void Bench_SessionOpen(S_MQC_SESSION_HANDLE* Handler, void* UsrCtx, int32_t (*WriteFuncCB)(void* Ctx, const uint8_t* Data, size_t Size))
+{
+    Bench_SessionInit(Handler, UsrCtx, WriteFuncCB);
+    Bench_SessionStart(Handler);
+    Bench_SessionConnect(Handler);
+}
+
+#endif /* __BENCH_COMMON_H__ */
@@ -0,0 +1,1132 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_core.c
+ * @brief       Micro benchmark of the Message encoders and decoders of MQC_core.c.
+ *              MQC_core.c is included into this file, so its static functions are called directly against the
+ *              synthetic buffers : the Remaining Length codec, every prvMQC_*MessageEncode and every
+ *              prvMQC_process* handler (the events are notified as MQC_Read does). \n
+ *              The cases which need the Messages in flight (PUBACK, PUBREC, PUBCOMP, SUBACK, ...) prepare a
+ *              batch of them before the measure, and only the handler is timed. \n
+ *              Each case reports ns/op, cycles/op, bytes/s (size of the Message encoded or decoded) and
+ *              allocs/op (calls of MallocFunc, the blocks taken from the pool of the session are not counted).
+ *              The result is printed as text, or as csv/json by the first argument to compare the releases.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+#include "../../MQTTClient/src/src/MQC_core.c"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_TOPIC           "bench/core/telemetry"  /*!< Topic Name of the PUBLISH Message */
+#define D_BENCH_PAYLOAD_MAX     (4096)                  /*!< Maximum size of the payload */
+#define D_BENCH_BATCH           (1000)                  /*!< Messages in flight prepared for one round */
+#define D_BENCH_ROUNDS          (20)                    /*!< Measure rounds of the batch cases */
+#define D_BENCH_FRAME_KEEP      (64)                    /*!< Bytes kept of the last Message written */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the core benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_CORE_CTX
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    /*!< Session connected with the synthetic CONNACK */
+
+    uint32_t                Param;
+    /*!< Parameter of the case (payload size of the PUBLISH Message) */
+
+    uint8_t                 Payload[D_BENCH_PAYLOAD_MAX];
+    /*!< Payload of the PUBLISH Message */
+
+    uint8_t                 Frame[D_BENCH_PAYLOAD_MAX + 64];
+    /*!< Message decoded by the handler (without Fixed Header and Remaining Length) */
+
+    uint32_t                FrameSize;
+    /*!< Size of \a Frame */
+
+    uint8_t                 Ack[D_BENCH_BATCH][2];
+    /*!< Packet Identifiers of the Messages in flight */
+
+    uint8_t                 LastWrite[D_BENCH_FRAME_KEEP];
+    /*!< Head of the last Message written */
+
+    uint64_t                Bytes;
+    /*!< Bytes encoded or decoded in the measure */
+
+    uint8_t                 Sink;
+    /*!< Keep the results used */
+}S_BENCH_CORE_CTX;
+
+/**
+ * @brief      Benchmark case
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_CORE_CASE
+{
+    const char*             Name;
+    /*!< Name of the case */
+
+    void                    (*Prepare)(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count);
+    /*!< Prepare \a Count operations before the measure (can be NULL) */
+
+    void                    (*Run)(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count);
+    /*!< Do \a Count operations (measured) */
+
+    void                    (*Finish)(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count);
+    /*!< Clean up after the measure (can be NULL) */
+
+    uint32_t                Count;
+    /*!< Operation count of one round */
+
+    uint32_t                Param;
+    /*!< Parameter of the case */
+}S_BENCH_CORE_CASE;
+
+/**
+ * @brief      Result of a case
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_CORE_RESULT
+{
+    S_BENCH_RESULT          Time;
+    /*!< Time of one operation */
+
+    double                  BytesPerOp;
+    /*!< Bytes encoded or decoded by one operation */
+
+    double                  AllocsPerOp;
+    /*!< Calls of MallocFunc by one operation */
+}S_BENCH_CORE_RESULT;
+
+/**************************************************************
+**  Global Param
+**************************************************************/
+
+static S_BENCH_CORE_CTX     g_BenchCtx;
+static uint64_t             g_MallocCount       =   0;
+static const uint32_t       g_RemainingLength[] =   { 0, 100, 127, 128, 1000, 16383, 16384, 100000, 2097151, 2097152, 268435455 };
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               malloc which counts the calls
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void* bench_malloc(size_t Size)
+{
+    g_MallocCount++;
+    return malloc(Size);
+}
+
+/**
+ * @brief               Write callback which keeps the head of the Message
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_write_callback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    S_BENCH_CORE_CTX*   BenchCtx    =   (S_BENCH_CORE_CTX*)Ctx;
+
+    memcpy(BenchCtx->LastWrite, Data, (Size < D_BENCH_FRAME_KEEP)?(Size):(D_BENCH_FRAME_KEEP));
+    return 0;
+}
+
+/**
+ * @brief               Read callback which touches the payload
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_read_callback(void* Ctx, E_MQC_MSG_TYPE Type, S_MQC_MESSAGE_INFO* Info)
+{
+    S_BENCH_CORE_CTX*   BenchCtx    =   (S_BENCH_CORE_CTX*)Ctx;
+
+    if(Info && Info->Length)
+    {
+        BenchCtx->Sink ^= Info->Content[Info->Length - 1];
+    }
+    return 0;
+}
+
+/**
+ * @brief               Keep the Packet Identifier of the last Message written
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Index                   Index of the Message in the batch
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_ack_keep(S_BENCH_CORE_CTX* BenchCtx, uint32_t Index)
+{
+    const uint8_t*  Frame   =   BenchCtx->LastWrite;
+    uint32_t        Offset  =   1;
+
+    /* Remaining Length */
+    while(Frame[Offset++] & 0x80);
+    /* Topic Name */
+    if( E_MQC_MSG_PUBLISH == (Frame[0] >> 4) )
+    {
+        Offset = Offset + sizeof(uint16_t) + ((Frame[Offset] << 8) | Frame[Offset + 1]);
+    }
+    BenchCtx->Ack[Index][0] = Frame[Offset];
+    BenchCtx->Ack[Index][1] = Frame[Offset + 1];
+}
+
+/**
+ * @brief               Start a session and connect it by the synthetic CONNACK
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_session_open(S_BENCH_CORE_CTX* BenchCtx)
+{
+    Bench_SessionInit(&BenchCtx->Handler, BenchCtx, bench_write_callback);
+    BenchCtx->Handler.MallocFunc            = bench_malloc;
+    BenchCtx->Handler.ReadFuncCB            = bench_read_callback;
+    Bench_SessionStart(&BenchCtx->Handler);
+    Bench_SessionConnect(&BenchCtx->Handler);
+}
+
+/**
+ * @brief               Check the return value of a function under the measure
+ * @param[in]           Ret                     Return value
+ * @param[in]           Name                    Name of the function
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_check(int32_t Ret, const char* Name)
+{
+    if(D_MQC_RET_OK != Ret)
+    {
+        printf("%s failed (%d)\n", Name, (int)Ret);
+        exit(1);
+    }
+}
+
+/**
+ * @brief               Make the variable header and the payload of a PUBLISH Message
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           QoS                     QoS Level
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_publish_frame(S_BENCH_CORE_CTX* BenchCtx, E_MQC_QOS_LEVEL QoS)
+{
+    uint16_t    TopicLength =   (uint16_t)strlen(D_BENCH_TOPIC);
+    uint8_t*    EndPtr      =   BenchCtx->Frame;
+
+    *EndPtr++ = (uint8_t)(TopicLength >> 8);
+    *EndPtr++ = (uint8_t)(TopicLength);
+    memcpy(EndPtr, D_BENCH_TOPIC, TopicLength);
+    EndPtr = EndPtr + TopicLength;
+    if(E_MQC_QOS_0 != QoS)
+    {
+        *EndPtr++ = 0;
+        *EndPtr++ = 1;
+    }
+    memcpy(EndPtr, BenchCtx->Payload, BenchCtx->Param);
+    EndPtr = EndPtr + BenchCtx->Param;
+    BenchCtx->FrameSize = (uint32_t)(EndPtr - BenchCtx->Frame);
+}
+
+/**
+ * @brief               Get the total size of a Message with its Fixed Header
+ * @param[in]           RemainingLength         Remaining Length of the Message
+ * @return              Total size
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static uint64_t bench_message_size(uint32_t RemainingLength)
+{
+    return 1 + prvMQC_RemainingLengthSize(RemainingLength) + RemainingLength;
+}
+
+/**
+ * @brief               Call a prvMQC_process* handler and notify the events as MQC_Read does
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Handler                 Handler of the Message
+ * @param[in]           FixedHeader             Fixed Header
+ * @param[in]           Data                    Message variable header and payload
+ * @param[in]           DataSize                Message remaining length
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static inline void bench_process(S_BENCH_CORE_CTX* BenchCtx, int32_t (*Handler)(S_MQC_SESSION_HANDLE*, uint8_t, uint8_t*, uint32_t),
+                                 uint8_t FixedHeader, uint8_t* Data, uint32_t DataSize)
+{
+    bench_check(Handler(&BenchCtx->Handler, FixedHeader, Data, DataSize), "prvMQC_process");
+    (void)prvMQC_BatchFlush(&BenchCtx->Handler);
+    prvMQC_CoreUnlock(&BenchCtx->Handler);
+    BenchCtx->Bytes += bench_message_size(DataSize);
+}
+
+/**
+ * @brief               Encode the Remaining Lengths of 1 to 4 bytes by prvMQC_RemainingLengthEncode
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_rl_encode(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint8_t     Buffer[4];
+    uint32_t    Size    =   0;
+    uint32_t    i       =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        Size = prvMQC_RemainingLengthEncode(Buffer, g_RemainingLength[i % (sizeof(g_RemainingLength) / sizeof(uint32_t))]);
+        BenchCtx->Sink ^= Buffer[Size - 1];
+        BenchCtx->Bytes += Size;
+    }
+}
+
+/**
+ * @brief               Decode the Remaining Lengths of 1 to 4 bytes by prvMQC_RemainingLengthDecode
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_rl_decode(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint8_t     Buffer[sizeof(g_RemainingLength) / sizeof(uint32_t)][4];
+    uint32_t    Size[sizeof(g_RemainingLength) / sizeof(uint32_t)];
+    uint32_t    Num     =   sizeof(g_RemainingLength) / sizeof(uint32_t);
+    uint32_t    Value   =   0;
+    uint32_t    i       =   0;
+
+    for(i = 0; i < Num; i++)
+    {
+        Size[i] = prvMQC_RemainingLengthEncode(Buffer[i], g_RemainingLength[i]);
+    }
+    for(i = 0; i < Count; i++)
+    {
+        if(prvMQC_RemainingLengthDecode(Buffer[i % Num], Size[i % Num], &Value))
+        {
+            bench_check(D_MQC_RET_BAD_FORMAT, "prvMQC_RemainingLengthDecode");
+        }
+        BenchCtx->Sink ^= (uint8_t)Value;
+        BenchCtx->Bytes += Size[i % Num];
+    }
+}
+
+/**
+ * @brief               Encode the CONNECT Messages with the Will Message and the authorization
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_connect(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    S_MQC_ENCODE_BUFFER Buffer;
+    S_MQC_WILL_INFO     Will;
+    S_MQC_AUTH_INFO     Auth;
+    uint32_t            i       =   0;
+
+    memset(&Will, 0, sizeof(Will));
+    memset(&Auth, 0, sizeof(Auth));
+    Will.Enable                 = true;
+    Will.QoS                    = E_MQC_QOS_1;
+    Will.Message.Topic.Data     = (uint8_t*)"bench/core/will";
+    Will.Message.Topic.Length   = strlen("bench/core/will");
+    Will.Message.Content        = (uint8_t*)"offline";
+    Will.Message.Length         = strlen("offline");
+    Auth.UsernameEnable         = true;
+    Auth.Username.Data          = (uint8_t*)"bench_user";
+    Auth.Username.Length        = strlen("bench_user");
+    Auth.PasswordEnable         = true;
+    Auth.Password.Data          = (uint8_t*)"bench_password";
+    Auth.Password.Length        = strlen("bench_password");
+    for(i = 0; i < Count; i++)
+    {
+        memset(&Buffer, 0, sizeof(Buffer));
+        bench_check(prvMQC_ConnectMessageEncode(&BenchCtx->Handler, &Buffer, true, &Will, &Auth, 60, &BenchCtx->Handler.ClientId), "prvMQC_ConnectMessageEncode");
+        BenchCtx->Bytes += Buffer.Size;
+        prvMQC_EncodeBufferRelease(&BenchCtx->Handler, &Buffer);
+    }
+}
+
+/**
+ * @brief               Encode the DISCONNECT Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_disconnect(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    S_MQC_ENCODE_BUFFER Buffer;
+    uint32_t            i       =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        memset(&Buffer, 0, sizeof(Buffer));
+        bench_check(prvMQC_DisconnectMessageEncode(&BenchCtx->Handler, &Buffer), "prvMQC_DisconnectMessageEncode");
+        BenchCtx->Bytes += Buffer.Size;
+        prvMQC_EncodeBufferRelease(&BenchCtx->Handler, &Buffer);
+    }
+}
+
+/**
+ * @brief               Encode the SUBSCRIBE Messages of 2 Topic Filters
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_subscribe(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    S_MQC_ENCODE_BUFFER Buffer;
+    S_MQC_UTF8_DATA     TopicFilter[2]  =   { { (uint8_t*)"bench/core/+/telemetry", 22 }, { (uint8_t*)"bench/core/command/#", 20 } };
+    E_MQC_QOS_LEVEL     QoS[2]          =   { E_MQC_QOS_1, E_MQC_QOS_2 };
+    uint32_t            i               =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        memset(&Buffer, 0, sizeof(Buffer));
+        bench_check(prvMQC_SubscribeMessageEncode(&BenchCtx->Handler, &Buffer, (uint16_t)(i + 1), TopicFilter, QoS, 2, NULL), "prvMQC_SubscribeMessageEncode");
+        BenchCtx->Bytes += Buffer.Size;
+        prvMQC_EncodeBufferRelease(&BenchCtx->Handler, &Buffer);
+    }
+}
+
+/**
+ * @brief               Encode the UNSUBSCRIBE Messages of 2 Topic Filters
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_unsubscribe(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    S_MQC_ENCODE_BUFFER Buffer;
+    S_MQC_UTF8_DATA     TopicFilter[2]  =   { { (uint8_t*)"bench/core/+/telemetry", 22 }, { (uint8_t*)"bench/core/command/#", 20 } };
+    uint32_t            i               =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        memset(&Buffer, 0, sizeof(Buffer));
+        bench_check(prvMQC_UnsubscribeMessageEncode(&BenchCtx->Handler, &Buffer, (uint16_t)(i + 1), TopicFilter, 2, NULL), "prvMQC_UnsubscribeMessageEncode");
+        BenchCtx->Bytes += Buffer.Size;
+        prvMQC_EncodeBufferRelease(&BenchCtx->Handler, &Buffer);
+    }
+}
+
+/**
+ * @brief               Encode the QoS1 PUBLISH Messages of Param bytes
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_publish(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    S_MQC_ENCODE_BUFFER Buffer;
+    S_MQC_MESSAGE_INFO  Message;
+    uint32_t            i       =   0;
+
+    Message.Topic.Data      = (uint8_t*)D_BENCH_TOPIC;
+    Message.Topic.Length    = strlen(D_BENCH_TOPIC);
+    Message.Content         = BenchCtx->Payload;
+    Message.Length          = BenchCtx->Param;
+    for(i = 0; i < Count; i++)
+    {
+        memset(&Buffer, 0, sizeof(Buffer));
+        bench_check(prvMQC_PublishMessageEncode(&BenchCtx->Handler, &Buffer, (uint16_t)(i + 1), &Message, false, E_MQC_QOS_1, false, NULL), "prvMQC_PublishMessageEncode");
+        BenchCtx->Bytes += Buffer.Size;
+        prvMQC_EncodeBufferRelease(&BenchCtx->Handler, &Buffer);
+    }
+}
+
+/**
+ * @brief               Encode the QoS0 PUBLISH Messages of Param bytes into segments
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_publish_vec(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint8_t             Header[D_MQC_PUBLISH_VEC_HEADER_SIZE];
+    S_MQC_IOVEC         Vec[D_MQC_PUBLISH_VEC_NUM];
+    S_MQC_MESSAGE_INFO  Message;
+    uint32_t            VecNum  =   0;
+    uint32_t            i       =   0;
+    uint32_t            j       =   0;
+
+    Message.Topic.Data      = (uint8_t*)D_BENCH_TOPIC;
+    Message.Topic.Length    = strlen(D_BENCH_TOPIC);
+    Message.Content         = BenchCtx->Payload;
+    Message.Length          = BenchCtx->Param;
+    for(i = 0; i < Count; i++)
+    {
+        bench_check(prvMQC_PublishMessageEncodeVec(&BenchCtx->Handler, Header, Vec, &VecNum, (E_MQC_MSG_PUBLISH << 4), &Message, 0, 0, false), "prvMQC_PublishMessageEncodeVec");
+        for(j = 0; j < VecNum; j++)
+        {
+            BenchCtx->Bytes += Vec[j].Size;
+        }
+    }
+}
+
+/**
+ * @brief               Encode the acknowledgement Messages into the buffer of the caller
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @param[in]           Encode                  Encoder of the acknowledgement Message
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_ack(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count, int32_t (*Encode)(S_MQC_SESSION_HANDLE*, S_MQC_ENCODE_BUFFER*, uint16_t))
+{
+    S_MQC_ENCODE_BUFFER Buffer;
+    uint8_t             Data[4];
+    uint32_t            i       =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        /* The responses are encoded into the buffer of the caller */
+        Buffer.Data     = Data;
+        Buffer.Size     = sizeof(Data);
+        Buffer.Persist  = false;
+        bench_check(Encode(&BenchCtx->Handler, &Buffer, (uint16_t)(i + 1)), "prvMQC_AckMessageEncode");
+        BenchCtx->Bytes += Buffer.Size;
+    }
+}
+
+/**
+ * @brief               Encode the PUBACK Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_puback(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_encode_ack(BenchCtx, Count, prvMQC_PubackMessageEncode);
+}
+
+/**
+ * @brief               Encode the PUBREC Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_pubrec(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_encode_ack(BenchCtx, Count, prvMQC_PubrecMessageEncode);
+}
+
+/**
+ * @brief               Encode the PUBREL Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_pubrel(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_encode_ack(BenchCtx, Count, prvMQC_PubrelMessageEncode);
+}
+
+/**
+ * @brief               Encode the PUBCOMP Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_pubcomp(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_encode_ack(BenchCtx, Count, prvMQC_PubcompMessageEncode);
+}
+
+/**
+ * @brief               Encode the PINGREQ Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_encode_pingreq(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    S_MQC_ENCODE_BUFFER Buffer;
+    uint32_t            i       =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        memset(&Buffer, 0, sizeof(Buffer));
+        bench_check(prvMQC_PingreqMessageEncode(&BenchCtx->Handler, &Buffer), "prvMQC_PingreqMessageEncode");
+        BenchCtx->Bytes += Buffer.Size;
+        prvMQC_EncodeBufferRelease(&BenchCtx->Handler, &Buffer);
+    }
+}
+
+/**
+ * @brief               Process the CONNACK Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_connack(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint8_t     Data[2]     =   { 0, 0 };
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        /* Back to the status waiting for CONNACK */
+        BenchCtx->Handler.SessionCtx.Status = E_MQC_STATUS_CONNECT;
+        bench_process(BenchCtx, prvMQC_processConnack, (E_MQC_MSG_CONNACK << 4), Data, sizeof(Data));
+    }
+}
+
+/**
+ * @brief               Make the QoS0 PUBLISH Message to process
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_publish_qos0(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_publish_frame(BenchCtx, E_MQC_QOS_0);
+}
+
+/**
+ * @brief               Make the QoS1 PUBLISH Message to process
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_publish_qos1(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_publish_frame(BenchCtx, E_MQC_QOS_1);
+}
+
+/**
+ * @brief               Make the QoS2 PUBLISH Message to process
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_publish_qos2(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_publish_frame(BenchCtx, E_MQC_QOS_2);
+}
+
+/**
+ * @brief               Process the QoS0 PUBLISH Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_publish_qos0(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_process(BenchCtx, prvMQC_processPublish, (E_MQC_MSG_PUBLISH << 4), BenchCtx->Frame, BenchCtx->FrameSize);
+    }
+}
+
+/**
+ * @brief               Process the QoS1 PUBLISH Messages (PUBACK is sent)
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_publish_qos1(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_process(BenchCtx, prvMQC_processPublish, (E_MQC_MSG_PUBLISH << 4) + (E_MQC_QOS_1 << 1), BenchCtx->Frame, BenchCtx->FrameSize);
+    }
+}
+
+/**
+ * @brief               Process the QoS2 PUBLISH Messages of new Packet Identifiers (PUBREC is sent)
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_publish_qos2(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint8_t*    Identifier  =   BenchCtx->Frame + sizeof(uint16_t) + strlen(D_BENCH_TOPIC);
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        /* Each Message waits for its PUBREL with a new Packet Identifier */
+        Identifier[0] = (uint8_t)((i + 1) >> 8);
+        Identifier[1] = (uint8_t)(i + 1);
+        bench_process(BenchCtx, prvMQC_processPublish, (E_MQC_MSG_PUBLISH << 4) + (E_MQC_QOS_2 << 1), BenchCtx->Frame, BenchCtx->FrameSize);
+    }
+}
+
+/**
+ * @brief               Process the PUBREL Messages of the QoS2 PUBLISH Messages received (PUBCOMP is sent)
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_pubrel(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint8_t     Data[2];
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        Data[0] = (uint8_t)((i + 1) >> 8);
+        Data[1] = (uint8_t)(i + 1);
+        bench_process(BenchCtx, prvMQC_processPubrel, (E_MQC_MSG_PUBREL << 4) + 0x02, Data, sizeof(Data));
+    }
+}
+
+/**
+ * @brief               Receive the QoS2 PUBLISH Messages which wait for PUBREL
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_pubrel(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_publish_frame(BenchCtx, E_MQC_QOS_2);
+    bench_process_publish_qos2(BenchCtx, Count);
+}
+
+/**
+ * @brief               Complete the QoS2 PUBLISH Messages received
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_finish_publish_qos2(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_process_pubrel(BenchCtx, Count);
+}
+
+/**
+ * @brief               Publish the Messages which wait for the acknowledgement and keep their Packet Identifiers
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the Messages
+ * @param[in]           QoS                     QoS Level
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_publish(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count, E_MQC_QOS_LEVEL QoS)
+{
+    S_MQC_MESSAGE_INFO  Message;
+    uint32_t            i       =   0;
+
+    Message.Topic.Data      = (uint8_t*)D_BENCH_TOPIC;
+    Message.Topic.Length    = strlen(D_BENCH_TOPIC);
+    Message.Content         = BenchCtx->Payload;
+    Message.Length          = BenchCtx->Param;
+    for(i = 0; i < Count; i++)
+    {
+        bench_check(MQC_CorePublish(&BenchCtx->Handler, &Message, QoS, false, NULL), "MQC_CorePublish");
+        bench_ack_keep(BenchCtx, i);
+    }
+}
+
+/**
+ * @brief               Publish the QoS1 Messages which wait for PUBACK
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_puback(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_prepare_publish(BenchCtx, Count, E_MQC_QOS_1);
+}
+
+/**
+ * @brief               Process the PUBACK Messages of the Messages in flight
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_puback(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_process(BenchCtx, prvMQC_processPuback, (E_MQC_MSG_PUBACK << 4), BenchCtx->Ack[i], 2);
+    }
+}
+
+/**
+ * @brief               Publish the QoS2 Messages which wait for PUBREC
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_pubrec(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_prepare_publish(BenchCtx, Count, E_MQC_QOS_2);
+}
+
+/**
+ * @brief               Process the PUBREC Messages of the Messages in flight (PUBREL is sent)
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_pubrec(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_process(BenchCtx, prvMQC_processPubrec, (E_MQC_MSG_PUBREC << 4), BenchCtx->Ack[i], 2);
+    }
+}
+
+/**
+ * @brief               Process the PUBCOMP Messages of the Messages in flight
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_pubcomp(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_process(BenchCtx, prvMQC_processPubcomp, (E_MQC_MSG_PUBCOMP << 4), BenchCtx->Ack[i], 2);
+    }
+}
+
+/**
+ * @brief               Publish the QoS2 Messages which wait for PUBCOMP
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_pubcomp(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_prepare_pubrec(BenchCtx, Count);
+    bench_process_pubrec(BenchCtx, Count);
+}
+
+/**
+ * @brief               Complete the QoS2 Messages which wait for PUBCOMP
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_finish_pubrec(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    bench_process_pubcomp(BenchCtx, Count);
+}
+
+/**
+ * @brief               Subscribe the Topic Filters which wait for SUBACK
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_suback(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    S_MQC_UTF8_DATA     TopicFilter[2]  =   { { (uint8_t*)"bench/core/+/telemetry", 22 }, { (uint8_t*)"bench/core/command/#", 20 } };
+    E_MQC_QOS_LEVEL     QoS[2]          =   { E_MQC_QOS_1, E_MQC_QOS_2 };
+    uint32_t            i               =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_check(MQC_CoreSubscribe(&BenchCtx->Handler, TopicFilter, QoS, 2, NULL), "MQC_CoreSubscribe");
+        bench_ack_keep(BenchCtx, i);
+    }
+}
+
+/**
+ * @brief               Process the SUBACK Messages of the SUBSCRIBE Messages in flight
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_suback(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint8_t     Data[4]     =   { 0, 0, E_MQC_CODE_QOS1, E_MQC_CODE_QOS2 };
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        Data[0] = BenchCtx->Ack[i][0];
+        Data[1] = BenchCtx->Ack[i][1];
+        bench_process(BenchCtx, prvMQC_processSuback, (E_MQC_MSG_SUBACK << 4), Data, sizeof(Data));
+    }
+}
+
+/**
+ * @brief               Unsubscribe the Topic Filters which wait for UNSUBACK
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_prepare_unsuback(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    S_MQC_UTF8_DATA     TopicFilter[2]  =   { { (uint8_t*)"bench/core/+/telemetry", 22 }, { (uint8_t*)"bench/core/command/#", 20 } };
+    uint32_t            i               =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_check(MQC_CoreUnsubscribe(&BenchCtx->Handler, TopicFilter, 2, NULL), "MQC_CoreUnsubscribe");
+        bench_ack_keep(BenchCtx, i);
+    }
+}
+
+/**
+ * @brief               Process the UNSUBACK Messages of the UNSUBSCRIBE Messages in flight
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_unsuback(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_process(BenchCtx, prvMQC_processUnsuback, (E_MQC_MSG_UNSUBACK << 4), BenchCtx->Ack[i], 2);
+    }
+}
+
+/**
+ * @brief               Process the PINGRESP Messages
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_process_pingresp(S_BENCH_CORE_CTX* BenchCtx, uint32_t Count)
+{
+    uint32_t    i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        bench_process(BenchCtx, prvMQC_processPingresp, (E_MQC_MSG_PINGRESP << 4), NULL, 0);
+    }
+}
+
+/**************************************************************
+**  Case
+**************************************************************/
+
+/*!< Cases in the order of the report */
+static const S_BENCH_CORE_CASE g_BenchCase[] = {
+    { "rl/encode",              NULL,                           bench_rl_encode,            NULL,                       1000000,        0       },
+    { "rl/decode",              NULL,                           bench_rl_decode,            NULL,                       1000000,        0       },
+    { "encode/connect",         NULL,                           bench_encode_connect,       NULL,                       200000,         0       },
+    { "encode/disconnect",      NULL,                           bench_encode_disconnect,    NULL,                       1000000,        0       },
+    { "encode/subscribe",       NULL,                           bench_encode_subscribe,     NULL,                       200000,         0       },
+    { "encode/unsubscribe",     NULL,                           bench_encode_unsubscribe,   NULL,                       200000,         0       },
+    { "encode/publish-16",      NULL,                           bench_encode_publish,       NULL,                       200000,         16      },
+    { "encode/publish-256",     NULL,                           bench_encode_publish,       NULL,                       200000,         256     },
+    { "encode/publish-4096",    NULL,                           bench_encode_publish,       NULL,                       50000,          4096    },
+    { "encode/publish-vec-256", NULL,                           bench_encode_publish_vec,   NULL,                       1000000,        256     },
+    { "encode/puback",          NULL,                           bench_encode_puback,        NULL,                       1000000,        0       },
+    { "encode/pubrec",          NULL,                           bench_encode_pubrec,        NULL,                       1000000,        0       },
+    { "encode/pubrel",          NULL,                           bench_encode_pubrel,        NULL,                       1000000,        0       },
+    { "encode/pubcomp",         NULL,                           bench_encode_pubcomp,       NULL,                       1000000,        0       },
+    { "encode/pingreq",         NULL,                           bench_encode_pingreq,       NULL,                       1000000,        0       },
+    { "process/connack",        NULL,                           bench_process_connack,      NULL,                       200000,         0       },
+    { "process/publish-qos0-16",  bench_prepare_publish_qos0,   bench_process_publish_qos0, NULL,                       200000,         16      },
+    { "process/publish-qos0-256", bench_prepare_publish_qos0,   bench_process_publish_qos0, NULL,                       200000,         256     },
+    { "process/publish-qos0-4096",bench_prepare_publish_qos0,   bench_process_publish_qos0, NULL,                       50000,          4096    },
+    { "process/publish-qos1-256", bench_prepare_publish_qos1,   bench_process_publish_qos1, NULL,                       200000,         256     },
+    { "process/publish-qos2-256", bench_prepare_publish_qos2,   bench_process_publish_qos2, bench_finish_publish_qos2,  D_BENCH_BATCH,  256     },
+    { "process/pubrel",         bench_prepare_pubrel,           bench_process_pubrel,       NULL,                       D_BENCH_BATCH,  256     },
+    { "process/puback",         bench_prepare_puback,           bench_process_puback,       NULL,                       D_BENCH_BATCH,  256     },
+    { "process/pubrec",         bench_prepare_pubrec,           bench_process_pubrec,       bench_finish_pubrec,        D_BENCH_BATCH,  256     },
+    { "process/pubcomp",        bench_prepare_pubcomp,          bench_process_pubcomp,      NULL,                       D_BENCH_BATCH,  256     },
+    { "process/suback",         bench_prepare_suback,           bench_process_suback,       NULL,                       D_BENCH_BATCH,  0       },
+    { "process/unsuback",       bench_prepare_unsuback,         bench_process_unsuback,     NULL,                       D_BENCH_BATCH,  0       },
+    { "process/pingresp",       NULL,                           bench_process_pingresp,     NULL,                       1000000,        0       },
+};
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Run a case and keep the best round
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Case                    Case
+ * @return              Result of the best round
+ * @note                Only Run is measured, Prepare and Finish are done out of the measure
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static S_BENCH_CORE_RESULT bench_case_run(S_BENCH_CORE_CTX* BenchCtx, const S_BENCH_CORE_CASE* Case)
+{
+    S_BENCH_CORE_RESULT Best;
+    uint32_t            Rounds      =   (D_BENCH_BATCH == Case->Count)?(D_BENCH_ROUNDS):(D_BENCH_DEFAULT_ROUNDS);
+    uint32_t            Count       =   0;
+    uint64_t            StartNs     =   0;
+    uint64_t            StartCycles =   0;
+    uint64_t            Malloc      =   0;
+    double              NsPerOp     =   0;
+    uint32_t            i           =   0;
+
+    memset(&Best, 0, sizeof(Best));
+    BenchCtx->Param = Case->Param;
+    /* The first round warms up the cache and the allocator */
+    for(i = 0; i <= Rounds; i++)
+    {
+        Count = (i)?(Case->Count):(Case->Count / 10 + 1);
+        if(Case->Prepare)
+        {
+            Case->Prepare(BenchCtx, Count);
+        }
+        BenchCtx->Bytes = 0;
+        Malloc          = g_MallocCount;
+        StartNs         = Bench_NowNs();
+        StartCycles     = Bench_NowCycles();
+        Case->Run(BenchCtx, Count);
+        NsPerOp = (double)(Bench_NowNs() - StartNs) / Count;
+        if( i && ( (1 == i) || (NsPerOp < Best.Time.NsPerOp) ) )
+        {
+            Best.Time.CyclesPerOp   = (double)(Bench_NowCycles() - StartCycles) / Count;
+            Best.Time.NsPerOp       = NsPerOp;
+            Best.BytesPerOp         = (double)BenchCtx->Bytes / Count;
+            Best.AllocsPerOp        = (double)(g_MallocCount - Malloc) / Count;
+        }
+        if(Case->Finish)
+        {
+            Case->Finish(BenchCtx, Count);
+        }
+    }
+    return Best;
+}
+
+/**
+ * @brief               Main function of the core benchmark
+ * @param[in]           argc                    Count of the arguments
+ * @param[in]           argv                    text (default), csv or json
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    S_BENCH_CORE_CTX*   BenchCtx    =   &g_BenchCtx;
+    const char*         Format      =   (argc > 1)?(argv[1]):("text");
+    S_BENCH_CORE_RESULT Result;
+    double              BytesPerSec =   0;
+    uint32_t            Num         =   sizeof(g_BenchCase) / sizeof(S_BENCH_CORE_CASE);
+    uint32_t            i           =   0;
+
+    if( strcmp(Format, "text") && strcmp(Format, "csv") && strcmp(Format, "json") )
+    {
+        printf("Usage: %s [text|csv|json]\n", argv[0]);
+        return 1;
+    }
+    for(i = 0; i < D_BENCH_PAYLOAD_MAX; i++)
+    {
+        BenchCtx->Payload[i] = (uint8_t)('a' + i % 26);
+    }
+    bench_session_open(BenchCtx);
+
+    if(!strcmp(Format, "csv"))
+    {
+        printf("name,ns_per_op,cycles_per_op,bytes_per_op,bytes_per_sec,allocs_per_op\n");
+    }
+    else if(!strcmp(Format, "json"))
+    {
+        printf("{\n  \"benchmark\": \"bench_core\",\n  \"cases\": [\n");
+    }
+    for(i = 0; i < Num; i++)
+    {
+        Result = bench_case_run(BenchCtx, &g_BenchCase[i]);
+        BytesPerSec = Result.BytesPerOp * 1000000000.0 / Result.Time.NsPerOp;
+        if(!strcmp(Format, "csv"))
+        {
+            printf("%s,%.1f,%.1f,%.1f,%.0f,%.3f\n", g_BenchCase[i].Name, Result.Time.NsPerOp, Result.Time.CyclesPerOp,
+                   Result.BytesPerOp, BytesPerSec, Result.AllocsPerOp);
+        }
+        else if(!strcmp(Format, "json"))
+        {
+            printf("    { \"name\": \"%s\", \"ns_per_op\": %.1f, \"cycles_per_op\": %.1f, \"bytes_per_op\": %.1f, "
+                   "\"bytes_per_sec\": %.0f, \"allocs_per_op\": %.3f }%s\n", g_BenchCase[i].Name, Result.Time.NsPerOp,
+                   Result.Time.CyclesPerOp, Result.BytesPerOp, BytesPerSec, Result.AllocsPerOp, (i + 1 < Num)?(","):(""));
+        }
+        else
+        {
+            Bench_Print(g_BenchCase[i].Name, Result.Time);
+            printf("%-32s %12.1f MB/s  %12.3f allocs/op\n", "", BytesPerSec / 1000000.0, Result.AllocsPerOp);
+        }
+    }
+    if(!strcmp(Format, "json"))
+    {
+        printf("  ]\n}\n");
+    }
+
+    (void)MQC_CoreStop(&BenchCtx->Handler);
+    return (BenchCtx->Sink == 0xFF)?(1):(0);
+}
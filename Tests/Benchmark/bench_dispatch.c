@@ -0,0 +1,245 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_dispatch.c
+ * @brief       Micro benchmark of the topic dispatch of the received PUBLISH Messages.
+ *              A number of Topic Filters are subscribed with a handler each, then
+ *              a batch of QoS0 PUBLISH Messages is fed to the library at once.
+ *              The "linear" cases do the same dispatch in ReadFuncCB by comparing
+ *              the topic with each Topic Filter, as a reference.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+
+#if !defined (MQC_TOPIC_DISPATCH)
+#error The dispatch benchmark requires MQC_TOPIC_DISPATCH
+#endif
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_MESSAGE_NUM     (1000)              /*!< PUBLISH Messages fed to the library at once */
+#define D_BENCH_TOPIC_SIZE      (32)                /*!< Buffer size of a Topic */
+#define D_BENCH_SUBSCRIBE_NUM   (100)               /*!< Topic Filters of a SUBSCRIBE Message */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the topic dispatch benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_DISPATCH_CTX
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    S_MQC_UTF8_DATA*        TopicFilter;
+    char*                   TopicData;
+    uint32_t                FilterNum;
+    uint8_t*                Stream;
+    size_t                  StreamSize;
+    uint32_t                Delivered;
+}S_BENCH_DISPATCH_CTX;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Handler of a Topic Filter
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_topic_handler(void* Ctx, S_MQC_MESSAGE_INFO* Message)
+{
+    ((S_BENCH_DISPATCH_CTX*)Ctx)->Delivered++;
+    return 0;
+}
+
+/**
+ * @brief               Read callback which finds the Topic Filter by comparing with each of them
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_linear_callback(void* Ctx, E_MQC_MSG_TYPE Type, S_MQC_MESSAGE_INFO* Info)
+{
+    S_BENCH_DISPATCH_CTX*   BenchCtx    =   (S_BENCH_DISPATCH_CTX*)Ctx;
+    uint32_t                i           =   0;
+
+    if(E_MQC_MSG_PUBLISH != Type)
+    {
+        return 0;
+    }
+    for(i = 0; i < BenchCtx->FilterNum; i++)
+    {
+        if( (BenchCtx->TopicFilter[i].Length == Info->Topic.Length) &&
+            !memcmp(BenchCtx->TopicFilter[i].Data, Info->Topic.Data, Info->Topic.Length) )
+        {
+            BenchCtx->Delivered++;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief               Feed the PUBLISH Messages to the library
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_dispatch(void* Ctx, uint32_t Count)
+{
+    S_BENCH_DISPATCH_CTX*   BenchCtx    =   (S_BENCH_DISPATCH_CTX*)Ctx;
+    uint32_t                i           =   0;
+
+    for(i = 0; i < Count; i += D_BENCH_MESSAGE_NUM)
+    {
+        BenchCtx->Delivered = 0;
+        if(MQC_Read(&BenchCtx->Handler, BenchCtx->Stream, BenchCtx->StreamSize))
+        {
+            printf("MQC_Read failed\n");
+            exit(1);
+        }
+        /* each Message matches one Topic Filter */
+        if(D_BENCH_MESSAGE_NUM != BenchCtx->Delivered)
+        {
+            printf("Delivered %u Messages\n", BenchCtx->Delivered);
+            exit(1);
+        }
+    }
+}
+
+/**
+ * @brief               Run the topic dispatch benchmark with a number of Topic Filters
+ * @param[in]           FilterNum               Number of the Topic Filters
+ * @param[in]           Linear                  Dispatch in ReadFuncCB instead of the Topic Filter Trie
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_dispatch_case(uint32_t FilterNum, bool Linear)
+{
+    static S_BENCH_DISPATCH_CTX BenchCtx;
+    E_MQC_QOS_LEVEL             QoS[D_BENCH_SUBSCRIBE_NUM];
+    S_MQC_TOPIC_HANDLER         Handler[D_BENCH_SUBSCRIBE_NUM];
+    S_MQC_UTF8_DATA*            Topic       =   NULL;
+    uint8_t*                    Frame       =   NULL;
+    uint32_t                    Num         =   0;
+    uint32_t                    i           =   0;
+    int32_t                     Ret         =   0;
+    S_BENCH_RESULT              Result;
+    char                        Name[64];
+
+    memset(&BenchCtx, 0, sizeof(BenchCtx));
+    BenchCtx.FilterNum      = FilterNum;
+    BenchCtx.TopicFilter    = malloc(FilterNum * sizeof(S_MQC_UTF8_DATA));
+    BenchCtx.TopicData      = malloc(FilterNum * D_BENCH_TOPIC_SIZE);
+    BenchCtx.Stream         = malloc(D_BENCH_MESSAGE_NUM * (4 + D_BENCH_TOPIC_SIZE));
+    if( (!BenchCtx.TopicFilter) || (!BenchCtx.TopicData) || (!BenchCtx.Stream) )
+    {
+        printf("No enough memory\n");
+        exit(1);
+    }
+    for(i = 0; i < FilterNum; i++)
+    {
+        BenchCtx.TopicFilter[i].Data    = (uint8_t*)(BenchCtx.TopicData + i * D_BENCH_TOPIC_SIZE);
+        BenchCtx.TopicFilter[i].Length  = (uint16_t)snprintf((char*)BenchCtx.TopicFilter[i].Data, D_BENCH_TOPIC_SIZE, "site/dev%u/temp", i);
+    }
+    /* QoS0 PUBLISH Messages to the subscribed topics (no payload) */
+    for(i = 0; i < D_BENCH_MESSAGE_NUM; i++)
+    {
+        Topic       = &(BenchCtx.TopicFilter[(i * 7919u) % FilterNum]);
+        Frame       = BenchCtx.Stream + BenchCtx.StreamSize;
+        Frame[0]    = (E_MQC_MSG_PUBLISH << 4);
+        Frame[1]    = (uint8_t)(2 + Topic->Length);
+        Frame[2]    = (uint8_t)(Topic->Length >> 8);
+        Frame[3]    = (uint8_t)(Topic->Length);
+        memcpy(Frame + 4, Topic->Data, Topic->Length);
+        BenchCtx.StreamSize += 4 + Topic->Length;
+    }
+
+    Bench_SessionInit(&BenchCtx.Handler, &BenchCtx, Bench_WriteCallback);
+    BenchCtx.Handler.ReadFuncCB             = bench_linear_callback;
+    Bench_SessionStart(&BenchCtx.Handler);
+    Bench_SessionConnect(&BenchCtx.Handler);
+    for(i = 0; i < D_BENCH_SUBSCRIBE_NUM; i++)
+    {
+        QoS[i]                  = E_MQC_QOS_0;
+        Handler[i].HandlerFuncCB= bench_topic_handler;
+        Handler[i].Ctx          = &BenchCtx;
+    }
+    for(i = 0; i < FilterNum; i += Num)
+    {
+        Num = (FilterNum - i < D_BENCH_SUBSCRIBE_NUM)?(FilterNum - i):(D_BENCH_SUBSCRIBE_NUM);
+        if(Linear)
+        {
+            Ret = MQC_Subscribe(&BenchCtx.Handler, &(BenchCtx.TopicFilter[i]), QoS, Num, NULL);
+        }
+        else
+        {
+            Ret = MQC_SubscribeHandler(&BenchCtx.Handler, &(BenchCtx.TopicFilter[i]), QoS, Handler, Num, NULL);
+        }
+        if(Ret)
+        {
+            printf("Failed to subscribe\n");
+            exit(1);
+        }
+    }
+
+    Result = Bench_Run(&BenchCtx, bench_dispatch, D_BENCH_MESSAGE_NUM * 20, D_BENCH_DEFAULT_ROUNDS);
+    snprintf(Name, sizeof(Name), "dispatch/%s/%u", (Linear)?("linear"):("trie"), FilterNum);
+    Bench_Print(Name, Result);
+
+    MQC_Stop(&BenchCtx.Handler);
+    free(BenchCtx.TopicFilter);
+    free(BenchCtx.TopicData);
+    free(BenchCtx.Stream);
+}
+
+/**
+ * @brief               Main function of the topic dispatch benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    static const uint32_t   FilterNum[] =   { 1, 10, 100, 1000, 10000 };
+    uint32_t                i           =   0;
+
+    for(i = 0; i < sizeof(FilterNum)/sizeof(FilterNum[0]); i++)
+    {
+        bench_dispatch_case(FilterNum[i], false);
+    }
+    for(i = 0; i < sizeof(FilterNum)/sizeof(FilterNum[0]); i++)
+    {
+        bench_dispatch_case(FilterNum[i], true);
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_journal.c
+ * @brief       Micro benchmark of the QoS1 PUBLISH flow saved into the journal.
+ *              Each PUBLISH Message is acknowledged at once, so the journal gets one saved and
+ *              one deleted record for each Message. The restore case measures MQC_Start resuming
+ *              the Messages left in the journal.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+#include <unistd.h>
+#include "journal.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_TOPIC           "bench/journal"     /*!< Topic of the PUBLISH Message */
+#define D_BENCH_PAYLOAD_SIZE    (256)               /*!< Size of the payload */
+#define D_BENCH_RESTORE_NUM     (10000)             /*!< Messages left in the journal for the restore case */
+
+#if defined (MQC_PERSISTENCE)
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the journal benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_JOURNAL_CTX
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    S_MQC_MESSAGE_INFO      Message;
+    S_JOURNAL               Journal;
+    uint16_t                PacketIdentifier;
+    uint8_t                 Sink;
+}S_BENCH_JOURNAL_CTX;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Write callback which drops the data
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_write_callback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    S_BENCH_JOURNAL_CTX*    BenchCtx    =   (S_BENCH_JOURNAL_CTX*)Ctx;
+    uint32_t                Offset      =   1;
+    uint16_t                TopicLength =   0;
+
+    BenchCtx->Sink ^= Data[Size - 1];
+    /* remember the Packet Identifier of the PUBLISH Message with QoS */
+    if( ((E_MQC_MSG_PUBLISH << 4) == (Data[0] & 0xF0)) && (Data[0] & 0x06) )
+    {
+        while(Data[Offset++] & 128);
+        TopicLength = (uint16_t)((Data[Offset] << 8) | Data[Offset + 1]);
+        Offset = Offset + sizeof(uint16_t) + TopicLength;
+        BenchCtx->PacketIdentifier = (uint16_t)((Data[Offset] << 8) | Data[Offset + 1]);
+    }
+    return 0;
+}
+
+/**
+ * @brief               Start the session with the journal
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Path                    Path of the journal file
+ * @param[in]           Fsync                   Flush the journal to the disk
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_session_start(S_BENCH_JOURNAL_CTX* BenchCtx, const char* Path, bool Fsync)
+{
+    static uint8_t  Payload[D_BENCH_PAYLOAD_SIZE];
+
+    memset(Payload, 0x5A, sizeof(Payload));
+    memset(BenchCtx, 0, sizeof(S_BENCH_JOURNAL_CTX));
+    if(journal_open(&BenchCtx->Journal, Path, 0, Fsync))
+    {
+        printf("Failed to open the journal %s\n", Path);
+        exit(1);
+    }
+    BenchCtx->Message.Topic.Data            = (uint8_t*)D_BENCH_TOPIC;
+    BenchCtx->Message.Topic.Length          = strlen(D_BENCH_TOPIC);
+    BenchCtx->Message.Content               = Payload;
+    BenchCtx->Message.Length                = sizeof(Payload);
+    Bench_SessionInit(&BenchCtx->Handler, BenchCtx, bench_write_callback);
+    BenchCtx->Handler.CleanSession          = false;
+    BenchCtx->Handler.PersistFunc           = &BenchCtx->Journal.Func;
+    Bench_SessionStart(&BenchCtx->Handler);
+}
+
+/**
+ * @brief               Stop the session and close the journal
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_session_stop(S_BENCH_JOURNAL_CTX* BenchCtx)
+{
+    MQC_Stop(&BenchCtx->Handler);
+    journal_close(&BenchCtx->Journal);
+}
+
+/**
+ * @brief               Publish some QoS1 messages and acknowledge each of them
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the messages
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_publish(void* Ctx, uint32_t Count)
+{
+    S_BENCH_JOURNAL_CTX*    BenchCtx    =   (S_BENCH_JOURNAL_CTX*)Ctx;
+    uint8_t                 Puback[4]   =   { (E_MQC_MSG_PUBACK << 4), 2, 0, 0 };
+    uint32_t                i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        if(MQC_Publish(&BenchCtx->Handler, &BenchCtx->Message, E_MQC_QOS_1, false, NULL))
+        {
+            printf("MQC_Publish failed\n");
+            exit(1);
+        }
+        Puback[2] = (uint8_t)(BenchCtx->PacketIdentifier >> 8);
+        Puback[3] = (uint8_t)(BenchCtx->PacketIdentifier);
+        (void)MQC_Read(&BenchCtx->Handler, Puback, sizeof(Puback));
+    }
+}
+
+/**
+ * @brief               Run the QoS1 PUBLISH flow with the journal
+ * @param[in]           Path                    Path of the journal file
+ * @param[in]           Fsync                   Flush the journal to the disk
+ * @param[in]           Count                   Operation count of one round
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_publish_case(const char* Path, bool Fsync, uint32_t Count)
+{
+    static S_BENCH_JOURNAL_CTX  BenchCtx;
+    char                        Name[64];
+
+    (void)unlink(Path);
+    bench_session_start(&BenchCtx, Path, Fsync);
+    Bench_SessionConnect(&BenchCtx.Handler);
+    snprintf(Name, sizeof(Name), "journal/qos1%s/%u", (Fsync)?("-fsync"):(""), D_BENCH_PAYLOAD_SIZE);
+    Bench_Print(Name, Bench_Run(&BenchCtx, bench_publish, Count, D_BENCH_DEFAULT_ROUNDS));
+    printf("%-32s %12u compactions %10zu bytes file\n", "", BenchCtx.Journal.CompactCount, BenchCtx.Journal.Size);
+    bench_session_stop(&BenchCtx);
+    (void)unlink(Path);
+}
+
+/**
+ * @brief               Measure MQC_Start resuming the Messages left in the journal
+ * @param[in]           Path                    Path of the journal file
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_restore_case(const char* Path)
+{
+    static S_BENCH_JOURNAL_CTX  BenchCtx;
+    S_BENCH_RESULT              Result      =   { 0, 0 };
+    S_MQC_STATISTICS            Statistics;
+    uint64_t                    StartNs     =   0;
+    uint64_t                    StartCycles =   0;
+    uint32_t                    i           =   0;
+
+    (void)unlink(Path);
+    bench_session_start(&BenchCtx, Path, false);
+    Bench_SessionConnect(&BenchCtx.Handler);
+    for(i = 0; i < D_BENCH_RESTORE_NUM; i++)
+    {
+        if(MQC_Publish(&BenchCtx.Handler, &BenchCtx.Message, E_MQC_QOS_1, false, NULL))
+        {
+            printf("MQC_Publish failed\n");
+            exit(1);
+        }
+    }
+    bench_session_stop(&BenchCtx);
+
+    StartNs     = Bench_NowNs();
+    StartCycles = Bench_NowCycles();
+    bench_session_start(&BenchCtx, Path, false);
+    Result.CyclesPerOp  = (double)(Bench_NowCycles() - StartCycles) / D_BENCH_RESTORE_NUM;
+    Result.NsPerOp      = (double)(Bench_NowNs() - StartNs) / D_BENCH_RESTORE_NUM;
+    (void)MQC_Statistics(&BenchCtx.Handler, &Statistics);
+    if(D_BENCH_RESTORE_NUM != Statistics.InflightCount)
+    {
+        printf("Resumed %u of %u messages\n", Statistics.InflightCount, D_BENCH_RESTORE_NUM);
+        exit(1);
+    }
+    Bench_Print("journal/restore/10000", Result);
+    bench_session_stop(&BenchCtx);
+    (void)unlink(Path);
+}
+
+/**
+ * @brief               Main function of the journal benchmark
+ * @param[in]           argc                    Argument count
+ * @param[in]           argv                    argv[1] is the directory of the journal file (/tmp by default)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    char    Path[D_JOURNAL_PATH_SIZE];
+
+    snprintf(Path, sizeof(Path), "%s/bench_journal.%d", (argc > 1)?(argv[1]):("/tmp"), (int)getpid());
+    bench_publish_case(Path, false, 100000);
+    bench_publish_case(Path, true, 2000);
+    bench_restore_case(Path);
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    printf("MQC_PERSISTENCE is not defined\n");
+    return 0;
+}
+
+#endif /* MQC_PERSISTENCE */
@@ -0,0 +1,394 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_lock.c
+ * @brief       Micro benchmark of the session lock.
+ *              Some threads publish with one session while another thread reads the incoming PUBLISH Messages,
+ *              the session is locked by the SysV semaphore (the former Linux wrapper) or by lock_wrapper (pthread mutex).
+ *              A burst of the incoming PUBLISH Messages in one read shows the lock operations for the callbacks.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Add the case of a burst of the incoming PUBLISH Messages in one read
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/sem.h>
+#include "wrapper.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_TOPIC           "bench/lock"        /*!< Topic of the PUBLISH Message */
+#define D_BENCH_PAYLOAD_SIZE    (16)                /*!< Payload size of the PUBLISH Message */
+#define D_BENCH_PUBLISHER_MAX   (4)                 /*!< Maximum number of the publisher threads */
+#define D_BENCH_BURST_NUM       (500)               /*!< PUBLISH Messages in one read of the burst case */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the lock benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_LOCK_CTX
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    S_MQC_MESSAGE_INFO      Message;
+    S_PLATFORM_DATA         Platform;
+    int                     SemaphoreId;
+    uint32_t                PublisherNum;
+    bool                    Reader;
+    uint32_t                PublishCount;
+    volatile int            Running;
+    uint64_t                WriteBytes;
+    uint64_t                ReadCount;
+    uint64_t                LockCount;
+    uint8_t                 Packet[64];
+    size_t                  PacketSize;
+}S_BENCH_LOCK_CTX;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Lock with the SysV semaphore (system call each time)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_sem_lock(void* Ctx)
+{
+    struct sembuf   sem_buf =   { 0, -1, 0 };
+    (void)semop(((S_BENCH_LOCK_CTX*)Ctx)->SemaphoreId, &sem_buf, 1);
+    ((S_BENCH_LOCK_CTX*)Ctx)->LockCount++;
+}
+
+/**
+ * @brief               Unlock with the SysV semaphore (system call each time)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_sem_unlock(void* Ctx)
+{
+    struct sembuf   sem_buf =   { 0, 1, 0 };
+    (void)semop(((S_BENCH_LOCK_CTX*)Ctx)->SemaphoreId, &sem_buf, 1);
+}
+
+/**
+ * @brief               Lock with the Linux wrapper
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_wrapper_lock(void* Ctx)
+{
+    lock_wrapper(&(((S_BENCH_LOCK_CTX*)Ctx)->Platform));
+    ((S_BENCH_LOCK_CTX*)Ctx)->LockCount++;
+}
+
+/**
+ * @brief               Unlock with the Linux wrapper
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_wrapper_unlock(void* Ctx)
+{
+    unlock_wrapper(&(((S_BENCH_LOCK_CTX*)Ctx)->Platform));
+}
+
+/**
+ * @brief               Write callback which drops the data (called under the lock)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_write_callback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    ((S_BENCH_LOCK_CTX*)Ctx)->WriteBytes += Size;
+    return 0;
+}
+
+/**
+ * @brief               Publisher thread
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void* bench_publisher(void* Ctx)
+{
+    S_BENCH_LOCK_CTX*   BenchCtx    =   (S_BENCH_LOCK_CTX*)Ctx;
+    uint32_t            i           =   0;
+
+    for(i = 0; i < BenchCtx->PublishCount; i++)
+    {
+        if(MQC_Publish(&BenchCtx->Handler, &BenchCtx->Message, E_MQC_QOS_0, false, NULL))
+        {
+            printf("MQC_Publish failed\n");
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief               Reader thread, feeds the incoming PUBLISH Messages until the publishers finish
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void* bench_reader(void* Ctx)
+{
+    S_BENCH_LOCK_CTX*   BenchCtx    =   (S_BENCH_LOCK_CTX*)Ctx;
+    uint64_t            Count       =   0;
+
+    while(__atomic_load_n(&BenchCtx->Running, __ATOMIC_ACQUIRE))
+    {
+        if(MQC_Read(&BenchCtx->Handler, BenchCtx->Packet, BenchCtx->PacketSize))
+        {
+            printf("MQC_Read failed\n");
+            exit(1);
+        }
+        Count++;
+    }
+    BenchCtx->ReadCount += Count;
+    return NULL;
+}
+
+/**
+ * @brief               Publish from the publisher threads with the reader thread running
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the PUBLISH Messages of all publishers
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_contention(void* Ctx, uint32_t Count)
+{
+    S_BENCH_LOCK_CTX*   BenchCtx    =   (S_BENCH_LOCK_CTX*)Ctx;
+    pthread_t           Publisher[D_BENCH_PUBLISHER_MAX];
+    pthread_t           Reader;
+    uint32_t            i           =   0;
+
+    BenchCtx->PublishCount = Count / BenchCtx->PublisherNum;
+    BenchCtx->Running = 1;
+    if(BenchCtx->Reader)
+    {
+        (void)pthread_create(&Reader, NULL, bench_reader, BenchCtx);
+    }
+    for(i = 0; i < BenchCtx->PublisherNum; i++)
+    {
+        (void)pthread_create(&Publisher[i], NULL, bench_publisher, BenchCtx);
+    }
+    for(i = 0; i < BenchCtx->PublisherNum; i++)
+    {
+        (void)pthread_join(Publisher[i], NULL);
+    }
+    __atomic_store_n(&BenchCtx->Running, 0, __ATOMIC_RELEASE);
+    if(BenchCtx->Reader)
+    {
+        (void)pthread_join(Reader, NULL);
+    }
+}
+
+/**
+ * @brief               Feed bursts of the incoming PUBLISH Messages, each burst in one read
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the PUBLISH Messages
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_burst(void* Ctx, uint32_t Count)
+{
+    static uint8_t      Burst[D_BENCH_BURST_NUM * sizeof(((S_BENCH_LOCK_CTX*)0)->Packet)];
+    S_BENCH_LOCK_CTX*   BenchCtx    =   (S_BENCH_LOCK_CTX*)Ctx;
+    uint32_t            i           =   0;
+
+    for(i = 0; i < D_BENCH_BURST_NUM; i++)
+    {
+        memcpy(&Burst[i * BenchCtx->PacketSize], BenchCtx->Packet, BenchCtx->PacketSize);
+    }
+    for(i = 0; i < Count; i += D_BENCH_BURST_NUM)
+    {
+        if(MQC_Read(&BenchCtx->Handler, Burst, D_BENCH_BURST_NUM * BenchCtx->PacketSize))
+        {
+            printf("MQC_Read failed\n");
+            exit(1);
+        }
+    }
+}
+
+/**
+ * @brief               Open a session locked by a lock
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Semaphore               Use the SysV semaphore (or else lock_wrapper)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_lock_open(S_BENCH_LOCK_CTX* BenchCtx, bool Semaphore)
+{
+    static uint8_t              Payload[D_BENCH_PAYLOAD_SIZE];
+    size_t                      TopicLength =   strlen(D_BENCH_TOPIC);
+
+    memset(BenchCtx, 0, sizeof(S_BENCH_LOCK_CTX));
+    memset(Payload, 0x5A, sizeof(Payload));
+    Bench_SessionInit(&BenchCtx->Handler, BenchCtx, bench_write_callback);
+    if(Semaphore)
+    {
+        BenchCtx->SemaphoreId = semget(IPC_PRIVATE, 1, IPC_CREAT | 0600);
+        if( (0 > BenchCtx->SemaphoreId) || semctl(BenchCtx->SemaphoreId, 0, SETVAL, 1) )
+        {
+            printf("Failed to create the semaphore\n");
+            exit(1);
+        }
+        BenchCtx->Handler.LockFunc   = bench_sem_lock;
+        BenchCtx->Handler.UnlockFunc = bench_sem_unlock;
+    }
+    else
+    {
+        if(wrapper_init(&BenchCtx->Platform))
+        {
+            printf("Failed to initialize the wrapper\n");
+            exit(1);
+        }
+        BenchCtx->Handler.LockFunc   = bench_wrapper_lock;
+        BenchCtx->Handler.UnlockFunc = bench_wrapper_unlock;
+    }
+    BenchCtx->Message.Topic.Data             = (uint8_t*)D_BENCH_TOPIC;
+    BenchCtx->Message.Topic.Length           = TopicLength;
+    BenchCtx->Message.Content                = Payload;
+    BenchCtx->Message.Length                 = sizeof(Payload);
+
+    /* incoming QoS0 PUBLISH Message fed by the reader */
+    BenchCtx->Packet[0] = (E_MQC_MSG_PUBLISH << 4);
+    BenchCtx->Packet[1] = (uint8_t)(2 + TopicLength + sizeof(Payload));
+    BenchCtx->Packet[2] = 0;
+    BenchCtx->Packet[3] = (uint8_t)TopicLength;
+    memcpy(&BenchCtx->Packet[4], D_BENCH_TOPIC, TopicLength);
+    memcpy(&BenchCtx->Packet[4 + TopicLength], Payload, sizeof(Payload));
+    BenchCtx->PacketSize = 4 + TopicLength + sizeof(Payload);
+
+    Bench_SessionStart(&BenchCtx->Handler);
+    Bench_SessionConnect(&BenchCtx->Handler);
+}
+
+/**
+ * @brief               Close the session and release the lock
+ * @param[in,out]       BenchCtx                Context of the benchmark
+ * @param[in]           Semaphore               Use the SysV semaphore (or else lock_wrapper)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_lock_close(S_BENCH_LOCK_CTX* BenchCtx, bool Semaphore)
+{
+    MQC_Stop(&BenchCtx->Handler);
+    if(Semaphore)
+    {
+        (void)semctl(BenchCtx->SemaphoreId, 0, IPC_RMID, 0);
+    }
+    else
+    {
+        wrapper_deinit(&BenchCtx->Platform);
+    }
+}
+
+/**
+ * @brief               Run the lock benchmark with a lock and some threads
+ * @param[in]           LockName                Name of the lock
+ * @param[in]           Semaphore               Use the SysV semaphore (or else lock_wrapper)
+ * @param[in]           PublisherNum            Number of the publisher threads
+ * @param[in]           Reader                  Run the reader thread
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_lock_case(const char* LockName, bool Semaphore, uint32_t PublisherNum, bool Reader)
+{
+    static S_BENCH_LOCK_CTX     BenchCtx;
+    char                        Name[64];
+
+    bench_lock_open(&BenchCtx, Semaphore);
+    BenchCtx.PublisherNum   = PublisherNum;
+    BenchCtx.Reader         = Reader;
+
+    snprintf(Name, sizeof(Name), "lock/%s/pub%u%s", LockName, PublisherNum, (Reader)?("+read"):(""));
+    Bench_Print(Name, Bench_Run(&BenchCtx, bench_contention, 1000000, D_BENCH_DEFAULT_ROUNDS));
+
+    bench_lock_close(&BenchCtx, Semaphore);
+}
+
+/**
+ * @brief               Run the burst benchmark with a lock
+ * @param[in]           LockName                Name of the lock
+ * @param[in]           Semaphore               Use the SysV semaphore (or else lock_wrapper)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_burst_case(const char* LockName, bool Semaphore)
+{
+    static S_BENCH_LOCK_CTX     BenchCtx;
+    char                        Name[64];
+
+    bench_lock_open(&BenchCtx, Semaphore);
+
+    snprintf(Name, sizeof(Name), "lock/%s/burst%d", LockName, D_BENCH_BURST_NUM);
+    BenchCtx.LockCount = 0;
+    bench_burst(&BenchCtx, D_BENCH_BURST_NUM);
+    printf("%-40s %6llu locks/read\n", Name, (unsigned long long)BenchCtx.LockCount);
+    Bench_Print(Name, Bench_Run(&BenchCtx, bench_burst, 1000000, D_BENCH_DEFAULT_ROUNDS));
+
+    bench_lock_close(&BenchCtx, Semaphore);
+}
+
+/**
+ * @brief               Main function of the lock benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    static const uint32_t   PublisherNum[]  =   { 1, 2, 4 };
+    uint32_t                i               =   0;
+
+    /* no contention: one publisher */
+    bench_lock_case("semaphore", true, 1, false);
+    bench_lock_case("mutex", false, 1, false);
+
+    /* contention: some publishers and the reader */
+    for(i = 0; i < sizeof(PublisherNum)/sizeof(PublisherNum[0]); i++)
+    {
+        bench_lock_case("semaphore", true, PublisherNum[i], true);
+        bench_lock_case("mutex", false, PublisherNum[i], true);
+    }
+
+    /* a burst of the incoming PUBLISH Messages in one read */
+    bench_burst_case("semaphore", true);
+    bench_burst_case("mutex", false);
+    return 0;
+}
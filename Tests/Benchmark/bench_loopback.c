@@ -0,0 +1,611 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_loopback.c
+ * @brief       End-to-end benchmark of the MQTT sessions with the in-process broker stand-in (bench_broker.c).
+ *              N sessions are served by the Linux event loop over socketpair(), each publishes M Messages per second
+ *              to its own topic (or to the topic of all sessions with the fanout) and receives them back through
+ *              the broker. QoS0, QoS1 and QoS2 are measured in turn. \n
+ *              Reported for each QoS: the throughput of the delivered Messages, the latency from MQC_Publish to the
+ *              result callback (ack, PUBACK for QoS1 and PUBREC for QoS2 where the library completes the Message,
+ *              none for QoS0) and the latency from MQC_Publish to the read callback of the subscriber (delivery),
+ *              with p50 p99 p999 in microsecond. \n
+ *              Usage : bench_loopback [sessions] [msgs/s per session (0: no limit)] [msgs per session] [payload size]
+ *              [workers] [fanout (0/1)]
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <signal.h>
+#include "wrapper.h"
+#include "eventloop.h"
+#include "bench_broker.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_SESSION_NUM     (8)                 /*!< Default number of the sessions */
+#define D_BENCH_RATE            (1000)              /*!< Default Messages per second of one session */
+#define D_BENCH_MSG_NUM         (2000)              /*!< Default Messages of one session for each QoS */
+#define D_BENCH_PAYLOAD_SIZE    (64)                /*!< Default payload size */
+#define D_BENCH_PAYLOAD_MIN     (9)                 /*!< Send time (8 bytes) and QoS (1 byte) in the payload */
+#define D_BENCH_PAYLOAD_MAX     (65536)             /*!< Max payload size */
+#define D_BENCH_WORKER_NUM      (2)                 /*!< Default number of the worker threads */
+#define D_BENCH_TICK_INTERVAL   (100)               /*!< Interval with millisecond to call MQC_Continue */
+#define D_BENCH_MAX_INFLIGHT    (64)                /*!< MaxInflight of each session */
+#define D_BENCH_SAMPLE_MAX      (4000000)           /*!< Max latency samples kept of each kind */
+#define D_BENCH_OPEN_TIMEOUT    (5000)              /*!< Timeout with millisecond to open and subscribe all sessions */
+#define D_BENCH_DRAIN_TIMEOUT   (30000)             /*!< Timeout with millisecond to wait for the Messages of one QoS */
+#define D_BENCH_TOPIC_SIZE      (32)                /*!< Buffer size of the topic */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Data of one session
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_SESSION
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    S_PLATFORM_DATA         Platform;
+    S_EVENT_SESSION         Event;
+    char                    ClientId[D_BENCH_TOPIC_SIZE];
+    char                    Topic[D_BENCH_TOPIC_SIZE];
+    char                    Filter[D_BENCH_TOPIC_SIZE];
+    uint8_t*                Payload;
+}S_BENCH_SESSION;
+
+/**
+ * @brief      Latency samples of one kind
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_SAMPLE
+{
+    uint64_t*               Data;               /*!< Latency with nanosecond */
+    uint64_t                Count;              /*!< Samples recorded (may be more than D_BENCH_SAMPLE_MAX) */
+}S_BENCH_SAMPLE;
+
+/**************************************************************
+**  Global
+**************************************************************/
+
+static S_BENCH_SAMPLE   g_Ack;                  /*!< MQC_Publish to the result callback */
+static S_BENCH_SAMPLE   g_Delivery;             /*!< MQC_Publish to the read callback */
+static uint8_t          g_Phase;                /*!< QoS measured now */
+static uint32_t         g_Subscribed;           /*!< Sessions which has got SUBACK */
+static uint32_t         g_Failed;               /*!< Sessions failed to open or closed */
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Record the latency of a Message
+ * @param[in,out]       Sample              Samples
+ * @param[in]           Payload             Payload of the Message
+ * @param[in]           Length              Length of the payload
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_record(S_BENCH_SAMPLE* Sample, const uint8_t* Payload, uint32_t Length)
+{
+    uint64_t    Now     =   Bench_NowNs();
+    uint64_t    Sent    =   0;
+    uint64_t    Index   =   0;
+
+    /* The late Messages of the former QoS (after the timeout) are not counted */
+    if( (D_BENCH_PAYLOAD_MIN > Length) || (Payload[8] != __atomic_load_n(&g_Phase, __ATOMIC_RELAXED)) )
+    {
+        return;
+    }
+    memcpy(&Sent, Payload, sizeof(Sent));
+    Index = __atomic_fetch_add(&Sample->Count, 1, __ATOMIC_RELAXED);
+    if(Index < D_BENCH_SAMPLE_MAX)
+    {
+        Sample->Data[Index] = Now - Sent;
+    }
+    return;
+}
+
+/**
+ * @brief               Resource Lock callback function
+ * @param[in,out]       Ctx                 User Context
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_lock(void* Ctx)
+{
+    lock_wrapper( &(((S_BENCH_SESSION*)Ctx)->Platform) );
+}
+
+/**
+ * @brief               Resource UnLock callback function
+ * @param[in,out]       Ctx                 User Context
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_unlock(void* Ctx)
+{
+    unlock_wrapper( &(((S_BENCH_SESSION*)Ctx)->Platform) );
+}
+
+/**
+ * @brief               Data Send callback function (the blocking client side of the socketpair)
+ * @param[in,out]       Ctx                 User Context
+ * @param[in]           Data                Data want to write
+ * @param[in]           Size                Size of the Data
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_write(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    S_BENCH_SESSION*    Session =   (S_BENCH_SESSION*)Ctx;
+    int32_t             Err     =   0;
+
+    while(Size)
+    {
+        Err = tcpwrite_wrapper( &(Session->Platform), Data, Size);
+        if(0 > Err)
+        {
+            return (-1);
+        }
+        Size    =   Size - Err;
+        Data    =   Data + Err;
+    }
+    return 0;
+}
+
+/**
+ * @brief               Subscribe result callback function
+ * @param[in]           Result              Result of the Subscribe Behavior
+ * @param[in]           TopicFilterList     Topic Filters
+ * @param[in]           SrvRetCodeList      Return Codes of SUBACK
+ * @param[in]           ListNum             Number of the Topic Filters
+ * @retval              0                   success
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_subscribed(E_MQC_BEHAVIOR_RESULT Result, S_MQC_UTF8_DATA* TopicFilterList, E_MQC_RETURN_CODE* SrvRetCodeList, uint32_t ListNum)
+{
+    (void)TopicFilterList;
+    if( (E_MQC_BEHAVIOR_COMPLETE == Result) && (1 == ListNum) && (E_MQC_CODE_FAIL != SrvRetCodeList[0]) )
+    {
+        __atomic_fetch_add(&g_Subscribed, 1, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        __atomic_fetch_add(&g_Failed, 1, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+/**
+ * @brief               Publish result callback function
+ * @param[in]           Result              Result of the Publish Behavior
+ * @param[in]           Message             Message published
+ * @retval              0                   success
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_published(E_MQC_BEHAVIOR_RESULT Result, S_MQC_MESSAGE_INFO* Message)
+{
+    if(E_MQC_BEHAVIOR_COMPLETE == Result)
+    {
+        bench_record(&g_Ack, Message->Content, Message->Length);
+    }
+    return 0;
+}
+
+/**
+ * @brief               Open/Reset callback function, subscribes the topic of the session
+ * @param[in,out]       Ctx                 User Context
+ * @param[in]           Result              Result of the Connect Behavior
+ * @param[in]           SrvResCode          Result of the server response
+ * @param[in]           SessionPresent      If server has already hold the MQTT Session
+ * @retval              0                   success
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_opened(void* Ctx, E_MQC_BEHAVIOR_RESULT Result, uint8_t SrvResCode, bool SessionPresent)
+{
+    S_BENCH_SESSION*    Session     =   (S_BENCH_SESSION*)Ctx;
+    S_MQC_UTF8_DATA     TopicFilter;
+    E_MQC_QOS_LEVEL     QoS         =   E_MQC_QOS_2;
+
+    (void)SessionPresent;
+    if( (E_MQC_BEHAVIOR_COMPLETE != Result) || (D_MQC_OPEN_SUCCESS_CODE != SrvResCode) )
+    {
+        __atomic_fetch_add(&g_Failed, 1, __ATOMIC_RELEASE);
+        return 0;
+    }
+    /* Granted QoS2, so each Message is delivered with the QoS it is published */
+    TopicFilter.Data    =   (uint8_t*)Session->Filter;
+    TopicFilter.Length  =   strlen(Session->Filter);
+    if(D_MQC_RET_OK != MQC_Subscribe(&(Session->Handler), &TopicFilter, &QoS, 1, bench_subscribed))
+    {
+        __atomic_fetch_add(&g_Failed, 1, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+/**
+ * @brief               Message read callback function
+ * @param[in,out]       Ctx                 User Context
+ * @param[in]           Type                Message Type
+ * @param[in]           Info                Information of the Message
+ * @retval              0                   success
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_read(void* Ctx, E_MQC_MSG_TYPE Type, S_MQC_MESSAGE_INFO* Info)
+{
+    (void)Ctx;
+    if(E_MQC_MSG_PUBLISH == Type)
+    {
+        bench_record(&g_Delivery, Info->Content, Info->Length);
+    }
+    return 0;
+}
+
+/**
+ * @brief               Callback function called when the connection of a session is closed
+ * @param[in,out]       Event               Session removed from the event loop
+ * @param[in]           Reason              Reason of the session removed
+ * @param[in]           Err                 errno or the return value of MQC_Read
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_closed(S_EVENT_SESSION* Event, E_EVENT_CLOSE_REASON Reason, int32_t Err)
+{
+    printf(" %s closed\n  ! Reason %d Error %d\n\n", ((S_BENCH_SESSION*)Event->UsrCtx)->ClientId, Reason, Err);
+    __atomic_fetch_add(&g_Failed, 1, __ATOMIC_RELEASE);
+    return;
+}
+
+/**
+ * @brief               Connect a session to the broker and open it
+ * @param[in,out]       Loop                Event Loop
+ * @param[in,out]       Broker              Broker
+ * @param[in,out]       Session             Session
+ * @param[in]           Index               Index of the session
+ * @param[in]           Fanout              Subscribe the topics of all sessions
+ * @retval              0                   success
+ * @retval              -1                  fail
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_session_open(S_EVENT_LOOP* Loop, S_BROKER* Broker, S_BENCH_SESSION* Session, uint32_t Index, bool Fanout)
+{
+    int     Fd  =   -1;
+
+    snprintf(Session->ClientId, sizeof(Session->ClientId), "loopback-%u", Index);
+    snprintf(Session->Topic, sizeof(Session->Topic), "loopback/%u", Index);
+    snprintf(Session->Filter, sizeof(Session->Filter), "%s", (Fanout)?("loopback/+"):(Session->Topic));
+    if(wrapper_init(&(Session->Platform)))
+    {
+        return (-1);
+    }
+    if(broker_connect(Broker, &Fd))
+    {
+        return (-1);
+    }
+    Session->Platform.SocketFd = Fd;
+
+    Session->Handler.UsrCtx                 =   Session;
+    Session->Handler.CleanSession           =   true;
+    Session->Handler.ClientId.Data          =   (uint8_t*)Session->ClientId;
+    Session->Handler.ClientId.Length        =   strlen(Session->ClientId);
+    Session->Handler.KeepAliveInterval      =   60;
+    Session->Handler.MessageRetryInterval   =   60;
+    Session->Handler.MessageRetryCount      =   3;
+    Session->Handler.MallocFunc             =   malloc;
+    Session->Handler.FreeFunc               =   free;
+    Session->Handler.LockFunc               =   bench_lock;
+    Session->Handler.UnlockFunc             =   bench_unlock;
+    Session->Handler.WriteFuncCB            =   bench_write;
+    Session->Handler.ReadFuncCB             =   bench_read;
+    Session->Handler.OpenResetFuncCB        =   bench_opened;
+    Session->Handler.MaxInflight            =   D_BENCH_MAX_INFLIGHT;
+
+    if(D_MQC_RET_OK != MQC_Start(&(Session->Handler), systick_wrapper()))
+    {
+        return (-1);
+    }
+    Session->Event.Handler      =   &(Session->Handler);
+    Session->Event.SocketFd     =   Fd;
+    Session->Event.CloseFuncCB  =   bench_closed;
+    Session->Event.UsrCtx       =   Session;
+    if(eventloop_add(Loop, &(Session->Event)))
+    {
+        return (-1);
+    }
+    if(D_MQC_RET_OK != MQC_Open(&(Session->Handler), D_BENCH_OPEN_TIMEOUT))
+    {
+        return (-1);
+    }
+    return 0;
+}
+
+/**
+ * @brief               Compare two latency samples for qsort()
+ * @param[in]           A                   Sample
+ * @param[in]           B                   Sample
+ * @return              Order of the samples
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int bench_compare(const void* A, const void* B)
+{
+    uint64_t    ValueA  =   *(const uint64_t*)A;
+    uint64_t    ValueB  =   *(const uint64_t*)B;
+
+    return (ValueA > ValueB) - (ValueA < ValueB);
+}
+
+/**
+ * @brief               Print the percentiles of the latency samples
+ * @param[in]           Name                Name of the samples
+ * @param[in,out]       Sample              Samples (sorted by this function)
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_percentile(const char* Name, S_BENCH_SAMPLE* Sample)
+{
+    uint64_t    Num     =   (Sample->Count < D_BENCH_SAMPLE_MAX)?(Sample->Count):(D_BENCH_SAMPLE_MAX);
+
+    if(!Num)
+    {
+        return;
+    }
+    qsort(Sample->Data, Num, sizeof(uint64_t), bench_compare);
+    printf("%-32s p50 %10.1f us  p99 %10.1f us  p999 %10.1f us\n", Name,
+           Sample->Data[(Num - 1) * 50 / 100] / 1000.0,
+           Sample->Data[(Num - 1) * 99 / 100] / 1000.0,
+           Sample->Data[(Num - 1) * 999 / 1000] / 1000.0);
+    return;
+}
+
+/**
+ * @brief               Sleep until a time
+ * @param[in]           Until               Monotonic time with nanosecond
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_sleep_until(uint64_t Until)
+{
+    struct timespec Time;
+
+    Time.tv_sec     =   (time_t)(Until / 1000000000ull);
+    Time.tv_nsec    =   (long)(Until % 1000000000ull);
+    while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Time, NULL))
+    {
+    }
+    return;
+}
+
+/**
+ * @brief               Publish the Messages of one QoS by all sessions and report the result
+ * @param[in,out]       Sessions            Sessions
+ * @param[in]           SessionNum          Number of the sessions
+ * @param[in]           QoS                 QoS of the Messages
+ * @param[in]           Rate                Messages per second of one session (0 means no limit)
+ * @param[in]           MsgNum              Messages of one session
+ * @param[in]           PayloadSize         Payload size
+ * @param[in]           Fanout              Each Message is delivered to all sessions
+ * @return              None
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_phase(S_BENCH_SESSION* Sessions, uint32_t SessionNum, E_MQC_QOS_LEVEL QoS, uint32_t Rate, uint32_t MsgNum, uint32_t PayloadSize, bool Fanout)
+{
+    S_MQC_MESSAGE_INFO  Message;
+    uint64_t            AckExpected         =   (E_MQC_QOS_0 != QoS)?((uint64_t)SessionNum * MsgNum):(0);
+    uint64_t            DeliveryExpected    =   (uint64_t)SessionNum * MsgNum * ((Fanout)?(SessionNum):(1));
+    uint64_t            Start               =   0;
+    uint64_t            End                 =   0;
+    uint64_t            Now                 =   0;
+    uint32_t            Published           =   0;
+    uint32_t            i                   =   0;
+    uint32_t            j                   =   0;
+    int32_t             Err                 =   D_MQC_RET_OK;
+    char                Name[32];
+
+    g_Ack.Count         =   0;
+    g_Delivery.Count    =   0;
+    __atomic_store_n(&g_Phase, (uint8_t)QoS, __ATOMIC_RELEASE);
+
+    Start = Bench_NowNs();
+    for(i = 0; i < MsgNum; i++)
+    {
+        if(Rate)
+        {
+            bench_sleep_until(Start + (uint64_t)i * 1000000000ull / Rate);
+        }
+        for(j = 0; j < SessionNum; j++)
+        {
+            Now = Bench_NowNs();
+            memcpy(Sessions[j].Payload, &Now, sizeof(Now));
+            Sessions[j].Payload[8]  =   (uint8_t)QoS;
+            Message.Topic.Data      =   (uint8_t*)Sessions[j].Topic;
+            Message.Topic.Length    =   strlen(Sessions[j].Topic);
+            Message.Content         =   Sessions[j].Payload;
+            Message.Length          =   PayloadSize;
+            /* D_MQC_RET_BUSY : all Packet Identifiers are in use, wait for the former Messages */
+            while(D_MQC_RET_BUSY == (Err = MQC_Publish(&(Sessions[j].Handler), &Message, QoS, false, bench_published)))
+            {
+                sched_yield();
+            }
+            if(D_MQC_RET_OK == Err)
+            {
+                Published++;
+            }
+        }
+    }
+
+    /* Wait for all acks and deliveries */
+    End = Bench_NowNs();
+    while( (__atomic_load_n(&g_Ack.Count, __ATOMIC_ACQUIRE) < AckExpected) ||
+           (__atomic_load_n(&g_Delivery.Count, __ATOMIC_ACQUIRE) < DeliveryExpected) )
+    {
+        if( (Bench_NowNs() - End) > (uint64_t)D_BENCH_DRAIN_TIMEOUT * 1000000ull )
+        {
+            printf("qos%u timeout : %u published, %llu/%llu acked, %llu/%llu delivered\n", (uint32_t)QoS, Published,
+                   (unsigned long long)g_Ack.Count, (unsigned long long)AckExpected,
+                   (unsigned long long)g_Delivery.Count, (unsigned long long)DeliveryExpected);
+            break;
+        }
+        bench_sleep_until(Bench_NowNs() + 100000);
+    }
+    End = Bench_NowNs();
+
+    snprintf(Name, sizeof(Name), "qos%u delivered", (uint32_t)QoS);
+    printf("%-32s %12.1f msgs/s %12.1f MB/s\n", Name,
+           (double)g_Delivery.Count * 1e9 / (End - Start),
+           (double)g_Delivery.Count * PayloadSize * 1e3 / (End - Start));
+    snprintf(Name, sizeof(Name), "qos%u ack", (uint32_t)QoS);
+    bench_percentile(Name, &g_Ack);
+    snprintf(Name, sizeof(Name), "qos%u delivery", (uint32_t)QoS);
+    bench_percentile(Name, &g_Delivery);
+    return;
+}
+
+/**
+ * @brief               main function
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main( int argc, char *argv[] )
+{
+    S_EVENT_LOOP        Loop;
+    S_BROKER            Broker;
+    S_BENCH_SESSION*    Sessions    =   NULL;
+    uint32_t            SessionNum  =   (argc > 1)?((uint32_t)atoi(argv[1])):(D_BENCH_SESSION_NUM);
+    uint32_t            Rate        =   (argc > 2)?((uint32_t)atoi(argv[2])):(D_BENCH_RATE);
+    uint32_t            MsgNum      =   (argc > 3)?((uint32_t)atoi(argv[3])):(D_BENCH_MSG_NUM);
+    uint32_t            PayloadSize =   (argc > 4)?((uint32_t)atoi(argv[4])):(D_BENCH_PAYLOAD_SIZE);
+    uint32_t            WorkerNum   =   (argc > 5)?((uint32_t)atoi(argv[5])):(D_BENCH_WORKER_NUM);
+    bool                Fanout      =   (argc > 6)?(0 != atoi(argv[6])):(false);
+    uint32_t            Opened      =   0;
+    uint64_t            Deadline    =   0;
+    uint32_t            i           =   0;
+
+    if( (!SessionNum) || (!MsgNum) || (D_BENCH_PAYLOAD_MIN > PayloadSize) || (D_BENCH_PAYLOAD_MAX < PayloadSize) )
+    {
+        printf("Usage : %s [sessions] [msgs/s per session] [msgs per session] [payload size (%d-%d)] [workers] [fanout]\n",
+               argv[0], D_BENCH_PAYLOAD_MIN, D_BENCH_PAYLOAD_MAX);
+        return (-1);
+    }
+    signal(SIGPIPE, SIG_IGN);
+    Sessions            =   (S_BENCH_SESSION*)calloc(SessionNum, sizeof(S_BENCH_SESSION));
+    g_Ack.Data          =   (uint64_t*)malloc(D_BENCH_SAMPLE_MAX * sizeof(uint64_t));
+    g_Delivery.Data     =   (uint64_t*)malloc(D_BENCH_SAMPLE_MAX * sizeof(uint64_t));
+    if( (!Sessions) || (!g_Ack.Data) || (!g_Delivery.Data) )
+    {
+        printf(" failed\n  ! malloc()\n\n");
+        return (-1);
+    }
+    if(broker_start(&Broker, SessionNum))
+    {
+        printf(" failed\n  ! broker_start()\n\n");
+        return (-1);
+    }
+    if(eventloop_start(&Loop, WorkerNum, D_BENCH_TICK_INTERVAL))
+    {
+        printf(" failed\n  ! eventloop_start()\n\n");
+        broker_stop(&Broker);
+        return (-1);
+    }
+
+    for(Opened = 0; Opened < SessionNum; Opened++)
+    {
+        Sessions[Opened].Payload = (uint8_t*)calloc(1, PayloadSize);
+        if( (!Sessions[Opened].Payload) || bench_session_open(&Loop, &Broker, &(Sessions[Opened]), Opened, Fanout) )
+        {
+            printf(" failed\n  ! open session %u\n\n", Opened);
+            eventloop_remove(&(Sessions[Opened].Event));
+            (void)MQC_Stop(&(Sessions[Opened].Handler));
+            wrapper_deinit(&(Sessions[Opened].Platform));
+            free(Sessions[Opened].Payload);
+            break;
+        }
+    }
+    Deadline = Bench_NowNs() + (uint64_t)D_BENCH_OPEN_TIMEOUT * 1000000ull;
+    while( (__atomic_load_n(&g_Subscribed, __ATOMIC_ACQUIRE) < Opened) && (!__atomic_load_n(&g_Failed, __ATOMIC_ACQUIRE)) && (Bench_NowNs() < Deadline) )
+    {
+        bench_sleep_until(Bench_NowNs() + 1000000);
+    }
+
+    if( (Opened == SessionNum) && (Opened == g_Subscribed) )
+    {
+        printf("%u sessions, %u workers, %u msgs/s each, %u msgs each, payload %u bytes%s\n",
+               SessionNum, WorkerNum, Rate, MsgNum, PayloadSize, (Fanout)?(", fanout"):(""));
+        bench_phase(Sessions, SessionNum, E_MQC_QOS_0, Rate, MsgNum, PayloadSize, Fanout);
+        bench_phase(Sessions, SessionNum, E_MQC_QOS_1, Rate, MsgNum, PayloadSize, Fanout);
+        bench_phase(Sessions, SessionNum, E_MQC_QOS_2, Rate, MsgNum, PayloadSize, Fanout);
+        pthread_mutex_lock(&Broker.Mutex);
+        printf("%-32s %12llu received %12llu forwarded\n", "broker",
+               (unsigned long long)Broker.Received, (unsigned long long)Broker.Forwarded);
+        pthread_mutex_unlock(&Broker.Mutex);
+    }
+    else
+    {
+        printf(" failed\n  ! %u of %u sessions subscribed\n\n", g_Subscribed, SessionNum);
+    }
+
+    for(i = 0; i < Opened; i++)
+    {
+        (void)MQC_Close(&(Sessions[i].Handler));
+        eventloop_remove(&(Sessions[i].Event));
+        (void)MQC_Stop(&(Sessions[i].Handler));
+        wrapper_deinit(&(Sessions[i].Platform));
+        free(Sessions[i].Payload);
+    }
+    eventloop_stop(&Loop);
+    broker_stop(&Broker);
+    free(g_Ack.Data);
+    free(g_Delivery.Data);
+    free(Sessions);
+    return 0;
+}
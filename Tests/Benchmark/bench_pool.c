@@ -0,0 +1,281 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_pool.c
+ * @brief       Micro benchmark of the allocators used for the objects of the session.
+ *              The fixed size pool (CLIB_pool), the heap (CLIB_heap, both engines) and the C library malloc
+ *              allocate and free the same sequence of small blocks.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Add the TLSF engine of CLIB_heap and the case with fragmentation
+ * @version     00.00.03
+ *              - 2026/10/17 : agent@local
+ *                  -# Dump the heap statistics in the case with fragmentation
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+#include "../../CommonLib/CLIB_api.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_LIVE_NUM        (64)                /*!< Blocks alive at the same time (like the Messages in flight) */
+#define D_BENCH_SMALL_SIZE      (4)                 /*!< Size of an acknowledge Message */
+#define D_BENCH_LARGE_SIZE      (128)               /*!< Size of about a Message context */
+#define D_BENCH_HEAP_SIZE       (8 * 1024 * 1024)   /*!< Memory of the heap */
+#define D_BENCH_FRAG_NUM        (4096)              /*!< Blocks alive at the same time in the case with fragmentation */
+#define D_BENCH_FRAG_SIZE_MAX   (1024)              /*!< Maximum block size in the case with fragmentation */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the allocator benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_POOL_CTX
+{
+    void*                   (*Malloc)(size_t Size);
+    void                    (*Free)(void* Ptr);
+    void*                   Live[D_BENCH_FRAG_NUM];
+    uint32_t                Seed;
+}S_BENCH_POOL_CTX;
+
+/**************************************************************
+**  Variable
+**************************************************************/
+
+static S_POOL_HANDLE    BenchPool;
+static S_HEAP_HANDLE    BenchHeap;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+static void* bench_pool_malloc(size_t Size)     { return CLIB_pool_malloc(&BenchPool, Size); }
+static void  bench_pool_free(void* Ptr)         { (void)CLIB_pool_free(&BenchPool, Ptr); }
+static void* bench_heap_malloc(size_t Size)     { return CLIB_heap_malloc(&BenchHeap, Size); }
+static void  bench_heap_free(void* Ptr)         { CLIB_heap_free(&BenchHeap, Ptr); }
+
+/**
+ * @brief               Allocate and free one block at once (acknowledge Message)
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_pair(void* Ctx, uint32_t Count)
+{
+    S_BENCH_POOL_CTX*   BenchCtx    =   (S_BENCH_POOL_CTX*)Ctx;
+    void*               Ptr         =   NULL;
+    uint32_t            i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        Ptr = BenchCtx->Malloc(D_BENCH_SMALL_SIZE);
+        if(!Ptr)
+        {
+            printf("No enough memory\n");
+            exit(1);
+        }
+        *((volatile uint8_t*)Ptr) = (uint8_t)i;
+        BenchCtx->Free(Ptr);
+    }
+}
+
+/**
+ * @brief               Keep some blocks alive and replace them out of order (Messages in flight)
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_churn(void* Ctx, uint32_t Count)
+{
+    S_BENCH_POOL_CTX*   BenchCtx    =   (S_BENCH_POOL_CTX*)Ctx;
+    uint32_t            Index       =   0;
+    uint32_t            i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        /* the responses do not come in order */
+        Index = (i * 37) % D_BENCH_LIVE_NUM;
+        BenchCtx->Free(BenchCtx->Live[Index]);
+        BenchCtx->Live[Index] = BenchCtx->Malloc((i & 1)?(D_BENCH_SMALL_SIZE):(D_BENCH_LARGE_SIZE));
+        if(!BenchCtx->Live[Index])
+        {
+            printf("No enough memory\n");
+            exit(1);
+        }
+    }
+}
+
+/**
+ * @brief               Keep many blocks with random size alive and replace them at random (fragmented heap)
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the operations
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_frag(void* Ctx, uint32_t Count)
+{
+    S_BENCH_POOL_CTX*   BenchCtx    =   (S_BENCH_POOL_CTX*)Ctx;
+    uint32_t            Index       =   0;
+    uint32_t            i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        BenchCtx->Seed = BenchCtx->Seed * 1103515245u + 12345u;
+        Index = (BenchCtx->Seed >> 8) % D_BENCH_FRAG_NUM;
+        BenchCtx->Free(BenchCtx->Live[Index]);
+        BenchCtx->Live[Index] = BenchCtx->Malloc(16 + (BenchCtx->Seed >> 4) % D_BENCH_FRAG_SIZE_MAX);
+        if(!BenchCtx->Live[Index])
+        {
+            printf("No enough memory\n");
+            exit(1);
+        }
+    }
+}
+
+/**
+ * @brief               Run the case with fragmentation with an allocator
+ * @param[in]           Name                    Name of the allocator
+ * @param[in]           Malloc                  Memory allocate function
+ * @param[in]           Free                    Memory free function
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_frag_case(const char* Name, void* (*Malloc)(size_t Size), void (*Free)(void* Ptr))
+{
+    static S_BENCH_POOL_CTX BenchCtx;
+    char                    CaseName[64];
+    uint32_t                i           =   0;
+
+    memset(&BenchCtx, 0, sizeof(BenchCtx));
+    BenchCtx.Malloc = Malloc;
+    BenchCtx.Free   = Free;
+    BenchCtx.Seed   = 1;
+
+    for(i = 0; i < D_BENCH_FRAG_NUM; i++)
+    {
+        BenchCtx.Live[i] = Malloc(16 + (i * 7919) % D_BENCH_FRAG_SIZE_MAX);
+    }
+    snprintf(CaseName, sizeof(CaseName), "alloc/frag%d/%s", D_BENCH_FRAG_NUM, Name);
+    Bench_Print(CaseName, Bench_Run(&BenchCtx, bench_frag, 1000000, D_BENCH_DEFAULT_ROUNDS));
+#if defined(CLIB_HEAP_STATISTICS)
+    if(bench_heap_malloc == Malloc)
+    {
+        /* the blocks are still alive, so the fragmentation can be seen */
+        (void)CLIB_heap_DumpStatistics(&BenchHeap, printf);
+    }
+#endif
+    for(i = 0; i < D_BENCH_FRAG_NUM; i++)
+    {
+        Free(BenchCtx.Live[i]);
+    }
+}
+
+/**
+ * @brief               Run the cases with an allocator
+ * @param[in]           Name                    Name of the allocator
+ * @param[in]           Malloc                  Memory allocate function
+ * @param[in]           Free                    Memory free function
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_pool_case(const char* Name, void* (*Malloc)(size_t Size), void (*Free)(void* Ptr))
+{
+    static S_BENCH_POOL_CTX BenchCtx;
+    char                    CaseName[64];
+    uint32_t                i           =   0;
+
+    memset(&BenchCtx, 0, sizeof(BenchCtx));
+    BenchCtx.Malloc = Malloc;
+    BenchCtx.Free   = Free;
+
+    snprintf(CaseName, sizeof(CaseName), "alloc/pair/%s", Name);
+    Bench_Print(CaseName, Bench_Run(&BenchCtx, bench_pair, 10000000, D_BENCH_DEFAULT_ROUNDS));
+
+    for(i = 0; i < D_BENCH_LIVE_NUM; i++)
+    {
+        BenchCtx.Live[i] = Malloc((i & 1)?(D_BENCH_SMALL_SIZE):(D_BENCH_LARGE_SIZE));
+    }
+    snprintf(CaseName, sizeof(CaseName), "alloc/churn%d/%s", D_BENCH_LIVE_NUM, Name);
+    Bench_Print(CaseName, Bench_Run(&BenchCtx, bench_churn, 10000000, D_BENCH_DEFAULT_ROUNDS));
+    for(i = 0; i < D_BENCH_LIVE_NUM; i++)
+    {
+        Free(BenchCtx.Live[i]);
+    }
+}
+
+/**
+ * @brief               Main function of the allocator benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    static uint8_t          HeapMemory[D_BENCH_HEAP_SIZE];
+    static const size_t     BlockSize[] =   { D_BENCH_SMALL_SIZE, D_BENCH_LARGE_SIZE };
+    static const size_t     BlockNum[]  =   { D_BENCH_LIVE_NUM, D_BENCH_LIVE_NUM };
+
+    if( CLIB_pool_create(&BenchPool, HeapMemory, sizeof(HeapMemory), BlockSize, BlockNum, 2, NULL, NULL, NULL) )
+    {
+        printf("Failed to create the pool\n");
+        return 1;
+    }
+    bench_pool_case("pool", bench_pool_malloc, bench_pool_free);
+    (void)CLIB_pool_delete(&BenchPool);
+
+    if( CLIB_heap_create(&BenchHeap, HeapMemory, sizeof(HeapMemory), 8, NULL, NULL, NULL) )
+    {
+        printf("Failed to create the heap\n");
+        return 1;
+    }
+    bench_pool_case("heap", bench_heap_malloc, bench_heap_free);
+    bench_frag_case("heap", bench_heap_malloc, bench_heap_free);
+    (void)CLIB_heap_delete(&BenchHeap);
+
+    if( CLIB_heap_create_ex(&BenchHeap, HeapMemory, sizeof(HeapMemory), 8, E_HEAP_ENGINE_TLSF, NULL, NULL, NULL) )
+    {
+        printf("Failed to create the heap\n");
+        return 1;
+    }
+    bench_pool_case("heap-tlsf", bench_heap_malloc, bench_heap_free);
+    bench_frag_case("heap-tlsf", bench_heap_malloc, bench_heap_free);
+    (void)CLIB_heap_delete(&BenchHeap);
+
+    bench_pool_case("malloc", malloc, free);
+    bench_frag_case("malloc", malloc, free);
+    return 0;
+}
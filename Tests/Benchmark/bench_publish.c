@@ -0,0 +1,223 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_publish.c
+ * @brief       Micro benchmark of the PUBLISH Message sending path.
+ *              The transport is replaced by a callback which only touches the data,
+ *              so the result shows the cost of the library itself.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ * @version     00.00.02
+ *              - 2026/10/17 : agent@local
+ *                  -# Add the case with the output batch
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_TOPIC           "bench/publish"     /*!< Topic of the PUBLISH Message */
+#define D_BENCH_BATCH_SIZE      (1460)              /*!< Output batch size of the case with batch (one TCP segment) */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the PUBLISH benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_PUBLISH_CTX
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    S_MQC_MESSAGE_INFO      Message;
+    E_MQC_QOS_LEVEL         QoS;
+    uint16_t                PacketIdentifier;
+    uint64_t                WriteBytes;
+    uint8_t                 Sink;
+}S_BENCH_PUBLISH_CTX;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Write callback which drops the data
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_write_callback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    S_BENCH_PUBLISH_CTX*    BenchCtx    =   (S_BENCH_PUBLISH_CTX*)Ctx;
+    uint32_t                Offset      =   1;
+    uint16_t                TopicLength =   0;
+
+    BenchCtx->WriteBytes += Size;
+    BenchCtx->Sink ^= Data[Size - 1];
+    /* remember the Packet Identifier of the PUBLISH Message with QoS */
+    if( ((E_MQC_MSG_PUBLISH << 4) == (Data[0] & 0xF0)) && (Data[0] & 0x06) )
+    {
+        while(Data[Offset++] & 128);
+        TopicLength = (uint16_t)((Data[Offset] << 8) | Data[Offset + 1]);
+        Offset = Offset + sizeof(uint16_t) + TopicLength;
+        BenchCtx->PacketIdentifier = (uint16_t)((Data[Offset] << 8) | Data[Offset + 1]);
+    }
+    return 0;
+}
+
+/**
+ * @brief               Write callback with segments which drops the data
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_writevec_callback(void* Ctx, const S_MQC_IOVEC* Vec, uint32_t VecNum)
+{
+    S_BENCH_PUBLISH_CTX*    BenchCtx    =   (S_BENCH_PUBLISH_CTX*)Ctx;
+    uint32_t                i           =   0;
+
+    for(i = 0; i < VecNum; i++)
+    {
+        BenchCtx->WriteBytes += Vec[i].Size;
+        BenchCtx->Sink ^= Vec[i].Data[Vec[i].Size - 1];
+    }
+    return 0;
+}
+
+/**
+ * @brief               Publish some messages
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the messages
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_publish(void* Ctx, uint32_t Count)
+{
+    S_BENCH_PUBLISH_CTX*    BenchCtx    =   (S_BENCH_PUBLISH_CTX*)Ctx;
+    uint8_t                 Puback[4]   =   { (E_MQC_MSG_PUBACK << 4), 2, 0, 0 };
+    uint32_t                i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        if(MQC_Publish(&BenchCtx->Handler, &BenchCtx->Message, BenchCtx->QoS, false, NULL))
+        {
+            printf("MQC_Publish failed\n");
+            exit(1);
+        }
+        if(E_MQC_QOS_1 == BenchCtx->QoS)
+        {
+            /* acknowledge it at once to keep the message queue short */
+            Puback[2] = (uint8_t)(BenchCtx->PacketIdentifier >> 8);
+            Puback[3] = (uint8_t)(BenchCtx->PacketIdentifier);
+            (void)MQC_Read(&BenchCtx->Handler, Puback, sizeof(Puback));
+        }
+    }
+}
+
+/**
+ * @brief               Run the PUBLISH benchmark with a payload size and a QoS level
+ * @param[in]           PayloadSize             Size of the payload
+ * @param[in]           QoS                     QoS level
+ * @param[in]           WriteVec                Write the Message by WriteVecFuncCB
+ * @param[in]           WriteBatchSize          Size of the output batch (0 means no batch)
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_publish_case(uint32_t PayloadSize, E_MQC_QOS_LEVEL QoS, bool WriteVec, uint32_t WriteBatchSize)
+{
+    static S_BENCH_PUBLISH_CTX  BenchCtx;
+    uint8_t*                    Payload     =   NULL;
+    uint32_t                    Count       =   0;
+    char                        Name[64];
+
+    Payload = malloc(PayloadSize);
+    if(!Payload)
+    {
+        printf("No enough memory\n");
+        exit(1);
+    }
+    memset(Payload, 0x5A, PayloadSize);
+    memset(&BenchCtx, 0, sizeof(BenchCtx));
+    BenchCtx.Message.Topic.Data             = (uint8_t*)D_BENCH_TOPIC;
+    BenchCtx.Message.Topic.Length           = strlen(D_BENCH_TOPIC);
+    BenchCtx.Message.Content                = Payload;
+    BenchCtx.Message.Length                 = PayloadSize;
+    BenchCtx.QoS                            = QoS;
+    Bench_SessionInit(&BenchCtx.Handler, &BenchCtx, bench_write_callback);
+    BenchCtx.Handler.WriteVecFuncCB         = (WriteVec)?(bench_writevec_callback):(NULL);
+    BenchCtx.Handler.WriteBatchSize         = WriteBatchSize;
+    Bench_SessionStart(&BenchCtx.Handler);
+    Bench_SessionConnect(&BenchCtx.Handler);
+
+    /* keep the copied bytes of each case in the same order */
+    Count = (uint32_t)(256u * 1024u * 1024u / (PayloadSize + 64));
+    if(Count > 1000000)
+    {
+        Count = 1000000;
+    }
+    snprintf(Name, sizeof(Name), "publish/qos%d%s%s/%u", (int)QoS, (WriteVec)?("-vec"):(""), (WriteBatchSize)?("-batch"):(""), PayloadSize);
+    Bench_Print(Name, Bench_Run(&BenchCtx, bench_publish, Count, D_BENCH_DEFAULT_ROUNDS));
+    if(WriteBatchSize)
+    {
+        (void)MQC_Flush(&BenchCtx.Handler);
+    }
+
+    MQC_Stop(&BenchCtx.Handler);
+    free(Payload);
+}
+
+/**
+ * @brief               Main function of the PUBLISH benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    static const uint32_t   PayloadSize[]   =   { 16, 1024, 65536 };
+    uint32_t                i               =   0;
+
+    for(i = 0; i < sizeof(PayloadSize)/sizeof(PayloadSize[0]); i++)
+    {
+        bench_publish_case(PayloadSize[i], E_MQC_QOS_0, false, 0);
+    }
+    for(i = 0; i < sizeof(PayloadSize)/sizeof(PayloadSize[0]); i++)
+    {
+        bench_publish_case(PayloadSize[i], E_MQC_QOS_0, true, 0);
+    }
+    for(i = 0; i < sizeof(PayloadSize)/sizeof(PayloadSize[0]); i++)
+    {
+        bench_publish_case(PayloadSize[i], E_MQC_QOS_0, true, D_BENCH_BATCH_SIZE);
+    }
+    for(i = 0; i < sizeof(PayloadSize)/sizeof(PayloadSize[0]); i++)
+    {
+        bench_publish_case(PayloadSize[i], E_MQC_QOS_1, false, 0);
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_queue.c
+ * @brief       Micro benchmark of the Message Queue lookup.
+ *              A number of QoS1 PUBLISH Messages are kept in flight, then all
+ *              of the PUBACK Messages are fed to the library at once, so the
+ *              result shows the cost to find and remove one in-flight Message.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_TOPIC           "bench/queue"       /*!< Topic of the PUBLISH Message */
+#define D_BENCH_PUBACK_SIZE     (4)                 /*!< Size of a PUBACK Message */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the Message Queue benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_QUEUE_CTX
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    S_MQC_MESSAGE_INFO      Message;
+    uint16_t*               PacketIdentifier;
+    uint32_t                PublishCount;
+}S_BENCH_QUEUE_CTX;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Write callback which remembers the Packet Identifier of the PUBLISH Message
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_write_callback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    S_BENCH_QUEUE_CTX*  BenchCtx    =   (S_BENCH_QUEUE_CTX*)Ctx;
+    uint32_t            Offset      =   1;
+    uint16_t            TopicLength =   0;
+
+    if( ((E_MQC_MSG_PUBLISH << 4) == (Data[0] & 0xF0)) && (Data[0] & 0x06) )
+    {
+        while(Data[Offset++] & 128);
+        TopicLength = (uint16_t)((Data[Offset] << 8) | Data[Offset + 1]);
+        Offset = Offset + sizeof(uint16_t) + TopicLength;
+        BenchCtx->PacketIdentifier[BenchCtx->PublishCount++] = (uint16_t)((Data[Offset] << 8) | Data[Offset + 1]);
+    }
+    return 0;
+}
+
+/**
+ * @brief               Run the Message Queue benchmark with a number of in-flight Messages
+ * @param[in]           Depth                   Number of the in-flight Messages
+ * @param[in]           Reverse                 Acknowledge the newest Message first
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_queue_case(uint32_t Depth, bool Reverse)
+{
+    static S_BENCH_QUEUE_CTX    BenchCtx;
+    uint8_t                     Payload[16];
+    uint8_t*                    Puback      =   NULL;
+    uint8_t*                    Ack         =   NULL;
+    uint64_t                    StartNs     =   0;
+    uint64_t                    StartCycles =   0;
+    S_BENCH_RESULT              Best        =   { 0, 0 };
+    S_BENCH_RESULT              Result      =   { 0, 0 };
+    uint32_t                    Rounds      =   0;
+    uint32_t                    i           =   0;
+    uint32_t                    j           =   0;
+    char                        Name[64];
+
+    memset(Payload, 0x5A, sizeof(Payload));
+    memset(&BenchCtx, 0, sizeof(BenchCtx));
+    BenchCtx.PacketIdentifier   = malloc(Depth * sizeof(uint16_t));
+    Puback                      = malloc(Depth * D_BENCH_PUBACK_SIZE);
+    if( (!BenchCtx.PacketIdentifier) || (!Puback) )
+    {
+        printf("No enough memory\n");
+        exit(1);
+    }
+    BenchCtx.Message.Topic.Data             = (uint8_t*)D_BENCH_TOPIC;
+    BenchCtx.Message.Topic.Length           = strlen(D_BENCH_TOPIC);
+    BenchCtx.Message.Content                = Payload;
+    BenchCtx.Message.Length                 = sizeof(Payload);
+    Bench_SessionOpen(&BenchCtx.Handler, &BenchCtx, bench_write_callback);
+
+    /* keep the acknowledged Messages of each case in the same order */
+    Rounds = 200000 / Depth + 1;
+    if(Rounds > D_BENCH_DEFAULT_ROUNDS * 20)
+    {
+        Rounds = D_BENCH_DEFAULT_ROUNDS * 20;
+    }
+    for(i = 0; i < Rounds; i++)
+    {
+        /* fill the Message Queue (not measured) */
+        BenchCtx.PublishCount = 0;
+        for(j = 0; j < Depth; j++)
+        {
+            if(MQC_Publish(&BenchCtx.Handler, &BenchCtx.Message, E_MQC_QOS_1, false, NULL))
+            {
+                printf("MQC_Publish failed\n");
+                exit(1);
+            }
+        }
+        for(j = 0; j < Depth; j++)
+        {
+            Ack     = Puback + ((Reverse)?(Depth - 1 - j):(j)) * D_BENCH_PUBACK_SIZE;
+            Ack[0]  = (E_MQC_MSG_PUBACK << 4);
+            Ack[1]  = 2;
+            Ack[2]  = (uint8_t)(BenchCtx.PacketIdentifier[j] >> 8);
+            Ack[3]  = (uint8_t)(BenchCtx.PacketIdentifier[j]);
+        }
+        /* acknowledge all of them */
+        StartNs     = Bench_NowNs();
+        StartCycles = Bench_NowCycles();
+        if(MQC_Read(&BenchCtx.Handler, Puback, Depth * D_BENCH_PUBACK_SIZE))
+        {
+            printf("MQC_Read failed\n");
+            exit(1);
+        }
+        Result.CyclesPerOp  = (double)(Bench_NowCycles() - StartCycles) / Depth;
+        Result.NsPerOp      = (double)(Bench_NowNs() - StartNs) / Depth;
+        if( (0 == i) || (Result.NsPerOp < Best.NsPerOp) )
+        {
+            Best = Result;
+        }
+    }
+    snprintf(Name, sizeof(Name), "queue/puback%s/%u", (Reverse)?("-reverse"):(""), Depth);
+    Bench_Print(Name, Best);
+
+    MQC_Stop(&BenchCtx.Handler);
+    free(BenchCtx.PacketIdentifier);
+    free(Puback);
+}
+
+/**
+ * @brief               Main function of the Message Queue benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    static const uint32_t   Depth[]     =   { 10, 100, 1000, 10000, 65535 };
+    uint32_t                i           =   0;
+
+    for(i = 0; i < sizeof(Depth)/sizeof(Depth[0]); i++)
+    {
+        bench_queue_case(Depth[i], false);
+    }
+    for(i = 0; i < sizeof(Depth)/sizeof(Depth[0]); i++)
+    {
+        bench_queue_case(Depth[i], true);
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (C) 2018, ZhaoZhenge, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**************************************************************
+**  Mbed MQTT Client Library with C
+**************************************************************/
+/**
+ * @example     bench_timer.c
+ * @brief       Micro benchmark of the retry timer.
+ *              A number of QoS1 PUBLISH Messages are kept in flight, then
+ *              MQC_Continue is called with 1 millisecond ticks while no Message
+ *              times out, so the result shows the cost of one idle tick.
+ * @author      agent@local
+ *
+ * @version     00.00.01
+ *              - 2026/10/17 : agent@local
+ *                  -# New
+ */
+
+/**************************************************************
+**  Include
+**************************************************************/
+
+#include "bench_common.h"
+
+/**************************************************************
+**  Symbol
+**************************************************************/
+
+#define D_BENCH_TOPIC           "bench/timer"       /*!< Topic of the PUBLISH Message */
+#define D_BENCH_TICK_COUNT      (4000)              /*!< Ticks of one round */
+
+/**************************************************************
+**  Structure
+**************************************************************/
+
+/**
+ * @brief      Context of the retry timer benchmark
+ * @author     agent@local
+ * @date       2026/10/17
+ */
+typedef struct _S_BENCH_TIMER_CTX
+{
+    S_MQC_SESSION_HANDLE    Handler;
+    S_MQC_MESSAGE_INFO      Message;
+    uint32_t                SystimeCount;
+    uint64_t                WriteCount;
+}S_BENCH_TIMER_CTX;
+
+/**************************************************************
+**  Function
+**************************************************************/
+
+/**
+ * @brief               Write callback which counts the Messages
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static int32_t bench_write_callback(void* Ctx, const uint8_t* Data, size_t Size)
+{
+    S_BENCH_TIMER_CTX*  BenchCtx    =   (S_BENCH_TIMER_CTX*)Ctx;
+
+    BenchCtx->WriteCount++;
+    return 0;
+}
+
+/**
+ * @brief               Drive the timer of the session with 1 millisecond ticks
+ * @param[in]           Ctx                     Context of the benchmark
+ * @param[in]           Count                   Count of the ticks
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_tick(void* Ctx, uint32_t Count)
+{
+    S_BENCH_TIMER_CTX*  BenchCtx    =   (S_BENCH_TIMER_CTX*)Ctx;
+    uint32_t            i           =   0;
+
+    for(i = 0; i < Count; i++)
+    {
+        BenchCtx->SystimeCount++;
+        MQC_Continue(&BenchCtx->Handler, BenchCtx->SystimeCount);
+    }
+}
+
+/**
+ * @brief               Run the retry timer benchmark with a number of in-flight Messages
+ * @param[in]           Depth                   Number of the in-flight Messages
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+static void bench_timer_case(uint32_t Depth)
+{
+    static S_BENCH_TIMER_CTX    BenchCtx;
+    uint8_t                     Payload[16];
+    uint64_t                    WriteCount  =   0;
+    uint32_t                    i           =   0;
+    char                        Name[64];
+
+    memset(Payload, 0x5A, sizeof(Payload));
+    memset(&BenchCtx, 0, sizeof(BenchCtx));
+    BenchCtx.Message.Topic.Data             = (uint8_t*)D_BENCH_TOPIC;
+    BenchCtx.Message.Topic.Length           = strlen(D_BENCH_TOPIC);
+    BenchCtx.Message.Content                = Payload;
+    BenchCtx.Message.Length                 = sizeof(Payload);
+    Bench_SessionInit(&BenchCtx.Handler, &BenchCtx, bench_write_callback);
+    /* no Message times out while measuring */
+    BenchCtx.Handler.KeepAliveInterval      = 600;
+    BenchCtx.Handler.MessageRetryInterval   = 600;
+    Bench_SessionStart(&BenchCtx.Handler);
+    Bench_SessionConnect(&BenchCtx.Handler);
+    for(i = 0; i < Depth; i++)
+    {
+        if(MQC_Publish(&BenchCtx.Handler, &BenchCtx.Message, E_MQC_QOS_1, false, NULL))
+        {
+            printf("MQC_Publish failed\n");
+            exit(1);
+        }
+    }
+
+    /* no Message should time out (nor PINGREQ should be sent) while measuring */
+    WriteCount = BenchCtx.WriteCount;
+    snprintf(Name, sizeof(Name), "timer/idle-tick/%u", Depth);
+    Bench_Print(Name, Bench_Run(&BenchCtx, bench_tick, D_BENCH_TICK_COUNT, D_BENCH_DEFAULT_ROUNDS));
+    if(WriteCount != BenchCtx.WriteCount)
+    {
+        printf("Unexpected Message is sent\n");
+        exit(1);
+    }
+
+    MQC_Stop(&BenchCtx.Handler);
+}
+
+/**
+ * @brief               Main function of the retry timer benchmark
+ * @author              agent@local
+ * @date                2026/10/17
+ */
+int main(int argc, char** argv)
+{
+    static const uint32_t   Depth[]     =   { 0, 10, 100, 1000, 10000, 65535 };
+    uint32_t                i           =   0;
+
+    for(i = 0; i < sizeof(Depth)/sizeof(Depth[0]); i++)
+    {
+        bench_timer_case(Depth[i]);
+    }
+    return 0;
+}